@@ -42,7 +42,8 @@ using float3x4 = glm::mat3x4;
 using float4x3 = glm::mat4x3;
 
 const char*           k_app_name = "ChessSet";
-const uint32_t        k_image_count = 1;
+const uint32_t        k_image_count = 3;
+const uint32_t        k_frame_count = 2;
 #if defined(__linux__)
 const tr::fs::path    k_asset_dir = "../demos/assets/";
 #elif defined(_WIN32)
@@ -50,8 +51,8 @@ const tr::fs::path    k_asset_dir = "../../demos/assets/";
 #endif
 
 tr_renderer*          g_renderer = nullptr;
-tr_cmd_pool*          g_cmd_pool = nullptr;
-tr_cmd**              g_cmds = nullptr;
+tr_frame_context*     g_frame_context = nullptr;
+tr_linear_allocator*  g_uniform_allocator = nullptr;
 
 tr::BlinnPhongEntity  g_chess_board_1_solid;
 tr::BlinnPhongEntity  g_chess_board_2_solid;
@@ -172,15 +173,20 @@ void init_tiny_renderer(GLFWwindow* window)
     settings.log_fn                         = renderer_log;
 #if defined(TINY_RENDERER_VK)
     settings.vk_debug_fn                    = vulkan_debug;
+    settings.vk_pipeline_cache_path         = "ChessSet.pipelinecache";
     settings.instance_layers.count          = (uint32_t)instance_layers.size();
     settings.instance_layers.names          = instance_layers.empty() ? nullptr : instance_layers.data();
 #endif
     tr_create_renderer(k_app_name, &settings, &g_renderer);
 
-    // Command buffers
+    // Command buffers and sync objects for each frame in flight
     {
-      tr_create_cmd_pool(g_renderer, g_renderer->graphics_queue, false, &g_cmd_pool);
-      tr_create_cmd_n(g_cmd_pool, false, k_image_count, &g_cmds);
+      tr_create_frame_context(g_renderer, k_frame_count, &g_frame_context);
+    }
+
+    // Per frame constant buffer data for all entities
+    {
+      tr_create_linear_allocator(g_renderer, 64 * 1024, k_frame_count, &g_uniform_allocator);
     }
   }
     
@@ -222,6 +228,7 @@ void init_tiny_renderer(GLFWwindow* window)
     entity_create_info.pipeline_settings.primitive_topo = tr_primitive_topo_tri_list;
     entity_create_info.pipeline_settings.depth          = true;
     entity_create_info.pipeline_settings.cull_mode      = tr_cull_mode_back;
+    entity_create_info.uniform_allocator                = g_uniform_allocator;
 
     // Create solids
     g_chess_board_1_solid.Create(g_renderer, entity_create_info);
@@ -235,6 +242,7 @@ void init_tiny_renderer(GLFWwindow* window)
     entity_create_info.render_target                    = g_renderer->swapchain_render_targets[0];
     entity_create_info.pipeline_settings.primitive_topo = tr_primitive_topo_tri_list;
     entity_create_info.pipeline_settings.depth          = true;
+    entity_create_info.uniform_allocator                = g_uniform_allocator;
 
     // Create wireframes
     g_chess_pieces_1_wireframe.Create(g_renderer, entity_create_info);
@@ -272,18 +280,16 @@ void init_tiny_renderer(GLFWwindow* window)
 
 void destroy_tiny_renderer()
 {
+    tr_destroy_frame_context(g_renderer, g_frame_context);
+    tr_destroy_linear_allocator(g_renderer, g_uniform_allocator);
     tr_destroy_renderer(g_renderer);
 }
 
 void draw_frame()
 {
-    uint32_t frameIdx = g_frame_count % g_renderer->settings.swapchain.image_count;
-
-    tr_fence* image_acquired_fence = g_renderer->image_acquired_fences[frameIdx];
-    tr_semaphore* image_acquired_semaphore = g_renderer->image_acquired_semaphores[frameIdx];
-    tr_semaphore* render_complete_semaphores = g_renderer->render_complete_semaphores[frameIdx];
-
-    tr_acquire_next_image(g_renderer, image_acquired_semaphore, image_acquired_fence);
+    // Waits for the frame that last used this slot, the slot's uniform data is free after that
+    tr_cmd* cmd = tr_frame_context_begin(g_frame_context);
+    tr_linear_allocator_reset(g_uniform_allocator, g_frame_context->frame_index);
 
     uint32_t swapchain_image_index = g_renderer->swapchain_image_index;
     tr_render_target* render_target = g_renderer->swapchain_render_targets[swapchain_image_index];
@@ -325,8 +331,6 @@ void draw_frame()
     g_chess_pieces_1_wireframe.UpdateGpuBuffers();
     g_chess_pieces_2_wireframe.UpdateGpuBuffers();
 
-    tr_cmd* cmd = g_cmds[frameIdx];
-    tr_begin_cmd(cmd);
     tr_cmd_render_target_transition(cmd, render_target, tr_texture_usage_present, tr_texture_usage_color_attachment); 
     tr_cmd_depth_stencil_transition(cmd, render_target, tr_texture_usage_sampled_image, tr_texture_usage_depth_stencil_attachment);
 	tr_cmd_set_line_width(cmd, 1.0f);
@@ -350,12 +354,8 @@ void draw_frame()
     tr_cmd_end_render(cmd);
     tr_cmd_render_target_transition(cmd, render_target, tr_texture_usage_color_attachment, tr_texture_usage_present); 
     tr_cmd_depth_stencil_transition(cmd, render_target, tr_texture_usage_depth_stencil_attachment, tr_texture_usage_sampled_image);
-    tr_end_cmd(cmd);
-
-    tr_queue_submit(g_renderer->graphics_queue, 1, &cmd, 1, &image_acquired_semaphore, 1, &render_complete_semaphores);
-    tr_queue_present(g_renderer->present_queue, 1, &render_complete_semaphores);
 
-    tr_queue_wait_idle(g_renderer->graphics_queue);
+    tr_frame_context_end(g_frame_context);
 }
 
 int main(int argc, char **argv)
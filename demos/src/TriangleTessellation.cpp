@@ -401,7 +401,7 @@ void draw_frame()
     tr_cmd_depth_stencil_transition(cmd, render_target, tr_texture_usage_depth_stencil_attachment, tr_texture_usage_sampled_image);
     tr_end_cmd(cmd);
 
-    tr_queue_submit(g_renderer->graphics_queue, 1, &cmd, 1, &image_acquired_semaphore, 1, &render_complete_semaphores);
+    tr_queue_submit(g_renderer->graphics_queue, 1, &cmd, 1, &image_acquired_semaphore, 1, &render_complete_semaphores, NULL);
     tr_queue_present(g_renderer->present_queue, 1, &render_complete_semaphores);
 
     tr_queue_wait_idle(g_renderer->graphics_queue);
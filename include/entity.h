@@ -39,6 +39,9 @@ namespace tr
         std::vector<uint32_t> buffer_bindings;
         tr_render_target* render_target;
         tr_pipeline_settings pipeline_settings;
+        // Optional, constant buffers are written into this each frame instead of
+        // into per entity buffers.
+        tr_linear_allocator* uniform_allocator;
     };
 
     /*! @class EntityT
@@ -78,6 +81,7 @@ namespace tr
       private:
         void SetViewDirty(bool value);
         void SetTranformDirty(bool value);
+        void UpdateTransientGpuBuffers();
 
       private:
         // Renderer
@@ -110,6 +114,8 @@ namespace tr
         // Tessellation
         TessParamsT m_cpu_tess_params;
         tr_buffer* m_gpu_tess_params = nullptr;
+        // Offsets into the uniform allocator's buffer for this frame
+        uint32_t m_dynamic_offsets[ENTITY_DESCRIPTOR_BINDING_COUNT] = {};
     };
 
     /*! @fn EntityT<CpuLightingBufferT>::EntityT */
@@ -164,34 +170,50 @@ namespace tr
             uint32_t total_descriptor_count = const_buffer_count + texture_count + buffer_count;
             std::vector<tr_descriptor> descriptors(total_descriptor_count);
 
+            // Limit each descriptor to the stages the shaders use it in when the program has
+            // SPIR-V reflection
+            auto binding_stages = [&](uint32_t binding) -> tr_shader_stage {
+                return tr_get_binding_shader_stages(m_create_info.shader_program, 0, binding,
+                                                    tr_shader_stage_all_graphics);
+            };
+
             uint32_t index = 0;
-            // Constant buffers descriptors
+            // Constant buffers descriptors, transient ones are bound with dynamic offsets so the
+            // set never has to be rewritten when the data moves
+            tr_descriptor_type const_buffer_type = tr_descriptor_type_uniform_buffer_cbv;
+            if (m_create_info.uniform_allocator != nullptr)
+            {
+                const_buffer_type = tr_descriptor_type_uniform_buffer_dynamic_cbv;
+            }
             {
                 // View transform
                 if (has_view_transform)
                 {
-                    descriptors[index].type = tr_descriptor_type_uniform_buffer_cbv;
+                    descriptors[index].type = const_buffer_type;
                     descriptors[index].count = 1;
                     descriptors[index].binding = ENTITY_DESCRIPTOR_BINDING_VIEW_TRANSFORM;
-                    descriptors[index].shader_stages = tr_shader_stage_all_graphics;
+                    descriptors[index].shader_stages =
+                        binding_stages(ENTITY_DESCRIPTOR_BINDING_VIEW_TRANSFORM);
                     ++index;
                 }
                 // Lighting
                 if (has_lighting)
                 {
-                    descriptors[index].type = tr_descriptor_type_uniform_buffer_cbv;
+                    descriptors[index].type = const_buffer_type;
                     descriptors[index].count = 1;
                     descriptors[index].binding = ENTITY_DESCRIPTOR_BINDING_LIGHTING_PARAMS;
-                    descriptors[index].shader_stages = tr_shader_stage_all_graphics;
+                    descriptors[index].shader_stages =
+                        binding_stages(ENTITY_DESCRIPTOR_BINDING_LIGHTING_PARAMS);
                     ++index;
                 }
                 // Tessellation
                 if (has_tess)
                 {
-                    descriptors[index].type = tr_descriptor_type_uniform_buffer_cbv;
+                    descriptors[index].type = const_buffer_type;
                     descriptors[index].count = 1;
                     descriptors[index].binding = ENTITY_DESCRIPTOR_BINDING_TESS_PARAMS;
-                    descriptors[index].shader_stages = tr_shader_stage_all_graphics;
+                    descriptors[index].shader_stages =
+                        binding_stages(ENTITY_DESCRIPTOR_BINDING_TESS_PARAMS);
                     ++index;
                 }
             }
@@ -203,7 +225,7 @@ namespace tr
                 descriptors[index].type = tr_descriptor_type_texture_srv;
                 descriptors[index].count = 1;
                 descriptors[index].binding = binding;
-                descriptors[index].shader_stages = tr_shader_stage_all_graphics;
+                descriptors[index].shader_stages = binding_stages(binding);
                 ++index;
             }
             // Buffers descriptors
@@ -214,7 +236,7 @@ namespace tr
                 descriptors[index].type = tr_descriptor_type_storage_buffer_srv;
                 descriptors[index].count = 1;
                 descriptors[index].binding = binding;
-                descriptors[index].shader_stages = tr_shader_stage_all_graphics;
+                descriptors[index].shader_stages = binding_stages(binding);
                 ++index;
             }
 
@@ -232,7 +254,8 @@ namespace tr
             assert(m_pipeline != nullptr);
         }
 
-        // Constant buffers
+        // Constant buffers, these are handed out per frame by the allocator if there is one
+        if (m_create_info.uniform_allocator == nullptr)
         {
             if (has_view_transform)
             {
@@ -416,7 +439,7 @@ namespace tr
         {
             for (uint32_t i = 0; i < m_descriptor_set->descriptor_count; ++i)
             {
-                auto& descriptor = m_descriptor_set->descriptors[index];
+                auto& descriptor = m_descriptor_set->descriptors[i];
                 if (descriptor.binding == texture_binding.binding)
                 {
                     assert(descriptor.type == tr_descriptor_type_texture_srv);
@@ -424,13 +447,94 @@ namespace tr
                 }
             }
         }
+
+        // Transient constant buffers all point at the allocator's buffer, only the dynamic
+        // offsets change from frame to frame
+        tr_linear_allocator* p_allocator = m_create_info.uniform_allocator;
+        if (p_allocator != nullptr)
+        {
+            uint32_t sizes[ENTITY_DESCRIPTOR_BINDING_COUNT] = {
+                m_cpu_view_transform.GetDataSize(), m_cpu_lighting_params.GetDataSize(),
+                m_cpu_tess_params.GetDataSize()};
+            index = 0;
+            for (uint32_t i = 0; i < ENTITY_DESCRIPTOR_BINDING_COUNT; ++i)
+            {
+                if (sizes[i] < 4)
+                {
+                    continue;
+                }
+                uint64_t alignment = p_allocator->alignment;
+                auto& descriptor = m_descriptor_set->descriptors[index];
+                descriptor.uniform_buffers[0] = p_allocator->buffer;
+                descriptor.uniform_buffer_offsets[0] = 0;
+                descriptor.uniform_buffer_sizes[0] =
+                    ((sizes[i] + alignment - 1) / alignment) * alignment;
+                ++index;
+            }
+        }
+
         tr_update_descriptor_set(m_renderer, m_descriptor_set);
     }
 
+    /*! @fn EntityT<CpuLightingBufferT>::UpdateTransientGpuBuffers */
+    template <typename LightingParamsT, typename TessParamsT>
+    void EntityT<LightingParamsT, TessParamsT>::UpdateTransientGpuBuffers()
+    {
+        if (m_view_dirty || m_transform_dirty)
+        {
+            if (m_transform_dirty)
+            {
+                m_cpu_view_transform.SetTransform(m_transform);
+            }
+            m_view_dirty = false;
+            m_transform_dirty = false;
+        }
+
+        // The allocator was reset for this frame so everything is written out again
+        tr_linear_allocator* p_allocator = m_create_info.uniform_allocator;
+        tr_linear_allocation allocation = {};
+        uint32_t index = 0;
+        if (m_cpu_view_transform.GetDataSize() >= 4)
+        {
+            bool res = tr_linear_allocator_alloc(p_allocator, m_cpu_view_transform.GetDataSize(),
+                                                 &allocation);
+            assert(res);
+            m_cpu_view_transform.Write(allocation.cpu_mapped_address);
+            m_dynamic_offsets[index] = (uint32_t)allocation.offset;
+            ++index;
+        }
+
+        if (m_cpu_lighting_params.GetDataSize() >= 4)
+        {
+            bool res = tr_linear_allocator_alloc(p_allocator, m_cpu_lighting_params.GetDataSize(),
+                                                 &allocation);
+            assert(res);
+            m_cpu_lighting_params.Write(allocation.cpu_mapped_address);
+            m_dynamic_offsets[index] = (uint32_t)allocation.offset;
+            ++index;
+        }
+
+        if (m_cpu_tess_params.GetDataSize() >= 4)
+        {
+            bool res = tr_linear_allocator_alloc(p_allocator, m_cpu_tess_params.GetDataSize(),
+                                                 &allocation);
+            assert(res);
+            m_cpu_tess_params.Write(allocation.cpu_mapped_address);
+            m_dynamic_offsets[index] = (uint32_t)allocation.offset;
+            ++index;
+        }
+    }
+
     /*! @fn EntityT<CpuLightingBufferT>::UpdateGpuBuffers */
     template <typename LightingParamsT, typename TessParamsT>
     void EntityT<LightingParamsT, TessParamsT>::UpdateGpuBuffers()
     {
+        if (m_create_info.uniform_allocator != nullptr)
+        {
+            UpdateTransientGpuBuffers();
+            return;
+        }
+
         // View/transform constant buffer
         if ((m_gpu_view_transform != nullptr) && (m_view_dirty || m_transform_dirty))
         {
@@ -468,7 +572,9 @@ namespace tr
     {
         tr_cmd_bind_pipeline(p_cmd, m_pipeline);
 
-        tr_cmd_bind_descriptor_sets(p_cmd, m_pipeline, m_descriptor_set);
+        tr_cmd_bind_descriptor_sets_dynamic(p_cmd, m_pipeline, m_descriptor_set,
+                                            m_descriptor_set->dynamic_offset_count,
+                                            m_dynamic_offsets);
 
         tr_cmd_bind_vertex_buffers(p_cmd, (uint32_t)m_vertex_buffers.size(),
                                    m_vertex_buffers.data());
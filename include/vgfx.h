@@ -43,10 +43,13 @@ THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 NOTES:
  - Microsoft's C compiler doesn't support certain C11/C99 features, such as VLAs
  - tinyvk/tinydx is written for experimentation and fun-having - not performance
- - For simplicity, only one descriptor set can be bound at once
-   - In D3D12, this means two descriptor heaps (CBVSRVUAVs and samplers)
-   - For Vulkan shaders the 'set' parameter for 'layout' should always be 0
-   - For D3D12 shaders the 'space' parameter for resource bindings should always be 0
+ - Pipelines take up to tr_max_descriptor_sets descriptor sets, e.g. one per update frequency
+   - Vulkan only guarantees maxBoundDescriptorSets = 4, stay at 4 sets for portable code
+   - Descriptor set i is 'set = i' for Vulkan shaders and 'space' i for D3D12 shaders
+   - tr_cmd_bind_descriptor_sets_n rebinds a range of sets, the sets before it stay bound
+   - In D3D12 every set takes its tables from two shader visible heaps (CBVSRVUAVs and
+     samplers) shared by the renderer, sized by tr_dx_cbvsrvuav_heap_size and
+     tr_dx_sampler_heap_size
  - Vulkan like idioms are used primarily with some D3D12 wherever it makes sense
  - Storage buffers created with tr_create_storage_buffer are not host visible.
    - This was done to align the behavior on Vulkan and D3D12. Vulkan's storage
@@ -58,8 +61,12 @@ NOTES:
 #pragma once
 
 #include <assert.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <stdint.h>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #if defined(__linux__)
@@ -135,8 +142,28 @@ enum
     tr_max_vertex_bindings = 15,
     tr_max_vertex_attribs = 15,
     tr_max_semantic_name_length = 128,
-    tr_max_descriptor_entries = 256,
+    tr_max_specialization_constants = 16,
+    tr_descriptor_pool_block_set_count = 1024,
+    tr_bindless_default_texture_count = 16384,
+    tr_bindless_default_buffer_count = 16384,
+    // Element 0 of both bindless arrays is never handed out
+    tr_bindless_invalid_index = 0,
+    // Shader visible D3D12 heaps every descriptor set takes its tables from, 2048 is the most
+    // samplers a shader visible heap can hold
+    tr_dx_cbvsrvuav_heap_size = 65536,
+    tr_dx_sampler_heap_size = 2048,
+    // Vulkan only guarantees 128 bytes of push constants
+    tr_max_push_constant_size = 128,
+    // Dynamic uniform buffer elements in one descriptor set, Vulkan only guarantees 8
+    tr_max_dynamic_offsets = 8,
+    // D3D12 root constants are bound to b0 in this space, past the spaces of the descriptor sets
+    tr_push_constant_register_space = tr_max_descriptor_sets,
     tr_max_mip_levels = 0xFFFFFFFF,
+    // tr_sampler_desc::max_lod that doesn't clamp the mip chain, same as VK_LOD_CLAMP_NONE
+    tr_lod_clamp_none = 1000,
+    tr_memory_block_size = 64 * 1024 * 1024,
+    tr_memory_min_allocation_size = 256,
+    tr_upload_staging_size = 32 * 1024 * 1024,
 };
 #endif
 
@@ -259,6 +286,8 @@ enum tr_format
     // 4 channel
     tr_format_b8g8r8a8_unorm,
     tr_format_r8g8b8a8_unorm,
+    tr_format_b8g8r8a8_srgb,
+    tr_format_r8g8b8a8_srgb,
     tr_format_r16g16b16a16_unorm,
     tr_format_r16g16b16a16_float,
     tr_format_r32g32b32a32_uint,
@@ -271,6 +300,21 @@ enum tr_format
     tr_format_d16_unorm_s8_uint,
     tr_format_d24_unorm_s8_uint,
     tr_format_d32_float_s8_uint,
+    // Block compressed, 4x4 texel blocks
+    tr_format_bc1_rgba_unorm,
+    tr_format_bc1_rgba_srgb,
+    tr_format_bc3_unorm,
+    tr_format_bc3_srgb,
+    tr_format_bc4_unorm,
+    tr_format_bc5_unorm,
+    tr_format_bc6h_ufloat,
+    tr_format_bc7_unorm,
+    tr_format_bc7_srgb,
+    tr_format_etc2_r8g8b8_unorm,
+    tr_format_etc2_r8g8b8a8_unorm,
+    tr_format_etc2_r8g8b8a8_srgb,
+    tr_format_astc_4x4_unorm,
+    tr_format_astc_4x4_srgb,
 };
 
 enum tr_descriptor_type
@@ -284,6 +328,7 @@ enum tr_descriptor_type
     tr_descriptor_type_storage_texel_buffer_uav, // UAV | VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER
     tr_descriptor_type_texture_srv,              // SRV | VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE
     tr_descriptor_type_texture_uav,              // UAV | VK_DESCRIPTOR_TYPE_STORAGE_IMAGE
+    tr_descriptor_type_uniform_buffer_dynamic_cbv, // CBV | VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC
 };
 
 enum tr_sample_count
@@ -363,6 +408,46 @@ enum tr_front_face
     tr_front_face_cw
 };
 
+enum tr_filter
+{
+    tr_filter_nearest = 0,
+    tr_filter_linear
+};
+
+enum tr_mipmap_mode
+{
+    tr_mipmap_mode_nearest = 0,
+    tr_mipmap_mode_linear
+};
+
+enum tr_address_mode
+{
+    tr_address_mode_repeat = 0,
+    tr_address_mode_mirrored_repeat,
+    tr_address_mode_clamp_to_edge,
+    tr_address_mode_clamp_to_border
+};
+
+enum tr_compare_op
+{
+    tr_compare_op_never = 0,
+    tr_compare_op_less,
+    tr_compare_op_equal,
+    tr_compare_op_less_or_equal,
+    tr_compare_op_greater,
+    tr_compare_op_not_equal,
+    tr_compare_op_greater_or_equal,
+    tr_compare_op_always
+};
+
+// Speed/quality trade off of the CPU block compressor, normal is the zero default
+enum tr_compression_quality
+{
+    tr_compression_quality_normal = 0,
+    tr_compression_quality_fast,
+    tr_compression_quality_high,
+};
+
 enum tr_tessellation_domain_origin
 {
     tr_tessellation_domain_origin_upper_left = 0,
@@ -382,12 +467,24 @@ enum tr_dx_shader_target
     tr_dx_shader_target_5_1,
     tr_dx_shader_target_6_0,
 };
+
+enum tr_deferred_destroy_type
+{
+    tr_deferred_destroy_type_buffer = 0,
+    tr_deferred_destroy_type_texture,
+    tr_deferred_destroy_type_pipeline,
+    tr_deferred_destroy_type_descriptor_set,
+};
 // Forward declarations
 struct tr_renderer;
 struct tr_render_target;
 struct tr_buffer;
 struct tr_texture;
 struct tr_sampler;
+struct tr_upload_context;
+struct tr_job_system;
+struct tr_descriptor_pool;
+struct tr_descriptor_set;
 
 struct tr_clear_value
 {
@@ -443,6 +540,19 @@ struct tr_renderer_settings
     // std::vector<std::string>                      device_layers;
     std::vector<std::string> device_extensions;
     PFN_vkDebugReportCallbackEXT vk_debug_fn;
+    // Optional file the pipeline cache is loaded from at startup and saved to at shutdown
+    std::string vk_pipeline_cache_path;
+    // Creates tr_renderer::bindless_descriptor_set when the device supports
+    // VK_EXT_descriptor_indexing. Counts of 0 use the defaults, both are clamped to device limits.
+    bool bindless;
+    uint32_t bindless_texture_count;
+    uint32_t bindless_buffer_count;
+    // Quality tr_queue_update_texture_uint8 compresses BC1, BC3, BC4, BC5 and BC7 textures with
+    tr_compression_quality texture_compression_quality;
+    // Optional directory the compressed mip chains are cached in, keyed by a hash of the source
+    // image and the texture's format, size and mip count. Uploads with a custom resize_fn
+    // always compress.
+    std::string texture_cache_dir;
 
 #if defined(TINY_RENDERER_MSW)
     D3D_FEATURE_LEVEL dx_feature_level;
@@ -453,28 +563,45 @@ struct tr_renderer_settings
 struct tr_fence
 {
     VkFence vk_fence;
+    // Set once the fence has been handed to a submit or acquire, waiting on a fence that was never
+    // submitted returns right away instead of blocking forever
+    bool vk_submitted;
 #if defined(TINY_RENDERER_MSW)
     ID3D12FencePtr dx_fence;
+    HANDLE dx_fence_event;
+    // Value signaled by the last submit, the fence is signaled once the GPU has reached it
+    UINT64 dx_fence_value;
 #endif
 };
 
 struct tr_semaphore
 {
+    // Timeline semaphores carry a 64-bit counter instead of a signaled bit
+    bool timeline;
     VkSemaphore vk_semaphore;
 #if defined(TINY_RENDERER_MSW)
     void* dx_semaphore;
+    // Both kinds map onto a fence. Binary semaphores signal dx_fence_value + 1 and waits are for
+    // the last signaled value, timeline semaphores use their values as fence values.
+    ID3D12FencePtr dx_fence;
+    uint64_t dx_fence_value;
+    HANDLE dx_fence_event;
 #endif
 };
 
 struct tr_queue
 {
     tr_renderer* renderer;
+    // Created on first use by the tr_queue_update_* functions
+    tr_upload_context* upload_context;
 
     VkQueue vk_queue;
     uint32_t vk_queue_family_index;
+    VkQueueFlags vk_queue_flags;
 
 #if defined(TINY_RENDERER_MSW)
     ID3D12CommandQueuePtr dx_queue;
+    D3D12_COMMAND_LIST_TYPE dx_cmd_list_type;
     HANDLE dx_wait_idle_fence_event;
     ID3D12FencePtr dx_wait_idle_fence;
     UINT64 dx_wait_idle_fence_value;
@@ -537,6 +664,101 @@ enum rtx_instance_flags
     rtx_instance_force_no_opaque = 0x8,
 };
 
+// A single VkDeviceMemory that buffers and textures are sub-allocated from using buddy blocks
+struct tr_memory_block
+{
+    VkDeviceMemory vk_memory;
+    uint32_t memory_type_index;
+    // Linear and optimal resources never share a block so bufferImageGranularity can be ignored
+    bool linear;
+    void* cpu_mapped_address;
+    uint32_t allocation_count;
+    // Free offsets per order, order 0 is tr_memory_min_allocation_size bytes
+    std::vector<std::vector<VkDeviceSize>> free_lists;
+};
+
+struct tr_memory_allocation
+{
+    // NULL for dedicated allocations that are too large for a block
+    tr_memory_block* block;
+    VkDeviceMemory vk_memory;
+    VkDeviceSize offset;
+    VkDeviceSize size;
+    void* cpu_mapped_address;
+};
+
+struct tr_memory_stats
+{
+    // Live vkAllocateMemory calls, this is block_count + dedicated_count
+    uint32_t device_memory_count;
+    uint32_t block_count;
+    uint32_t dedicated_count;
+    // Live buffer and texture allocations
+    uint32_t allocation_count;
+    uint64_t reserved_bytes;
+    uint64_t used_bytes;
+};
+
+// Object waiting for the GPU to retire frame_number before it's destroyed
+struct tr_deferred_destroy
+{
+    tr_deferred_destroy_type type;
+    uint64_t frame_number;
+    void* object;
+};
+
+struct tr_pipeline_stats
+{
+    // True when the pipeline cache was loaded from disk, pipelines created since then are warm
+    bool cache_warm;
+    uint64_t cache_loaded_bytes;
+    uint32_t cold_pipeline_count;
+    uint32_t warm_pipeline_count;
+    // CPU time spent in pipeline creation
+    double cold_create_ms;
+    double warm_create_ms;
+    // Create calls that returned an existing pipeline instead of compiling a new one
+    uint32_t shared_pipeline_count;
+};
+
+// Index released while frame_number was recorded
+struct tr_bindless_retired_index
+{
+    uint32_t index;
+    uint64_t frame_number;
+};
+
+// Hands out stable indices into one array of the bindless descriptor set
+struct tr_bindless_table
+{
+    uint32_t capacity;
+    // Indices past next_index have never been used
+    uint32_t next_index;
+    // Released indices whose frame has retired, reused before next_index grows
+    std::vector<uint32_t> free_indices;
+    // Released indices frames in flight may still read, ordered by frame_number
+    std::vector<tr_bindless_retired_index> retired_indices;
+};
+
+// Consecutive descriptors of a tr_dx_descriptor_heap
+struct tr_dx_descriptor_range
+{
+    uint32_t offset;
+    uint32_t count;
+};
+
+// One shader visible D3D12 heap shared by all descriptor sets, which take ranges out of it
+struct tr_dx_descriptor_heap
+{
+    uint32_t capacity;
+    // Unused ranges ordered by offset, neighbours are merged when a range is freed
+    std::vector<tr_dx_descriptor_range> free_ranges;
+    std::mutex mutex;
+#if defined(TINY_RENDERER_MSW)
+    ID3D12DescriptorHeapPtr dx_heap;
+#endif
+};
+
 struct tr_renderer
 {
     tr_api api;
@@ -545,10 +767,46 @@ struct tr_renderer
     uint32_t swapchain_image_index;
     tr_queue* graphics_queue;
     tr_queue* present_queue;
+    // Optional, NULL when the GPU has no dedicated transfer or async compute queue family. The
+    // tr_queue_update_* helpers leave resources in shader states and need the graphics queue.
+    tr_queue* transfer_queue;
+    tr_queue* compute_queue;
     std::vector<tr_fence*> image_acquired_fences;
     std::vector<tr_semaphore*> image_acquired_semaphores;
     std::vector<tr_semaphore*> render_complete_semaphores;
 
+    // Frame being recorded and the newest frame the GPU is known to have finished, both are
+    // advanced by tr_frame_context. Deferred destroys are tagged with frame_number.
+    uint64_t frame_number;
+    uint64_t retired_frame_number;
+    // Ordered by frame_number
+    std::vector<tr_deferred_destroy> deferred_destroys;
+
+    uint64_t next_shader_program_id;
+    // Live pipelines keyed on everything that goes into creating them. The mutex also guards
+    // pipeline ref counts and pipeline_stats since async creates finish on worker threads.
+    std::unordered_map<std::string, tr_pipeline*> pipelines;
+    std::mutex pipeline_mutex;
+    // Notified with pipeline_mutex held whenever pipelines become ready, by worker jobs and by
+    // synchronous creates alike
+    std::condition_variable pipeline_ready_cv;
+    // Live samplers keyed on their tr_sampler_desc, the mutex also guards their ref counts
+    std::unordered_map<std::string, tr_sampler*> samplers;
+    std::mutex sampler_mutex;
+    // Worker threads for async pipeline creation, started on first use
+    tr_job_system* job_system;
+    // Backs tr_create_descriptor_set
+    tr_descriptor_pool* descriptor_pool;
+    // NULL unless bindless is enabled and supported. Binding 0 is an array of every sampled
+    // texture and binding 1 an array of every storage buffer, indexed by their bindless_index.
+    // Pass it to tr_create_pipeline_n and bind it like any other set, it's never updated by hand.
+    // Shaders declare e.g. [[vk::binding(0, N)]] Texture2D g_textures[] and wrap indices that
+    // vary within a draw in NonUniformResourceIndex.
+    tr_descriptor_set* bindless_descriptor_set;
+    tr_bindless_table bindless_textures;
+    tr_bindless_table bindless_buffers;
+    std::mutex bindless_mutex;
+
     tr_render_target* bound_render_target;
 
     VkInstance vk_instance;
@@ -558,12 +816,40 @@ struct tr_renderer
     uint32_t vk_active_gpu_index;
     VkPhysicalDeviceMemoryProperties vk_memory_properties;
     VkPhysicalDeviceProperties vk_active_gpu_properties;
+    uint32_t vk_api_version;
+    // Hands out vk_resource_id to buffers, textures and samplers
+    std::atomic<uint64_t> vk_next_resource_id;
+    std::vector<tr_memory_block*> vk_memory_blocks;
+    tr_memory_stats memory_stats;
+    tr_pipeline_stats pipeline_stats;
     VkDevice vk_device;
+    VkPipelineCache vk_pipeline_cache;
     VkSurfaceKHR vk_surface;
     VkSwapchainKHR vk_swapchain;
     VkDebugReportCallbackEXT vk_debug_report;
 
     bool vk_device_ext_VK_AMD_negative_viewport_height;
+    bool vk_device_ext_VK_KHR_timeline_semaphore;
+    bool vk_device_ext_VK_KHR_descriptor_update_template;
+    bool vk_device_ext_VK_EXT_descriptor_indexing;
+    VkDescriptorPool vk_bindless_descriptor_pool;
+
+#if defined(VK_VERSION_1_1)
+    PFN_vkGetPhysicalDeviceFeatures2 vkGetPhysicalDeviceFeatures2 = VK_NULL_HANDLE;
+    PFN_vkGetPhysicalDeviceProperties2 vkGetPhysicalDeviceProperties2 = VK_NULL_HANDLE;
+#endif
+#if defined(VK_KHR_timeline_semaphore)
+    PFN_vkGetSemaphoreCounterValueKHR vkGetSemaphoreCounterValueKHR = VK_NULL_HANDLE;
+    PFN_vkWaitSemaphoresKHR vkWaitSemaphoresKHR = VK_NULL_HANDLE;
+    PFN_vkSignalSemaphoreKHR vkSignalSemaphoreKHR = VK_NULL_HANDLE;
+#endif
+#if defined(VK_KHR_descriptor_update_template)
+    PFN_vkCreateDescriptorUpdateTemplateKHR vkCreateDescriptorUpdateTemplateKHR = VK_NULL_HANDLE;
+    PFN_vkDestroyDescriptorUpdateTemplateKHR vkDestroyDescriptorUpdateTemplateKHR =
+        VK_NULL_HANDLE;
+    PFN_vkUpdateDescriptorSetWithTemplateKHR vkUpdateDescriptorSetWithTemplateKHR =
+        VK_NULL_HANDLE;
+#endif
 
     PFN_vkCreateAccelerationStructureNVX vkCreateAccelerationStructureNVX = VK_NULL_HANDLE;
     PFN_vkDestroyAccelerationStructureNVX vkDestroyAccelerationStructureNVX = VK_NULL_HANDLE;
@@ -591,6 +877,10 @@ struct tr_renderer
     IDXGIAdapter3Ptr dx_gpus[tr_max_gpus];
     IDXGIAdapter3Ptr dx_active_gpu;
     ID3D12DevicePtr dx_device;
+    // SetDescriptorHeaps replaces the bound heaps and invalidates tables into the old ones, so
+    // every set is allocated from this one pair and several sets stay bound at once
+    tr_dx_descriptor_heap dx_cbvsrvuav_heap;
+    tr_dx_descriptor_heap dx_sampler_heap;
     // Use IDXGISwapChain3 for now since IDXGISwapChain4
     // isn't supported by older devices.
     IDXGISwapChain3Ptr dx_swapchain;
@@ -603,32 +893,86 @@ struct tr_descriptor
     uint32_t binding;
     uint32_t count;
     tr_shader_stage shader_stages;
-    tr_buffer* uniform_buffers[tr_max_descriptor_entries];
-    tr_texture* textures[tr_max_descriptor_entries];
-    tr_sampler* samplers[tr_max_descriptor_entries];
-    tr_buffer* buffers[tr_max_descriptor_entries];
+    // count entries in the arena of the owning set, type decides which member is valid. When
+    // creating a set these are optional, non-NULL entries are copied into the set.
+    union
+    {
+        tr_buffer** uniform_buffers;
+        tr_texture** textures;
+        tr_sampler** samplers;
+        tr_buffer** buffers;
+    };
+    // Optional sub-range into each uniform buffer, a size of 0 means the whole buffer. Only
+    // uniform buffer descriptors have these.
+    uint64_t* uniform_buffer_offsets;
+    uint64_t* uniform_buffer_sizes;
 #if defined(TINY_RENDERER_MSW)
     uint32_t dx_heap_offset;
     uint32_t dx_root_parameter_index;
+    uint32_t dx_dynamic_offset_index;
 #endif
 };
 
+// What a single descriptor element resolves to when it's written to a VkDescriptorSet
+union tr_vk_descriptor_info
+{
+    VkDescriptorImageInfo image;
+    VkDescriptorBufferInfo buffer;
+    VkBufferView texel_buffer_view;
+};
+
 struct tr_descriptor_set
 {
     uint32_t descriptor_count;
     tr_descriptor* descriptors;
+    // Single allocation holding the entries of all descriptors
+    uint64_t* descriptor_arena;
+    // Number of offsets tr_cmd_bind_descriptor_sets_dynamic expects
+    uint32_t dynamic_offset_count;
+    tr_descriptor_pool* descriptor_pool;
     VkDescriptorSetLayout vk_descriptor_set_layout;
     VkDescriptorSet vk_descriptor_set;
+    // Block of descriptor_pool the set was carved out of
     VkDescriptorPool vk_descriptor_pool;
+    // Infos written by the last tr_update_descriptor_set, later updates only write the
+    // descriptors whose infos changed. Each descriptor owns count consecutive entries
+    // starting at vk_descriptor_info_offsets[i]. Handles of destroyed objects can come back
+    // for new ones, so the vk_resource_id of every entry is compared as well.
+    std::vector<tr_vk_descriptor_info> vk_descriptor_infos;
+    std::vector<uint64_t> vk_descriptor_resource_ids;
+    std::vector<uint32_t> vk_descriptor_info_offsets;
+    bool vk_descriptors_written;
+#if defined(VK_KHR_descriptor_update_template)
+    // Writes the whole set from vk_descriptor_infos in one call
+    VkDescriptorUpdateTemplateKHR vk_update_template;
+#endif
 #if defined(TINY_RENDERER_MSW)
-    ID3D12DescriptorHeapPtr dx_cbvsrvuav_heap;
-    ID3D12DescriptorHeapPtr dx_sampler_heap;
+    // Ranges of the renderer's shared heaps, dx_heap_offset of each descriptor is relative to the
+    // start of the heap and already includes the range offset
+    tr_dx_descriptor_range dx_cbvsrvuav_range;
+    tr_dx_descriptor_range dx_sampler_range;
 #endif
 };
 
+// Hands out descriptor sets from large shared VkDescriptorPool blocks, adding a block whenever the
+// existing ones are full. Sets of a persistent pool are freed back into their block one by one.
+// Sets of a transient pool live until tr_reset_descriptor_pool frees all of them at once.
+struct tr_descriptor_pool
+{
+    tr_renderer* renderer;
+    bool transient;
+    uint32_t sets_per_block;
+    std::vector<tr_descriptor_set*> transient_sets;
+    std::mutex mutex;
+    std::vector<VkDescriptorPool> vk_descriptor_pools;
+    // First block to allocate from, moves back when a set is freed into an earlier block
+    uint32_t vk_pool_index;
+};
+
 struct tr_cmd_pool
 {
     tr_renderer* renderer;
+    tr_queue* queue;
     VkCommandPool vk_cmd_pool;
 #if defined(TINY_RENDERER_MSW)
     ID3D12CommandAllocatorPtr dx_cmd_alloc;
@@ -641,6 +985,8 @@ struct tr_cmd
     VkCommandBuffer vk_cmd_buf;
 #if defined(TINY_RENDERER_MSW)
     ID3D12GraphicsCommandListPtr dx_cmd_list;
+    // The shared descriptor heaps only need to be set once per recording
+    bool dx_descriptor_heaps_bound;
 #endif
 };
 
@@ -659,11 +1005,15 @@ struct tr_buffer
     bool raw;
     void* cpu_mapped_address;
     VkBuffer vk_buffer;
-    VkDeviceMemory vk_memory;
+    tr_memory_allocation vk_allocation;
     // Used for uniform and storage buffers
     VkDescriptorBufferInfo vk_buffer_info;
     // Used for uniform texel and storage texel buffers
     VkBufferView vk_buffer_view;
+    // Never reused, unlike the handles, so cached descriptor writes can tell objects apart
+    uint64_t vk_resource_id;
+    // Element of the bindless storage buffer array, tr_bindless_invalid_index (0) if it has none
+    uint32_t bindless_index;
 #if defined(TINY_RENDERER_MSW)
     ID3D12ResourcePtr dx_resource;
     D3D12_CONSTANT_BUFFER_VIEW_DESC dx_cbv_view_desc;
@@ -693,10 +1043,14 @@ struct tr_texture
     void* cpu_mapped_address;
     uint32_t owns_image;
     VkImage vk_image;
-    VkDeviceMemory vk_memory;
+    tr_memory_allocation vk_allocation;
     VkImageView vk_image_view;
     VkImageAspectFlags vk_aspect_mask;
     VkDescriptorImageInfo vk_texture_view;
+    // Never reused, unlike the handles, so cached descriptor writes can tell objects apart
+    uint64_t vk_resource_id;
+    // Element of the bindless texture array, tr_bindless_invalid_index (0) if it has none
+    uint32_t bindless_index;
 
 #if defined(TINY_RENDERER_MSW)
     ID3D12ResourcePtr dx_resource;
@@ -705,19 +1059,82 @@ struct tr_texture
 #endif
 };
 
+// A zeroed desc is nearest filtering with repeat addressing that only samples mip 0. Border
+// addressing uses transparent black.
+struct tr_sampler_desc
+{
+    tr_filter mag_filter;
+    tr_filter min_filter;
+    tr_mipmap_mode mipmap_mode;
+    tr_address_mode address_u;
+    tr_address_mode address_v;
+    tr_address_mode address_w;
+    float mip_lod_bias;
+    float min_lod;
+    // tr_lod_clamp_none samples the whole mip chain
+    float max_lod;
+    // Values above 1 turn on anisotropic filtering, clamped to what the device supports
+    float max_anisotropy;
+    // Turns the sampler into a comparison sampler for shadow lookups
+    bool compare_enable;
+    tr_compare_op compare_op;
+};
+
 struct tr_sampler
 {
     tr_renderer* renderer;
+    tr_sampler_desc desc;
+    // Samplers are shared between identical create calls, tr_destroy_sampler drops a reference
+    uint32_t ref_count;
+    std::string cache_key;
     VkSampler vk_sampler;
     VkDescriptorImageInfo vk_sampler_view;
+    // Never reused, unlike the handles, so cached descriptor writes can tell objects apart
+    uint64_t vk_resource_id;
 #if defined(TINY_RENDERER_MSW)
     D3D12_SAMPLER_DESC dx_sampler_desc;
 #endif
 };
 
+// A descriptor used by a shader program, shader_stages only holds the stages that use it. A count
+// of 0 is a runtime sized array.
+struct tr_shader_binding
+{
+    uint32_t set;
+    uint32_t binding;
+    tr_descriptor_type type;
+    uint32_t count;
+    uint32_t shader_stages;
+};
+
+struct tr_shader_push_constant_range
+{
+    uint32_t offset;
+    uint32_t size;
+    uint32_t shader_stages;
+};
+
+struct tr_shader_input
+{
+    uint32_t location;
+    tr_format format;
+};
+
+// What the SPIR-V of a shader program uses, bindings are sorted by set and binding, vertex inputs
+// by location. Only Vulkan programs are reflected.
+struct tr_shader_reflection
+{
+    bool reflected;
+    std::vector<tr_shader_binding> bindings;
+    std::vector<tr_shader_push_constant_range> push_constant_ranges;
+    std::vector<tr_shader_input> vertex_inputs;
+};
+
 struct tr_shader_program
 {
     tr_renderer* renderer;
+    // Unique for the renderer's lifetime, pipeline cache keys use it instead of the address
+    uint64_t id;
     uint32_t shader_stages;
     VkShaderModule vk_vert;
     VkShaderModule vk_tesc;
@@ -731,6 +1148,7 @@ struct tr_shader_program
     std::string geom_entry_point;
     std::string frag_entry_point;
     std::string comp_entry_point;
+    tr_shader_reflection reflection;
 
 #if defined(TINY_RENDERER_MSW)
     ID3DBlobPtr dx_vert;
@@ -759,6 +1177,14 @@ struct tr_vertex_layout
     tr_vertex_attrib attribs[tr_max_vertex_attribs];
 };
 
+// Value of a SPIR-V specialization constant. Every constant is 32 bits wide, floats are passed as
+// their bit pattern and bools as 0 or 1.
+struct tr_specialization_constant
+{
+    uint32_t constant_id;
+    uint32_t value;
+};
+
 struct tr_pipeline_settings
 {
     tr_primitive_topo primitive_topo;
@@ -766,6 +1192,13 @@ struct tr_pipeline_settings
     tr_front_face front_face;
     bool depth;
     tr_tessellation_domain_origin tessellation_domain_origin;
+    // Applied to every shader stage and part of the pipeline cache key. Ignored by D3D12, which
+    // has no specialization constants.
+    uint32_t specialization_constant_count;
+    tr_specialization_constant specialization_constants[tr_max_specialization_constants];
+    // Bytes of push constants, a multiple of 4. HLSL declares them as
+    // [[vk::push_constant]] ConstantBuffer<T> name : register(b0, space8);
+    uint32_t push_constant_size;
 };
 
 struct tr_pipeline
@@ -773,15 +1206,44 @@ struct tr_pipeline
     tr_renderer* renderer;
     tr_pipeline_settings settings;
     tr_pipeline_type type;
+    // Pipelines are shared between identical create calls, tr_destroy_pipeline drops a reference
+    uint32_t ref_count;
+    std::string cache_key;
+    // False while an async create is still compiling the pipeline
+    std::atomic<bool> ready;
+    uint32_t descriptor_set_count;
+#if defined(TINY_RENDERER_MSW)
+    // Root parameter index per descriptor of every set, applied to the descriptor sets of later
+    // cache hits
+    std::vector<uint32_t> dx_root_parameter_indices;
+    // Sets of cache hits made while the pipeline was still compiling, descriptor_set_count per
+    // hit. They get their root parameter indices right before the pipeline is marked ready.
+    std::vector<tr_descriptor_set*> dx_pending_descriptor_sets;
+#endif
     VkPipelineLayout vk_pipeline_layout;
     VkPipeline vk_pipeline;
+    VkShaderStageFlags vk_push_constant_stages;
 
 #if defined(TINY_RENDERER_MSW)
+    uint32_t dx_push_constant_root_parameter_index;
     ID3D12RootSignaturePtr dx_root_signature;
     ID3D12PipelineStatePtr dx_pipeline_state;
 #endif
 };
 
+// One entry of a batched pipeline create, render_target and vertex_layout are ignored for compute
+struct tr_pipeline_create_info
+{
+    tr_pipeline_type type;
+    tr_shader_program* shader_program;
+    const tr_vertex_layout* vertex_layout;
+    // descriptor_sets[i] is set i
+    uint32_t descriptor_set_count;
+    tr_descriptor_set* descriptor_sets[tr_max_descriptor_sets];
+    tr_render_target* render_target;
+    const tr_pipeline_settings* pipeline_settings;
+};
+
 struct tr_render_target
 {
     tr_renderer* renderer;
@@ -804,6 +1266,79 @@ struct tr_render_target
 #endif
 };
 
+// Bump allocator over one persistently mapped uniform buffer that's split into one region per
+// frame in flight. Allocations are only valid until the same frame region is reset.
+struct tr_linear_allocator
+{
+    tr_renderer* renderer;
+    tr_buffer* buffer;
+    uint32_t frame_count;
+    uint32_t frame_index;
+    uint64_t frame_size;
+    uint64_t alignment;
+    uint64_t offset;
+};
+
+struct tr_linear_allocation
+{
+    tr_buffer* buffer;
+    uint64_t offset;
+    uint64_t size;
+    void* cpu_mapped_address;
+};
+
+// Ring of frame_count frames in flight. Each slot owns its command buffer, sync objects and the
+// fence its submit signals, the CPU only waits on that fence when the slot comes around again.
+struct tr_frame_context
+{
+    tr_renderer* renderer;
+    uint32_t frame_count;
+    // Slot of the frame being recorded, pass to tr_linear_allocator_reset and friends
+    uint32_t frame_index;
+    uint64_t frame_number;
+    // Number of times tr_frame_context_begin had to block on a slot the GPU was still using
+    uint64_t stall_count;
+    std::vector<tr_cmd_pool*> cmd_pools;
+    std::vector<tr_cmd*> cmds;
+    std::vector<tr_fence*> submit_fences;
+    std::vector<tr_semaphore*> image_acquired_semaphores;
+    std::vector<tr_semaphore*> render_complete_semaphores;
+    // Transient descriptor sets of each slot, reset by tr_frame_context_begin
+    std::vector<tr_descriptor_pool*> descriptor_pools;
+};
+
+// One submit worth of uploads, identified by its ticket
+struct tr_upload_batch
+{
+    uint64_t ticket;
+    tr_cmd_pool* cmd_pool;
+    tr_cmd* cmd;
+    tr_fence* fence;
+    // Ring offset just past this batch's staging memory, becomes the ring tail once it retires
+    uint64_t staging_end;
+    // Dedicated staging buffers for uploads larger than the ring
+    std::vector<tr_buffer*> oversized_buffers;
+};
+
+// Persistently mapped staging ring and reusable upload batches for one queue. Uploads are
+// sub-allocated from the ring and recorded into the open batch. Submitted batches keep their
+// staging memory until their fence signals, which retires their ticket.
+struct tr_upload_context
+{
+    tr_queue* queue;
+    tr_buffer* staging_buffer;
+    uint64_t staging_head;
+    uint64_t staging_tail;
+    uint32_t batch_depth;
+    // Ticket the open batch will retire with
+    uint64_t next_ticket;
+    uint64_t completed_ticket;
+    tr_upload_batch* open_batch;
+    // Submitted batches, oldest first
+    std::vector<tr_upload_batch*> pending_batches;
+    std::vector<tr_upload_batch*> free_batches;
+};
+
 struct tr_mesh
 {
     tr_renderer* renderer;
@@ -835,15 +1370,39 @@ void tr_destroy_renderer(tr_renderer* p_renderer);
 
 void tr_create_fence(tr_renderer* p_renderer, tr_fence** pp_fence);
 void tr_destroy_fence(tr_renderer* p_renderer, tr_fence* p_fence);
+// Returns true once the GPU has finished the submit that signals the fence
+bool tr_get_fence_status(tr_renderer* p_renderer, tr_fence* p_fence);
+void tr_wait_for_fence(tr_renderer* p_renderer, tr_fence* p_fence);
+void tr_reset_fence(tr_renderer* p_renderer, tr_fence* p_fence);
 
 void tr_create_semaphore(tr_renderer* p_renderer, tr_semaphore** pp_semaphore);
 void tr_destroy_semaphore(tr_renderer* p_renderer, tr_semaphore* p_semaphore);
+// Timeline semaphores hold a monotonically increasing value that queues and the host can signal
+// and wait on. Vulkan requires VK_KHR_timeline_semaphore, they can't be used for presenting.
+void tr_create_timeline_semaphore(tr_renderer* p_renderer, uint64_t initial_value,
+                                  tr_semaphore** pp_semaphore);
+uint64_t tr_get_semaphore_value(tr_renderer* p_renderer, tr_semaphore* p_semaphore);
+void tr_signal_semaphore(tr_renderer* p_renderer, tr_semaphore* p_semaphore, uint64_t value);
+// Blocks until the semaphore's value is at least value
+void tr_wait_for_semaphore(tr_renderer* p_renderer, tr_semaphore* p_semaphore, uint64_t value);
 
 void tr_create_descriptor_set(tr_renderer* p_renderer, uint32_t descriptor_count,
                               const tr_descriptor* descriptors,
                               tr_descriptor_set** pp_descriptor_set);
+// Sets of transient pools can't be destroyed, tr_reset_descriptor_pool frees them
 void tr_destroy_descriptor_set(tr_renderer* p_renderer, tr_descriptor_set* p_descriptor_set);
 
+void tr_create_descriptor_pool(tr_renderer* p_renderer, bool transient, uint32_t sets_per_block,
+                               tr_descriptor_pool** pp_descriptor_pool);
+void tr_destroy_descriptor_pool(tr_renderer* p_renderer, tr_descriptor_pool* p_descriptor_pool);
+// Frees every set of a transient pool, the GPU must be done with them
+void tr_reset_descriptor_pool(tr_renderer* p_renderer, tr_descriptor_pool* p_descriptor_pool);
+void tr_create_descriptor_set_from_pool(tr_renderer* p_renderer,
+                                        tr_descriptor_pool* p_descriptor_pool,
+                                        uint32_t descriptor_count,
+                                        const tr_descriptor* descriptors,
+                                        tr_descriptor_set** pp_descriptor_set);
+
 void tr_create_cmd_pool(tr_renderer* p_renderer, tr_queue* p_queue, bool transient,
                         tr_cmd_pool** pp_cmd_pool);
 void tr_destroy_cmd_pool(tr_renderer* p_renderer, tr_cmd_pool* p_cmd_pool);
@@ -887,7 +1446,11 @@ void tr_create_texture_3d(tr_renderer* p_renderer, uint32_t width, uint32_t heig
                           tr_texture_usage_flags usage, tr_texture** pp_texture);
 void tr_destroy_texture(tr_renderer* p_renderer, tr_texture* p_texture);
 
+// Linear filtering over the whole mip chain with clamp to edge addressing
 void tr_create_sampler(tr_renderer* p_renderer, tr_sampler** pp_sampler);
+// Returns the existing sampler when one was already created from an identical desc
+void tr_create_sampler_from_desc(tr_renderer* p_renderer, const tr_sampler_desc* p_desc,
+                                 tr_sampler** pp_sampler);
 void tr_destroy_sampler(tr_renderer* p_renderer, tr_sampler* p_sampler);
 
 void tr_create_shader_program_n(tr_renderer* p_renderer, uint32_t vert_size, const void* vert_code,
@@ -904,6 +1467,26 @@ void tr_create_shader_program_compute(tr_renderer* p_renderer, uint32_t comp_siz
                                       const void* comp_code, const char* comp_enpt,
                                       tr_shader_program** pp_shader_program);
 void tr_destroy_shader_program(tr_renderer* p_renderer, tr_shader_program* p_shader_program);
+// Adds the bindings, push constant ranges and vertex inputs of one SPIR-V module to
+// p_reflection. tr_create_shader_program_n already does this for Vulkan programs. Bindings with no
+// tr_descriptor_type, such as combined image samplers and acceleration structures, are skipped
+// with a warning. Arrays sized by a spec constant use its default value.
+void tr_reflect_spirv(uint32_t code_size, const void* code, tr_shader_stage shader_stage,
+                      tr_shader_reflection* p_reflection);
+// Creates a descriptor set with every binding of set the program uses, visible only to the
+// stages that use it. Needs a reflected program.
+void tr_create_descriptor_set_from_program(tr_renderer* p_renderer,
+                                           const tr_shader_program* p_shader_program, uint32_t set,
+                                           tr_descriptor_set** pp_descriptor_set);
+// Stages of the program that use set/binding, default_stages when the program isn't reflected or
+// doesn't use the binding.
+tr_shader_stage tr_get_binding_shader_stages(const tr_shader_program* p_shader_program,
+                                             uint32_t set, uint32_t binding,
+                                             tr_shader_stage default_stages);
+// Vertex layout with the vertex shader inputs packed into binding 0 in location order. Needs a
+// reflected program.
+void tr_get_vertex_layout(const tr_shader_program* p_shader_program,
+                          tr_vertex_layout* p_vertex_layout);
 
 void tr_create_pipeline(tr_renderer* p_renderer, tr_shader_program* p_shader_program,
                         const tr_vertex_layout* p_vertex_layout,
@@ -913,7 +1496,30 @@ void tr_create_compute_pipeline(tr_renderer* p_renderer, tr_shader_program* p_sh
                                 tr_descriptor_set* p_descriptor_set,
                                 const tr_pipeline_settings* p_pipeline_settings,
                                 tr_pipeline** pp_pipeline);
+// Pipelines with several descriptor sets, pp_descriptor_sets[i] is set i. Sets that change at
+// different rates (per frame, per material, per draw) can then be bound separately.
+void tr_create_pipeline_n(tr_renderer* p_renderer, tr_shader_program* p_shader_program,
+                          const tr_vertex_layout* p_vertex_layout, uint32_t descriptor_set_count,
+                          tr_descriptor_set** pp_descriptor_sets,
+                          tr_render_target* p_render_target,
+                          const tr_pipeline_settings* p_pipeline_settings,
+                          tr_pipeline** pp_pipeline);
+void tr_create_compute_pipeline_n(tr_renderer* p_renderer, tr_shader_program* p_shader_program,
+                                  uint32_t descriptor_set_count,
+                                  tr_descriptor_set** pp_descriptor_sets,
+                                  const tr_pipeline_settings* p_pipeline_settings,
+                                  tr_pipeline** pp_pipeline);
+// Identical create calls share one pipeline. Every create must be matched by a destroy.
 void tr_destroy_pipeline(tr_renderer* p_renderer, tr_pipeline* p_pipeline);
+// Returns right away and compiles the pipelines on worker threads. Vulkan graphics pipelines of
+// one call are split into one vkCreateGraphicsPipelines batch per worker. A pipeline must not be
+// bound until it is ready. The shader programs, descriptor sets and render targets must stay
+// alive until then, the create infos and vertex layouts are copied before this returns.
+void tr_create_pipelines_async(tr_renderer* p_renderer, uint32_t pipeline_count,
+                               const tr_pipeline_create_info* p_create_infos,
+                               tr_pipeline** pp_pipelines);
+bool tr_is_pipeline_ready(tr_pipeline* p_pipeline);
+void tr_wait_for_pipeline(tr_renderer* p_renderer, tr_pipeline* p_pipeline);
 
 void tr_create_render_target(tr_renderer* p_renderer, uint32_t width, uint32_t height,
                              tr_sample_count sample_count, tr_format color_format,
@@ -924,8 +1530,42 @@ void tr_create_render_target(tr_renderer* p_renderer, uint32_t width, uint32_t h
                              tr_render_target** pp_render_target);
 void tr_destroy_render_target(tr_renderer* p_renderer, tr_render_target* p_render_target);
 
+// Writes the descriptors of p_descriptor_set. On Vulkan only descriptors whose resources changed
+// since the last call are written, so it's cheap to call every frame.
 void tr_update_descriptor_set(tr_renderer* p_renderer, tr_descriptor_set* p_descriptor_set);
 
+// linear allocator
+void tr_create_linear_allocator(tr_renderer* p_renderer, uint64_t frame_size, uint32_t frame_count,
+                                tr_linear_allocator** pp_allocator);
+void tr_destroy_linear_allocator(tr_renderer* p_renderer, tr_linear_allocator* p_allocator);
+// Must only be called once the GPU is done with the frame that last used frame_index
+void tr_linear_allocator_reset(tr_linear_allocator* p_allocator, uint32_t frame_index);
+bool tr_linear_allocator_alloc(tr_linear_allocator* p_allocator, uint64_t size,
+                               tr_linear_allocation* p_allocation);
+
+// frame context
+void tr_create_frame_context(tr_renderer* p_renderer, uint32_t frame_count,
+                             tr_frame_context** pp_frame_context);
+// Waits for every frame still in flight
+void tr_destroy_frame_context(tr_renderer* p_renderer, tr_frame_context* p_frame_context);
+// Moves to the next slot, waits for that slot's previous submit if needed, acquires the next
+// swapchain image and returns the slot's command buffer ready for recording
+tr_cmd* tr_frame_context_begin(tr_frame_context* p_frame_context);
+// Ends the command buffer, submits it with the slot's fence and presents
+void tr_frame_context_end(tr_frame_context* p_frame_context);
+
+// deferred destruction
+// These hold on to the object until every frame that could still reference it has retired, so
+// nothing needs to wait for the queue to go idle first.
+void tr_destroy_buffer_deferred(tr_renderer* p_renderer, tr_buffer* p_buffer);
+void tr_destroy_texture_deferred(tr_renderer* p_renderer, tr_texture* p_texture);
+void tr_destroy_pipeline_deferred(tr_renderer* p_renderer, tr_pipeline* p_pipeline);
+void tr_destroy_descriptor_set_deferred(tr_renderer* p_renderer,
+                                        tr_descriptor_set* p_descriptor_set);
+// Destroys everything deferred up to and including retired_frame_number. tr_frame_context calls
+// this, code that manages its own fences can call it after waiting on a frame.
+void tr_retire_frames(tr_renderer* p_renderer, uint64_t retired_frame_number);
+
 // cmd
 void tr_begin_cmd(tr_cmd* p_cmd);
 void tr_end_cmd(tr_cmd* p_cmd);
@@ -941,6 +1581,24 @@ void tr_cmd_clear_depth_stencil_attachment(tr_cmd* p_cmd, const tr_clear_value*
 void tr_cmd_bind_pipeline(tr_cmd* p_cmd, tr_pipeline* p_pipeline);
 void tr_cmd_bind_descriptor_sets(tr_cmd* p_cmd, tr_pipeline* p_pipeline,
                                  tr_descriptor_set* p_descriptor_set);
+// One offset per dynamic uniform buffer descriptor ordered by binding, added to the descriptor's
+// uniform_buffer_offsets. Offsets must be multiples of minUniformBufferOffsetAlignment (and 256 on
+// D3D12).
+void tr_cmd_bind_descriptor_sets_dynamic(tr_cmd* p_cmd, tr_pipeline* p_pipeline,
+                                         tr_descriptor_set* p_descriptor_set,
+                                         uint32_t dynamic_offset_count,
+                                         const uint32_t* p_dynamic_offsets);
+// Binds pp_descriptor_sets to sets first_set and up. Sets below first_set stay bound as long as
+// the pipelines bound in between were created with the same layouts for them. The dynamic offsets
+// of all sets are concatenated in set order, or none are given to bind them all at 0.
+void tr_cmd_bind_descriptor_sets_n(tr_cmd* p_cmd, tr_pipeline* p_pipeline, uint32_t first_set,
+                                   uint32_t descriptor_set_count,
+                                   tr_descriptor_set** pp_descriptor_sets,
+                                   uint32_t dynamic_offset_count,
+                                   const uint32_t* p_dynamic_offsets);
+// Writes size bytes at offset into the push constants of p_pipeline, both multiples of 4
+void tr_cmd_push_constants(tr_cmd* p_cmd, tr_pipeline* p_pipeline, uint32_t offset, uint32_t size,
+                           const void* p_data);
 void tr_cmd_bind_index_buffer(tr_cmd* p_cmd, tr_buffer* p_buffer);
 void tr_cmd_bind_vertex_buffers(tr_cmd* p_cmd, uint32_t buffer_count, tr_buffer** pp_buffers);
 void tr_cmd_draw(tr_cmd* p_cmd, uint32_t vertex_count, uint32_t first_vertex);
@@ -950,6 +1608,14 @@ void tr_cmd_buffer_transition(tr_cmd* p_cmd, tr_buffer* p_buffer, tr_buffer_usag
                               tr_buffer_usage new_usage);
 void tr_cmd_image_transition(tr_cmd* p_cmd, tr_texture* p_texture, tr_texture_usage old_usage,
                              tr_texture_usage new_usage);
+// Queue ownership transfers. Record the same call into a command buffer for p_src_queue (release)
+// and one for p_dst_queue (acquire), and make the acquiring submit wait on the releasing one.
+void tr_cmd_buffer_transition_queue(tr_cmd* p_cmd, tr_buffer* p_buffer, tr_buffer_usage old_usage,
+                                    tr_buffer_usage new_usage, tr_queue* p_src_queue,
+                                    tr_queue* p_dst_queue);
+void tr_cmd_image_transition_queue(tr_cmd* p_cmd, tr_texture* p_texture,
+                                   tr_texture_usage old_usage, tr_texture_usage new_usage,
+                                   tr_queue* p_src_queue, tr_queue* p_dst_queue);
 void tr_cmd_render_target_transition(tr_cmd* p_cmd, tr_render_target* p_render_target,
                                      tr_texture_usage old_usage, tr_texture_usage new_usage);
 void tr_cmd_depth_stencil_transition(tr_cmd* p_cmd, tr_render_target* p_render_target,
@@ -959,14 +1625,28 @@ void tr_cmd_dispatch(tr_cmd* p_cmd, uint32_t group_count_x, uint32_t group_count
 void tr_cmd_copy_buffer_to_texture2d(tr_cmd* p_cmd, uint32_t width, uint32_t height,
                                      uint32_t row_pitch, uint64_t buffer_offset, uint32_t mip_level,
                                      tr_buffer* p_buffer, tr_texture* p_texture);
+// Fills mips 1 and up of p_texture by repeatedly halving mip 0 with blits. Every mip is expected
+// in tr_texture_usage_sampled_image and is left there. Needs a graphics queue and a format that
+// can be blitted, otherwise it logs a warning and leaves the mips alone. Vulkan only for now.
+void tr_cmd_generate_mipmaps(tr_cmd* p_cmd, tr_texture* p_texture);
 
 void tr_acquire_next_image(tr_renderer* p_renderer, tr_semaphore* p_signal_semaphore,
                            tr_fence* p_fence);
 
 // queue
+// p_fence is optional and signaled once the submitted work completes. A fence can be submitted
+// again once it has been waited on.
 void tr_queue_submit(tr_queue* p_queue, uint32_t cmd_count, tr_cmd** pp_cmds,
                      uint32_t wait_semaphore_count, tr_semaphore** pp_wait_semaphores,
-                     uint32_t signal_semaphore_count, tr_semaphore** pp_signal_semaphores);
+                     uint32_t signal_semaphore_count, tr_semaphore** pp_signal_semaphores,
+                     tr_fence* p_fence);
+// Takes one value per semaphore, the submit waits until each wait semaphore reaches its value and
+// sets each signal semaphore to its value. Values of binary semaphores are ignored.
+void tr_queue_submit_timeline(tr_queue* p_queue, uint32_t cmd_count, tr_cmd** pp_cmds,
+                              uint32_t wait_semaphore_count, tr_semaphore** pp_wait_semaphores,
+                              const uint64_t* p_wait_values, uint32_t signal_semaphore_count,
+                              tr_semaphore** pp_signal_semaphores,
+                              const uint64_t* p_signal_values, tr_fence* p_fence);
 void tr_queue_present(tr_queue* p_queue, uint32_t wait_semaphore_count,
                       tr_semaphore** pp_wait_semaphores);
 void tr_queue_wait_idle(tr_queue* p_queue);
@@ -975,15 +1655,37 @@ void tr_queue_transition_buffer(tr_queue* p_queue, tr_buffer* p_buffer, tr_buffe
                                 tr_buffer_usage new_usage);
 void tr_queue_transition_image(tr_queue* p_queue, tr_texture* p_texture, tr_texture_usage old_usage,
                                tr_texture_usage new_usage);
+// Uploads between begin and end are recorded into one command buffer and submitted together when
+// the outermost batch ends. Uploaded resources must not be used by other submissions until then.
+// tr_queue_end_upload_batch waits for the uploads, tr_queue_end_upload_batch_async returns a
+// ticket instead. Later submits to the same queue see the uploaded data without waiting, other
+// queues and CPU readers must wait for the ticket.
+void tr_queue_begin_upload_batch(tr_queue* p_queue);
+void tr_queue_end_upload_batch(tr_queue* p_queue);
+uint64_t tr_queue_end_upload_batch_async(tr_queue* p_queue);
+bool tr_queue_is_upload_complete(tr_queue* p_queue, uint64_t ticket);
+void tr_queue_wait_upload(tr_queue* p_queue, uint64_t ticket);
 void tr_queue_set_storage_buffer_count(tr_queue* p_queue, uint64_t count_offset, uint32_t count,
                                        tr_buffer* p_buffer);
 void tr_queue_clear_buffer(tr_queue* p_queue, tr_buffer* p_buffer);
 void tr_queue_update_buffer(tr_queue* p_queue, uint64_t size, const void* p_src_data,
                             tr_buffer* p_buffer);
+// A custom resize_fn builds every level on the CPU. With a NULL resize_fn on Vulkan, mip levels
+// past 0 come from tr_cmd_generate_mipmaps when the texture allows it on p_queue and only mip 0
+// is staged, otherwise each level is box filtered from the one before it. Textures in a format
+// tr_image_compress_uint8 handles get their levels compressed on the CPU, see
+// tr_renderer_settings::texture_cache_dir. Other block compressed formats go through
+// tr_queue_update_texture_blocks.
 void tr_queue_update_texture_uint8(tr_queue* p_queue, uint32_t src_width, uint32_t src_height,
                                    uint32_t src_row_stride, const uint8_t* p_src_data,
                                    uint32_t src_channel_count, tr_texture* p_texture,
                                    tr_image_resize_uint8_fn resize_fn, void* p_user_data);
+// Uploads mip levels [0, mip_level_count) as they are. p_src_data holds the levels back to back,
+// each one tightly packed rows of blocks, see tr_util_calc_texture_size. This is the upload path
+// for block compressed formats, uncompressed formats work too as 1x1 blocks.
+void tr_queue_update_texture_blocks(tr_queue* p_queue, uint32_t mip_level_count,
+                                    uint64_t src_size, const void* p_src_data,
+                                    tr_texture* p_texture);
 void tr_queue_update_texture_float(tr_queue* p_queue, uint32_t src_width, uint32_t src_height,
                                    uint32_t src_row_stride, const float* p_src_data,
                                    uint32_t channels, tr_texture* p_texture,
@@ -996,10 +1698,44 @@ void tr_render_target_set_depth_stencil_clear_value(tr_render_target* p_render_t
                                                     uint8_t stencil);
 
 // Utility functions
+void tr_get_memory_stats(tr_renderer* p_renderer, tr_memory_stats* p_stats);
+void tr_get_pipeline_stats(tr_renderer* p_renderer, tr_pipeline_stats* p_stats);
 uint64_t tr_util_calc_storage_counter_offset(uint64_t buffer_size);
 uint32_t tr_util_calc_mip_levels(uint32_t width, uint32_t height);
 uint32_t tr_util_format_stride(tr_format format);
 uint32_t tr_util_format_channel_count(tr_format format);
+bool tr_util_format_is_srgb(tr_format format);
+bool tr_util_format_is_compressed(tr_format format);
+// Texel dimensions and byte size of a format's blocks, uncompressed formats have 1x1 blocks
+uint32_t tr_util_format_block_width(tr_format format);
+uint32_t tr_util_format_block_height(tr_format format);
+uint32_t tr_util_format_block_size(tr_format format);
+// Bytes in mip levels [0, mip_levels) of a 2D image stored as tightly packed rows of blocks
+uint64_t tr_util_calc_texture_size(tr_format format, uint32_t width, uint32_t height,
+                                   uint32_t mip_levels);
+// Whether textures of format can be created with usage on this device. ETC2 and ASTC are
+// mostly found on mobile GPUs, BC on desktop ones.
+bool tr_renderer_supports_format(tr_renderer* p_renderer, tr_format format,
+                                 tr_texture_usage_flags usage);
+// Default tr_image_resize_uint8_fn, nearest neighbor sampling straight from the source
+bool tr_image_resize_uint8_t(uint32_t src_width, uint32_t src_height, uint32_t src_row_stride,
+                             const uint8_t* src_data, uint32_t dst_width, uint32_t dst_height,
+                             uint32_t dst_row_stride, uint8_t* dst_data, uint32_t channel_cout,
+                             void* user_data);
+// Builds the next mip level of an image with a 2x2 box filter, odd sizes round down. sRGB data is
+// averaged in linear space with alpha left linear. Rows are split across thread_count threads, 0
+// uses one per core.
+void tr_image_downsample_uint8(uint32_t src_width, uint32_t src_height, uint32_t src_row_stride,
+                               const uint8_t* src_data, uint32_t dst_row_stride, uint8_t* dst_data,
+                               uint32_t channel_count, bool srgb, uint32_t thread_count);
+// Compresses an RGBA8 image into BC1, BC3, BC4, BC5 or BC7 blocks, written to dst_data as tightly
+// packed rows of blocks. BC4 takes red and BC5 red and green, BC7 uses mode 6 only. Blocks past
+// the right and bottom edges repeat the last column and row. Block rows are split across
+// thread_count threads, 0 uses one per core. Returns false for any other format.
+bool tr_image_compress_uint8(uint32_t width, uint32_t height, uint32_t row_stride,
+                             const uint8_t* src_data, tr_format format,
+                             tr_compression_quality quality, uint32_t thread_count,
+                             uint8_t* dst_data);
 bool tr_vertex_layout_support_format(tr_format format);
 uint32_t tr_vertex_layout_stride(const tr_vertex_layout* p_vertex_layout);
 
@@ -7,6 +7,14 @@
 #define NUM_THREADS_Y       1
 #define NUM_THREADS_Z       1
 
+// The Vulkan path picks the blur radius per pipeline with a specialization constant, so the
+// loops below unroll for each radius. Radii above HALF_KERNEL_SIZE are not supported.
+#if defined(__spirv__)
+[[vk::constant_id(0)]] const int k_half_kernel_size = HALF_KERNEL_SIZE;
+#else
+static const int k_half_kernel_size = HALF_KERNEL_SIZE;
+#endif
+
 static const float k_sample_weights[KERNEL_SIZE] = {
   0.002216,
   0.008764,
@@ -40,7 +48,7 @@ void hblur_main(uint3 gid : SV_GroupID, uint gindex : SV_GroupIndex)
   GroupMemoryBarrierWithGroupSync();
 
   float4 value = 0;
-  for (int i = -HALF_KERNEL_SIZE; i < HALF_KERNEL_SIZE; ++i) {
+  for (int i = -k_half_kernel_size; i < k_half_kernel_size; ++i) {
     int index = gindex + i;
     if (index >= 0 && index < NUM_THREADS_X) {
       value += g_shared_input[index] * k_sample_weights[i + HALF_KERNEL_SIZE];
@@ -61,7 +69,7 @@ void vblur_main(uint3 gid : SV_GroupID, uint gindex : SV_GroupIndex)
   GroupMemoryBarrierWithGroupSync();
 
   float4 value = 0;
-  for (int i = -HALF_KERNEL_SIZE; i < HALF_KERNEL_SIZE; ++i) {
+  for (int i = -k_half_kernel_size; i < k_half_kernel_size; ++i) {
     int index = gindex + i;
     if (index >= 0 && index < NUM_THREADS_X) {
       value += g_shared_input[index] * k_sample_weights[i + HALF_KERNEL_SIZE];
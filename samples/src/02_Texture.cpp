@@ -18,12 +18,12 @@
 
 const char* k_app_name = "02_Texture";
 const uint32_t k_image_count = 3;
+const uint32_t k_frame_count = 2;
 const std::string k_asset_dir = "../samples/assets/";
 
 tr_renderer* m_renderer = nullptr;
 tr_descriptor_set* m_desc_set = nullptr;
-tr_cmd_pool* m_cmd_pool = nullptr;
-tr_cmd** m_cmds = nullptr;
+tr_frame_context* m_frame_context = nullptr;
 tr_shader_program* m_shader = nullptr;
 tr_buffer* m_rect_index_buffer = nullptr;
 tr_buffer* m_rect_vertex_buffer = nullptr;
@@ -76,8 +76,7 @@ void init_tiny_renderer(GLFWwindow* window)
 #endif
     tr_create_renderer(k_app_name, &settings, &m_renderer);
 
-    tr_create_cmd_pool(m_renderer, m_renderer->graphics_queue, false, &m_cmd_pool);
-    tr_create_cmd_n(m_cmd_pool, false, k_image_count, &m_cmds);
+    tr_create_frame_context(m_renderer, k_frame_count, &m_frame_context);
 
 #if defined(TINY_RENDERER_VK)
     // Uses HLSL source
@@ -158,24 +157,19 @@ void init_tiny_renderer(GLFWwindow* window)
     tr_update_descriptor_set(m_renderer, m_desc_set);
 }
 
-void destroy_tiny_renderer() { tr_destroy_renderer(m_renderer); }
+void destroy_tiny_renderer()
+{
+    tr_destroy_frame_context(m_renderer, m_frame_context);
+    tr_destroy_renderer(m_renderer);
+}
 
 void draw_frame()
 {
-    uint32_t frameIdx = s_frame_count % m_renderer->settings.swapchain.image_count;
-
-    tr_fence* image_acquired_fence = m_renderer->image_acquired_fences[frameIdx];
-    tr_semaphore* image_acquired_semaphore = m_renderer->image_acquired_semaphores[frameIdx];
-    tr_semaphore* render_complete_semaphores = m_renderer->render_complete_semaphores[frameIdx];
-
-    tr_acquire_next_image(m_renderer, image_acquired_semaphore, image_acquired_fence);
+    tr_cmd* cmd = tr_frame_context_begin(m_frame_context);
 
     uint32_t swapchain_image_index = m_renderer->swapchain_image_index;
     tr_render_target* render_target = m_renderer->swapchain_render_targets[swapchain_image_index];
 
-    tr_cmd* cmd = m_cmds[frameIdx];
-
-    tr_begin_cmd(cmd);
     tr_cmd_render_target_transition(cmd, render_target, tr_texture_usage_present,
                                     tr_texture_usage_color_attachment);
     tr_cmd_set_viewport(cmd, 0, 0, (float)s_window_width, (float)s_window_height, 0.0f, 1.0f);
@@ -191,13 +185,8 @@ void draw_frame()
     tr_cmd_end_render(cmd);
     tr_cmd_render_target_transition(cmd, render_target, tr_texture_usage_color_attachment,
                                     tr_texture_usage_present);
-    tr_end_cmd(cmd);
-
-    tr_queue_submit(m_renderer->graphics_queue, 1, &cmd, 1, &image_acquired_semaphore, 1,
-                    &render_complete_semaphores);
-    tr_queue_present(m_renderer->present_queue, 1, &render_complete_semaphores);
 
-    tr_queue_wait_idle(m_renderer->graphics_queue);
+    tr_frame_context_end(m_frame_context);
 }
 
 int main(int argc, char** argv)
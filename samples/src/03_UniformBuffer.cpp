@@ -19,19 +19,20 @@
 
 const char* k_app_name = "03_UniformBuffer";
 const uint32_t k_image_count = 3;
+const uint32_t k_frame_count = 2;
 const std::string k_asset_dir = "../samples/assets/";
 
 tr_renderer* m_renderer = nullptr;
-tr_descriptor_set* m_desc_set = nullptr;
-tr_cmd_pool* m_cmd_pool = nullptr;
-tr_cmd** m_cmds = nullptr;
+// One set and uniform buffer per frame in flight, the CPU only writes the current frame's
+tr_descriptor_set* m_desc_sets[k_frame_count] = {};
+tr_frame_context* m_frame_context = nullptr;
 tr_shader_program* m_shader = nullptr;
 tr_buffer* m_rect_index_buffer = nullptr;
 tr_buffer* m_rect_vertex_buffer = nullptr;
 tr_pipeline* m_pipeline = nullptr;
 tr_texture* m_texture = nullptr;
 tr_sampler* m_sampler = nullptr;
-tr_buffer* m_uniform_buffer = nullptr;
+tr_buffer* m_uniform_buffers[k_frame_count] = {};
 
 uint32_t s_window_width;
 uint32_t s_window_height;
@@ -78,8 +79,7 @@ void init_tiny_renderer(GLFWwindow* window)
 #endif
     tr_create_renderer(k_app_name, &settings, &m_renderer);
 
-    tr_create_cmd_pool(m_renderer, m_renderer->graphics_queue, false, &m_cmd_pool);
-    tr_create_cmd_n(m_cmd_pool, false, k_image_count, &m_cmds);
+    tr_create_frame_context(m_renderer, k_frame_count, &m_frame_context);
 
 #if defined(TINY_RENDERER_VK)
     // Uses HLSL source
@@ -106,8 +106,11 @@ void init_tiny_renderer(GLFWwindow* window)
     descriptors[2].count = 1;
     descriptors[2].binding = 2;
     descriptors[2].shader_stages = tr_shader_stage_frag;
-    tr_create_descriptor_set(m_renderer, (uint32_t)descriptors.size(), descriptors.data(),
-                             &m_desc_set);
+    for (uint32_t i = 0; i < k_frame_count; ++i)
+    {
+        tr_create_descriptor_set(m_renderer, (uint32_t)descriptors.size(), descriptors.data(),
+                                 &m_desc_sets[i]);
+    }
 
     tr_vertex_layout vertex_layout = {};
     vertex_layout.attrib_count = 2;
@@ -122,8 +125,14 @@ void init_tiny_renderer(GLFWwindow* window)
     vertex_layout.attribs[1].location = 1;
     vertex_layout.attribs[1].offset = tr_util_format_stride(tr_format_r32g32b32a32_float);
     tr_pipeline_settings pipeline_settings = {tr_primitive_topo_tri_list};
-    tr_create_pipeline(m_renderer, m_shader, &vertex_layout, m_desc_set,
-                       m_renderer->swapchain_render_targets[0], &pipeline_settings, &m_pipeline);
+    // Every slot's set goes through a create, which hands back the same pipeline and gives the
+    // set its D3D12 root parameter indices
+    for (uint32_t i = 0; i < k_frame_count; ++i)
+    {
+        tr_create_pipeline(m_renderer, m_shader, &vertex_layout, m_desc_sets[i],
+                           m_renderer->swapchain_render_targets[0], &pipeline_settings,
+                           &m_pipeline);
+    }
 
     std::vector<float> vertexData = {
         -0.5f, 0.5f,  0.0f, 1.0f, 0.0f, 0.0f, -0.5f, -0.5f, 0.0f, 1.0f, 0.0f, 1.0f,
@@ -159,25 +168,27 @@ void init_tiny_renderer(GLFWwindow* window)
 
     tr_create_sampler(m_renderer, &m_sampler);
 
-    tr_create_uniform_buffer(m_renderer, 16 * sizeof(float), true, &m_uniform_buffer);
+    for (uint32_t i = 0; i < k_frame_count; ++i)
+    {
+        tr_create_uniform_buffer(m_renderer, 16 * sizeof(float), true, &m_uniform_buffers[i]);
 
-    m_desc_set->descriptors[0].uniform_buffers[0] = m_uniform_buffer;
-    m_desc_set->descriptors[1].textures[0] = m_texture;
-    m_desc_set->descriptors[2].samplers[0] = m_sampler;
-    tr_update_descriptor_set(m_renderer, m_desc_set);
+        m_desc_sets[i]->descriptors[0].uniform_buffers[0] = m_uniform_buffers[i];
+        m_desc_sets[i]->descriptors[1].textures[0] = m_texture;
+        m_desc_sets[i]->descriptors[2].samplers[0] = m_sampler;
+        tr_update_descriptor_set(m_renderer, m_desc_sets[i]);
+    }
 }
 
-void destroy_tiny_renderer() { tr_destroy_renderer(m_renderer); }
+void destroy_tiny_renderer()
+{
+    tr_destroy_frame_context(m_renderer, m_frame_context);
+    tr_destroy_renderer(m_renderer);
+}
 
 void draw_frame()
 {
-    uint32_t frameIdx = s_frame_count % m_renderer->settings.swapchain.image_count;
-
-    tr_fence* image_acquired_fence = m_renderer->image_acquired_fences[frameIdx];
-    tr_semaphore* image_acquired_semaphore = m_renderer->image_acquired_semaphores[frameIdx];
-    tr_semaphore* render_complete_semaphores = m_renderer->render_complete_semaphores[frameIdx];
-
-    tr_acquire_next_image(m_renderer, image_acquired_semaphore, image_acquired_fence);
+    tr_cmd* cmd = tr_frame_context_begin(m_frame_context);
+    uint32_t frame_index = m_frame_context->frame_index;
 
     uint32_t swapchain_image_index = m_renderer->swapchain_image_index;
     tr_render_target* render_target = m_renderer->swapchain_render_targets[swapchain_image_index];
@@ -192,11 +203,9 @@ void draw_frame()
     mvp[5] = cos(t);
     mvp[10] = 1.0f;
     mvp[15] = 1.0f;
-    memcpy(m_uniform_buffer->cpu_mapped_address, mvp.data(), mvp.size() * sizeof(float));
-
-    tr_cmd* cmd = m_cmds[frameIdx];
+    memcpy(m_uniform_buffers[frame_index]->cpu_mapped_address, mvp.data(),
+           mvp.size() * sizeof(float));
 
-    tr_begin_cmd(cmd);
     tr_cmd_render_target_transition(cmd, render_target, tr_texture_usage_present,
                                     tr_texture_usage_color_attachment);
     tr_cmd_set_viewport(cmd, 0, 0, (float)s_window_width, (float)s_window_height, 0.0f, 1.0f);
@@ -207,18 +216,13 @@ void draw_frame()
     tr_cmd_bind_pipeline(cmd, m_pipeline);
     tr_cmd_bind_index_buffer(cmd, m_rect_index_buffer);
     tr_cmd_bind_vertex_buffers(cmd, 1, &m_rect_vertex_buffer);
-    tr_cmd_bind_descriptor_sets(cmd, m_pipeline, m_desc_set);
+    tr_cmd_bind_descriptor_sets(cmd, m_pipeline, m_desc_sets[frame_index]);
     tr_cmd_draw_indexed(cmd, 6, 0);
     tr_cmd_end_render(cmd);
     tr_cmd_render_target_transition(cmd, render_target, tr_texture_usage_color_attachment,
                                     tr_texture_usage_present);
-    tr_end_cmd(cmd);
-
-    tr_queue_submit(m_renderer->graphics_queue, 1, &cmd, 1, &image_acquired_semaphore, 1,
-                    &render_complete_semaphores);
-    tr_queue_present(m_renderer->present_queue, 1, &render_complete_semaphores);
 
-    tr_queue_wait_idle(m_renderer->graphics_queue);
+    tr_frame_context_end(m_frame_context);
 }
 
 int main(int argc, char** argv)
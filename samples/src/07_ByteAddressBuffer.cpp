@@ -18,13 +18,13 @@
 
 const char* k_app_name = "07_ByteAddressBuffer";
 const uint32_t k_image_count = 3;
+const uint32_t k_frame_count = 2;
 const std::string k_asset_dir = "../samples/assets/";
 
 tr_renderer* m_renderer = nullptr;
 tr_descriptor_set* m_desc_set = nullptr;
 tr_descriptor_set* m_compute_desc_set = nullptr;
-tr_cmd_pool* m_cmd_pool = nullptr;
-tr_cmd** m_cmds = nullptr;
+tr_frame_context* m_frame_context = nullptr;
 tr_shader_program* m_compute_shader = nullptr;
 tr_shader_program* m_texture_shader = nullptr;
 tr_buffer* m_compute_src_buffer = nullptr;
@@ -85,8 +85,7 @@ void init_tiny_renderer(GLFWwindow* window)
 #endif
     tr_create_renderer(k_app_name, &settings, &m_renderer);
 
-    tr_create_cmd_pool(m_renderer, m_renderer->graphics_queue, false, &m_cmd_pool);
-    tr_create_cmd_n(m_cmd_pool, false, k_image_count, &m_cmds);
+    tr_create_frame_context(m_renderer, k_frame_count, &m_frame_context);
 
 #if defined(TINY_RENDERER_VK)
     auto comp = load_file(k_asset_dir + "byte_address_buffer.cs.spv");
@@ -187,6 +186,8 @@ void init_tiny_renderer(GLFWwindow* window)
     uint64_t struct_stride = 0;
     tr_create_structured_buffer(m_renderer, buffer_size, 0, element_count, struct_stride, true,
                                 &m_compute_src_buffer);
+    // Record all the initial uploads and transitions into a single submit
+    tr_queue_begin_upload_batch(m_renderer->graphics_queue);
     tr_queue_update_buffer(m_renderer->graphics_queue, buffer_size, image_data,
                           m_compute_src_buffer);
     stbi_image_free(image_data);
@@ -207,6 +208,7 @@ void init_tiny_renderer(GLFWwindow* window)
                          &m_texture);
     tr_queue_transition_image(m_renderer->graphics_queue, m_texture, tr_texture_usage_undefined,
                              tr_texture_usage_sampled_image);
+    tr_queue_end_upload_batch(m_renderer->graphics_queue);
 
     tr_create_sampler(m_renderer, &m_sampler);
 
@@ -219,24 +221,19 @@ void init_tiny_renderer(GLFWwindow* window)
     tr_update_descriptor_set(m_renderer, m_compute_desc_set);
 }
 
-void destroy_tiny_renderer() { tr_destroy_renderer(m_renderer); }
+void destroy_tiny_renderer()
+{
+    tr_destroy_frame_context(m_renderer, m_frame_context);
+    tr_destroy_renderer(m_renderer);
+}
 
 void draw_frame()
 {
-    uint32_t frameIdx = s_frame_count % m_renderer->settings.swapchain.image_count;
-
-    tr_fence* image_acquired_fence = m_renderer->image_acquired_fences[frameIdx];
-    tr_semaphore* image_acquired_semaphore = m_renderer->image_acquired_semaphores[frameIdx];
-    tr_semaphore* render_complete_semaphores = m_renderer->render_complete_semaphores[frameIdx];
-
-    tr_acquire_next_image(m_renderer, image_acquired_semaphore, image_acquired_fence);
+    tr_cmd* cmd = tr_frame_context_begin(m_frame_context);
 
     uint32_t swapchain_image_index = m_renderer->swapchain_image_index;
     tr_render_target* render_target = m_renderer->swapchain_render_targets[swapchain_image_index];
 
-    tr_cmd* cmd = m_cmds[frameIdx];
-
-    tr_begin_cmd(cmd);
 
     // Use compute to swizzle RGB -> BRG in buffer
     tr_cmd_buffer_transition(cmd, m_compute_dst_buffer, tr_buffer_usage_transfer_src,
@@ -269,13 +266,8 @@ void draw_frame()
     tr_cmd_end_render(cmd);
     tr_cmd_render_target_transition(cmd, render_target, tr_texture_usage_color_attachment,
                                     tr_texture_usage_present);
-    tr_end_cmd(cmd);
-
-    tr_queue_submit(m_renderer->graphics_queue, 1, &cmd, 1, &image_acquired_semaphore, 1,
-                    &render_complete_semaphores);
-    tr_queue_present(m_renderer->present_queue, 1, &render_complete_semaphores);
 
-    tr_queue_wait_idle(m_renderer->graphics_queue);
+    tr_frame_context_end(m_frame_context);
 }
 
 int main(int argc, char** argv)
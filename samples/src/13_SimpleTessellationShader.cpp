@@ -27,26 +27,27 @@ using float4x4 = glm::mat4;
 
 
 const char*         k_app_name = "13_SimpleTessellationShader";
-const uint32_t      k_image_count = 1;
+const uint32_t      k_image_count = 3;
+const uint32_t      k_frame_count = 2;
 const std::string   k_asset_dir = "../samples/assets/";
 
 tr_renderer*        m_renderer = nullptr;
-tr_cmd_pool*        m_cmd_pool = nullptr;
-tr_cmd**            m_cmds = nullptr;
+tr_frame_context*   m_frame_context = nullptr;
 
 tr_buffer*          m_color_vertex_buffer = nullptr;
 uint32_t            m_color_vertex_count = 0;
 tr_shader_program*  m_color_shader = nullptr;
-tr_descriptor_set*  m_color_desc_set = nullptr;
+// One set and uniform buffer per frame in flight, the CPU only writes the current frame's
+tr_descriptor_set*  m_color_desc_sets[k_frame_count] = {};
 tr_pipeline*        m_color_pipeline = nullptr;
-tr_buffer*          m_color_uniform_buffer = nullptr;
+tr_buffer*          m_color_uniform_buffers[k_frame_count] = {};
 
 tr_buffer*          m_isoline_vertex_buffer = nullptr;
 uint32_t            m_isoline_vertex_count = 0;
 tr_shader_program*  m_isoline_shader = nullptr;
-tr_descriptor_set*  m_isoline_desc_set = nullptr;
+tr_descriptor_set*  m_isoline_desc_sets[k_frame_count] = {};
 tr_pipeline*        m_isoline_pipeline = nullptr;
-tr_buffer*          m_isoline_uniform_buffer = nullptr;
+tr_buffer*          m_isoline_uniform_buffers[k_frame_count] = {};
 
 uint32_t            s_window_width;
 uint32_t            s_window_height;
@@ -95,8 +96,7 @@ void init_tiny_renderer(GLFWwindow* window)
 #endif
     tr_create_renderer(k_app_name, &settings, &m_renderer);
 
-    tr_create_cmd_pool(m_renderer, m_renderer->graphics_queue, false, &m_cmd_pool);
-    tr_create_cmd_n(m_cmd_pool, false, k_image_count, &m_cmds);
+    tr_create_frame_context(m_renderer, k_frame_count, &m_frame_context);
     
 #if defined(TINY_RENDERER_VK)
     auto vert = load_file(k_asset_dir + "simple_tess_color.vs.spv");
@@ -141,8 +141,10 @@ void init_tiny_renderer(GLFWwindow* window)
     descriptors[0].count         = 1;
     descriptors[0].binding       = 0;
     descriptors[0].shader_stages = (tr_shader_stage)(tr_shader_stage_vert | tr_shader_stage_tesc | tr_shader_stage_tese | tr_shader_stage_frag);
-    tr_create_descriptor_set(m_renderer, (uint32_t)descriptors.size(), descriptors.data(), &m_color_desc_set);
-    tr_create_descriptor_set(m_renderer, (uint32_t)descriptors.size(), descriptors.data(), &m_isoline_desc_set);
+    for (uint32_t i = 0; i < k_frame_count; ++i) {
+      tr_create_descriptor_set(m_renderer, (uint32_t)descriptors.size(), descriptors.data(), &m_color_desc_sets[i]);
+      tr_create_descriptor_set(m_renderer, (uint32_t)descriptors.size(), descriptors.data(), &m_isoline_desc_sets[i]);
+    }
 
     tr_vertex_layout vertex_layout = {};
     vertex_layout.attrib_count = 1;
@@ -152,10 +154,16 @@ void init_tiny_renderer(GLFWwindow* window)
     vertex_layout.attribs[0].location = 0;
     vertex_layout.attribs[0].offset   = 0;
     tr_pipeline_settings pipeline_settings = {tr_primitive_topo_line_strip};
-    tr_create_pipeline(m_renderer, m_color_shader, &vertex_layout, m_color_desc_set, m_renderer->swapchain_render_targets[0], &pipeline_settings, &m_color_pipeline);
+    // Every slot's set goes through a create, which hands back the same pipeline and gives the
+    // set its D3D12 root parameter indices
+    for (uint32_t i = 0; i < k_frame_count; ++i) {
+      tr_create_pipeline(m_renderer, m_color_shader, &vertex_layout, m_color_desc_sets[i], m_renderer->swapchain_render_targets[0], &pipeline_settings, &m_color_pipeline);
+    }
 
     pipeline_settings = {tr_primitive_topo_4_point_patch};
-    tr_create_pipeline(m_renderer, m_isoline_shader, &vertex_layout, m_isoline_desc_set, m_renderer->swapchain_render_targets[0], &pipeline_settings, &m_isoline_pipeline);
+    for (uint32_t i = 0; i < k_frame_count; ++i) {
+      tr_create_pipeline(m_renderer, m_isoline_shader, &vertex_layout, m_isoline_desc_sets[i], m_renderer->swapchain_render_targets[0], &pipeline_settings, &m_isoline_pipeline);
+    }
 
 
     float4 positions[13] = {
@@ -280,31 +288,29 @@ void init_tiny_renderer(GLFWwindow* window)
     uint32_t ubo_size = sizeof(float4x4)  // float4x4  model_view_matrix
                       + sizeof(float4x4)  // float4x4  proj_matrix
                       + sizeof(float3);   // float3    color
-    tr_create_uniform_buffer(m_renderer, ubo_size, true, &m_color_uniform_buffer);
+    for (uint32_t i = 0; i < k_frame_count; ++i) {
+      tr_create_uniform_buffer(m_renderer, ubo_size, true, &m_color_uniform_buffers[i]);
 
-    tr_create_uniform_buffer(m_renderer, ubo_size, true, &m_isoline_uniform_buffer);
+      tr_create_uniform_buffer(m_renderer, ubo_size, true, &m_isoline_uniform_buffers[i]);
 
-    m_color_desc_set->descriptors[0].uniform_buffers[0] = m_color_uniform_buffer;
-    tr_update_descriptor_set(m_renderer, m_color_desc_set);
+      m_color_desc_sets[i]->descriptors[0].uniform_buffers[0] = m_color_uniform_buffers[i];
+      tr_update_descriptor_set(m_renderer, m_color_desc_sets[i]);
 
-    m_isoline_desc_set->descriptors[0].uniform_buffers[0] = m_isoline_uniform_buffer;
-    tr_update_descriptor_set(m_renderer, m_isoline_desc_set);
+      m_isoline_desc_sets[i]->descriptors[0].uniform_buffers[0] = m_isoline_uniform_buffers[i];
+      tr_update_descriptor_set(m_renderer, m_isoline_desc_sets[i]);
+    }
 }
 
 void destroy_tiny_renderer()
 {
+    tr_destroy_frame_context(m_renderer, m_frame_context);
     tr_destroy_renderer(m_renderer);
 }
 
 void draw_frame()
 {
-    uint32_t frameIdx = s_frame_count % m_renderer->settings.swapchain.image_count;
-
-    tr_fence* image_acquired_fence = m_renderer->image_acquired_fences[frameIdx];
-    tr_semaphore* image_acquired_semaphore = m_renderer->image_acquired_semaphores[frameIdx];
-    tr_semaphore* render_complete_semaphores = m_renderer->render_complete_semaphores[frameIdx];
-
-    tr_acquire_next_image(m_renderer, image_acquired_semaphore, image_acquired_fence);
+    tr_cmd* cmd = tr_frame_context_begin(m_frame_context);
+    uint32_t frame_index = m_frame_context->frame_index;
 
     uint32_t swapchain_image_index = m_renderer->swapchain_image_index;
     tr_render_target* render_target = m_renderer->swapchain_render_targets[swapchain_image_index];
@@ -327,7 +333,7 @@ void draw_frame()
       // Color pipeline gets MVP stuffed into MV.
       buffer.model_view_matrix = proj * view * model;
       buffer.color = float4(1, 1, 0, 0);
-      memcpy(m_color_uniform_buffer->cpu_mapped_address, &buffer, sizeof(buffer));
+      memcpy(m_color_uniform_buffers[frame_index]->cpu_mapped_address, &buffer, sizeof(buffer));
     }
 
     // Isoline constant buffer
@@ -344,11 +350,9 @@ void draw_frame()
       buffer.model_view_matrix = view * model;
       buffer.proj_matrix = proj;
       buffer.color = float4(1, 1, 0, 0);
-      memcpy(m_isoline_uniform_buffer->cpu_mapped_address, &buffer, sizeof(buffer));
+      memcpy(m_isoline_uniform_buffers[frame_index]->cpu_mapped_address, &buffer, sizeof(buffer));
     }
 
-    tr_cmd* cmd = m_cmds[frameIdx];
-    tr_begin_cmd(cmd);
     tr_cmd_render_target_transition(cmd, render_target, tr_texture_usage_present, tr_texture_usage_color_attachment); 
     tr_cmd_depth_stencil_transition(cmd, render_target, tr_texture_usage_sampled_image, tr_texture_usage_depth_stencil_attachment);
     tr_cmd_set_viewport(cmd, 0, 0, (float)s_window_width, (float)s_window_height, 0.0f, 1.0f);
@@ -366,25 +370,21 @@ void draw_frame()
     {
       tr_cmd_bind_pipeline(cmd, m_color_pipeline);
       tr_cmd_bind_vertex_buffers(cmd, 1, &m_color_vertex_buffer);
-      tr_cmd_bind_descriptor_sets(cmd, m_color_pipeline, m_color_desc_set);
+      tr_cmd_bind_descriptor_sets(cmd, m_color_pipeline, m_color_desc_sets[frame_index]);
       tr_cmd_draw(cmd, m_color_vertex_count, 0);
     }
     // Isoline
     {
       tr_cmd_bind_pipeline(cmd, m_isoline_pipeline);
       tr_cmd_bind_vertex_buffers(cmd, 1, &m_isoline_vertex_buffer);
-      tr_cmd_bind_descriptor_sets(cmd, m_isoline_pipeline, m_isoline_desc_set);
+      tr_cmd_bind_descriptor_sets(cmd, m_isoline_pipeline, m_isoline_desc_sets[frame_index]);
       tr_cmd_draw(cmd, m_isoline_vertex_count, 0);
     }
     tr_cmd_end_render(cmd);
     tr_cmd_render_target_transition(cmd, render_target, tr_texture_usage_color_attachment, tr_texture_usage_present); 
     tr_cmd_depth_stencil_transition(cmd, render_target, tr_texture_usage_depth_stencil_attachment, tr_texture_usage_sampled_image);
-    tr_end_cmd(cmd);
-
-    tr_queue_submit(m_renderer->graphics_queue, 1, &cmd, 1, &image_acquired_semaphore, 1, &render_complete_semaphores);
-    tr_queue_present(m_renderer->present_queue, 1, &render_complete_semaphores);
 
-    tr_queue_wait_idle(m_renderer->graphics_queue);
+    tr_frame_context_end(m_frame_context);
 }
 
 int main(int argc, char **argv)
@@ -18,6 +18,7 @@
 
 const char*         k_app_name = "14_ComputeBloom";
 const uint32_t      k_image_count = 3;
+const uint32_t      k_frame_count = 2;
 const std::string   k_asset_dir = "../samples/assets/";
 
 #define NUM_THREADS_X  1024
@@ -28,8 +29,7 @@ tr_renderer*        g_renderer = nullptr;
 tr_descriptor_set*  g_desc_set = nullptr;
 tr_descriptor_set*  g_compute_desc_set_hblur = nullptr;
 tr_descriptor_set*  g_compute_desc_set_vblur = nullptr;
-tr_cmd_pool*        g_cmd_pool = nullptr;
-tr_cmd**            g_cmds = nullptr;
+tr_frame_context*   g_frame_context = nullptr;
 tr_shader_program*  g_compute_shader_hblur = nullptr;
 tr_shader_program*  g_compute_shader_vblur = nullptr;
 tr_shader_program*  g_texture_shader = nullptr;
@@ -91,10 +91,9 @@ void init_tiny_renderer(GLFWwindow* window)
     tr_create_renderer(k_app_name, &settings, &g_renderer);
   }
 
-  // Command buffer
+  // Command buffers and sync objects for each frame in flight
   {
-    tr_create_cmd_pool(g_renderer, g_renderer->graphics_queue, false, &g_cmd_pool);
-    tr_create_cmd_n(g_cmd_pool, false, k_image_count, &g_cmds);
+    tr_create_frame_context(g_renderer, k_frame_count, &g_frame_context);
   }
   
   // Shaders
@@ -176,6 +175,10 @@ void init_tiny_renderer(GLFWwindow* window)
     tr_create_pipeline(g_renderer, g_texture_shader, &vertex_layout, g_desc_set, g_renderer->swapchain_render_targets[0], &pipeline_settings, &g_pipeline);
 
     pipeline_settings = {};
+    // Blur radius, see k_half_kernel_size in compute_blur.hlsl
+    pipeline_settings.specialization_constant_count = 1;
+    pipeline_settings.specialization_constants[0].constant_id = 0;
+    pipeline_settings.specialization_constants[0].value = 6;
     tr_create_compute_pipeline(g_renderer, g_compute_shader_hblur, g_compute_desc_set_hblur, &pipeline_settings, &g_compute_pipeline_hblur);
     tr_create_compute_pipeline(g_renderer, g_compute_shader_vblur, g_compute_desc_set_vblur, &pipeline_settings, &g_compute_pipeline_vblur);
 
@@ -246,25 +249,17 @@ void init_tiny_renderer(GLFWwindow* window)
 
 void destroy_tiny_renderer()
 {
+    tr_destroy_frame_context(g_renderer, g_frame_context);
     tr_destroy_renderer(g_renderer);
 }
 
 void draw_frame()
 {
-  uint32_t frameIdx = g_frame_count % g_renderer->settings.swapchain.image_count;
-
-  tr_fence* image_acquired_fence = g_renderer->image_acquired_fences[frameIdx];
-  tr_semaphore* image_acquired_semaphore = g_renderer->image_acquired_semaphores[frameIdx];
-  tr_semaphore* render_complete_semaphores = g_renderer->render_complete_semaphores[frameIdx];
-
-  tr_acquire_next_image(g_renderer, image_acquired_semaphore, image_acquired_fence);
+  tr_cmd* cmd = tr_frame_context_begin(g_frame_context);
 
   uint32_t swapchain_image_index = g_renderer->swapchain_image_index;
   tr_render_target* render_target = g_renderer->swapchain_render_targets[swapchain_image_index];
 
-  tr_cmd* cmd = g_cmds[frameIdx];
-
-  tr_begin_cmd(cmd);
   // hblur
   {
     tr_cmd_image_transition(cmd, g_texture_compute_output_hblur, tr_texture_usage_sampled_image, tr_texture_usage_storage_image);
@@ -301,12 +296,8 @@ void draw_frame()
   tr_cmd_draw_indexed(cmd, 6, 0);
   tr_cmd_end_render(cmd);
   tr_cmd_render_target_transition(cmd, render_target, tr_texture_usage_color_attachment, tr_texture_usage_present); 
-  tr_end_cmd(cmd);
-
-  tr_queue_submit(g_renderer->graphics_queue, 1, &cmd, 1, &image_acquired_semaphore, 1, &render_complete_semaphores);
-  tr_queue_present(g_renderer->present_queue, 1, &render_complete_semaphores);
 
-  tr_queue_wait_idle(g_renderer->graphics_queue);
+  tr_frame_context_end(g_frame_context);
 }
 
 int main(int argc, char **argv)
@@ -0,0 +1,101 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "vgfx.h"
+
+// Times building a full mip chain on the CPU for a 4K RGBA image. Resizing every level from the
+// source is what tr_queue_update_texture_uint8 did before, downsampling builds each level from
+// the one before it.
+
+const uint32_t k_width = 4096;
+const uint32_t k_height = 4096;
+const uint32_t k_channel_count = 4;
+const uint32_t k_iteration_count = 10;
+
+typedef void (*build_chain_fn)(const std::vector<uint8_t>& src,
+                               std::vector<std::vector<uint8_t>>& levels, bool srgb,
+                               uint32_t thread_count);
+
+void resize_chain(const std::vector<uint8_t>& src, std::vector<std::vector<uint8_t>>& levels,
+                  bool srgb, uint32_t thread_count)
+{
+    uint32_t width = k_width >> 1;
+    uint32_t height = k_height >> 1;
+    for (size_t i = 1; i < levels.size(); ++i)
+    {
+        tr_image_resize_uint8_t(k_width, k_height, k_width * k_channel_count, src.data(), width,
+                                height, width * k_channel_count, levels[i].data(),
+                                k_channel_count, nullptr);
+        width = width > 1 ? width >> 1 : 1;
+        height = height > 1 ? height >> 1 : 1;
+    }
+}
+
+void downsample_chain(const std::vector<uint8_t>& src, std::vector<std::vector<uint8_t>>& levels,
+                      bool srgb, uint32_t thread_count)
+{
+    uint32_t width = k_width;
+    uint32_t height = k_height;
+    const uint8_t* p_prev = src.data();
+    for (size_t i = 1; i < levels.size(); ++i)
+    {
+        uint32_t dst_width = width > 1 ? width >> 1 : 1;
+        tr_image_downsample_uint8(width, height, width * k_channel_count, p_prev,
+                                  dst_width * k_channel_count, levels[i].data(), k_channel_count,
+                                  srgb, thread_count);
+        p_prev = levels[i].data();
+        width = dst_width;
+        height = height > 1 ? height >> 1 : 1;
+    }
+}
+
+void run(const char* name, build_chain_fn build_chain, const std::vector<uint8_t>& src,
+         std::vector<std::vector<uint8_t>>& levels, bool srgb, uint32_t thread_count)
+{
+    // Warm up caches and the sRGB tables
+    build_chain(src, levels, srgb, thread_count);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0; i < k_iteration_count; ++i)
+    {
+        build_chain(src, levels, srgb, thread_count);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(end - start).count() / k_iteration_count;
+    printf("%-24s %2u thread(s) %8.2f ms\n", name, thread_count, ms);
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<uint8_t> src(k_width * k_height * k_channel_count);
+    uint32_t seed = 1;
+    for (size_t i = 0; i < src.size(); ++i)
+    {
+        seed = seed * 1664525 + 1013904223;
+        src[i] = (uint8_t)(seed >> 24);
+    }
+
+    std::vector<std::vector<uint8_t>> levels;
+    uint32_t width = k_width;
+    uint32_t height = k_height;
+    levels.push_back(std::vector<uint8_t>());
+    while ((width > 1) || (height > 1))
+    {
+        width = width > 1 ? width >> 1 : 1;
+        height = height > 1 ? height >> 1 : 1;
+        levels.push_back(std::vector<uint8_t>(width * height * k_channel_count));
+    }
+
+    uint32_t core_count = std::thread::hardware_concurrency();
+    core_count = core_count > 0 ? core_count : 1;
+    printf("%ux%u RGBA8, %u mip levels\n", k_width, k_height, (uint32_t)levels.size());
+    run("resize from source", resize_chain, src, levels, false, 1);
+    run("downsample linear", downsample_chain, src, levels, false, 1);
+    run("downsample linear", downsample_chain, src, levels, false, core_count);
+    run("downsample sRGB", downsample_chain, src, levels, true, 1);
+    run("downsample sRGB", downsample_chain, src, levels, true, core_count);
+    return EXIT_SUCCESS;
+}
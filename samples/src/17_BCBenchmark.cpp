@@ -0,0 +1,97 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "vgfx.h"
+
+// Measures tr_image_compress_uint8 throughput in MPixel/s for each block format and quality
+// preset, on one thread and on every core.
+
+const uint32_t k_width = 2048;
+const uint32_t k_height = 2048;
+const uint32_t k_channel_count = 4;
+const uint32_t k_iteration_count = 3;
+
+void run(const char* name, tr_format format, tr_compression_quality quality,
+         const std::vector<uint8_t>& src, std::vector<uint8_t>& dst, uint32_t thread_count)
+{
+    static const char* quality_names[] = {"normal", "fast", "high"};
+
+    // Warm up caches and the worker threads
+    bool result = tr_image_compress_uint8(k_width, k_height, k_width * k_channel_count, src.data(),
+                                          format, quality, thread_count, dst.data());
+    if (!result)
+    {
+        printf("%-6s not supported\n", name);
+        return;
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0; i < k_iteration_count; ++i)
+    {
+        tr_image_compress_uint8(k_width, k_height, k_width * k_channel_count, src.data(), format,
+                                quality, thread_count, dst.data());
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count() / k_iteration_count;
+    double mpixels = (double)k_width * k_height / (seconds * 1000000.0);
+    printf("%-6s %-6s %2u thread(s) %8.2f MPixel/s\n", name, quality_names[quality], thread_count,
+           mpixels);
+}
+
+int main(int argc, char** argv)
+{
+    // Smooth gradients with some noise, closer to real textures than pure noise
+    std::vector<uint8_t> src(k_width * k_height * k_channel_count);
+    uint32_t seed = 1;
+    for (uint32_t y = 0; y < k_height; ++y)
+    {
+        for (uint32_t x = 0; x < k_width; ++x)
+        {
+            seed = seed * 1664525 + 1013904223;
+            uint8_t* p = src.data() + (y * k_width + x) * k_channel_count;
+            uint32_t noise = (seed >> 28);
+            p[0] = (uint8_t)(((x * 255) / k_width + noise) & 0xFF);
+            p[1] = (uint8_t)(((y * 255) / k_height + noise) & 0xFF);
+            p[2] = (uint8_t)((((x ^ y) >> 3) + noise) & 0xFF);
+            p[3] = (uint8_t)(255 - ((x + y) * 255) / (k_width + k_height));
+        }
+    }
+    // 16 bytes per 4x4 block is the largest footprint
+    std::vector<uint8_t> dst((k_width / 4) * (k_height / 4) * 16);
+
+    uint32_t core_count = std::thread::hardware_concurrency();
+    core_count = core_count > 0 ? core_count : 1;
+
+    const struct
+    {
+        const char* name;
+        tr_format format;
+    } formats[] = {
+        {"BC1", tr_format_bc1_rgba_unorm},
+        {"BC3", tr_format_bc3_unorm},
+        {"BC5", tr_format_bc5_unorm},
+        {"BC7", tr_format_bc7_unorm},
+    };
+    const tr_compression_quality qualities[] = {
+        tr_compression_quality_fast,
+        tr_compression_quality_normal,
+        tr_compression_quality_high,
+    };
+
+    printf("%ux%u RGBA8\n", k_width, k_height);
+    for (size_t i = 0; i < sizeof(formats) / sizeof(formats[0]); ++i)
+    {
+        for (size_t j = 0; j < sizeof(qualities) / sizeof(qualities[0]); ++j)
+        {
+            run(formats[i].name, formats[i].format, qualities[j], src, dst, 1);
+            if (core_count > 1)
+            {
+                run(formats[i].name, formats[i].format, qualities[j], src, dst, core_count);
+            }
+        }
+    }
+    return EXIT_SUCCESS;
+}
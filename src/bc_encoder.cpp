@@ -0,0 +1,1133 @@
+#include "internal.h"
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+// -------------------------------------------------------------------------------------------------
+// BC block encoders
+// -------------------------------------------------------------------------------------------------
+// Every encoder reads a 4x4 block of RGBA8 pixels stored row after row. Endpoints are fit in the
+// encoded color space, so sRGB formats are encoded the same way as their UNORM counterparts.
+//
+// Quality presets:
+//   fast   - endpoints from the bounding box, indices by projecting onto the endpoint line
+//   normal - endpoints from the principal axis, indices by projection
+//   high   - principal axis, then endpoints refined by least squares against the nearest indices
+
+static const uint32_t k_bc_pixel_count = 16;
+
+// BC7 4 bit index weights
+static const int32_t k_bc7_weights[16] = {0,  4,  9,  13, 17, 21, 26, 30,
+                                          34, 38, 43, 47, 51, 55, 60, 64};
+
+static void tr_internal_bc_load_block(uint32_t width, uint32_t height, uint32_t row_stride,
+                                      const uint8_t* src_data, uint32_t block_x,
+                                      uint32_t block_y, uint8_t* pixels)
+{
+    const uint32_t x0 = 4 * block_x;
+    const uint32_t y0 = 4 * block_y;
+    if ((x0 + 4 <= width) && (y0 + 4 <= height))
+    {
+        for (uint32_t y = 0; y < 4; ++y)
+        {
+            memcpy(pixels + 16 * y, src_data + (size_t)(y0 + y) * row_stride + 4 * x0, 16);
+        }
+        return;
+    }
+    // Blocks hanging over the right or bottom edge repeat the last column or row
+    for (uint32_t y = 0; y < 4; ++y)
+    {
+        const uint8_t* row = src_data + (size_t)tr_min(y0 + y, height - 1) * row_stride;
+        for (uint32_t x = 0; x < 4; ++x)
+        {
+            memcpy(pixels + 16 * y + 4 * x, row + 4 * tr_min(x0 + x, width - 1), 4);
+        }
+    }
+}
+
+// Dot product of every pixel's RGBA with axis, components of axis must fit in 16 bits
+static void tr_internal_bc_project(const uint8_t* pixels, const int32_t* axis, int32_t* dots)
+{
+#if defined(TINY_RENDERER_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i axis16 = _mm_setr_epi16((int16_t)axis[0], (int16_t)axis[1], (int16_t)axis[2],
+                                          (int16_t)axis[3], (int16_t)axis[0], (int16_t)axis[1],
+                                          (int16_t)axis[2], (int16_t)axis[3]);
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        __m128i p = _mm_loadu_si128((const __m128i*)(pixels + 16 * i));
+        // Each pixel becomes two partial sums, r*x + g*y and b*z + a*w
+        __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi8(p, zero), axis16);
+        __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi8(p, zero), axis16);
+        __m128 even = _mm_shuffle_ps(_mm_castsi128_ps(lo), _mm_castsi128_ps(hi),
+                                     _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 odd = _mm_shuffle_ps(_mm_castsi128_ps(lo), _mm_castsi128_ps(hi),
+                                    _MM_SHUFFLE(3, 1, 3, 1));
+        _mm_storeu_si128((__m128i*)(dots + 4 * i),
+                         _mm_add_epi32(_mm_castps_si128(even), _mm_castps_si128(odd)));
+    }
+#else
+    for (uint32_t i = 0; i < k_bc_pixel_count; ++i)
+    {
+        const uint8_t* p = pixels + 4 * i;
+        dots[i] = p[0] * axis[0] + p[1] * axis[1] + p[2] * axis[2] + p[3] * axis[3];
+    }
+#endif
+}
+
+static inline float tr_internal_bc_clamp(float value, float min_value, float max_value)
+{
+    return (value < min_value) ? min_value : ((value > max_value) ? max_value : value);
+}
+
+// Per channel sums, products of every channel pair and bounds over the pixels in pixel_mask
+struct tr_internal_bc_stats
+{
+    int32_t sum[4];
+    int32_t products[4][4];
+    int32_t min_value[4];
+    int32_t max_value[4];
+    uint32_t count;
+};
+
+static void tr_internal_bc_gather_stats(const uint8_t* pixels, uint32_t pixel_mask,
+                                        tr_internal_bc_stats* p_stats)
+{
+#if defined(TINY_RENDERER_SSE2)
+    if (0xFFFF == pixel_mask)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        __m128i min_bytes = _mm_set1_epi8(-1);
+        __m128i max_bytes = zero;
+        __m128i sum = zero;
+        // Products of each channel with itself, the next channel and the one after that
+        __m128i products0 = zero;
+        __m128i products1 = zero;
+        __m128i products2 = zero;
+        for (uint32_t i = 0; i < 4; ++i)
+        {
+            const __m128i p = _mm_loadu_si128((const __m128i*)(pixels + 16 * i));
+            min_bytes = _mm_min_epu8(min_bytes, p);
+            max_bytes = _mm_max_epu8(max_bytes, p);
+            const __m128i lo = _mm_unpacklo_epi8(p, zero);
+            const __m128i hi = _mm_unpackhi_epi8(p, zero);
+            sum = _mm_add_epi16(sum, _mm_add_epi16(lo, hi));
+            // Two pixels per register, rotated one and two channels within each pixel
+            const __m128i lo1 = _mm_shufflehi_epi16(
+                _mm_shufflelo_epi16(lo, _MM_SHUFFLE(0, 3, 2, 1)), _MM_SHUFFLE(0, 3, 2, 1));
+            const __m128i hi1 = _mm_shufflehi_epi16(
+                _mm_shufflelo_epi16(hi, _MM_SHUFFLE(0, 3, 2, 1)), _MM_SHUFFLE(0, 3, 2, 1));
+            const __m128i lo2 = _mm_shuffle_epi32(lo, _MM_SHUFFLE(2, 3, 0, 1));
+            const __m128i hi2 = _mm_shuffle_epi32(hi, _MM_SHUFFLE(2, 3, 0, 1));
+            // 255 * 255 still fits in 16 unsigned bits, the sums are widened to 32
+            const __m128i q0 = _mm_mullo_epi16(lo, lo);
+            const __m128i q1 = _mm_mullo_epi16(lo, lo1);
+            const __m128i q2 = _mm_mullo_epi16(lo, lo2);
+            const __m128i r0 = _mm_mullo_epi16(hi, hi);
+            const __m128i r1 = _mm_mullo_epi16(hi, hi1);
+            const __m128i r2 = _mm_mullo_epi16(hi, hi2);
+            products0 = _mm_add_epi32(
+                products0, _mm_add_epi32(_mm_add_epi32(_mm_unpacklo_epi16(q0, zero),
+                                                       _mm_unpackhi_epi16(q0, zero)),
+                                         _mm_add_epi32(_mm_unpacklo_epi16(r0, zero),
+                                                       _mm_unpackhi_epi16(r0, zero))));
+            products1 = _mm_add_epi32(
+                products1, _mm_add_epi32(_mm_add_epi32(_mm_unpacklo_epi16(q1, zero),
+                                                       _mm_unpackhi_epi16(q1, zero)),
+                                         _mm_add_epi32(_mm_unpacklo_epi16(r1, zero),
+                                                       _mm_unpackhi_epi16(r1, zero))));
+            products2 = _mm_add_epi32(
+                products2, _mm_add_epi32(_mm_add_epi32(_mm_unpacklo_epi16(q2, zero),
+                                                       _mm_unpackhi_epi16(q2, zero)),
+                                         _mm_add_epi32(_mm_unpacklo_epi16(r2, zero),
+                                                       _mm_unpackhi_epi16(r2, zero))));
+        }
+        min_bytes = _mm_min_epu8(min_bytes, _mm_srli_si128(min_bytes, 8));
+        min_bytes = _mm_min_epu8(min_bytes, _mm_srli_si128(min_bytes, 4));
+        max_bytes = _mm_max_epu8(max_bytes, _mm_srli_si128(max_bytes, 8));
+        max_bytes = _mm_max_epu8(max_bytes, _mm_srli_si128(max_bytes, 4));
+        sum = _mm_add_epi16(sum, _mm_srli_si128(sum, 8));
+
+        int16_t sums[8];
+        int32_t lanes[3][4];
+        uint32_t min_packed = (uint32_t)_mm_cvtsi128_si32(min_bytes);
+        uint32_t max_packed = (uint32_t)_mm_cvtsi128_si32(max_bytes);
+        _mm_storeu_si128((__m128i*)sums, sum);
+        _mm_storeu_si128((__m128i*)lanes[0], products0);
+        _mm_storeu_si128((__m128i*)lanes[1], products1);
+        _mm_storeu_si128((__m128i*)lanes[2], products2);
+        for (uint32_t c = 0; c < 4; ++c)
+        {
+            p_stats->sum[c] = sums[c];
+            p_stats->min_value[c] = (min_packed >> (8 * c)) & 0xFF;
+            p_stats->max_value[c] = (max_packed >> (8 * c)) & 0xFF;
+            p_stats->products[c][c] = lanes[0][c];
+            p_stats->products[c][(c + 1) % 4] = lanes[1][c];
+            p_stats->products[(c + 1) % 4][c] = lanes[1][c];
+        }
+        p_stats->products[0][2] = p_stats->products[2][0] = lanes[2][0];
+        p_stats->products[1][3] = p_stats->products[3][1] = lanes[2][1];
+        p_stats->count = k_bc_pixel_count;
+        return;
+    }
+#endif
+    int32_t r_sum = 0, g_sum = 0, b_sum = 0, a_sum = 0;
+    int32_t rr = 0, rg = 0, rb = 0, ra = 0, gg = 0, gb = 0, ga = 0, bb = 0, ba = 0, aa = 0;
+    int32_t min_value[4] = {255, 255, 255, 255};
+    int32_t max_value[4] = {0, 0, 0, 0};
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < k_bc_pixel_count; ++i)
+    {
+        if (0 == (pixel_mask & (1 << i)))
+        {
+            continue;
+        }
+        const uint8_t* p = pixels + 4 * i;
+        const int32_t r = p[0], g = p[1], b = p[2], a = p[3];
+        r_sum += r;
+        g_sum += g;
+        b_sum += b;
+        a_sum += a;
+        rr += r * r;
+        rg += r * g;
+        rb += r * b;
+        ra += r * a;
+        gg += g * g;
+        gb += g * b;
+        ga += g * a;
+        bb += b * b;
+        ba += b * a;
+        aa += a * a;
+        for (uint32_t c = 0; c < 4; ++c)
+        {
+            min_value[c] = (p[c] < min_value[c]) ? p[c] : min_value[c];
+            max_value[c] = (p[c] > max_value[c]) ? p[c] : max_value[c];
+        }
+        ++count;
+    }
+    const int32_t products[4][4] = {
+        {rr, rg, rb, ra}, {rg, gg, gb, ga}, {rb, gb, bb, ba}, {ra, ga, ba, aa}};
+    const int32_t sum[4] = {r_sum, g_sum, b_sum, a_sum};
+    memcpy(p_stats->sum, sum, sizeof(sum));
+    memcpy(p_stats->products, products, sizeof(products));
+    memcpy(p_stats->min_value, min_value, sizeof(min_value));
+    memcpy(p_stats->max_value, max_value, sizeof(max_value));
+    p_stats->count = count;
+}
+
+// Fits a line through the first channel_count channels of the pixels in pixel_mask and returns
+// the two points on it that bound the pixels.
+static void tr_internal_bc_fit_line(const uint8_t* pixels, uint32_t pixel_mask,
+                                    uint32_t channel_count, tr_compression_quality quality,
+                                    float* p_endpoint0, float* p_endpoint1)
+{
+    tr_internal_bc_stats stats;
+    tr_internal_bc_gather_stats(pixels, pixel_mask, &stats);
+    assert(stats.count > 0);
+    const int32_t* min_value = stats.min_value;
+    const int32_t* max_value = stats.max_value;
+
+    float mean[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    float covariance[4][4] = {};
+    const float inv_count = 1.0f / (float)stats.count;
+    for (uint32_t r = 0; r < channel_count; ++r)
+    {
+        mean[r] = (float)stats.sum[r] * inv_count;
+        for (uint32_t c = 0; c < channel_count; ++c)
+        {
+            covariance[r][c] = (float)stats.products[r][c] -
+                               (float)stats.sum[r] * (float)stats.sum[c] * inv_count;
+        }
+    }
+
+    // Start from the bounding box diagonal, flipping channels that run against the widest one
+    uint32_t widest = 0;
+    for (uint32_t c = 1; c < channel_count; ++c)
+    {
+        if ((max_value[c] - min_value[c]) > (max_value[widest] - min_value[widest]))
+        {
+            widest = c;
+        }
+    }
+    float axis[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    for (uint32_t c = 0; c < channel_count; ++c)
+    {
+        axis[c] = (float)(max_value[c] - min_value[c]);
+        if (covariance[widest][c] < 0.0f)
+        {
+            axis[c] = -axis[c];
+        }
+    }
+    // Power iteration converges on the principal axis
+    if (tr_compression_quality_fast != quality)
+    {
+        for (uint32_t iteration = 0; iteration < 8; ++iteration)
+        {
+            float next[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+            float length = 0.0f;
+            for (uint32_t r = 0; r < channel_count; ++r)
+            {
+                for (uint32_t c = 0; c < channel_count; ++c)
+                {
+                    next[r] += covariance[r][c] * axis[c];
+                }
+                const float magnitude = fabsf(next[r]);
+                length = (magnitude > length) ? magnitude : length;
+            }
+            if (length < 1e-6f)
+            {
+                break;
+            }
+            for (uint32_t c = 0; c < channel_count; ++c)
+            {
+                axis[c] = next[c] / length;
+            }
+        }
+    }
+
+    float axis_length = 0.0f;
+    for (uint32_t c = 0; c < channel_count; ++c)
+    {
+        const float magnitude = fabsf(axis[c]);
+        axis_length = (magnitude > axis_length) ? magnitude : axis_length;
+    }
+    if (axis_length < 1e-6f)
+    {
+        // Flat block
+        for (uint32_t c = 0; c < channel_count; ++c)
+        {
+            p_endpoint0[c] = mean[c];
+            p_endpoint1[c] = mean[c];
+        }
+        return;
+    }
+
+    // Scale the axis into 9 bits so the projections can run in 16 bit lanes
+    int32_t int_axis[4] = {0, 0, 0, 0};
+    float axis_dot_axis = 0.0f;
+    float mean_dot = 0.0f;
+    for (uint32_t c = 0; c < channel_count; ++c)
+    {
+        int_axis[c] = (int32_t)lrintf(axis[c] * 255.0f / axis_length);
+        axis_dot_axis += (float)(int_axis[c] * int_axis[c]);
+        mean_dot += mean[c] * (float)int_axis[c];
+    }
+    int32_t dots[k_bc_pixel_count];
+    tr_internal_bc_project(pixels, int_axis, dots);
+    int32_t min_dot = INT32_MAX;
+    int32_t max_dot = INT32_MIN;
+    for (uint32_t i = 0; i < k_bc_pixel_count; ++i)
+    {
+        if (pixel_mask & (1 << i))
+        {
+            min_dot = (dots[i] < min_dot) ? dots[i] : min_dot;
+            max_dot = (dots[i] > max_dot) ? dots[i] : max_dot;
+        }
+    }
+
+    const float t0 = ((float)min_dot - mean_dot) / axis_dot_axis;
+    const float t1 = ((float)max_dot - mean_dot) / axis_dot_axis;
+    for (uint32_t c = 0; c < channel_count; ++c)
+    {
+        p_endpoint0[c] = tr_internal_bc_clamp(mean[c] + t0 * (float)int_axis[c], 0.0f, 255.0f);
+        p_endpoint1[c] = tr_internal_bc_clamp(mean[c] + t1 * (float)int_axis[c], 0.0f, 255.0f);
+    }
+}
+
+// Least squares endpoints for pixels in pixel_mask given each pixel's weight along the line.
+// Returns false when the weights don't pin down two endpoints.
+static bool tr_internal_bc_refine_endpoints(const uint8_t* pixels, uint32_t pixel_mask,
+                                            uint32_t channel_count, const float* weights,
+                                            float* p_endpoint0, float* p_endpoint1)
+{
+    float alpha2 = 0.0f;
+    float beta2 = 0.0f;
+    float alpha_beta = 0.0f;
+    float alpha_x[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    float beta_x[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    for (uint32_t i = 0; i < k_bc_pixel_count; ++i)
+    {
+        if (0 == (pixel_mask & (1 << i)))
+        {
+            continue;
+        }
+        const float beta = weights[i];
+        const float alpha = 1.0f - beta;
+        alpha2 += alpha * alpha;
+        beta2 += beta * beta;
+        alpha_beta += alpha * beta;
+        for (uint32_t c = 0; c < channel_count; ++c)
+        {
+            alpha_x[c] += alpha * (float)pixels[4 * i + c];
+            beta_x[c] += beta * (float)pixels[4 * i + c];
+        }
+    }
+    const float det = alpha2 * beta2 - alpha_beta * alpha_beta;
+    if (fabsf(det) < 1e-6f)
+    {
+        return false;
+    }
+    const float inv_det = 1.0f / det;
+    for (uint32_t c = 0; c < channel_count; ++c)
+    {
+        float e0 = (alpha_x[c] * beta2 - beta_x[c] * alpha_beta) * inv_det;
+        float e1 = (beta_x[c] * alpha2 - alpha_x[c] * alpha_beta) * inv_det;
+        p_endpoint0[c] = tr_internal_bc_clamp(e0, 0.0f, 255.0f);
+        p_endpoint1[c] = tr_internal_bc_clamp(e1, 0.0f, 255.0f);
+    }
+    return true;
+}
+
+static inline uint32_t tr_internal_bc_distance(const uint8_t* a, const int32_t* b,
+                                               uint32_t channel_count)
+{
+    uint32_t result = 0;
+    for (uint32_t c = 0; c < channel_count; ++c)
+    {
+        int32_t d = (int32_t)a[c] - b[c];
+        result += (uint32_t)(d * d);
+    }
+    return result;
+}
+
+// Index of the palette entry nearest to every pixel in pixel_mask, returns the total error
+static uint32_t tr_internal_bc_nearest_indices(const uint8_t* pixels, uint32_t pixel_mask,
+                                               uint32_t channel_count, const int32_t* palette,
+                                               uint32_t palette_count, uint32_t* indices)
+{
+    uint32_t total_error = 0;
+    for (uint32_t i = 0; i < k_bc_pixel_count; ++i)
+    {
+        if (0 == (pixel_mask & (1 << i)))
+        {
+            continue;
+        }
+        uint32_t best_error = UINT32_MAX;
+        for (uint32_t p = 0; p < palette_count; ++p)
+        {
+            uint32_t error =
+                tr_internal_bc_distance(pixels + 4 * i, palette + 4 * p, channel_count);
+            if (error < best_error)
+            {
+                best_error = error;
+                indices[i] = p;
+            }
+        }
+        total_error += best_error;
+    }
+    return total_error;
+}
+
+// Position of every pixel in pixel_mask along the line from palette entry 0 to 1, rounded to
+// one of step_count steps. Fills steps with 0 when the two entries are the same.
+static void tr_internal_bc_project_steps(const uint8_t* pixels, uint32_t pixel_mask,
+                                         const int32_t* color0, const int32_t* color1,
+                                         int32_t step_count, uint32_t* steps)
+{
+    int32_t axis[4] = {color1[0] - color0[0], color1[1] - color0[1], color1[2] - color0[2],
+                       color1[3] - color0[3]};
+    const int32_t dot0 = color0[0] * axis[0] + color0[1] * axis[1] + color0[2] * axis[2] +
+                         color0[3] * axis[3];
+    const int32_t dot1 = color1[0] * axis[0] + color1[1] * axis[1] + color1[2] * axis[2] +
+                         color1[3] * axis[3];
+    const int32_t range = dot1 - dot0;
+    if (range <= 0)
+    {
+        memset(steps, 0, k_bc_pixel_count * sizeof(*steps));
+        return;
+    }
+    int32_t dots[k_bc_pixel_count];
+    tr_internal_bc_project(pixels, axis, dots);
+    const float scale = (float)(step_count - 1) / (float)range;
+    const float max_step = (float)(step_count - 1);
+    for (uint32_t i = 0; i < k_bc_pixel_count; ++i)
+    {
+        float step = tr_internal_bc_clamp((float)(dots[i] - dot0) * scale + 0.5f, 0.0f, max_step);
+        steps[i] = (pixel_mask & (1 << i)) ? (uint32_t)step : 0;
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+// BC1 color block, also the color half of BC3
+// -------------------------------------------------------------------------------------------------
+static inline uint32_t tr_internal_bc1_pack_565(const float* color)
+{
+    uint32_t r = (uint32_t)(color[0] * (31.0f / 255.0f) + 0.5f);
+    uint32_t g = (uint32_t)(color[1] * (63.0f / 255.0f) + 0.5f);
+    uint32_t b = (uint32_t)(color[2] * (31.0f / 255.0f) + 0.5f);
+    return (r << 11) | (g << 5) | b;
+}
+
+static inline void tr_internal_bc1_unpack_565(uint32_t packed, int32_t* color)
+{
+    uint32_t r = (packed >> 11) & 0x1F;
+    uint32_t g = (packed >> 5) & 0x3F;
+    uint32_t b = packed & 0x1F;
+    color[0] = (int32_t)((r << 3) | (r >> 2));
+    color[1] = (int32_t)((g << 2) | (g >> 4));
+    color[2] = (int32_t)((b << 3) | (b >> 2));
+    color[3] = 0;
+}
+
+static void tr_internal_bc1_write(uint32_t color0, uint32_t color1, const uint32_t* indices,
+                                  uint8_t* dst)
+{
+    uint32_t bits = 0;
+    for (uint32_t i = 0; i < k_bc_pixel_count; ++i)
+    {
+        bits |= indices[i] << (2 * i);
+    }
+    dst[0] = (uint8_t)(color0 & 0xFF);
+    dst[1] = (uint8_t)(color0 >> 8);
+    dst[2] = (uint8_t)(color1 & 0xFF);
+    dst[3] = (uint8_t)(color1 >> 8);
+    dst[4] = (uint8_t)(bits & 0xFF);
+    dst[5] = (uint8_t)((bits >> 8) & 0xFF);
+    dst[6] = (uint8_t)((bits >> 16) & 0xFF);
+    dst[7] = (uint8_t)(bits >> 24);
+}
+
+// Indices for a pair of packed endpoints in 4 color mode, or 3 color mode when transparent_mask
+// is non zero. Returns the error when quality is high, 0 otherwise.
+static uint32_t tr_internal_bc1_select_indices(const uint8_t* pixels, uint32_t transparent_mask,
+                                               uint32_t color0, uint32_t color1,
+                                               tr_compression_quality quality, uint32_t* indices)
+{
+    const uint32_t opaque_mask = 0xFFFF & ~transparent_mask;
+    const bool four_colors = (0 == transparent_mask);
+    int32_t palette[4][4];
+    tr_internal_bc1_unpack_565(color0, palette[0]);
+    tr_internal_bc1_unpack_565(color1, palette[1]);
+    for (uint32_t c = 0; c < 3; ++c)
+    {
+        if (four_colors)
+        {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+        else
+        {
+            palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+            palette[3][c] = 0;
+        }
+    }
+    palette[2][3] = 0;
+    palette[3][3] = 0;
+
+    uint32_t error = 0;
+    if (tr_compression_quality_high == quality)
+    {
+        error = tr_internal_bc_nearest_indices(pixels, opaque_mask, 3, &palette[0][0],
+                                               four_colors ? 4 : 3, indices);
+    }
+    else
+    {
+        // Steps along the line from color 0 to color 1 mapped to palette order
+        static const uint32_t k_four_color_order[4] = {0, 2, 3, 1};
+        static const uint32_t k_three_color_order[3] = {0, 2, 1};
+        // Palette alpha is 0 so the projection ignores the pixels' alpha
+        tr_internal_bc_project_steps(pixels, opaque_mask, palette[0], palette[1],
+                                     four_colors ? 4 : 3, indices);
+        for (uint32_t i = 0; i < k_bc_pixel_count; ++i)
+        {
+            indices[i] = four_colors ? k_four_color_order[indices[i]]
+                                     : k_three_color_order[indices[i]];
+        }
+    }
+    for (uint32_t i = 0; i < k_bc_pixel_count; ++i)
+    {
+        if (transparent_mask & (1 << i))
+        {
+            indices[i] = 3;
+        }
+    }
+    return error;
+}
+
+// Puts the endpoints in the order the mode needs, swapping indices to match
+static void tr_internal_bc1_order_endpoints(bool four_colors, uint32_t* p_color0,
+                                            uint32_t* p_color1, uint32_t* indices)
+{
+    // 4 color blocks need color0 > color1, 3 color blocks color0 <= color1
+    const bool swap = four_colors ? (*p_color0 < *p_color1) : (*p_color0 > *p_color1);
+    if (swap)
+    {
+        uint32_t color = *p_color0;
+        *p_color0 = *p_color1;
+        *p_color1 = color;
+        for (uint32_t i = 0; i < k_bc_pixel_count; ++i)
+        {
+            if (indices[i] < 2 || four_colors)
+            {
+                indices[i] ^= 1;
+            }
+        }
+    }
+}
+
+static void tr_internal_bc1_encode_block(const uint8_t* pixels, bool punch_through_alpha,
+                                         tr_compression_quality quality, uint8_t* dst)
+{
+    uint32_t transparent_mask = 0;
+    if (punch_through_alpha)
+    {
+        for (uint32_t i = 0; i < k_bc_pixel_count; ++i)
+        {
+            transparent_mask |= (pixels[4 * i + 3] < 128) ? (1 << i) : 0;
+        }
+    }
+    const uint32_t opaque_mask = 0xFFFF & ~transparent_mask;
+    if (0 == opaque_mask)
+    {
+        const uint32_t indices[k_bc_pixel_count] = {3, 3, 3, 3, 3, 3, 3, 3,
+                                                    3, 3, 3, 3, 3, 3, 3, 3};
+        tr_internal_bc1_write(0, 0, indices, dst);
+        return;
+    }
+    const bool four_colors = (0 == transparent_mask);
+
+    float endpoint0[4];
+    float endpoint1[4];
+    tr_internal_bc_fit_line(pixels, opaque_mask, 3, quality, endpoint0, endpoint1);
+    if (four_colors && (tr_compression_quality_high != quality))
+    {
+        // Pull the endpoints in a little, the line ends are rarely hit exactly
+        for (uint32_t c = 0; c < 3; ++c)
+        {
+            float inset = (endpoint1[c] - endpoint0[c]) / 16.0f;
+            endpoint0[c] += inset;
+            endpoint1[c] -= inset;
+        }
+    }
+
+    uint32_t color0 = tr_internal_bc1_pack_565(endpoint0);
+    uint32_t color1 = tr_internal_bc1_pack_565(endpoint1);
+    uint32_t indices[k_bc_pixel_count];
+    uint32_t error = tr_internal_bc1_select_indices(pixels, transparent_mask, color0, color1,
+                                                    quality, indices);
+    if (four_colors && (tr_compression_quality_high == quality))
+    {
+        // The inset line from the faster presets is sometimes the better start
+        float inset0[4];
+        float inset1[4];
+        for (uint32_t c = 0; c < 3; ++c)
+        {
+            float inset = (endpoint1[c] - endpoint0[c]) / 16.0f;
+            inset0[c] = endpoint0[c] + inset;
+            inset1[c] = endpoint1[c] - inset;
+        }
+        uint32_t inset_color0 = tr_internal_bc1_pack_565(inset0);
+        uint32_t inset_color1 = tr_internal_bc1_pack_565(inset1);
+        uint32_t inset_indices[k_bc_pixel_count];
+        uint32_t inset_error = tr_internal_bc1_select_indices(
+            pixels, transparent_mask, inset_color0, inset_color1, quality, inset_indices);
+        if (inset_error < error)
+        {
+            color0 = inset_color0;
+            color1 = inset_color1;
+            memcpy(indices, inset_indices, sizeof(indices));
+            error = inset_error;
+        }
+    }
+    if (tr_compression_quality_high == quality)
+    {
+        static const float k_four_color_weights[4] = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+        static const float k_three_color_weights[4] = {0.0f, 1.0f, 0.5f, 0.0f};
+        for (uint32_t iteration = 0; (iteration < 2) && (error > 0); ++iteration)
+        {
+            float weights[k_bc_pixel_count];
+            for (uint32_t i = 0; i < k_bc_pixel_count; ++i)
+            {
+                weights[i] = four_colors ? k_four_color_weights[indices[i]]
+                                         : k_three_color_weights[indices[i]];
+            }
+            if (!tr_internal_bc_refine_endpoints(pixels, opaque_mask, 3, weights, endpoint0,
+                                                 endpoint1))
+            {
+                break;
+            }
+            uint32_t refined_color0 = tr_internal_bc1_pack_565(endpoint0);
+            uint32_t refined_color1 = tr_internal_bc1_pack_565(endpoint1);
+            uint32_t refined_indices[k_bc_pixel_count];
+            uint32_t refined_error =
+                tr_internal_bc1_select_indices(pixels, transparent_mask, refined_color0,
+                                               refined_color1, quality, refined_indices);
+            if (refined_error >= error)
+            {
+                break;
+            }
+            color0 = refined_color0;
+            color1 = refined_color1;
+            memcpy(indices, refined_indices, sizeof(indices));
+            error = refined_error;
+        }
+    }
+
+    if (four_colors && (color0 == color1))
+    {
+        // Equal endpoints read as 3 color mode, index 0 is still color0 there
+        for (uint32_t i = 0; i < k_bc_pixel_count; ++i)
+        {
+            indices[i] = 0;
+        }
+    }
+    else
+    {
+        tr_internal_bc1_order_endpoints(four_colors, &color0, &color1, indices);
+    }
+    tr_internal_bc1_write(color0, color1, indices, dst);
+}
+
+// -------------------------------------------------------------------------------------------------
+// BC4 single channel block, also the alpha half of BC3 and both halves of BC5
+// -------------------------------------------------------------------------------------------------
+static void tr_internal_bc4_palette(uint32_t value0, uint32_t value1, int32_t* palette)
+{
+    palette[0] = (int32_t)value0;
+    palette[1] = (int32_t)value1;
+    if (value0 > value1)
+    {
+        for (uint32_t i = 1; i < 7; ++i)
+        {
+            palette[1 + i] = (int32_t)(((7 - i) * value0 + i * value1 + 3) / 7);
+        }
+    }
+    else
+    {
+        for (uint32_t i = 1; i < 5; ++i)
+        {
+            palette[1 + i] = (int32_t)(((5 - i) * value0 + i * value1 + 2) / 5);
+        }
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+}
+
+static uint32_t tr_internal_bc4_nearest(const uint8_t* values, const int32_t* palette,
+                                        uint32_t* indices)
+{
+    uint32_t total_error = 0;
+    for (uint32_t i = 0; i < k_bc_pixel_count; ++i)
+    {
+        uint32_t best_error = UINT32_MAX;
+        for (uint32_t p = 0; p < 8; ++p)
+        {
+            int32_t d = (int32_t)values[i] - palette[p];
+            uint32_t error = (uint32_t)(d * d);
+            if (error < best_error)
+            {
+                best_error = error;
+                indices[i] = p;
+            }
+        }
+        total_error += best_error;
+    }
+    return total_error;
+}
+
+static void tr_internal_bc4_write(uint32_t value0, uint32_t value1, const uint32_t* indices,
+                                  uint8_t* dst)
+{
+    uint64_t bits = 0;
+    for (uint32_t i = 0; i < k_bc_pixel_count; ++i)
+    {
+        bits |= (uint64_t)indices[i] << (3 * i);
+    }
+    dst[0] = (uint8_t)value0;
+    dst[1] = (uint8_t)value1;
+    for (uint32_t i = 0; i < 6; ++i)
+    {
+        dst[2 + i] = (uint8_t)((bits >> (8 * i)) & 0xFF);
+    }
+}
+
+static void tr_internal_bc4_encode_block(const uint8_t* pixels, uint32_t channel,
+                                         tr_compression_quality quality, uint8_t* dst)
+{
+    uint8_t values[k_bc_pixel_count];
+    uint32_t min_value = 255;
+    uint32_t max_value = 0;
+    for (uint32_t i = 0; i < k_bc_pixel_count; ++i)
+    {
+        values[i] = pixels[4 * i + channel];
+        min_value = tr_min(min_value, values[i]);
+        max_value = tr_max(max_value, values[i]);
+    }
+
+    uint32_t indices[k_bc_pixel_count] = {};
+    if (min_value == max_value)
+    {
+        tr_internal_bc4_write(max_value, min_value, indices, dst);
+        return;
+    }
+
+    // 8 value mode with the block's range as endpoints
+    if (tr_compression_quality_high != quality)
+    {
+        // Steps from min to max map to indices 1, 7, 6, ..., 2, 0
+        const float scale = 7.0f / (float)(max_value - min_value);
+        for (uint32_t i = 0; i < k_bc_pixel_count; ++i)
+        {
+            uint32_t step = (uint32_t)((float)(values[i] - min_value) * scale + 0.5f);
+            indices[i] = (7 == step) ? 0 : ((0 == step) ? 1 : 8 - step);
+        }
+        tr_internal_bc4_write(max_value, min_value, indices, dst);
+        return;
+    }
+
+    int32_t palette[8];
+    tr_internal_bc4_palette(max_value, min_value, palette);
+    uint32_t error = tr_internal_bc4_nearest(values, palette, indices);
+    uint32_t value0 = max_value;
+    uint32_t value1 = min_value;
+
+    // 6 value mode has exact 0 and 255, which helps blocks that mix extremes with a narrow range
+    uint32_t inner_min = 255;
+    uint32_t inner_max = 0;
+    for (uint32_t i = 0; i < k_bc_pixel_count; ++i)
+    {
+        if ((values[i] > 0) && (values[i] < 255))
+        {
+            inner_min = tr_min(inner_min, values[i]);
+            inner_max = tr_max(inner_max, values[i]);
+        }
+    }
+    if ((error > 0) && (inner_min <= inner_max))
+    {
+        uint32_t six_indices[k_bc_pixel_count];
+        tr_internal_bc4_palette(inner_min, inner_max, palette);
+        uint32_t six_error = tr_internal_bc4_nearest(values, palette, six_indices);
+        if (six_error < error)
+        {
+            error = six_error;
+            value0 = inner_min;
+            value1 = inner_max;
+            memcpy(indices, six_indices, sizeof(indices));
+        }
+    }
+    tr_internal_bc4_write(value0, value1, indices, dst);
+}
+
+// -------------------------------------------------------------------------------------------------
+// BC7, mode 6 only: one subset, RGBA endpoints with 7 bits and a p-bit, 4 bit indices
+// -------------------------------------------------------------------------------------------------
+struct tr_internal_bc7_endpoints
+{
+    // 7 bit values, the p-bit becomes the low bit of each channel when decoded
+    uint32_t values[2][4];
+    uint32_t p_bits[2];
+};
+
+static void tr_internal_bc7_quantize(const float* endpoint, uint32_t p_bit, uint32_t* values)
+{
+    for (uint32_t c = 0; c < 4; ++c)
+    {
+        int32_t value = (int32_t)((endpoint[c] - (float)p_bit) * 0.5f + 0.5f);
+        values[c] = (uint32_t)((value < 0) ? 0 : ((value > 127) ? 127 : value));
+    }
+}
+
+// Picks the p-bit that keeps the decoded endpoint closest
+static void tr_internal_bc7_quantize_best(const float* endpoint, uint32_t* values,
+                                          uint32_t* p_p_bit)
+{
+    float best_error = 0.0f;
+    for (uint32_t p_bit = 0; p_bit < 2; ++p_bit)
+    {
+        uint32_t candidate[4];
+        tr_internal_bc7_quantize(endpoint, p_bit, candidate);
+        float error = 0.0f;
+        for (uint32_t c = 0; c < 4; ++c)
+        {
+            float d = (float)((candidate[c] << 1) | p_bit) - endpoint[c];
+            error += d * d;
+        }
+        if ((0 == p_bit) || (error < best_error))
+        {
+            best_error = error;
+            memcpy(values, candidate, sizeof(candidate));
+            *p_p_bit = p_bit;
+        }
+    }
+}
+
+static uint32_t tr_internal_bc7_select_indices(const uint8_t* pixels,
+                                               const tr_internal_bc7_endpoints& endpoints,
+                                               tr_compression_quality quality,
+                                               uint32_t* indices)
+{
+    int32_t palette[16][4];
+    int32_t color[2][4];
+    for (uint32_t e = 0; e < 2; ++e)
+    {
+        for (uint32_t c = 0; c < 4; ++c)
+        {
+            color[e][c] = (int32_t)((endpoints.values[e][c] << 1) | endpoints.p_bits[e]);
+        }
+    }
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        for (uint32_t c = 0; c < 4; ++c)
+        {
+            palette[i][c] = ((64 - k_bc7_weights[i]) * color[0][c] +
+                             k_bc7_weights[i] * color[1][c] + 32) >> 6;
+        }
+    }
+
+    if (tr_compression_quality_high == quality)
+    {
+        return tr_internal_bc_nearest_indices(pixels, 0xFFFF, 4, &palette[0][0], 16, indices);
+    }
+    // The weights are close enough to even steps to round to
+    tr_internal_bc_project_steps(pixels, 0xFFFF, color[0], color[1], 16, indices);
+    return 0;
+}
+
+static void tr_internal_bc7_write(const tr_internal_bc7_endpoints& endpoints,
+                                  const uint32_t* indices, uint8_t* dst)
+{
+    uint64_t bits[2] = {0, 0};
+    uint32_t offset = 0;
+    auto write_bits = [&bits, &offset](uint64_t value, uint32_t count) {
+        bits[offset / 64] |= value << (offset % 64);
+        if ((offset % 64) + count > 64)
+        {
+            bits[1] |= value >> (64 - (offset % 64));
+        }
+        offset += count;
+    };
+
+    // Mode 6 is six 0 bits and a 1
+    write_bits(1 << 6, 7);
+    for (uint32_t c = 0; c < 4; ++c)
+    {
+        write_bits(endpoints.values[0][c], 7);
+        write_bits(endpoints.values[1][c], 7);
+    }
+    write_bits(endpoints.p_bits[0], 1);
+    write_bits(endpoints.p_bits[1], 1);
+    // The anchor index drops its high bit, which is always 0
+    write_bits(indices[0], 3);
+    for (uint32_t i = 1; i < k_bc_pixel_count; ++i)
+    {
+        write_bits(indices[i], 4);
+    }
+    assert(128 == offset);
+
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        dst[i] = (uint8_t)((bits[i / 8] >> (8 * (i % 8))) & 0xFF);
+    }
+}
+
+static void tr_internal_bc7_encode_block(const uint8_t* pixels, tr_compression_quality quality,
+                                         uint8_t* dst)
+{
+    float endpoint0[4];
+    float endpoint1[4];
+    tr_internal_bc_fit_line(pixels, 0xFFFF, 4, quality, endpoint0, endpoint1);
+
+    tr_internal_bc7_endpoints endpoints = {};
+    tr_internal_bc7_quantize_best(endpoint0, endpoints.values[0], &endpoints.p_bits[0]);
+    tr_internal_bc7_quantize_best(endpoint1, endpoints.values[1], &endpoints.p_bits[1]);
+    uint32_t indices[k_bc_pixel_count];
+    uint32_t error = tr_internal_bc7_select_indices(pixels, endpoints, quality, indices);
+
+    if (tr_compression_quality_high == quality)
+    {
+        for (uint32_t iteration = 0; (iteration < 2) && (error > 0); ++iteration)
+        {
+            float weights[k_bc_pixel_count];
+            for (uint32_t i = 0; i < k_bc_pixel_count; ++i)
+            {
+                weights[i] = (float)k_bc7_weights[indices[i]] / 64.0f;
+            }
+            if (!tr_internal_bc_refine_endpoints(pixels, 0xFFFF, 4, weights, endpoint0,
+                                                 endpoint1))
+            {
+                break;
+            }
+            // Try every p-bit pair, the best one isn't always the closest per endpoint
+            bool improved = false;
+            for (uint32_t p_bits = 0; p_bits < 4; ++p_bits)
+            {
+                tr_internal_bc7_endpoints candidate = {};
+                candidate.p_bits[0] = p_bits & 1;
+                candidate.p_bits[1] = p_bits >> 1;
+                tr_internal_bc7_quantize(endpoint0, candidate.p_bits[0], candidate.values[0]);
+                tr_internal_bc7_quantize(endpoint1, candidate.p_bits[1], candidate.values[1]);
+                uint32_t candidate_indices[k_bc_pixel_count];
+                uint32_t candidate_error =
+                    tr_internal_bc7_select_indices(pixels, candidate, quality, candidate_indices);
+                if (candidate_error < error)
+                {
+                    endpoints = candidate;
+                    memcpy(indices, candidate_indices, sizeof(indices));
+                    error = candidate_error;
+                    improved = true;
+                }
+            }
+            if (!improved)
+            {
+                break;
+            }
+        }
+    }
+
+    // Index 0 is stored without its high bit, flip the line so it's clear
+    if (indices[0] & 8)
+    {
+        for (uint32_t c = 0; c < 4; ++c)
+        {
+            uint32_t value = endpoints.values[0][c];
+            endpoints.values[0][c] = endpoints.values[1][c];
+            endpoints.values[1][c] = value;
+        }
+        uint32_t p_bit = endpoints.p_bits[0];
+        endpoints.p_bits[0] = endpoints.p_bits[1];
+        endpoints.p_bits[1] = p_bit;
+        for (uint32_t i = 0; i < k_bc_pixel_count; ++i)
+        {
+            indices[i] = 15 - indices[i];
+        }
+    }
+    tr_internal_bc7_write(endpoints, indices, dst);
+}
+
+// -------------------------------------------------------------------------------------------------
+// Image compression
+// -------------------------------------------------------------------------------------------------
+static void tr_internal_compress_rows_uint8(uint32_t width, uint32_t height, uint32_t row_stride,
+                                            const uint8_t* src_data, tr_format format,
+                                            tr_compression_quality quality, uint32_t first_row,
+                                            uint32_t last_row, uint8_t* dst_data)
+{
+    const uint32_t blocks_x = (width + 3) / 4;
+    const uint32_t block_size = tr_util_format_block_size(format);
+    uint8_t pixels[64];
+    for (uint32_t block_y = first_row; block_y < last_row; ++block_y)
+    {
+        uint8_t* dst = dst_data + (size_t)block_y * blocks_x * block_size;
+        for (uint32_t block_x = 0; block_x < blocks_x; ++block_x, dst += block_size)
+        {
+            tr_internal_bc_load_block(width, height, row_stride, src_data, block_x, block_y,
+                                      pixels);
+            switch (format)
+            {
+            case tr_format_bc1_rgba_unorm:
+            case tr_format_bc1_rgba_srgb:
+                tr_internal_bc1_encode_block(pixels, true, quality, dst);
+                break;
+            case tr_format_bc3_unorm:
+            case tr_format_bc3_srgb:
+                tr_internal_bc4_encode_block(pixels, 3, quality, dst);
+                tr_internal_bc1_encode_block(pixels, false, quality, dst + 8);
+                break;
+            case tr_format_bc4_unorm:
+                tr_internal_bc4_encode_block(pixels, 0, quality, dst);
+                break;
+            case tr_format_bc5_unorm:
+                tr_internal_bc4_encode_block(pixels, 0, quality, dst);
+                tr_internal_bc4_encode_block(pixels, 1, quality, dst + 8);
+                break;
+            case tr_format_bc7_unorm:
+            case tr_format_bc7_srgb:
+                tr_internal_bc7_encode_block(pixels, quality, dst);
+                break;
+            default:
+                break;
+            }
+        }
+    }
+}
+
+bool tr_internal_can_compress(tr_format format)
+{
+    switch (format)
+    {
+    case tr_format_bc1_rgba_unorm:
+    case tr_format_bc1_rgba_srgb:
+    case tr_format_bc3_unorm:
+    case tr_format_bc3_srgb:
+    case tr_format_bc4_unorm:
+    case tr_format_bc5_unorm:
+    case tr_format_bc7_unorm:
+    case tr_format_bc7_srgb:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool tr_image_compress_uint8(uint32_t width, uint32_t height, uint32_t row_stride,
+                             const uint8_t* src_data, tr_format format,
+                             tr_compression_quality quality, uint32_t thread_count,
+                             uint8_t* dst_data)
+{
+    assert((width > 0) && (height > 0));
+    assert(NULL != src_data);
+    assert(NULL != dst_data);
+
+    if (!tr_internal_can_compress(format))
+    {
+        return false;
+    }
+
+    const uint32_t blocks_x = (width + 3) / 4;
+    const uint32_t blocks_y = (height + 3) / 4;
+    if (0 == thread_count)
+    {
+        thread_count = tr_max(std::thread::hardware_concurrency(), 1);
+    }
+    // Not worth waking threads for small images
+    const uint32_t min_rows_per_thread = tr_max(4096 / blocks_x, 1);
+    thread_count = tr_min(thread_count, tr_max(blocks_y / min_rows_per_thread, 1));
+
+    const uint32_t rows_per_thread = (blocks_y + thread_count - 1) / thread_count;
+    std::vector<std::thread> threads;
+    threads.reserve(thread_count - 1);
+    for (uint32_t i = 1; i < thread_count; ++i)
+    {
+        uint32_t first_row = i * rows_per_thread;
+        uint32_t last_row = tr_min(first_row + rows_per_thread, blocks_y);
+        if (first_row < last_row)
+        {
+            threads.push_back(std::thread(tr_internal_compress_rows_uint8, width, height,
+                                          row_stride, src_data, format, quality, first_row,
+                                          last_row, dst_data));
+        }
+    }
+    tr_internal_compress_rows_uint8(width, height, row_stride, src_data, format, quality, 0,
+                                    tr_min(rows_per_thread, blocks_y), dst_data);
+    for (size_t i = 0; i < threads.size(); ++i)
+    {
+        threads[i].join();
+    }
+    return true;
+}
+
+bool tr_internal_compress_uint8(tr_renderer* p_renderer, uint32_t width, uint32_t height,
+                                uint32_t row_stride, const uint8_t* src_data, tr_format format,
+                                tr_compression_quality quality, uint8_t* dst_data)
+{
+    assert((width > 0) && (height > 0));
+    assert(NULL != src_data);
+    assert(NULL != dst_data);
+
+    if (!tr_internal_can_compress(format))
+    {
+        return false;
+    }
+
+    const uint32_t blocks_x = (width + 3) / 4;
+    const uint32_t blocks_y = (height + 3) / 4;
+    // Same minimum range as the thread split above
+    const uint32_t min_rows = tr_max(4096 / blocks_x, 1);
+    tr_internal_parallel_for(p_renderer, blocks_y, min_rows, [=](uint32_t first, uint32_t last) {
+        tr_internal_compress_rows_uint8(width, height, row_stride, src_data, format, quality,
+                                        first, last, dst_data);
+    });
+    return true;
+}
@@ -84,6 +84,117 @@ D3D12_RESOURCE_STATES tr_util_to_dx_resource_state_texture(tr_texture_usage_flag
 // -------------------------------------------------------------------------------------------------
 // Internal init functions
 // -------------------------------------------------------------------------------------------------
+static void tr_internal_dx_create_queue(tr_renderer* p_renderer, D3D12_COMMAND_LIST_TYPE type,
+                                        tr_queue* p_queue)
+{
+    assert(NULL != p_renderer->dx_device);
+
+    D3D12_COMMAND_QUEUE_DESC desc = {};
+    desc.Type = type;
+    desc.Priority = D3D12_COMMAND_QUEUE_PRIORITY_NORMAL;
+    HRESULT hres =
+        p_renderer->dx_device->CreateCommandQueue(&desc, IID_PPV_ARGS(&p_queue->dx_queue));
+    assert(SUCCEEDED(hres));
+
+    p_queue->dx_cmd_list_type = type;
+
+    // Create fence
+    hres = p_renderer->dx_device->CreateFence(0, D3D12_FENCE_FLAG_NONE,
+                                              IID_PPV_ARGS(&p_queue->dx_wait_idle_fence));
+    assert(SUCCEEDED(hres));
+    p_queue->dx_wait_idle_fence_value = 1;
+
+    p_queue->dx_wait_idle_fence_event = CreateEvent(NULL, FALSE, FALSE, NULL);
+    assert(NULL != p_queue->dx_wait_idle_fence_event);
+}
+
+static void tr_internal_dx_create_descriptor_heap(tr_renderer* p_renderer,
+                                                  D3D12_DESCRIPTOR_HEAP_TYPE type,
+                                                  uint32_t capacity,
+                                                  tr_dx_descriptor_heap* p_heap)
+{
+    D3D12_DESCRIPTOR_HEAP_DESC desc = {};
+    desc.Type = type;
+    desc.NumDescriptors = capacity;
+    desc.NodeMask = 0;
+    desc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+    HRESULT hres =
+        p_renderer->dx_device->CreateDescriptorHeap(&desc, IID_PPV_ARGS(&p_heap->dx_heap));
+    assert(SUCCEEDED(hres));
+
+    p_heap->capacity = capacity;
+    tr_dx_descriptor_range range = {0, capacity};
+    p_heap->free_ranges.push_back(range);
+}
+
+// First fit, sets are long lived and mostly the same few sizes
+static void tr_internal_dx_allocate_descriptors(tr_dx_descriptor_heap* p_heap, uint32_t count,
+                                                tr_dx_descriptor_range* p_range)
+{
+    p_range->offset = 0;
+    p_range->count = 0;
+    if (0 == count)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(p_heap->mutex);
+    for (size_t i = 0; i < p_heap->free_ranges.size(); ++i)
+    {
+        tr_dx_descriptor_range* free_range = &(p_heap->free_ranges[i]);
+        if (free_range->count < count)
+        {
+            continue;
+        }
+
+        p_range->offset = free_range->offset;
+        p_range->count = count;
+        free_range->offset += count;
+        free_range->count -= count;
+        if (0 == free_range->count)
+        {
+            p_heap->free_ranges.erase(p_heap->free_ranges.begin() + i);
+        }
+        return;
+    }
+    assert(false && "Shared descriptor heap is full");
+}
+
+static void tr_internal_dx_free_descriptors(tr_dx_descriptor_heap* p_heap,
+                                            tr_dx_descriptor_range* p_range)
+{
+    if (0 == p_range->count)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(p_heap->mutex);
+    std::vector<tr_dx_descriptor_range>& free_ranges = p_heap->free_ranges;
+    size_t index = 0;
+    while ((index < free_ranges.size()) && (free_ranges[index].offset < p_range->offset))
+    {
+        ++index;
+    }
+    free_ranges.insert(free_ranges.begin() + index, *p_range);
+
+    // Merge with the next range and then with the previous one
+    if ((index + 1 < free_ranges.size()) &&
+        (free_ranges[index].offset + free_ranges[index].count == free_ranges[index + 1].offset))
+    {
+        free_ranges[index].count += free_ranges[index + 1].count;
+        free_ranges.erase(free_ranges.begin() + index + 1);
+    }
+    if ((index > 0) &&
+        (free_ranges[index - 1].offset + free_ranges[index - 1].count == free_ranges[index].offset))
+    {
+        free_ranges[index - 1].count += free_ranges[index].count;
+        free_ranges.erase(free_ranges.begin() + index);
+    }
+
+    p_range->offset = 0;
+    p_range->count = 0;
+}
+
 void tr_internal_dx_create_device(tr_renderer* p_renderer)
 {
 #if defined(_DEBUG)
@@ -240,28 +351,29 @@ void tr_internal_dx_create_device(tr_renderer* p_renderer)
 
     p_renderer->settings.dx_feature_level = target_feature_level;
 
-    // Queues
-    {
-        D3D12_COMMAND_QUEUE_DESC desc = {};
-        desc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
-        desc.Priority = D3D12_COMMAND_QUEUE_PRIORITY_NORMAL;
-        hres = p_renderer->dx_device->CreateCommandQueue(
-            &desc, IID_PPV_ARGS(&p_renderer->graphics_queue->dx_queue));
-        assert(SUCCEEDED(hres));
-    }
-
-    // Create fence
-    {
-        hres = p_renderer->dx_device->CreateFence(
-            0, D3D12_FENCE_FLAG_NONE,
-            IID_PPV_ARGS(&p_renderer->graphics_queue->dx_wait_idle_fence));
-        assert(SUCCEEDED(hres));
-        p_renderer->graphics_queue->dx_wait_idle_fence_value = 1;
-
-        p_renderer->graphics_queue->dx_wait_idle_fence_event =
-            CreateEvent(NULL, FALSE, FALSE, NULL);
-        assert(NULL != p_renderer->graphics_queue->dx_wait_idle_fence_event);
-    }
+    // Queues, D3D12 always has copy and compute queues so those are created as well
+    tr_internal_dx_create_queue(p_renderer, D3D12_COMMAND_LIST_TYPE_DIRECT,
+                                p_renderer->graphics_queue);
+
+    p_renderer->transfer_queue = new tr_queue();
+    assert(NULL != p_renderer->transfer_queue);
+    p_renderer->transfer_queue->renderer = p_renderer;
+    tr_internal_dx_create_queue(p_renderer, D3D12_COMMAND_LIST_TYPE_COPY,
+                                p_renderer->transfer_queue);
+
+    p_renderer->compute_queue = new tr_queue();
+    assert(NULL != p_renderer->compute_queue);
+    p_renderer->compute_queue->renderer = p_renderer;
+    tr_internal_dx_create_queue(p_renderer, D3D12_COMMAND_LIST_TYPE_COMPUTE,
+                                p_renderer->compute_queue);
+
+    // Shared shader visible heaps for the descriptor sets
+    tr_internal_dx_create_descriptor_heap(p_renderer, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV,
+                                          tr_dx_cbvsrvuav_heap_size,
+                                          &(p_renderer->dx_cbvsrvuav_heap));
+    tr_internal_dx_create_descriptor_heap(p_renderer, D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER,
+                                          tr_dx_sampler_heap_size,
+                                          &(p_renderer->dx_sampler_heap));
 }
 
 void tr_internal_dx_create_swapchain(tr_renderer* p_renderer)
@@ -366,13 +478,57 @@ void tr_internal_dx_destroy_swapchain(tr_renderer* p_renderer) {}
 // -------------------------------------------------------------------------------------------------
 // Internal create functions
 // -------------------------------------------------------------------------------------------------
-void tr_internal_dx_create_fence(tr_renderer* p_renderer, tr_fence* p_fence) {}
+void tr_internal_dx_create_fence(tr_renderer* p_renderer, tr_fence* p_fence)
+{
+    assert(NULL != p_renderer->dx_device);
 
-void tr_internal_dx_destroy_fence(tr_renderer* p_renderer, tr_fence* p_fence) {}
+    HRESULT hres = p_renderer->dx_device->CreateFence(0, D3D12_FENCE_FLAG_NONE,
+                                                      IID_PPV_ARGS(&p_fence->dx_fence));
+    assert(SUCCEEDED(hres));
 
-void tr_internal_dx_create_semaphore(tr_renderer* p_renderer, tr_semaphore* p_semaphore) {}
+    p_fence->dx_fence_value = 0;
+    p_fence->dx_fence_event = CreateEvent(NULL, FALSE, FALSE, NULL);
+    assert(NULL != p_fence->dx_fence_event);
+}
+
+void tr_internal_dx_destroy_fence(tr_renderer* p_renderer, tr_fence* p_fence)
+{
+    assert(NULL != p_fence->dx_fence_event);
 
-void tr_internal_dx_destroy_semaphore(tr_renderer* p_renderer, tr_semaphore* p_semaphore) {}
+    CloseHandle(p_fence->dx_fence_event);
+}
+
+void tr_internal_dx_create_semaphore(tr_renderer* p_renderer, tr_semaphore* p_semaphore)
+{
+    assert(NULL != p_renderer->dx_device);
+
+    HRESULT hres = p_renderer->dx_device->CreateFence(0, D3D12_FENCE_FLAG_NONE,
+                                                      IID_PPV_ARGS(&p_semaphore->dx_fence));
+    assert(SUCCEEDED(hres));
+
+    p_semaphore->dx_fence_value = 0;
+}
+
+void tr_internal_dx_destroy_semaphore(tr_renderer* p_renderer, tr_semaphore* p_semaphore)
+{
+    if (NULL != p_semaphore->dx_fence_event)
+    {
+        CloseHandle(p_semaphore->dx_fence_event);
+    }
+}
+
+void tr_internal_dx_create_timeline_semaphore(tr_renderer* p_renderer, uint64_t initial_value,
+                                             tr_semaphore* p_semaphore)
+{
+    assert(NULL != p_renderer->dx_device);
+
+    HRESULT hres = p_renderer->dx_device->CreateFence(initial_value, D3D12_FENCE_FLAG_NONE,
+                                                      IID_PPV_ARGS(&p_semaphore->dx_fence));
+    assert(SUCCEEDED(hres));
+
+    p_semaphore->dx_fence_event = CreateEvent(NULL, FALSE, FALSE, NULL);
+    assert(NULL != p_semaphore->dx_fence_event);
+}
 
 void tr_internal_dx_create_descriptor_set(tr_renderer* p_renderer,
                                           tr_descriptor_set* p_descriptor_set)
@@ -414,33 +570,14 @@ void tr_internal_dx_create_descriptor_set(tr_renderer* p_renderer,
         }
     }
 
-    if (cbvsrvuav_count > 0)
-    {
-        D3D12_DESCRIPTOR_HEAP_DESC desc = {};
-        desc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-        desc.NumDescriptors = cbvsrvuav_count;
-        desc.NodeMask = 0;
-        desc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
-        HRESULT hres = p_renderer->dx_device->CreateDescriptorHeap(
-            &desc, IID_PPV_ARGS(&p_descriptor_set->dx_cbvsrvuav_heap));
-        assert(SUCCEEDED(hres));
-    }
-
-    if (sampler_count > 0)
-    {
-        D3D12_DESCRIPTOR_HEAP_DESC desc = {};
-        desc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER;
-        desc.NumDescriptors = sampler_count;
-        desc.NodeMask = 0;
-        desc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
-        HRESULT hres = p_renderer->dx_device->CreateDescriptorHeap(
-            &desc, IID_PPV_ARGS(&p_descriptor_set->dx_sampler_heap));
-        assert(SUCCEEDED(hres));
-    }
+    tr_internal_dx_allocate_descriptors(&(p_renderer->dx_cbvsrvuav_heap), cbvsrvuav_count,
+                                        &(p_descriptor_set->dx_cbvsrvuav_range));
+    tr_internal_dx_allocate_descriptors(&(p_renderer->dx_sampler_heap), sampler_count,
+                                        &(p_descriptor_set->dx_sampler_range));
 
     // Assign heap offsets
-    uint32_t cbvsrvuav_heap_offset = 0;
-    uint32_t sampler_heap_offset = 0;
+    uint32_t cbvsrvuav_heap_offset = p_descriptor_set->dx_cbvsrvuav_range.offset;
+    uint32_t sampler_heap_offset = p_descriptor_set->dx_sampler_range.offset;
     for (uint32_t i = 0; i < p_descriptor_set->descriptor_count; ++i)
     {
         tr_descriptor* descriptor = &(p_descriptor_set->descriptors[i]);
@@ -465,6 +602,24 @@ void tr_internal_dx_create_descriptor_set(tr_renderer* p_renderer,
             cbvsrvuav_heap_offset += descriptor->count;
         }
         break;
+
+        case tr_descriptor_type_uniform_buffer_dynamic_cbv:
+        {
+            // Dynamic uniform buffers are root CBVs and don't live in the heap. Their offsets
+            // are ordered by binding to match Vulkan.
+            assert(1 == descriptor->count);
+            descriptor->dx_dynamic_offset_index = 0;
+            for (uint32_t j = 0; j < p_descriptor_set->descriptor_count; ++j)
+            {
+                const tr_descriptor* other = &(p_descriptor_set->descriptors[j]);
+                if ((tr_descriptor_type_uniform_buffer_dynamic_cbv == other->type) &&
+                    (other->binding < descriptor->binding))
+                {
+                    descriptor->dx_dynamic_offset_index += other->count;
+                }
+            }
+        }
+        break;
         }
     }
 }
@@ -472,6 +627,10 @@ void tr_internal_dx_create_descriptor_set(tr_renderer* p_renderer,
 void tr_internal_dx_destroy_descriptor_set(tr_renderer* p_renderer,
                                            tr_descriptor_set* p_descriptor_set)
 {
+    tr_internal_dx_free_descriptors(&(p_renderer->dx_cbvsrvuav_heap),
+                                    &(p_descriptor_set->dx_cbvsrvuav_range));
+    tr_internal_dx_free_descriptors(&(p_renderer->dx_sampler_heap),
+                                    &(p_descriptor_set->dx_sampler_range));
 }
 
 void tr_internal_dx_create_cmd_pool(tr_renderer* p_renderer, tr_queue* p_queue, bool transient,
@@ -480,7 +639,7 @@ void tr_internal_dx_create_cmd_pool(tr_renderer* p_renderer, tr_queue* p_queue,
     assert(NULL != p_renderer->dx_device);
 
     HRESULT hres = p_renderer->dx_device->CreateCommandAllocator(
-        D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&p_cmd_pool->dx_cmd_alloc));
+        p_queue->dx_cmd_list_type, IID_PPV_ARGS(&p_cmd_pool->dx_cmd_alloc));
     assert(SUCCEEDED(hres));
 }
 
@@ -490,10 +649,11 @@ void tr_internal_dx_create_cmd(tr_cmd_pool* p_cmd_pool, bool secondary, tr_cmd*
 {
     assert(NULL != p_cmd_pool->dx_cmd_alloc);
     assert(NULL != p_cmd_pool->renderer);
+    assert(NULL != p_cmd_pool->queue);
 
     ID3D12PipelineState* initialState = NULL;
     HRESULT hres = p_cmd_pool->renderer->dx_device->CreateCommandList(
-        0, D3D12_COMMAND_LIST_TYPE_DIRECT, p_cmd_pool->dx_cmd_alloc, initialState,
+        0, p_cmd_pool->queue->dx_cmd_list_type, p_cmd_pool->dx_cmd_alloc, initialState,
         IID_PPV_ARGS(&p_cmd->dx_cmd_list));
     assert(SUCCEEDED(hres));
 
@@ -844,23 +1004,131 @@ void tr_internal_dx_create_texture(tr_renderer* p_renderer, tr_texture* p_textur
 
 void tr_internal_dx_destroy_texture(tr_renderer* p_renderer, tr_texture* p_texture) {}
 
+bool tr_internal_dx_supports_format(tr_renderer* p_renderer, tr_format format,
+                                    tr_texture_usage_flags usage)
+{
+    D3D12_FEATURE_DATA_FORMAT_SUPPORT format_support = {};
+    format_support.Format = tr_util_to_dx_format(format);
+    if (DXGI_FORMAT_UNKNOWN == format_support.Format)
+    {
+        return false;
+    }
+    HRESULT hres = p_renderer->dx_device->CheckFeatureSupport(
+        D3D12_FEATURE_FORMAT_SUPPORT, &format_support, sizeof(format_support));
+    if (FAILED(hres))
+    {
+        return false;
+    }
+
+    UINT required = D3D12_FORMAT_SUPPORT1_TEXTURE2D;
+    if (usage & tr_texture_usage_sampled_image)
+    {
+        required |= D3D12_FORMAT_SUPPORT1_SHADER_SAMPLE;
+    }
+    if (usage & tr_texture_usage_storage_image)
+    {
+        required |= D3D12_FORMAT_SUPPORT1_TYPED_UNORDERED_ACCESS_VIEW;
+    }
+    if (usage & tr_texture_usage_color_attachment)
+    {
+        required |= D3D12_FORMAT_SUPPORT1_RENDER_TARGET;
+    }
+    if (usage & tr_texture_usage_depth_stencil_attachment)
+    {
+        required |= D3D12_FORMAT_SUPPORT1_DEPTH_STENCIL;
+    }
+    return required == (format_support.Support1 & required);
+}
+
+static D3D12_TEXTURE_ADDRESS_MODE tr_internal_dx_to_address_mode(tr_address_mode address_mode)
+{
+    switch (address_mode)
+    {
+    case tr_address_mode_repeat:
+        return D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+    case tr_address_mode_mirrored_repeat:
+        return D3D12_TEXTURE_ADDRESS_MODE_MIRROR;
+    case tr_address_mode_clamp_to_edge:
+        return D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+    case tr_address_mode_clamp_to_border:
+        return D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+    }
+    return D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+}
+
+static D3D12_COMPARISON_FUNC tr_internal_dx_to_comparison_func(tr_compare_op compare_op)
+{
+    switch (compare_op)
+    {
+    case tr_compare_op_never:
+        return D3D12_COMPARISON_FUNC_NEVER;
+    case tr_compare_op_less:
+        return D3D12_COMPARISON_FUNC_LESS;
+    case tr_compare_op_equal:
+        return D3D12_COMPARISON_FUNC_EQUAL;
+    case tr_compare_op_less_or_equal:
+        return D3D12_COMPARISON_FUNC_LESS_EQUAL;
+    case tr_compare_op_greater:
+        return D3D12_COMPARISON_FUNC_GREATER;
+    case tr_compare_op_not_equal:
+        return D3D12_COMPARISON_FUNC_NOT_EQUAL;
+    case tr_compare_op_greater_or_equal:
+        return D3D12_COMPARISON_FUNC_GREATER_EQUAL;
+    case tr_compare_op_always:
+        return D3D12_COMPARISON_FUNC_ALWAYS;
+    }
+    return D3D12_COMPARISON_FUNC_NEVER;
+}
+
 void tr_internal_dx_create_sampler(tr_renderer* p_renderer, tr_sampler* p_sampler)
 {
     assert(NULL != p_renderer->dx_device);
 
-    p_sampler->dx_sampler_desc.Filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
-    p_sampler->dx_sampler_desc.AddressU = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
-    p_sampler->dx_sampler_desc.AddressV = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
-    p_sampler->dx_sampler_desc.AddressW = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
-    p_sampler->dx_sampler_desc.MipLODBias = 0;
-    p_sampler->dx_sampler_desc.MaxAnisotropy = 0;
-    p_sampler->dx_sampler_desc.ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
+    const tr_sampler_desc* p_desc = &(p_sampler->desc);
+
+    D3D12_FILTER_REDUCTION_TYPE reduction = p_desc->compare_enable
+                                                ? D3D12_FILTER_REDUCTION_TYPE_COMPARISON
+                                                : D3D12_FILTER_REDUCTION_TYPE_STANDARD;
+    float max_anisotropy_f = p_desc->max_anisotropy;
+    if (max_anisotropy_f > (float)D3D12_MAX_MAXANISOTROPY)
+    {
+        max_anisotropy_f = (float)D3D12_MAX_MAXANISOTROPY;
+    }
+    UINT max_anisotropy = (UINT)max_anisotropy_f;
+    if (max_anisotropy > 1)
+    {
+        p_sampler->dx_sampler_desc.Filter = D3D12_ENCODE_ANISOTROPIC_FILTER(reduction);
+    }
+    else
+    {
+        D3D12_FILTER_TYPE min_filter = (tr_filter_linear == p_desc->min_filter)
+                                           ? D3D12_FILTER_TYPE_LINEAR
+                                           : D3D12_FILTER_TYPE_POINT;
+        D3D12_FILTER_TYPE mag_filter = (tr_filter_linear == p_desc->mag_filter)
+                                           ? D3D12_FILTER_TYPE_LINEAR
+                                           : D3D12_FILTER_TYPE_POINT;
+        D3D12_FILTER_TYPE mip_filter = (tr_mipmap_mode_linear == p_desc->mipmap_mode)
+                                           ? D3D12_FILTER_TYPE_LINEAR
+                                           : D3D12_FILTER_TYPE_POINT;
+        p_sampler->dx_sampler_desc.Filter =
+            D3D12_ENCODE_BASIC_FILTER(min_filter, mag_filter, mip_filter, reduction);
+    }
+    p_sampler->dx_sampler_desc.AddressU = tr_internal_dx_to_address_mode(p_desc->address_u);
+    p_sampler->dx_sampler_desc.AddressV = tr_internal_dx_to_address_mode(p_desc->address_v);
+    p_sampler->dx_sampler_desc.AddressW = tr_internal_dx_to_address_mode(p_desc->address_w);
+    p_sampler->dx_sampler_desc.MipLODBias = p_desc->mip_lod_bias;
+    p_sampler->dx_sampler_desc.MaxAnisotropy = tr_max(max_anisotropy, 1);
+    p_sampler->dx_sampler_desc.ComparisonFunc =
+        tr_internal_dx_to_comparison_func(p_desc->compare_op);
     p_sampler->dx_sampler_desc.BorderColor[0] = 0.0f;
     p_sampler->dx_sampler_desc.BorderColor[1] = 0.0f;
     p_sampler->dx_sampler_desc.BorderColor[2] = 0.0f;
     p_sampler->dx_sampler_desc.BorderColor[3] = 0.0f;
-    p_sampler->dx_sampler_desc.MinLOD = 0.0f;
-    p_sampler->dx_sampler_desc.MaxLOD = D3D12_FLOAT32_MAX;
+    p_sampler->dx_sampler_desc.MinLOD = p_desc->min_lod;
+    // D3D12 has no clamp-none value, anything past the last mip samples the whole chain
+    p_sampler->dx_sampler_desc.MaxLOD = (p_desc->max_lod >= (float)tr_lod_clamp_none)
+                                            ? D3D12_FLOAT32_MAX
+                                            : p_desc->max_lod;
 }
 
 void tr_internal_dx_destroy_sampler(tr_renderer* p_renderer, tr_sampler* p_sampler)
@@ -1024,7 +1292,8 @@ void tr_internal_dx_destroy_shader_program(tr_renderer* p_renderer,
 }
 
 void tr_internal_dx_create_root_signature(tr_renderer* p_renderer,
-                                          tr_descriptor_set* p_descriptor_set,
+                                          uint32_t descriptor_set_count,
+                                          tr_descriptor_set* const* pp_descriptor_sets,
                                           tr_pipeline* p_pipeline)
 {
     D3D12_FEATURE_DATA_ROOT_SIGNATURE feature_data = {};
@@ -1044,50 +1313,23 @@ void tr_internal_dx_create_root_signature(tr_renderer* p_renderer,
     vector<D3D12_ROOT_PARAMETER1> parameters_11;
     vector<D3D12_ROOT_PARAMETER> parameters_10;
 
-    if (NULL != p_descriptor_set)
+    // Allocate everything with an upper bound of descriptor counts
+    uint32_t total_descriptor_count = 0;
+    for (uint32_t i = 0; i < descriptor_set_count; ++i)
     {
-        const uint32_t descriptor_count = p_descriptor_set->descriptor_count;
-
-        uint32_t cbvsrvuav_count = 0;
-        uint32_t sampler_count = 0;
-        for (uint32_t i = 0; i < descriptor_count; ++i)
-        {
-            uint32_t count = p_descriptor_set->descriptors[i].count;
-            switch (p_descriptor_set->descriptors[i].type)
-            {
-            case tr_descriptor_type_sampler:
-                sampler_count += count;
-                break;
-            case tr_descriptor_type_uniform_buffer_cbv:
-                cbvsrvuav_count += count;
-                break;
-            case tr_descriptor_type_storage_buffer_srv:
-                cbvsrvuav_count += count;
-                break;
-            case tr_descriptor_type_storage_buffer_uav:
-                cbvsrvuav_count += count;
-                break;
-            case tr_descriptor_type_uniform_texel_buffer_srv:
-                cbvsrvuav_count += count;
-                break;
-            case tr_descriptor_type_storage_texel_buffer_uav:
-                cbvsrvuav_count += count;
-                break;
-            case tr_descriptor_type_texture_srv:
-                cbvsrvuav_count += count;
-                break;
-            case tr_descriptor_type_texture_uav:
-                cbvsrvuav_count += count;
-                break;
-            }
-        }
+        total_descriptor_count += pp_descriptor_sets[i]->descriptor_count;
+    }
+    ranges_11.resize(total_descriptor_count);
+    ranges_10.resize(total_descriptor_count);
 
-        // Allocate everything with an upper bound of descriptor counts
-        ranges_11.resize(descriptor_count);
-        ranges_10.resize(descriptor_count);
+    parameters_11.resize(total_descriptor_count);
+    parameters_10.resize(total_descriptor_count);
 
-        parameters_11.resize(descriptor_count);
-        parameters_10.resize(descriptor_count);
+    // Descriptor set i goes into register space i
+    for (uint32_t set_index = 0; set_index < descriptor_set_count; ++set_index)
+    {
+        tr_descriptor_set* p_descriptor_set = pp_descriptor_sets[set_index];
+        const uint32_t descriptor_count = p_descriptor_set->descriptor_count;
 
         // Build ranges
         for (uint32_t descriptor_index = 0; descriptor_index < descriptor_count; ++descriptor_index)
@@ -1173,6 +1415,23 @@ void tr_internal_dx_create_root_signature(tr_renderer* p_renderer,
                 assign_range = true;
             }
             break;
+            case tr_descriptor_type_uniform_buffer_dynamic_cbv:
+            {
+                // Root CBV so the address can change per draw without touching the heap
+                param_11->ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
+                param_11->Descriptor.ShaderRegister = descriptor->binding;
+                param_11->Descriptor.RegisterSpace = set_index;
+                param_11->Descriptor.Flags = D3D12_ROOT_DESCRIPTOR_FLAG_NONE;
+
+                param_10->ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
+                param_10->Descriptor.ShaderRegister = descriptor->binding;
+                param_10->Descriptor.RegisterSpace = set_index;
+
+                descriptor->dx_root_parameter_index = parameter_count;
+
+                ++parameter_count;
+            }
+            break;
             case tr_descriptor_type_storage_buffer_uav:
             case tr_descriptor_type_storage_texel_buffer_uav:
             case tr_descriptor_type_texture_uav:
@@ -1188,13 +1447,13 @@ void tr_internal_dx_create_root_signature(tr_renderer* p_renderer,
             {
                 range_11->NumDescriptors = descriptor->count;
                 range_11->BaseShaderRegister = descriptor->binding;
-                range_11->RegisterSpace = 0;
+                range_11->RegisterSpace = set_index;
                 range_11->Flags = D3D12_DESCRIPTOR_RANGE_FLAG_NONE;
                 range_11->OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
 
                 range_10->NumDescriptors = descriptor->count;
                 range_10->BaseShaderRegister = descriptor->binding;
-                range_10->RegisterSpace = 0;
+                range_10->RegisterSpace = set_index;
                 range_10->OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
 
                 param_11->DescriptorTable.pDescriptorRanges = range_11;
@@ -1211,6 +1470,32 @@ void tr_internal_dx_create_root_signature(tr_renderer* p_renderer,
         }
     }
 
+    // Push constants are root constants at b0 in their own register space
+    p_pipeline->dx_push_constant_root_parameter_index = UINT32_MAX;
+    uint32_t push_constant_size = p_pipeline->settings.push_constant_size;
+    if (push_constant_size > 0)
+    {
+        parameters_11.resize(parameter_count + 1);
+        parameters_10.resize(parameter_count + 1);
+
+        D3D12_ROOT_PARAMETER1* param_11 = &parameters_11[parameter_count];
+        param_11->ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+        param_11->ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+        param_11->Constants.ShaderRegister = 0;
+        param_11->Constants.RegisterSpace = tr_push_constant_register_space;
+        param_11->Constants.Num32BitValues = push_constant_size / 4;
+
+        D3D12_ROOT_PARAMETER* param_10 = &parameters_10[parameter_count];
+        param_10->ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+        param_10->ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+        param_10->Constants.ShaderRegister = 0;
+        param_10->Constants.RegisterSpace = tr_push_constant_register_space;
+        param_10->Constants.Num32BitValues = push_constant_size / 4;
+
+        p_pipeline->dx_push_constant_root_parameter_index = parameter_count;
+        ++parameter_count;
+    }
+
     D3D12_VERSIONED_ROOT_SIGNATURE_DESC desc = {};
     if (D3D_ROOT_SIGNATURE_VERSION_1_1 == feature_data.HighestVersion)
     {
@@ -1564,7 +1849,8 @@ void tr_internal_dx_create_pipeline_state(tr_renderer* p_renderer,
 
 void tr_internal_dx_create_pipeline(tr_renderer* p_renderer, tr_shader_program* p_shader_program,
                                     const tr_vertex_layout* p_vertex_layout,
-                                    tr_descriptor_set* p_descriptor_set,
+                                    uint32_t descriptor_set_count,
+                                    tr_descriptor_set* const* pp_descriptor_sets,
                                     tr_render_target* p_render_target,
                                     const tr_pipeline_settings* p_pipeline_settings,
                                     tr_pipeline* p_pipeline)
@@ -1575,7 +1861,8 @@ void tr_internal_dx_create_pipeline(tr_renderer* p_renderer, tr_shader_program*
            (NULL != p_shader_program->dx_frag));
     assert((NULL != p_render_target->dx_rtv_heap) || (NULL != p_render_target->dx_dsv_heap));
 
-    tr_internal_dx_create_root_signature(p_renderer, p_descriptor_set, p_pipeline);
+    tr_internal_dx_create_root_signature(p_renderer, descriptor_set_count, pp_descriptor_sets,
+                                         p_pipeline);
     tr_internal_dx_create_pipeline_state(p_renderer, p_shader_program, p_vertex_layout,
                                          p_render_target, p_pipeline_settings, p_pipeline);
 }
@@ -1610,14 +1897,16 @@ void tr_internal_dx_create_compute_pipeline_state(tr_renderer* p_renderer,
 
 void tr_internal_dx_create_compute_pipeline(tr_renderer* p_renderer,
                                             tr_shader_program* p_shader_program,
-                                            tr_descriptor_set* p_descriptor_set,
+                                            uint32_t descriptor_set_count,
+                                            tr_descriptor_set* const* pp_descriptor_sets,
                                             const tr_pipeline_settings* p_pipeline_settings,
                                             tr_pipeline* p_pipeline)
 {
     assert(NULL != p_renderer->dx_device);
     assert(NULL != p_shader_program->dx_comp);
 
-    tr_internal_dx_create_root_signature(p_renderer, p_descriptor_set, p_pipeline);
+    tr_internal_dx_create_root_signature(p_renderer, descriptor_set_count, pp_descriptor_sets,
+                                         p_pipeline);
     tr_internal_dx_create_compute_pipeline_state(p_renderer, p_shader_program, p_pipeline_settings,
                                                  p_pipeline);
 }
@@ -1723,31 +2012,14 @@ void tr_internal_dx_update_descriptor_set(tr_renderer* p_renderer,
                                           tr_descriptor_set* p_descriptor_set)
 {
     assert(NULL != p_renderer->dx_device);
-    assert((NULL != p_descriptor_set->dx_cbvsrvuav_heap) ||
-           (NULL != p_descriptor_set->dx_sampler_heap));
+    assert((p_descriptor_set->dx_cbvsrvuav_range.count > 0) ||
+           (p_descriptor_set->dx_sampler_range.count > 0));
 
     // Not really efficient, just write less frequently ;)
-    uint32_t write_count = 0;
     for (uint32_t i = 0; i < p_descriptor_set->descriptor_count; ++i)
     {
         tr_descriptor* descriptor = &(p_descriptor_set->descriptors[i]);
-        if ((NULL != descriptor->samplers) || (NULL != descriptor->textures) ||
-            (NULL != descriptor->uniform_buffers))
-        {
-            ++write_count;
-        }
-    }
-    // Bail if there's nothing to write
-    if (0 == write_count)
-    {
-        return;
-    }
-
-    for (uint32_t i = 0; i < p_descriptor_set->descriptor_count; ++i)
-    {
-        tr_descriptor* descriptor = &(p_descriptor_set->descriptors[i]);
-        if ((NULL == descriptor->samplers) && (NULL == descriptor->textures) &&
-            (NULL == descriptor->uniform_buffers))
+        if (0 == descriptor->count)
         {
             continue;
         }
@@ -1759,7 +2031,7 @@ void tr_internal_dx_update_descriptor_set(tr_renderer* p_renderer,
             assert(NULL != descriptor->samplers);
 
             D3D12_CPU_DESCRIPTOR_HANDLE handle =
-                p_descriptor_set->dx_sampler_heap->GetCPUDescriptorHandleForHeapStart();
+                p_renderer->dx_sampler_heap.dx_heap->GetCPUDescriptorHandleForHeapStart();
             UINT handle_inc_size = p_renderer->dx_device->GetDescriptorHandleIncrementSize(
                 D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER);
             handle.ptr += descriptor->dx_heap_offset * handle_inc_size;
@@ -1779,7 +2051,7 @@ void tr_internal_dx_update_descriptor_set(tr_renderer* p_renderer,
             assert(NULL != descriptor->uniform_buffers);
 
             D3D12_CPU_DESCRIPTOR_HANDLE handle =
-                p_descriptor_set->dx_cbvsrvuav_heap->GetCPUDescriptorHandleForHeapStart();
+                p_renderer->dx_cbvsrvuav_heap.dx_heap->GetCPUDescriptorHandleForHeapStart();
             UINT handle_inc_size = p_renderer->dx_device->GetDescriptorHandleIncrementSize(
                 D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
             handle.ptr += descriptor->dx_heap_offset * handle_inc_size;
@@ -1788,9 +2060,16 @@ void tr_internal_dx_update_descriptor_set(tr_renderer* p_renderer,
                 assert(NULL != descriptor->uniform_buffers[i]);
 
                 ID3D12Resource* resource = descriptor->uniform_buffers[i]->dx_resource;
-                D3D12_CONSTANT_BUFFER_VIEW_DESC* view_desc =
-                    &(descriptor->uniform_buffers[i]->dx_cbv_view_desc);
-                p_renderer->dx_device->CreateConstantBufferView(view_desc, handle);
+                D3D12_CONSTANT_BUFFER_VIEW_DESC view_desc =
+                    descriptor->uniform_buffers[i]->dx_cbv_view_desc;
+                if (0 != descriptor->uniform_buffer_sizes[i])
+                {
+                    view_desc.BufferLocation += descriptor->uniform_buffer_offsets[i];
+                    view_desc.SizeInBytes = tr_round_up(
+                        (uint32_t)descriptor->uniform_buffer_sizes[i],
+                        D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+                }
+                p_renderer->dx_device->CreateConstantBufferView(&view_desc, handle);
                 handle.ptr += handle_inc_size;
             }
         }
@@ -1802,7 +2081,7 @@ void tr_internal_dx_update_descriptor_set(tr_renderer* p_renderer,
             assert(NULL != descriptor->buffers);
 
             D3D12_CPU_DESCRIPTOR_HANDLE handle =
-                p_descriptor_set->dx_cbvsrvuav_heap->GetCPUDescriptorHandleForHeapStart();
+                p_renderer->dx_cbvsrvuav_heap.dx_heap->GetCPUDescriptorHandleForHeapStart();
             UINT handle_inc_size = p_renderer->dx_device->GetDescriptorHandleIncrementSize(
                 D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
             handle.ptr += descriptor->dx_heap_offset * handle_inc_size;
@@ -1825,7 +2104,7 @@ void tr_internal_dx_update_descriptor_set(tr_renderer* p_renderer,
             assert(NULL != descriptor->buffers);
 
             D3D12_CPU_DESCRIPTOR_HANDLE handle =
-                p_descriptor_set->dx_cbvsrvuav_heap->GetCPUDescriptorHandleForHeapStart();
+                p_renderer->dx_cbvsrvuav_heap.dx_heap->GetCPUDescriptorHandleForHeapStart();
             UINT handle_inc_size = p_renderer->dx_device->GetDescriptorHandleIncrementSize(
                 D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
             handle.ptr += descriptor->dx_heap_offset * handle_inc_size;
@@ -1858,7 +2137,7 @@ void tr_internal_dx_update_descriptor_set(tr_renderer* p_renderer,
             assert(NULL != descriptor->textures);
 
             D3D12_CPU_DESCRIPTOR_HANDLE handle =
-                p_descriptor_set->dx_cbvsrvuav_heap->GetCPUDescriptorHandleForHeapStart();
+                p_renderer->dx_cbvsrvuav_heap.dx_heap->GetCPUDescriptorHandleForHeapStart();
             UINT handle_inc_size = p_renderer->dx_device->GetDescriptorHandleIncrementSize(
                 D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
             handle.ptr += descriptor->dx_heap_offset * handle_inc_size;
@@ -1880,7 +2159,7 @@ void tr_internal_dx_update_descriptor_set(tr_renderer* p_renderer,
             assert(NULL != descriptor->textures);
 
             D3D12_CPU_DESCRIPTOR_HANDLE handle =
-                p_descriptor_set->dx_cbvsrvuav_heap->GetCPUDescriptorHandleForHeapStart();
+                p_renderer->dx_cbvsrvuav_heap.dx_heap->GetCPUDescriptorHandleForHeapStart();
             UINT handle_inc_size = p_renderer->dx_device->GetDescriptorHandleIncrementSize(
                 D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
             handle.ptr += descriptor->dx_heap_offset * handle_inc_size;
@@ -1913,6 +2192,8 @@ void tr_internal_dx_begin_cmd(tr_cmd* p_cmd)
 
     hres = p_cmd->dx_cmd_list->Reset(p_cmd->cmd_pool->dx_cmd_alloc, NULL);
     assert(SUCCEEDED(hres));
+
+    p_cmd->dx_descriptor_heaps_bound = false;
 }
 
 void tr_internal_dx_end_cmd(tr_cmd* p_cmd)
@@ -2113,28 +2394,12 @@ void tr_internal_dx_cmd_bind_pipeline(tr_cmd* p_cmd, tr_pipeline* p_pipeline)
     }
 }
 
-void tr_internal_dx_cmd_bind_descriptor_sets(tr_cmd* p_cmd, tr_pipeline* p_pipeline,
-                                             tr_descriptor_set* p_descriptor_set)
+static void tr_internal_dx_cmd_bind_descriptor_set(tr_cmd* p_cmd, tr_pipeline* p_pipeline,
+                                                   tr_descriptor_set* p_descriptor_set,
+                                                   uint32_t dynamic_offset_count,
+                                                   const uint32_t* p_dynamic_offsets)
 {
-    assert(NULL != p_cmd->dx_cmd_list);
-
-    uint32_t descriptor_heap_count = 0;
-    ID3D12DescriptorHeap* descriptor_heaps[2];
-    if (NULL != p_descriptor_set->dx_cbvsrvuav_heap)
-    {
-        descriptor_heaps[descriptor_heap_count] = p_descriptor_set->dx_cbvsrvuav_heap;
-        ++descriptor_heap_count;
-    }
-    if (NULL != p_descriptor_set->dx_sampler_heap)
-    {
-        descriptor_heaps[descriptor_heap_count] = p_descriptor_set->dx_sampler_heap;
-        ++descriptor_heap_count;
-    }
-
-    if (descriptor_heap_count > 0)
-    {
-        p_cmd->dx_cmd_list->SetDescriptorHeaps(descriptor_heap_count, descriptor_heaps);
-    }
+    tr_renderer* p_renderer = p_cmd->cmd_pool->renderer;
 
     for (uint32_t i = 0; i < p_descriptor_set->descriptor_count; ++i)
     {
@@ -2149,13 +2414,20 @@ void tr_internal_dx_cmd_bind_descriptor_sets(tr_cmd* p_cmd, tr_pipeline* p_pipel
         case tr_descriptor_type_sampler:
         {
             D3D12_GPU_DESCRIPTOR_HANDLE handle =
-                p_descriptor_set->dx_sampler_heap->GetGPUDescriptorHandleForHeapStart();
-            UINT handle_inc_size =
-                p_cmd->cmd_pool->renderer->dx_device->GetDescriptorHandleIncrementSize(
-                    D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER);
+                p_renderer->dx_sampler_heap.dx_heap->GetGPUDescriptorHandleForHeapStart();
+            UINT handle_inc_size = p_renderer->dx_device->GetDescriptorHandleIncrementSize(
+                D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER);
             handle.ptr += descriptor->dx_heap_offset * handle_inc_size;
-            p_cmd->dx_cmd_list->SetGraphicsRootDescriptorTable(descriptor->dx_root_parameter_index,
-                                                               handle);
+            if (p_pipeline->type == tr_pipeline_type_graphics)
+            {
+                p_cmd->dx_cmd_list->SetGraphicsRootDescriptorTable(
+                    descriptor->dx_root_parameter_index, handle);
+            }
+            else if (p_pipeline->type == tr_pipeline_type_compute)
+            {
+                p_cmd->dx_cmd_list->SetComputeRootDescriptorTable(
+                    descriptor->dx_root_parameter_index, handle);
+            }
         }
         break;
 
@@ -2168,10 +2440,9 @@ void tr_internal_dx_cmd_bind_descriptor_sets(tr_cmd* p_cmd, tr_pipeline* p_pipel
         case tr_descriptor_type_storage_texel_buffer_uav:
         {
             D3D12_GPU_DESCRIPTOR_HANDLE handle =
-                p_descriptor_set->dx_cbvsrvuav_heap->GetGPUDescriptorHandleForHeapStart();
-            UINT handle_inc_size =
-                p_cmd->cmd_pool->renderer->dx_device->GetDescriptorHandleIncrementSize(
-                    D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+                p_renderer->dx_cbvsrvuav_heap.dx_heap->GetGPUDescriptorHandleForHeapStart();
+            UINT handle_inc_size = p_renderer->dx_device->GetDescriptorHandleIncrementSize(
+                D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
             handle.ptr += descriptor->dx_heap_offset * handle_inc_size;
             if (p_pipeline->type == tr_pipeline_type_graphics)
             {
@@ -2185,10 +2456,89 @@ void tr_internal_dx_cmd_bind_descriptor_sets(tr_cmd* p_cmd, tr_pipeline* p_pipel
             }
         }
         break;
+
+        case tr_descriptor_type_uniform_buffer_dynamic_cbv:
+        {
+            assert(NULL != descriptor->uniform_buffers[0]);
+
+            D3D12_GPU_VIRTUAL_ADDRESS address =
+                descriptor->uniform_buffers[0]->dx_resource->GetGPUVirtualAddress();
+            address += descriptor->uniform_buffer_offsets[0];
+            if (descriptor->dx_dynamic_offset_index < dynamic_offset_count)
+            {
+                address += p_dynamic_offsets[descriptor->dx_dynamic_offset_index];
+            }
+            if (p_pipeline->type == tr_pipeline_type_graphics)
+            {
+                p_cmd->dx_cmd_list->SetGraphicsRootConstantBufferView(
+                    descriptor->dx_root_parameter_index, address);
+            }
+            else if (p_pipeline->type == tr_pipeline_type_compute)
+            {
+                p_cmd->dx_cmd_list->SetComputeRootConstantBufferView(
+                    descriptor->dx_root_parameter_index, address);
+            }
+        }
+        break;
         }
     }
 }
 
+// Root parameter indices live on the descriptors, so first_set only matters to Vulkan. All sets
+// are tables into the renderer's shared heaps, which are set once per recording so tables bound
+// by earlier calls stay valid.
+void tr_internal_dx_cmd_bind_descriptor_sets(tr_cmd* p_cmd, tr_pipeline* p_pipeline,
+                                             uint32_t first_set, uint32_t descriptor_set_count,
+                                             tr_descriptor_set* const* pp_descriptor_sets,
+                                             uint32_t dynamic_offset_count,
+                                             const uint32_t* p_dynamic_offsets)
+{
+    assert(NULL != p_cmd->dx_cmd_list);
+
+    if (!p_cmd->dx_descriptor_heaps_bound)
+    {
+        tr_renderer* p_renderer = p_cmd->cmd_pool->renderer;
+        ID3D12DescriptorHeap* descriptor_heaps[2] = {p_renderer->dx_cbvsrvuav_heap.dx_heap,
+                                                     p_renderer->dx_sampler_heap.dx_heap};
+        p_cmd->dx_cmd_list->SetDescriptorHeaps(2, descriptor_heaps);
+        p_cmd->dx_descriptor_heaps_bound = true;
+    }
+
+    // The offsets of each set follow the ones of the set before it
+    uint32_t offset_index = 0;
+    for (uint32_t i = 0; i < descriptor_set_count; ++i)
+    {
+        tr_descriptor_set* p_descriptor_set = pp_descriptor_sets[i];
+        uint32_t set_offset_count =
+            (dynamic_offset_count > 0) ? p_descriptor_set->dynamic_offset_count : 0;
+        tr_internal_dx_cmd_bind_descriptor_set(p_cmd, p_pipeline, p_descriptor_set,
+                                               set_offset_count,
+                                               (set_offset_count > 0)
+                                                   ? &(p_dynamic_offsets[offset_index])
+                                                   : NULL);
+        offset_index += set_offset_count;
+    }
+}
+
+void tr_internal_dx_cmd_push_constants(tr_cmd* p_cmd, tr_pipeline* p_pipeline, uint32_t offset,
+                                      uint32_t size, const void* p_data)
+{
+    assert(NULL != p_cmd->dx_cmd_list);
+    assert(UINT32_MAX != p_pipeline->dx_push_constant_root_parameter_index);
+
+    uint32_t root_parameter_index = p_pipeline->dx_push_constant_root_parameter_index;
+    if (p_pipeline->type == tr_pipeline_type_graphics)
+    {
+        p_cmd->dx_cmd_list->SetGraphicsRoot32BitConstants(root_parameter_index, size / 4, p_data,
+                                                          offset / 4);
+    }
+    else if (p_pipeline->type == tr_pipeline_type_compute)
+    {
+        p_cmd->dx_cmd_list->SetComputeRoot32BitConstants(root_parameter_index, size / 4, p_data,
+                                                         offset / 4);
+    }
+}
+
 void tr_internal_dx_cmd_bind_index_buffer(tr_cmd* p_cmd, tr_buffer* p_buffer)
 {
     assert(NULL != p_cmd->dx_cmd_list);
@@ -2231,6 +2581,44 @@ void tr_internal_dx_cmd_draw_indexed(tr_cmd* p_cmd, uint32_t index_count, uint32
 
 void tr_internal_dx_cmd_buffer_transition(tr_cmd* p_cmd, tr_buffer* p_buffer,
                                           tr_buffer_usage old_usage, tr_buffer_usage new_usage)
+{
+    tr_internal_dx_cmd_buffer_transition_queue(p_cmd, p_buffer, old_usage, new_usage, NULL, NULL);
+}
+
+void tr_internal_dx_cmd_image_transition(tr_cmd* p_cmd, tr_texture* p_texture,
+                                         tr_texture_usage old_usage, tr_texture_usage new_usage)
+{
+    tr_internal_dx_cmd_image_transition_queue(p_cmd, p_texture, old_usage, new_usage, NULL, NULL);
+}
+
+// D3D12 has no queue ownership. Resources are handed from one queue to another in the common
+// state instead: the source queue transitions into it and the destination queue out of it, since
+// copy queues can't use any of the shader states.
+static void tr_internal_dx_queue_ownership_transfer(tr_cmd* p_cmd, tr_queue* p_src_queue,
+                                                    tr_queue* p_dst_queue,
+                                                    D3D12_RESOURCE_STATES* p_state_before,
+                                                    D3D12_RESOURCE_STATES* p_state_after)
+{
+    if ((NULL == p_src_queue) || (NULL == p_dst_queue) || (p_src_queue == p_dst_queue))
+    {
+        return;
+    }
+
+    if (p_cmd->cmd_pool->queue == p_src_queue)
+    {
+        *p_state_after = D3D12_RESOURCE_STATE_COMMON;
+    }
+    else
+    {
+        assert(p_cmd->cmd_pool->queue == p_dst_queue);
+        *p_state_before = D3D12_RESOURCE_STATE_COMMON;
+    }
+}
+
+void tr_internal_dx_cmd_buffer_transition_queue(tr_cmd* p_cmd, tr_buffer* p_buffer,
+                                                tr_buffer_usage old_usage,
+                                                tr_buffer_usage new_usage, tr_queue* p_src_queue,
+                                                tr_queue* p_dst_queue)
 {
     assert(NULL != p_cmd->dx_cmd_list);
     assert(NULL != p_buffer->dx_resource);
@@ -2243,11 +2631,21 @@ void tr_internal_dx_cmd_buffer_transition(tr_cmd* p_cmd, tr_buffer* p_buffer,
     barrier.Transition.StateBefore = tr_util_to_dx_resource_state_buffer(old_usage);
     barrier.Transition.StateAfter = tr_util_to_dx_resource_state_buffer(new_usage);
 
+    tr_internal_dx_queue_ownership_transfer(p_cmd, p_src_queue, p_dst_queue,
+                                            &barrier.Transition.StateBefore,
+                                            &barrier.Transition.StateAfter);
+    if (barrier.Transition.StateBefore == barrier.Transition.StateAfter)
+    {
+        return;
+    }
+
     p_cmd->dx_cmd_list->ResourceBarrier(1, &barrier);
 }
 
-void tr_internal_dx_cmd_image_transition(tr_cmd* p_cmd, tr_texture* p_texture,
-                                         tr_texture_usage old_usage, tr_texture_usage new_usage)
+void tr_internal_dx_cmd_image_transition_queue(tr_cmd* p_cmd, tr_texture* p_texture,
+                                               tr_texture_usage old_usage,
+                                               tr_texture_usage new_usage, tr_queue* p_src_queue,
+                                               tr_queue* p_dst_queue)
 {
     assert(NULL != p_cmd->dx_cmd_list);
     assert(NULL != p_texture->dx_resource);
@@ -2260,6 +2658,14 @@ void tr_internal_dx_cmd_image_transition(tr_cmd* p_cmd, tr_texture* p_texture,
     barrier.Transition.StateBefore = tr_util_to_dx_resource_state_texture(old_usage);
     barrier.Transition.StateAfter = tr_util_to_dx_resource_state_texture(new_usage);
 
+    tr_internal_dx_queue_ownership_transfer(p_cmd, p_src_queue, p_dst_queue,
+                                            &barrier.Transition.StateBefore,
+                                            &barrier.Transition.StateAfter);
+    if (barrier.Transition.StateBefore == barrier.Transition.StateAfter)
+    {
+        return;
+    }
+
     p_cmd->dx_cmd_list->ResourceBarrier(1, &barrier);
 }
 
@@ -2390,8 +2796,9 @@ void tr_internal_dx_acquire_next_image(tr_renderer* p_renderer, tr_semaphore* p_
 
 void tr_internal_dx_queue_submit(tr_queue* p_queue, uint32_t cmd_count, tr_cmd** pp_cmds,
                                  uint32_t wait_semaphore_count, tr_semaphore** pp_wait_semaphores,
-                                 uint32_t signal_semaphore_count,
-                                 tr_semaphore** pp_signal_semaphores)
+                                 const uint64_t* p_wait_values, uint32_t signal_semaphore_count,
+                                 tr_semaphore** pp_signal_semaphores,
+                                 const uint64_t* p_signal_values, tr_fence* p_fence)
 {
     assert(NULL != p_queue->dx_queue);
 
@@ -2402,7 +2809,33 @@ void tr_internal_dx_queue_submit(tr_queue* p_queue, uint32_t cmd_count, tr_cmd**
         cmds[i] = pp_cmds[i]->dx_cmd_list;
     }
 
+    // Semaphores order work across queues, e.g. around tr_cmd_*_transition_queue. A binary
+    // semaphore that was never signaled has a value of 0 and doesn't hold anything up.
+    for (uint32_t i = 0; i < wait_semaphore_count; ++i)
+    {
+        tr_semaphore* p_semaphore = pp_wait_semaphores[i];
+        assert(NULL != p_semaphore->dx_fence);
+        assert(!p_semaphore->timeline || (NULL != p_wait_values));
+        uint64_t value = p_semaphore->timeline ? p_wait_values[i] : p_semaphore->dx_fence_value;
+        p_queue->dx_queue->Wait(p_semaphore->dx_fence, value);
+    }
+
     p_queue->dx_queue->ExecuteCommandLists(count, cmds);
+
+    for (uint32_t i = 0; i < signal_semaphore_count; ++i)
+    {
+        tr_semaphore* p_semaphore = pp_signal_semaphores[i];
+        assert(NULL != p_semaphore->dx_fence);
+        assert(!p_semaphore->timeline || (NULL != p_signal_values));
+        uint64_t value = p_semaphore->timeline ? p_signal_values[i] : ++p_semaphore->dx_fence_value;
+        p_queue->dx_queue->Signal(p_semaphore->dx_fence, value);
+    }
+
+    if (NULL != p_fence)
+    {
+        ++p_fence->dx_fence_value;
+        p_queue->dx_queue->Signal(p_fence->dx_fence, p_fence->dx_fence_value);
+    }
 }
 
 void tr_internal_dx_queue_present(tr_queue* p_queue, uint32_t wait_semaphore_count,
@@ -2436,6 +2869,58 @@ void tr_internal_dx_queue_wait_idle(tr_queue* p_queue)
     }
 }
 
+bool tr_internal_dx_get_fence_status(tr_renderer* p_renderer, tr_fence* p_fence)
+{
+    assert(NULL != p_fence->dx_fence);
+
+    return p_fence->dx_fence->GetCompletedValue() >= p_fence->dx_fence_value;
+}
+
+void tr_internal_dx_wait_for_fence(tr_renderer* p_renderer, tr_fence* p_fence)
+{
+    assert(NULL != p_fence->dx_fence);
+    assert(NULL != p_fence->dx_fence_event);
+
+    if (p_fence->dx_fence->GetCompletedValue() < p_fence->dx_fence_value)
+    {
+        p_fence->dx_fence->SetEventOnCompletion(p_fence->dx_fence_value,
+                                                p_fence->dx_fence_event);
+        WaitForSingleObject(p_fence->dx_fence_event, INFINITE);
+    }
+}
+
+// Fence values only ever increase so there is nothing to reset
+void tr_internal_dx_reset_fence(tr_renderer* p_renderer, tr_fence* p_fence) {}
+
+uint64_t tr_internal_dx_get_semaphore_value(tr_renderer* p_renderer, tr_semaphore* p_semaphore)
+{
+    assert(NULL != p_semaphore->dx_fence);
+
+    return p_semaphore->dx_fence->GetCompletedValue();
+}
+
+void tr_internal_dx_signal_semaphore(tr_renderer* p_renderer, tr_semaphore* p_semaphore,
+                                    uint64_t value)
+{
+    assert(NULL != p_semaphore->dx_fence);
+
+    HRESULT hres = p_semaphore->dx_fence->Signal(value);
+    assert(SUCCEEDED(hres));
+}
+
+void tr_internal_dx_wait_for_semaphore(tr_renderer* p_renderer, tr_semaphore* p_semaphore,
+                                      uint64_t value)
+{
+    assert(NULL != p_semaphore->dx_fence);
+    assert(NULL != p_semaphore->dx_fence_event);
+
+    if (p_semaphore->dx_fence->GetCompletedValue() < value)
+    {
+        p_semaphore->dx_fence->SetEventOnCompletion(value, p_semaphore->dx_fence_event);
+        WaitForSingleObject(p_semaphore->dx_fence_event, INFINITE);
+    }
+}
+
 DXGI_FORMAT tr_util_to_dx_format(tr_format format)
 {
     DXGI_FORMAT result = DXGI_FORMAT_UNKNOWN;
@@ -2487,6 +2972,12 @@ DXGI_FORMAT tr_util_to_dx_format(tr_format format)
     case tr_format_r8g8b8a8_unorm:
         result = DXGI_FORMAT_R8G8B8A8_UNORM;
         break;
+    case tr_format_b8g8r8a8_srgb:
+        result = DXGI_FORMAT_B8G8R8A8_UNORM_SRGB;
+        break;
+    case tr_format_r8g8b8a8_srgb:
+        result = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+        break;
     case tr_format_r16g16b16a16_unorm:
         result = DXGI_FORMAT_R16G16B16A16_UNORM;
         break;
@@ -2515,6 +3006,34 @@ DXGI_FORMAT tr_util_to_dx_format(tr_format format)
     case tr_format_d32_float_s8_uint:
         result = DXGI_FORMAT_D32_FLOAT_S8X24_UINT;
         break;
+        // Block compressed, D3D12 has no ETC2 or ASTC
+    case tr_format_bc1_rgba_unorm:
+        result = DXGI_FORMAT_BC1_UNORM;
+        break;
+    case tr_format_bc1_rgba_srgb:
+        result = DXGI_FORMAT_BC1_UNORM_SRGB;
+        break;
+    case tr_format_bc3_unorm:
+        result = DXGI_FORMAT_BC3_UNORM;
+        break;
+    case tr_format_bc3_srgb:
+        result = DXGI_FORMAT_BC3_UNORM_SRGB;
+        break;
+    case tr_format_bc4_unorm:
+        result = DXGI_FORMAT_BC4_UNORM;
+        break;
+    case tr_format_bc5_unorm:
+        result = DXGI_FORMAT_BC5_UNORM;
+        break;
+    case tr_format_bc6h_ufloat:
+        result = DXGI_FORMAT_BC6H_UF16;
+        break;
+    case tr_format_bc7_unorm:
+        result = DXGI_FORMAT_BC7_UNORM;
+        break;
+    case tr_format_bc7_srgb:
+        result = DXGI_FORMAT_BC7_UNORM_SRGB;
+        break;
     }
     return result;
 }
@@ -2570,6 +3089,12 @@ tr_format tr_util_from_dx_format(DXGI_FORMAT format)
     case DXGI_FORMAT_R8G8B8A8_UNORM:
         result = tr_format_r8g8b8a8_unorm;
         break;
+    case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+        result = tr_format_b8g8r8a8_srgb;
+        break;
+    case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+        result = tr_format_r8g8b8a8_srgb;
+        break;
     case DXGI_FORMAT_R16G16B16A16_UNORM:
         result = tr_format_r16g16b16a16_unorm;
         break;
@@ -2598,6 +3123,34 @@ tr_format tr_util_from_dx_format(DXGI_FORMAT format)
     case DXGI_FORMAT_D32_FLOAT_S8X24_UINT:
         result = tr_format_d32_float_s8_uint;
         break;
+        // Block compressed
+    case DXGI_FORMAT_BC1_UNORM:
+        result = tr_format_bc1_rgba_unorm;
+        break;
+    case DXGI_FORMAT_BC1_UNORM_SRGB:
+        result = tr_format_bc1_rgba_srgb;
+        break;
+    case DXGI_FORMAT_BC3_UNORM:
+        result = tr_format_bc3_unorm;
+        break;
+    case DXGI_FORMAT_BC3_UNORM_SRGB:
+        result = tr_format_bc3_srgb;
+        break;
+    case DXGI_FORMAT_BC4_UNORM:
+        result = tr_format_bc4_unorm;
+        break;
+    case DXGI_FORMAT_BC5_UNORM:
+        result = tr_format_bc5_unorm;
+        break;
+    case DXGI_FORMAT_BC6H_UF16:
+        result = tr_format_bc6h_ufloat;
+        break;
+    case DXGI_FORMAT_BC7_UNORM:
+        result = tr_format_bc7_unorm;
+        break;
+    case DXGI_FORMAT_BC7_UNORM_SRGB:
+        result = tr_format_bc7_srgb;
+        break;
     }
     return result;
 }
@@ -18,6 +18,8 @@ void tr_internal_dx_create_fence(tr_renderer* p_renderer, tr_fence* p_fence);
 void tr_internal_dx_destroy_fence(tr_renderer* p_renderer, tr_fence* p_fence);
 void tr_internal_dx_create_semaphore(tr_renderer* p_renderer, tr_semaphore* p_semaphore);
 void tr_internal_dx_destroy_semaphore(tr_renderer* p_renderer, tr_semaphore* p_semaphore);
+void tr_internal_dx_create_timeline_semaphore(tr_renderer* p_renderer, uint64_t initial_value,
+                                             tr_semaphore* p_semaphore);
 void tr_internal_dx_create_descriptor_set(tr_renderer* p_renderer,
                                           tr_descriptor_set* p_descriptor_set);
 void tr_internal_dx_destroy_descriptor_set(tr_renderer* p_renderer,
@@ -31,17 +33,21 @@ void tr_internal_dx_create_buffer(tr_renderer* p_renderer, tr_buffer* p_buffer);
 void tr_internal_dx_destroy_buffer(tr_renderer* p_renderer, tr_buffer* p_buffer);
 void tr_internal_dx_create_texture(tr_renderer* p_renderer, tr_texture* p_texture);
 void tr_internal_dx_destroy_texture(tr_renderer* p_renderer, tr_texture* p_texture);
+bool tr_internal_dx_supports_format(tr_renderer* p_renderer, tr_format format,
+                                    tr_texture_usage_flags usage);
 void tr_internal_dx_create_sampler(tr_renderer* p_renderer, tr_sampler* p_sampler);
 void tr_internal_dx_destroy_sampler(tr_renderer* p_renderer, tr_sampler* p_sampler);
 void tr_internal_dx_create_pipeline(tr_renderer* p_renderer, tr_shader_program* p_shader_program,
                                     const tr_vertex_layout* p_vertex_layout,
-                                    tr_descriptor_set* p_descriptor_set,
+                                    uint32_t descriptor_set_count,
+                                    tr_descriptor_set* const* pp_descriptor_sets,
                                     tr_render_target* p_render_target,
                                     const tr_pipeline_settings* p_pipeline_settings,
                                     tr_pipeline* p_pipeline);
 void tr_internal_dx_create_compute_pipeline(tr_renderer* p_renderer,
                                             tr_shader_program* p_shader_program,
-                                            tr_descriptor_set* p_descriptor_set,
+                                            uint32_t descriptor_set_count,
+                                            tr_descriptor_set* const* pp_descriptor_sets,
                                             const tr_pipeline_settings* p_pipeline_settings,
                                             tr_pipeline* p_pipeline);
 void tr_internal_dx_destroy_pipeline(tr_renderer* p_renderer, tr_pipeline* p_pipeline);
@@ -78,7 +84,12 @@ void tr_cmd_internal_dx_cmd_clear_depth_stencil_attachment(tr_cmd* p_cmd,
                                                            const tr_clear_value* clear_value);
 void tr_internal_dx_cmd_bind_pipeline(tr_cmd* p_cmd, tr_pipeline* p_pipeline);
 void tr_internal_dx_cmd_bind_descriptor_sets(tr_cmd* p_cmd, tr_pipeline* p_pipeline,
-                                             tr_descriptor_set* p_descriptor_set);
+                                             uint32_t first_set, uint32_t descriptor_set_count,
+                                             tr_descriptor_set* const* pp_descriptor_sets,
+                                             uint32_t dynamic_offset_count,
+                                             const uint32_t* p_dynamic_offsets);
+void tr_internal_dx_cmd_push_constants(tr_cmd* p_cmd, tr_pipeline* p_pipeline, uint32_t offset,
+                                      uint32_t size, const void* p_data);
 void tr_internal_dx_cmd_bind_index_buffer(tr_cmd* p_cmd, tr_buffer* p_buffer);
 void tr_internal_dx_cmd_bind_vertex_buffers(tr_cmd* p_cmd, uint32_t buffer_count,
                                             tr_buffer** pp_buffers);
@@ -89,6 +100,14 @@ void tr_internal_dx_cmd_buffer_transition(tr_cmd* p_cmd, tr_buffer* p_texture,
                                           tr_buffer_usage old_usage, tr_buffer_usage new_usage);
 void tr_internal_dx_cmd_image_transition(tr_cmd* p_cmd, tr_texture* p_texture,
                                          tr_texture_usage old_usage, tr_texture_usage new_usage);
+void tr_internal_dx_cmd_buffer_transition_queue(tr_cmd* p_cmd, tr_buffer* p_buffer,
+                                                tr_buffer_usage old_usage,
+                                                tr_buffer_usage new_usage, tr_queue* p_src_queue,
+                                                tr_queue* p_dst_queue);
+void tr_internal_dx_cmd_image_transition_queue(tr_cmd* p_cmd, tr_texture* p_texture,
+                                               tr_texture_usage old_usage,
+                                               tr_texture_usage new_usage, tr_queue* p_src_queue,
+                                               tr_queue* p_dst_queue);
 void tr_internal_dx_cmd_render_target_transition(tr_cmd* p_cmd, tr_render_target* p_render_target,
                                                  tr_texture_usage old_usage,
                                                  tr_texture_usage new_usage);
@@ -107,11 +126,20 @@ void tr_internal_dx_acquire_next_image(tr_renderer* p_renderer, tr_semaphore* p_
                                        tr_fence* p_fence);
 void tr_internal_dx_queue_submit(tr_queue* p_queue, uint32_t cmd_count, tr_cmd** pp_cmds,
                                  uint32_t wait_semaphore_count, tr_semaphore** pp_wait_semaphores,
-                                 uint32_t signal_semaphore_count,
-                                 tr_semaphore** pp_signal_semaphores);
+                                 const uint64_t* p_wait_values, uint32_t signal_semaphore_count,
+                                 tr_semaphore** pp_signal_semaphores,
+                                 const uint64_t* p_signal_values, tr_fence* p_fence);
 void tr_internal_dx_queue_present(tr_queue* p_queue, uint32_t wait_semaphore_count,
                                   tr_semaphore** pp_wait_semaphores);
 void tr_internal_dx_queue_wait_idle(tr_queue* p_queue);
+bool tr_internal_dx_get_fence_status(tr_renderer* p_renderer, tr_fence* p_fence);
+void tr_internal_dx_wait_for_fence(tr_renderer* p_renderer, tr_fence* p_fence);
+void tr_internal_dx_reset_fence(tr_renderer* p_renderer, tr_fence* p_fence);
+uint64_t tr_internal_dx_get_semaphore_value(tr_renderer* p_renderer, tr_semaphore* p_semaphore);
+void tr_internal_dx_signal_semaphore(tr_renderer* p_renderer, tr_semaphore* p_semaphore,
+                                    uint64_t value);
+void tr_internal_dx_wait_for_semaphore(tr_renderer* p_renderer, tr_semaphore* p_semaphore,
+                                      uint64_t value);
 
 DXGI_FORMAT tr_util_to_dx_format(tr_format format);
 
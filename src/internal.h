@@ -2,6 +2,14 @@
 
 #include "vgfx.h"
 
+#include <functional>
+
+// SSE2 is part of every x64 target, the scalar paths cover everything else
+#if defined(__SSE2__) || defined(_M_X64)
+#define TINY_RENDERER_SSE2
+#include <emmintrin.h>
+#endif
+
 #define TINY_RENDERER_RENDERER_PTR_CHECK(p_renderer)                                               \
     assert(NULL != s_tr_internal);                                                                 \
     assert(NULL != p_renderer);                                                                    \
@@ -11,16 +19,41 @@ static inline uint32_t tr_max(uint32_t a, uint32_t b) { return a > b ? a : b; }
 
 static inline uint32_t tr_min(uint32_t a, uint32_t b) { return a < b ? a : b; }
 
+static inline uint64_t tr_max_u64(uint64_t a, uint64_t b) { return a > b ? a : b; }
+
+static inline uint64_t tr_min_u64(uint64_t a, uint64_t b) { return a < b ? a : b; }
+
 static inline uint32_t tr_round_up(uint32_t value, uint32_t multiple)
 {
     assert(multiple);
     return ((value + multiple - 1) / multiple) * multiple;
 }
 
+static inline uint64_t tr_round_up_u64(uint64_t value, uint64_t multiple)
+{
+    assert(multiple);
+    return ((value + multiple - 1) / multiple) * multiple;
+}
+
 extern tr_renderer* s_tr_internal;
 void tr_internal_log(tr_log_type type, const char* msg, const char* component);
-
-bool tr_image_resize_uint8_t(uint32_t src_width, uint32_t src_height, uint32_t src_row_stride,
-    const uint8_t* src_data, uint32_t dst_width, uint32_t dst_height,
-    uint32_t dst_row_stride, uint8_t* dst_data, uint32_t channel_cout,
-    void* user_data);
\ No newline at end of file
+void tr_internal_destroy_upload_context(tr_queue* p_queue);
+void tr_internal_destroy_job_system(tr_renderer* p_renderer);
+// Calls fn(first, last) on ranges covering [0, count), each at least min_range_size long, spread
+// over the renderer's job system. The calling thread takes ranges too and returns once all of
+// them are done.
+void tr_internal_parallel_for(tr_renderer* p_renderer, uint32_t count, uint32_t min_range_size,
+                              const std::function<void(uint32_t, uint32_t)>& fn);
+// tr_image_downsample_uint8 with the rows split over the renderer's job system
+void tr_internal_downsample_uint8(tr_renderer* p_renderer, uint32_t src_width, uint32_t src_height,
+                                  uint32_t src_row_stride, const uint8_t* src_data,
+                                  uint32_t dst_row_stride, uint8_t* dst_data,
+                                  uint32_t channel_count, bool srgb);
+// True for the formats tr_image_compress_uint8 encodes
+bool tr_internal_can_compress(tr_format format);
+// tr_image_compress_uint8 with the block rows split over the renderer's job system
+bool tr_internal_compress_uint8(tr_renderer* p_renderer, uint32_t width, uint32_t height,
+                                uint32_t row_stride, const uint8_t* src_data, tr_format format,
+                                tr_compression_quality quality, uint8_t* dst_data);
+void tr_internal_create_bindless(tr_renderer* p_renderer);
+void tr_internal_destroy_bindless(tr_renderer* p_renderer);
@@ -1,8 +1,17 @@
 #include "dx_internal.h"
 #include "internal.h"
 #include "vk_internal.h"
+#include <algorithm>
 #include <assert.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <fstream>
+#include <functional>
+#include <math.h>
+#include <memory>
+#include <stdio.h>
+#include <thread>
 
 using namespace std;
 
@@ -16,6 +25,43 @@ void tr_destroy_renderer(tr_renderer* p_renderer)
     TINY_RENDERER_RENDERER_PTR_CHECK(p_renderer);
     assert(NULL != s_tr_internal);
 
+    // Finish async pipeline compiles before anything they use goes away
+    tr_internal_destroy_job_system(p_renderer);
+
+    // Destroy the upload contexts, this also submits anything still pending
+    tr_internal_destroy_upload_context(p_renderer->graphics_queue);
+    if (p_renderer->present_queue != p_renderer->graphics_queue)
+    {
+        tr_internal_destroy_upload_context(p_renderer->present_queue);
+    }
+    if (NULL != p_renderer->transfer_queue)
+    {
+        tr_internal_destroy_upload_context(p_renderer->transfer_queue);
+    }
+    if (NULL != p_renderer->compute_queue)
+    {
+        tr_internal_destroy_upload_context(p_renderer->compute_queue);
+    }
+
+    // Free anything still waiting on a frame, it can be in use on any of the queues
+    if (!p_renderer->deferred_destroys.empty())
+    {
+        tr_queue_wait_idle(p_renderer->graphics_queue);
+        if (p_renderer->present_queue != p_renderer->graphics_queue)
+        {
+            tr_queue_wait_idle(p_renderer->present_queue);
+        }
+        if (NULL != p_renderer->transfer_queue)
+        {
+            tr_queue_wait_idle(p_renderer->transfer_queue);
+        }
+        if (NULL != p_renderer->compute_queue)
+        {
+            tr_queue_wait_idle(p_renderer->compute_queue);
+        }
+        tr_retire_frames(p_renderer, UINT64_MAX);
+    }
+
     // Destroy the swapchain render targets
     for (size_t i = 0; i < p_renderer->settings.swapchain.image_count; ++i)
     {
@@ -36,10 +82,15 @@ void tr_destroy_renderer(tr_renderer* p_renderer)
         tr_destroy_semaphore(p_renderer, p_renderer->render_complete_semaphores[i]);
     }
 
+    tr_internal_destroy_bindless(p_renderer);
+    tr_destroy_descriptor_pool(p_renderer, p_renderer->descriptor_pool);
+
     if (p_renderer->api == tr_api_vulkan)
     {
         tr_internal_vk_destroy_swapchain(p_renderer);
+        tr_internal_vk_destroy_pipeline_cache(p_renderer);
         tr_internal_vk_destroy_surface(p_renderer);
+        tr_internal_vk_destroy_memory_blocks(p_renderer);
         tr_internal_vk_destroy_device(p_renderer);
         tr_internal_vk_destroy_instance(p_renderer);
 
@@ -57,6 +108,8 @@ void tr_destroy_renderer(tr_renderer* p_renderer)
     // Destroy the Vulkan bits
 
     // Free all the renderer components!
+    delete s_tr_internal->transfer_queue;
+    delete s_tr_internal->compute_queue;
     delete s_tr_internal->graphics_queue;
     delete s_tr_internal;
 }
@@ -89,6 +142,39 @@ void tr_destroy_fence(tr_renderer* p_renderer, tr_fence* p_fence)
     delete p_fence;
 }
 
+bool tr_get_fence_status(tr_renderer* p_renderer, tr_fence* p_fence)
+{
+    TINY_RENDERER_RENDERER_PTR_CHECK(p_renderer);
+    assert(NULL != p_fence);
+
+    if (p_renderer->api == tr_api_vulkan)
+        return tr_internal_vk_get_fence_status(p_renderer, p_fence);
+    else
+        return tr_internal_dx_get_fence_status(p_renderer, p_fence);
+}
+
+void tr_wait_for_fence(tr_renderer* p_renderer, tr_fence* p_fence)
+{
+    TINY_RENDERER_RENDERER_PTR_CHECK(p_renderer);
+    assert(NULL != p_fence);
+
+    if (p_renderer->api == tr_api_vulkan)
+        tr_internal_vk_wait_for_fence(p_renderer, p_fence);
+    else
+        tr_internal_dx_wait_for_fence(p_renderer, p_fence);
+}
+
+void tr_reset_fence(tr_renderer* p_renderer, tr_fence* p_fence)
+{
+    TINY_RENDERER_RENDERER_PTR_CHECK(p_renderer);
+    assert(NULL != p_fence);
+
+    if (p_renderer->api == tr_api_vulkan)
+        tr_internal_vk_reset_fence(p_renderer, p_fence);
+    else
+        tr_internal_dx_reset_fence(p_renderer, p_fence);
+}
+
 void tr_create_semaphore(tr_renderer* p_renderer, tr_semaphore** pp_semaphore)
 {
     TINY_RENDERER_RENDERER_PTR_CHECK(p_renderer);
@@ -117,40 +203,176 @@ void tr_destroy_semaphore(tr_renderer* p_renderer, tr_semaphore* p_semaphore)
     delete p_semaphore;
 }
 
+void tr_create_timeline_semaphore(tr_renderer* p_renderer, uint64_t initial_value,
+                                  tr_semaphore** pp_semaphore)
+{
+    TINY_RENDERER_RENDERER_PTR_CHECK(p_renderer);
+
+    tr_semaphore* p_semaphore = new tr_semaphore();
+    assert(NULL != p_semaphore);
+
+    p_semaphore->timeline = true;
+
+    if (p_renderer->api == tr_api_vulkan)
+        tr_internal_vk_create_timeline_semaphore(p_renderer, initial_value, p_semaphore);
+    else
+        tr_internal_dx_create_timeline_semaphore(p_renderer, initial_value, p_semaphore);
+
+    *pp_semaphore = p_semaphore;
+}
+
+uint64_t tr_get_semaphore_value(tr_renderer* p_renderer, tr_semaphore* p_semaphore)
+{
+    TINY_RENDERER_RENDERER_PTR_CHECK(p_renderer);
+    assert(NULL != p_semaphore);
+    assert(p_semaphore->timeline);
+
+    if (p_renderer->api == tr_api_vulkan)
+        return tr_internal_vk_get_semaphore_value(p_renderer, p_semaphore);
+    else
+        return tr_internal_dx_get_semaphore_value(p_renderer, p_semaphore);
+}
+
+void tr_signal_semaphore(tr_renderer* p_renderer, tr_semaphore* p_semaphore, uint64_t value)
+{
+    TINY_RENDERER_RENDERER_PTR_CHECK(p_renderer);
+    assert(NULL != p_semaphore);
+    assert(p_semaphore->timeline);
+
+    if (p_renderer->api == tr_api_vulkan)
+        tr_internal_vk_signal_semaphore(p_renderer, p_semaphore, value);
+    else
+        tr_internal_dx_signal_semaphore(p_renderer, p_semaphore, value);
+}
+
+void tr_wait_for_semaphore(tr_renderer* p_renderer, tr_semaphore* p_semaphore, uint64_t value)
+{
+    TINY_RENDERER_RENDERER_PTR_CHECK(p_renderer);
+    assert(NULL != p_semaphore);
+    assert(p_semaphore->timeline);
+
+    if (p_renderer->api == tr_api_vulkan)
+        tr_internal_vk_wait_for_semaphore(p_renderer, p_semaphore, value);
+    else
+        tr_internal_dx_wait_for_semaphore(p_renderer, p_semaphore, value);
+}
+
 void tr_create_descriptor_set(tr_renderer* p_renderer, uint32_t descriptor_count,
                               const tr_descriptor* p_descriptors,
                               tr_descriptor_set** pp_descriptor_set)
 {
     TINY_RENDERER_RENDERER_PTR_CHECK(p_renderer);
 
+    tr_create_descriptor_set_from_pool(p_renderer, p_renderer->descriptor_pool, descriptor_count,
+                                       p_descriptors, pp_descriptor_set);
+}
+
+// Number of 8 byte arena slots the entries of p_descriptor take up
+static uint32_t tr_internal_descriptor_arena_slot_count(const tr_descriptor* p_descriptor)
+{
+    uint32_t slot_count = tr_round_up(p_descriptor->count * (uint32_t)sizeof(void*), 8) / 8;
+    if ((tr_descriptor_type_uniform_buffer_cbv == p_descriptor->type) ||
+        (tr_descriptor_type_uniform_buffer_dynamic_cbv == p_descriptor->type))
+    {
+        // Offsets and sizes
+        slot_count += 2 * p_descriptor->count;
+    }
+    return slot_count;
+}
+
+void tr_create_descriptor_set_from_pool(tr_renderer* p_renderer,
+                                        tr_descriptor_pool* p_descriptor_pool,
+                                        uint32_t descriptor_count,
+                                        const tr_descriptor* p_descriptors,
+                                        tr_descriptor_set** pp_descriptor_set)
+{
+    TINY_RENDERER_RENDERER_PTR_CHECK(p_renderer);
+    assert(NULL != p_descriptor_pool);
+
     tr_descriptor_set* p_descriptor_set = new tr_descriptor_set();
     assert(NULL != p_descriptor_set);
 
+    p_descriptor_set->descriptor_pool = p_descriptor_pool;
     p_descriptor_set->descriptors = new tr_descriptor[descriptor_count]();
 
     p_descriptor_set->descriptor_count = descriptor_count;
     memcpy(p_descriptor_set->descriptors, p_descriptors,
            descriptor_count * sizeof(*(p_descriptor_set->descriptors)));
 
+    uint32_t arena_slot_count = 0;
+    for (uint32_t i = 0; i < descriptor_count; ++i)
+    {
+        arena_slot_count += tr_internal_descriptor_arena_slot_count(&(p_descriptors[i]));
+    }
+    p_descriptor_set->descriptor_arena = new uint64_t[tr_max(arena_slot_count, 1)]();
+
+    // Point each descriptor at its entries, copying whatever the caller already filled in
+    uint64_t* p_slot = p_descriptor_set->descriptor_arena;
+    for (uint32_t i = 0; i < descriptor_count; ++i)
+    {
+        const tr_descriptor* src = &(p_descriptors[i]);
+        tr_descriptor* dst = &(p_descriptor_set->descriptors[i]);
+        uint32_t pointer_bytes = src->count * (uint32_t)sizeof(void*);
+
+        dst->uniform_buffers = (tr_buffer**)p_slot;
+        if (NULL != src->uniform_buffers)
+        {
+            memcpy(dst->uniform_buffers, src->uniform_buffers, pointer_bytes);
+        }
+        p_slot += tr_round_up(pointer_bytes, 8) / 8;
+
+        dst->uniform_buffer_offsets = NULL;
+        dst->uniform_buffer_sizes = NULL;
+        if ((tr_descriptor_type_uniform_buffer_cbv == src->type) ||
+            (tr_descriptor_type_uniform_buffer_dynamic_cbv == src->type))
+        {
+            dst->uniform_buffer_offsets = p_slot;
+            p_slot += src->count;
+            dst->uniform_buffer_sizes = p_slot;
+            p_slot += src->count;
+            if (NULL != src->uniform_buffer_offsets)
+            {
+                memcpy(dst->uniform_buffer_offsets, src->uniform_buffer_offsets,
+                       src->count * sizeof(uint64_t));
+            }
+            if (NULL != src->uniform_buffer_sizes)
+            {
+                memcpy(dst->uniform_buffer_sizes, src->uniform_buffer_sizes,
+                       src->count * sizeof(uint64_t));
+            }
+        }
+    }
+
     for (uint32_t i = 0; i < descriptor_count; ++i)
     {
         p_descriptor_set->descriptors[i].dx_root_parameter_index = 0xFFFFFFFF;
+
+        if (tr_descriptor_type_uniform_buffer_dynamic_cbv == p_descriptor_set->descriptors[i].type)
+        {
+            p_descriptor_set->dynamic_offset_count += p_descriptor_set->descriptors[i].count;
+        }
     }
+    assert(p_descriptor_set->dynamic_offset_count <= tr_max_dynamic_offsets);
 
     if (p_renderer->api == tr_api_vulkan)
         tr_internal_vk_create_descriptor_set(p_renderer, p_descriptor_set);
     else
         tr_internal_dx_create_descriptor_set(p_renderer, p_descriptor_set);
 
+    if (p_descriptor_pool->transient)
+    {
+        std::lock_guard<std::mutex> lock(p_descriptor_pool->mutex);
+        p_descriptor_pool->transient_sets.push_back(p_descriptor_set);
+    }
+
     *pp_descriptor_set = p_descriptor_set;
 }
 
-void tr_destroy_descriptor_set(tr_renderer* p_renderer, tr_descriptor_set* p_descriptor_set)
+static void tr_internal_destroy_descriptor_set(tr_renderer* p_renderer,
+                                               tr_descriptor_set* p_descriptor_set)
 {
-    TINY_RENDERER_RENDERER_PTR_CHECK(p_renderer);
-    assert(NULL != p_descriptor_set);
-
     delete[] p_descriptor_set->descriptors;
+    delete[] p_descriptor_set->descriptor_arena;
 
     if (p_renderer->api == tr_api_vulkan)
         tr_internal_vk_destroy_descriptor_set(p_renderer, p_descriptor_set);
@@ -160,6 +382,225 @@ void tr_destroy_descriptor_set(tr_renderer* p_renderer, tr_descriptor_set* p_des
     delete p_descriptor_set;
 }
 
+void tr_destroy_descriptor_set(tr_renderer* p_renderer, tr_descriptor_set* p_descriptor_set)
+{
+    TINY_RENDERER_RENDERER_PTR_CHECK(p_renderer);
+    assert(NULL != p_descriptor_set);
+    assert(p_renderer->bindless_descriptor_set != p_descriptor_set);
+    assert(!p_descriptor_set->descriptor_pool->transient);
+
+    tr_internal_destroy_descriptor_set(p_renderer, p_descriptor_set);
+}
+
+// -------------------------------------------------------------------------------------------------
+// Bindless functions
+// -------------------------------------------------------------------------------------------------
+void tr_internal_create_bindless(tr_renderer* p_renderer)
+{
+    if (!p_renderer->settings.bindless)
+    {
+        return;
+    }
+
+    if (p_renderer->api != tr_api_vulkan)
+    {
+        tr_internal_log(tr_log_type_warn, "Bindless tables are only implemented for Vulkan",
+                        "tr_create_renderer");
+        return;
+    }
+
+    if (!p_renderer->vk_device_ext_VK_EXT_descriptor_indexing)
+    {
+        tr_internal_log(tr_log_type_warn,
+                        "Device lacks the descriptor indexing features bindless tables need",
+                        "tr_create_renderer");
+        return;
+    }
+
+    tr_descriptor_set* p_descriptor_set = new tr_descriptor_set();
+    assert(NULL != p_descriptor_set);
+
+    // Entries live in the renderer's tables, not in the descriptors
+    p_descriptor_set->descriptor_count = 2;
+    p_descriptor_set->descriptors = new tr_descriptor[2]();
+
+    tr_descriptor* p_textures = &(p_descriptor_set->descriptors[0]);
+    p_textures->type = tr_descriptor_type_texture_srv;
+    p_textures->binding = 0;
+    p_textures->count = (0 != p_renderer->settings.bindless_texture_count)
+                            ? p_renderer->settings.bindless_texture_count
+                            : tr_bindless_default_texture_count;
+    p_textures->shader_stages =
+        (tr_shader_stage)(tr_shader_stage_all_graphics | tr_shader_stage_comp);
+    p_textures->dx_root_parameter_index = 0xFFFFFFFF;
+
+    tr_descriptor* p_buffers = &(p_descriptor_set->descriptors[1]);
+    p_buffers->type = tr_descriptor_type_storage_buffer_uav;
+    p_buffers->binding = 1;
+    p_buffers->count = (0 != p_renderer->settings.bindless_buffer_count)
+                           ? p_renderer->settings.bindless_buffer_count
+                           : tr_bindless_default_buffer_count;
+    p_buffers->shader_stages = p_textures->shader_stages;
+    p_buffers->dx_root_parameter_index = 0xFFFFFFFF;
+
+    // Counts come back clamped to the device limits
+    tr_internal_vk_create_bindless_descriptor_set(p_renderer, p_descriptor_set);
+
+    p_renderer->bindless_textures.capacity = p_textures->count;
+    p_renderer->bindless_textures.next_index = tr_bindless_invalid_index + 1;
+    p_renderer->bindless_buffers.capacity = p_buffers->count;
+    p_renderer->bindless_buffers.next_index = tr_bindless_invalid_index + 1;
+
+    p_renderer->bindless_descriptor_set = p_descriptor_set;
+}
+
+void tr_internal_destroy_bindless(tr_renderer* p_renderer)
+{
+    tr_descriptor_set* p_descriptor_set = p_renderer->bindless_descriptor_set;
+    if (NULL == p_descriptor_set)
+    {
+        return;
+    }
+
+    tr_internal_vk_destroy_bindless_descriptor_set(p_renderer, p_descriptor_set);
+
+    delete[] p_descriptor_set->descriptors;
+    delete p_descriptor_set;
+    p_renderer->bindless_descriptor_set = NULL;
+}
+
+// Callers hold bindless_mutex
+static uint32_t tr_internal_bindless_acquire(tr_renderer* p_renderer, tr_bindless_table* p_table)
+{
+    // Indices released in frames the GPU has finished can be rewritten
+    std::vector<tr_bindless_retired_index>& retired = p_table->retired_indices;
+    size_t retired_count = 0;
+    while ((retired_count < retired.size()) &&
+           (retired[retired_count].frame_number <= p_renderer->retired_frame_number))
+    {
+        p_table->free_indices.push_back(retired[retired_count].index);
+        ++retired_count;
+    }
+    retired.erase(retired.begin(), retired.begin() + retired_count);
+
+    if (!p_table->free_indices.empty())
+    {
+        uint32_t index = p_table->free_indices.back();
+        p_table->free_indices.pop_back();
+        return index;
+    }
+
+    if (p_table->next_index >= p_table->capacity)
+    {
+        tr_internal_log(tr_log_type_warn, "Bindless table is full, resource was not added",
+                        "tr_internal_bindless_acquire");
+        return tr_bindless_invalid_index;
+    }
+    return p_table->next_index++;
+}
+
+static void tr_internal_bindless_release(tr_renderer* p_renderer, tr_bindless_table* p_table,
+                                         uint32_t index)
+{
+    if (tr_bindless_invalid_index == index)
+    {
+        return;
+    }
+
+    // The old descriptor stays in place until the index is handed out again, which waits for
+    // tr_retire_frames to pass the current frame so no frame in flight reads the new resource
+    std::lock_guard<std::mutex> lock(p_renderer->bindless_mutex);
+    tr_bindless_retired_index retired = {};
+    retired.index = index;
+    retired.frame_number = p_renderer->frame_number;
+    p_table->retired_indices.push_back(retired);
+}
+
+static void tr_internal_bindless_add_buffer(tr_renderer* p_renderer, tr_buffer* p_buffer)
+{
+    if ((NULL == p_renderer->bindless_descriptor_set) ||
+        (0 == (p_buffer->usage & (tr_buffer_usage_storage_srv | tr_buffer_usage_storage_uav))))
+    {
+        return;
+    }
+
+    // The bindless set is shared, so the write has to happen under the lock as well
+    std::lock_guard<std::mutex> lock(p_renderer->bindless_mutex);
+    p_buffer->bindless_index =
+        tr_internal_bindless_acquire(p_renderer, &(p_renderer->bindless_buffers));
+    if (tr_bindless_invalid_index != p_buffer->bindless_index)
+    {
+        tr_internal_vk_update_bindless_buffer(p_renderer, p_buffer);
+    }
+}
+
+static void tr_internal_bindless_add_texture(tr_renderer* p_renderer, tr_texture* p_texture)
+{
+    if ((NULL == p_renderer->bindless_descriptor_set) ||
+        (0 == (p_texture->usage & tr_texture_usage_sampled_image)))
+    {
+        return;
+    }
+
+    // The bindless set is shared, so the write has to happen under the lock as well
+    std::lock_guard<std::mutex> lock(p_renderer->bindless_mutex);
+    p_texture->bindless_index =
+        tr_internal_bindless_acquire(p_renderer, &(p_renderer->bindless_textures));
+    if (tr_bindless_invalid_index != p_texture->bindless_index)
+    {
+        tr_internal_vk_update_bindless_texture(p_renderer, p_texture);
+    }
+}
+
+void tr_create_descriptor_pool(tr_renderer* p_renderer, bool transient, uint32_t sets_per_block,
+                               tr_descriptor_pool** pp_descriptor_pool)
+{
+    TINY_RENDERER_RENDERER_PTR_CHECK(p_renderer);
+    assert(sets_per_block > 0);
+
+    tr_descriptor_pool* p_descriptor_pool = new tr_descriptor_pool();
+    assert(NULL != p_descriptor_pool);
+
+    // Blocks are created on the first allocation that needs one
+    p_descriptor_pool->renderer = p_renderer;
+    p_descriptor_pool->transient = transient;
+    p_descriptor_pool->sets_per_block = sets_per_block;
+
+    *pp_descriptor_pool = p_descriptor_pool;
+}
+
+void tr_destroy_descriptor_pool(tr_renderer* p_renderer, tr_descriptor_pool* p_descriptor_pool)
+{
+    TINY_RENDERER_RENDERER_PTR_CHECK(p_renderer);
+    assert(NULL != p_descriptor_pool);
+
+    if (p_descriptor_pool->transient)
+    {
+        tr_reset_descriptor_pool(p_renderer, p_descriptor_pool);
+    }
+
+    if (p_renderer->api == tr_api_vulkan)
+        tr_internal_vk_destroy_descriptor_pool(p_renderer, p_descriptor_pool);
+
+    delete p_descriptor_pool;
+}
+
+void tr_reset_descriptor_pool(tr_renderer* p_renderer, tr_descriptor_pool* p_descriptor_pool)
+{
+    TINY_RENDERER_RENDERER_PTR_CHECK(p_renderer);
+    assert(NULL != p_descriptor_pool);
+    assert(p_descriptor_pool->transient);
+
+    for (size_t i = 0; i < p_descriptor_pool->transient_sets.size(); ++i)
+    {
+        tr_internal_destroy_descriptor_set(p_renderer, p_descriptor_pool->transient_sets[i]);
+    }
+    p_descriptor_pool->transient_sets.clear();
+
+    if (p_renderer->api == tr_api_vulkan)
+        tr_internal_vk_reset_descriptor_pool(p_renderer, p_descriptor_pool);
+}
+
 void tr_create_cmd_pool(tr_renderer* p_renderer, tr_queue* p_queue, bool transient,
                         tr_cmd_pool** pp_cmd_pool)
 {
@@ -169,6 +610,7 @@ void tr_create_cmd_pool(tr_renderer* p_renderer, tr_queue* p_queue, bool transie
     assert(NULL != p_cmd_pool);
 
     p_cmd_pool->renderer = p_renderer;
+    p_cmd_pool->queue = p_queue;
 
     if (p_renderer->api == tr_api_vulkan)
         tr_internal_vk_create_cmd_pool(p_renderer, p_queue, transient, p_cmd_pool);
@@ -267,6 +709,8 @@ void tr_create_buffer(tr_renderer* p_renderer, tr_buffer_usage usage, uint64_t s
     else
         tr_internal_dx_create_buffer(p_renderer, p_buffer);
 
+    tr_internal_bindless_add_buffer(p_renderer, p_buffer);
+
     *pp_buffer = p_buffer;
 }
 
@@ -318,6 +762,8 @@ void tr_create_structured_buffer(tr_renderer* p_renderer, uint64_t size, uint64_
     else
         tr_internal_dx_create_buffer(p_renderer, p_buffer);
 
+    tr_internal_bindless_add_buffer(p_renderer, p_buffer);
+
     *pp_buffer = p_buffer;
 }
 
@@ -376,6 +822,8 @@ void tr_create_rw_structured_buffer(tr_renderer* p_renderer, uint64_t size, uint
         else
             tr_internal_dx_create_buffer(p_renderer, p_buffer);
 
+        tr_internal_bindless_add_buffer(p_renderer, p_buffer);
+
         *pp_buffer = p_buffer;
     }
 }
@@ -385,6 +833,9 @@ void tr_destroy_buffer(tr_renderer* p_renderer, tr_buffer* p_buffer)
     TINY_RENDERER_RENDERER_PTR_CHECK(p_renderer);
     assert(NULL != p_buffer);
 
+    tr_internal_bindless_release(p_renderer, &(p_renderer->bindless_buffers),
+                                 p_buffer->bindless_index);
+
     if (p_renderer->api == tr_api_vulkan)
         tr_internal_vk_destroy_buffer(p_renderer, p_buffer);
     else
@@ -438,6 +889,8 @@ void tr_create_texture(tr_renderer* p_renderer, tr_texture_type type, uint32_t w
     else
         tr_internal_dx_create_texture(p_renderer, p_texture);
 
+    tr_internal_bindless_add_texture(p_renderer, p_texture);
+
     *pp_texture = p_texture;
 
     if (host_visible)
@@ -484,6 +937,9 @@ void tr_destroy_texture(tr_renderer* p_renderer, tr_texture* p_texture)
     TINY_RENDERER_RENDERER_PTR_CHECK(p_renderer);
     assert(NULL != p_texture);
 
+    tr_internal_bindless_release(p_renderer, &(p_renderer->bindless_textures),
+                                 p_texture->bindless_index);
+
     if (p_renderer->api == tr_api_vulkan)
         tr_internal_vk_destroy_texture(p_renderer, p_texture);
     else
@@ -493,19 +949,82 @@ void tr_destroy_texture(tr_renderer* p_renderer, tr_texture* p_texture)
 }
 
 void tr_create_sampler(tr_renderer* p_renderer, tr_sampler** pp_sampler)
+{
+    tr_sampler_desc desc = {};
+    desc.mag_filter = tr_filter_linear;
+    desc.min_filter = tr_filter_linear;
+    desc.mipmap_mode = tr_mipmap_mode_linear;
+    desc.address_u = tr_address_mode_clamp_to_edge;
+    desc.address_v = tr_address_mode_clamp_to_edge;
+    desc.address_w = tr_address_mode_clamp_to_edge;
+    desc.max_lod = tr_lod_clamp_none;
+    tr_create_sampler_from_desc(p_renderer, &desc, pp_sampler);
+}
+
+// Sampler cache key. Fields are appended one by one so struct padding never ends up in it.
+static std::string tr_internal_sampler_key(const tr_sampler_desc* p_desc)
+{
+    uint32_t values[] = {(uint32_t)p_desc->mag_filter,
+                         (uint32_t)p_desc->min_filter,
+                         (uint32_t)p_desc->mipmap_mode,
+                         (uint32_t)p_desc->address_u,
+                         (uint32_t)p_desc->address_v,
+                         (uint32_t)p_desc->address_w,
+                         p_desc->compare_enable ? 1u : 0u,
+                         (uint32_t)p_desc->compare_op};
+    float lods[] = {p_desc->mip_lod_bias, p_desc->min_lod, p_desc->max_lod,
+                    p_desc->max_anisotropy};
+
+    std::string key((const char*)values, sizeof(values));
+    key.append((const char*)lods, sizeof(lods));
+    return key;
+}
+
+void tr_create_sampler_from_desc(tr_renderer* p_renderer, const tr_sampler_desc* p_desc,
+                                 tr_sampler** pp_sampler)
 {
     TINY_RENDERER_RENDERER_PTR_CHECK(p_renderer);
+    assert(NULL != p_desc);
+    assert(p_desc->min_lod <= p_desc->max_lod);
+
+    // Fields the backends ignore shouldn't split the cache
+    tr_sampler_desc desc = *p_desc;
+    if (desc.max_anisotropy <= 1.0f)
+    {
+        desc.max_anisotropy = 1.0f;
+    }
+    if (!desc.compare_enable)
+    {
+        desc.compare_op = tr_compare_op_never;
+    }
+
+    std::string key = tr_internal_sampler_key(&desc);
+
+    // Creation stays under the lock so two threads asking for the same desc share one sampler
+    std::lock_guard<std::mutex> lock(p_renderer->sampler_mutex);
+    std::unordered_map<std::string, tr_sampler*>::iterator it = p_renderer->samplers.find(key);
+    if (it != p_renderer->samplers.end())
+    {
+        ++it->second->ref_count;
+        *pp_sampler = it->second;
+        return;
+    }
 
     tr_sampler* p_sampler = new tr_sampler();
     assert(NULL != p_sampler);
 
     p_sampler->renderer = p_renderer;
+    p_sampler->desc = desc;
+    p_sampler->ref_count = 1;
+    p_sampler->cache_key = key;
 
     if (p_renderer->api == tr_api_vulkan)
         tr_internal_vk_create_sampler(p_renderer, p_sampler);
     else
         tr_internal_dx_create_sampler(p_renderer, p_sampler);
 
+    p_renderer->samplers[key] = p_sampler;
+
     *pp_sampler = p_sampler;
 }
 
@@ -514,6 +1033,16 @@ void tr_destroy_sampler(tr_renderer* p_renderer, tr_sampler* p_sampler)
     TINY_RENDERER_RENDERER_PTR_CHECK(p_renderer);
     assert(NULL != p_sampler);
 
+    {
+        std::lock_guard<std::mutex> lock(p_renderer->sampler_mutex);
+        assert(p_sampler->ref_count > 0);
+        if (--p_sampler->ref_count > 0)
+        {
+            return;
+        }
+        p_renderer->samplers.erase(p_sampler->cache_key);
+    }
+
     if (p_renderer->api == tr_api_vulkan)
         tr_internal_vk_destroy_sampler(p_renderer, p_sampler);
     else
@@ -560,6 +1089,7 @@ void tr_create_shader_program_n(tr_renderer* p_renderer, uint32_t vert_size, con
     assert(NULL != p_shader_program);
 
     p_shader_program->renderer = p_renderer;
+    p_shader_program->id = ++p_renderer->next_shader_program_id;
     p_shader_program->shader_stages |= (vert_size > 0) ? tr_shader_stage_vert : 0;
     p_shader_program->shader_stages |= (hull_size > 0) ? tr_shader_stage_tesc : 0;
     p_shader_program->shader_stages |= (domn_size > 0) ? tr_shader_stage_tese : 0;
@@ -574,22 +1104,48 @@ void tr_create_shader_program_n(tr_renderer* p_renderer, uint32_t vert_size, con
             domn_code, domn_enpt, geom_size, geom_code, geom_enpt, frag_size, frag_code, frag_enpt,
             comp_size, comp_code, comp_enpt, p_shader_program);
 
-        if (vert_enpt != NULL)
+        tr_shader_reflection* p_reflection = &(p_shader_program->reflection);
+        if (vert_size > 0)
         {
-            p_shader_program->vert_entry_point = vert_enpt;
+            tr_reflect_spirv(vert_size, vert_code, tr_shader_stage_vert, p_reflection);
         }
-
-        if (hull_enpt != NULL)
+        if (hull_size > 0)
         {
-            p_shader_program->tesc_entry_point = hull_enpt;
+            tr_reflect_spirv(hull_size, hull_code, tr_shader_stage_tesc, p_reflection);
         }
-
-        if (domn_enpt != NULL)
+        if (domn_size > 0)
         {
-            p_shader_program->tese_entry_point = domn_enpt;
+            tr_reflect_spirv(domn_size, domn_code, tr_shader_stage_tese, p_reflection);
         }
-
-        if (geom_enpt != NULL)
+        if (geom_size > 0)
+        {
+            tr_reflect_spirv(geom_size, geom_code, tr_shader_stage_geom, p_reflection);
+        }
+        if (frag_size > 0)
+        {
+            tr_reflect_spirv(frag_size, frag_code, tr_shader_stage_frag, p_reflection);
+        }
+        if (comp_size > 0)
+        {
+            tr_reflect_spirv(comp_size, comp_code, tr_shader_stage_comp, p_reflection);
+        }
+
+        if (vert_enpt != NULL)
+        {
+            p_shader_program->vert_entry_point = vert_enpt;
+        }
+
+        if (hull_enpt != NULL)
+        {
+            p_shader_program->tesc_entry_point = hull_enpt;
+        }
+
+        if (domn_enpt != NULL)
+        {
+            p_shader_program->tese_entry_point = domn_enpt;
+        }
+
+        if (geom_enpt != NULL)
         {
             p_shader_program->geom_entry_point = geom_enpt;
         }
@@ -641,57 +1197,361 @@ void tr_destroy_shader_program(tr_renderer* p_renderer, tr_shader_program* p_sha
         tr_internal_dx_destroy_shader_program(p_renderer, p_shader_program);
 }
 
-void tr_create_pipeline(tr_renderer* p_renderer, tr_shader_program* p_shader_program,
-                        const tr_vertex_layout* p_vertex_layout,
-                        tr_descriptor_set* p_descriptor_set, tr_render_target* p_render_target,
-                        const tr_pipeline_settings* p_pipeline_settings, tr_pipeline** pp_pipeline)
+// Pipelines count as warm when the pipeline cache was loaded from disk at startup. Must be called
+// with pipeline_mutex held.
+static void tr_internal_record_pipeline_create(tr_renderer* p_renderer, uint32_t pipeline_count,
+                                               std::chrono::high_resolution_clock::time_point start)
 {
-    TINY_RENDERER_RENDERER_PTR_CHECK(p_renderer);
-    assert(NULL != p_shader_program);
-    assert(NULL != p_render_target);
-    assert(NULL != p_pipeline_settings);
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::high_resolution_clock::now() - start;
+
+    tr_pipeline_stats& stats = p_renderer->pipeline_stats;
+    if (stats.cache_warm)
+    {
+        stats.warm_pipeline_count += pipeline_count;
+        stats.warm_create_ms += elapsed.count();
+    }
+    else
+    {
+        stats.cold_pipeline_count += pipeline_count;
+        stats.cold_create_ms += elapsed.count();
+    }
+}
+
+static void tr_internal_append_key(std::string& key, const void* p_data, size_t size)
+{
+    key.append((const char*)p_data, size);
+}
+
+// Pipeline cache key. Fields are appended one by one so struct padding never ends up in it. Only
+// the layouts of the descriptor sets matter, and only the parts of the render target that make
+// render passes compatible.
+static std::string tr_internal_pipeline_key(tr_pipeline_type type,
+                                            const tr_shader_program* p_shader_program,
+                                            const tr_vertex_layout* p_vertex_layout,
+                                            uint32_t descriptor_set_count,
+                                            tr_descriptor_set* const* pp_descriptor_sets,
+                                            const tr_render_target* p_render_target,
+                                            const tr_pipeline_settings* p_pipeline_settings)
+{
+    std::string key;
+    tr_internal_append_key(key, &type, sizeof(type));
+    tr_internal_append_key(key, &(p_shader_program->id), sizeof(p_shader_program->id));
+
+    uint32_t attrib_count = (NULL != p_vertex_layout) ? p_vertex_layout->attrib_count : 0;
+    tr_internal_append_key(key, &attrib_count, sizeof(attrib_count));
+    for (uint32_t i = 0; i < attrib_count; ++i)
+    {
+        const tr_vertex_attrib* attrib = &(p_vertex_layout->attribs[i]);
+        tr_internal_append_key(key, &(attrib->semantic), sizeof(attrib->semantic));
+        tr_internal_append_key(key, &(attrib->semantic_name_length),
+                               sizeof(attrib->semantic_name_length));
+        tr_internal_append_key(key, attrib->semantic_name, attrib->semantic_name_length);
+        tr_internal_append_key(key, &(attrib->format), sizeof(attrib->format));
+        tr_internal_append_key(key, &(attrib->binding), sizeof(attrib->binding));
+        tr_internal_append_key(key, &(attrib->location), sizeof(attrib->location));
+        tr_internal_append_key(key, &(attrib->offset), sizeof(attrib->offset));
+    }
+
+    tr_internal_append_key(key, &descriptor_set_count, sizeof(descriptor_set_count));
+    for (uint32_t set_index = 0; set_index < descriptor_set_count; ++set_index)
+    {
+        const tr_descriptor_set* p_descriptor_set = pp_descriptor_sets[set_index];
+        uint32_t descriptor_count = p_descriptor_set->descriptor_count;
+        tr_internal_append_key(key, &descriptor_count, sizeof(descriptor_count));
+        for (uint32_t i = 0; i < descriptor_count; ++i)
+        {
+            const tr_descriptor* descriptor = &(p_descriptor_set->descriptors[i]);
+            tr_internal_append_key(key, &(descriptor->type), sizeof(descriptor->type));
+            tr_internal_append_key(key, &(descriptor->binding), sizeof(descriptor->binding));
+            tr_internal_append_key(key, &(descriptor->count), sizeof(descriptor->count));
+            tr_internal_append_key(key, &(descriptor->shader_stages),
+                                   sizeof(descriptor->shader_stages));
+        }
+    }
+
+    if (NULL != p_render_target)
+    {
+        tr_internal_append_key(key, &(p_render_target->sample_count),
+                               sizeof(p_render_target->sample_count));
+        tr_internal_append_key(key, &(p_render_target->color_format),
+                               sizeof(p_render_target->color_format));
+        tr_internal_append_key(key, &(p_render_target->color_attachment_count),
+                               sizeof(p_render_target->color_attachment_count));
+        tr_internal_append_key(key, &(p_render_target->depth_stencil_format),
+                               sizeof(p_render_target->depth_stencil_format));
+    }
+
+    tr_internal_append_key(key, &(p_pipeline_settings->primitive_topo),
+                           sizeof(p_pipeline_settings->primitive_topo));
+    tr_internal_append_key(key, &(p_pipeline_settings->cull_mode),
+                           sizeof(p_pipeline_settings->cull_mode));
+    tr_internal_append_key(key, &(p_pipeline_settings->front_face),
+                           sizeof(p_pipeline_settings->front_face));
+    tr_internal_append_key(key, &(p_pipeline_settings->depth),
+                           sizeof(p_pipeline_settings->depth));
+    tr_internal_append_key(key, &(p_pipeline_settings->tessellation_domain_origin),
+                           sizeof(p_pipeline_settings->tessellation_domain_origin));
+    tr_internal_append_key(key, &(p_pipeline_settings->specialization_constant_count),
+                           sizeof(p_pipeline_settings->specialization_constant_count));
+    for (uint32_t i = 0; i < p_pipeline_settings->specialization_constant_count; ++i)
+    {
+        const tr_specialization_constant* p_constant =
+            &(p_pipeline_settings->specialization_constants[i]);
+        tr_internal_append_key(key, &(p_constant->constant_id), sizeof(p_constant->constant_id));
+        tr_internal_append_key(key, &(p_constant->value), sizeof(p_constant->value));
+    }
+    tr_internal_append_key(key, &(p_pipeline_settings->push_constant_size),
+                           sizeof(p_pipeline_settings->push_constant_size));
+    return key;
+}
+
+// Looks up the pipeline for p_create_info and adds a reference, or adds a new pipeline that isn't
+// ready yet. Returns true when the caller has to compile the pipeline.
+static bool tr_internal_acquire_pipeline(tr_renderer* p_renderer,
+                                         const tr_pipeline_create_info* p_create_info,
+                                         tr_pipeline** pp_pipeline)
+{
+    std::string key = tr_internal_pipeline_key(
+        p_create_info->type, p_create_info->shader_program, p_create_info->vertex_layout,
+        p_create_info->descriptor_set_count, p_create_info->descriptor_sets,
+        p_create_info->render_target, p_create_info->pipeline_settings);
+
+    std::lock_guard<std::mutex> lock(p_renderer->pipeline_mutex);
+    std::unordered_map<std::string, tr_pipeline*>::iterator it = p_renderer->pipelines.find(key);
+    if (it != p_renderer->pipelines.end())
+    {
+        ++it->second->ref_count;
+        ++p_renderer->pipeline_stats.shared_pipeline_count;
+        *pp_pipeline = it->second;
+        return false;
+    }
 
     tr_pipeline* p_pipeline = new tr_pipeline();
     assert(NULL != p_pipeline);
 
-    memcpy(&(p_pipeline->settings), p_pipeline_settings, sizeof(*p_pipeline_settings));
+    p_pipeline->renderer = p_renderer;
+    memcpy(&(p_pipeline->settings), p_create_info->pipeline_settings,
+           sizeof(*p_create_info->pipeline_settings));
+    p_pipeline->type = p_create_info->type;
+    p_pipeline->descriptor_set_count = p_create_info->descriptor_set_count;
+    p_pipeline->ref_count = 1;
+    p_pipeline->cache_key = key;
+    p_renderer->pipelines[key] = p_pipeline;
 
-    if (p_renderer->api == tr_api_vulkan)
-        tr_internal_vk_create_pipeline(p_renderer, p_shader_program, p_vertex_layout,
-                                       p_descriptor_set, p_render_target, p_pipeline_settings,
-                                       p_pipeline);
+    *pp_pipeline = p_pipeline;
+    return true;
+}
+
+#if defined(TINY_RENDERER_MSW)
+static void tr_internal_apply_root_parameter_indices(const tr_pipeline* p_pipeline,
+                                                     uint32_t descriptor_set_count,
+                                                     tr_descriptor_set* const* pp_descriptor_sets)
+{
+    uint32_t index = 0;
+    for (uint32_t set_index = 0; set_index < descriptor_set_count; ++set_index)
+    {
+        tr_descriptor_set* p_descriptor_set = pp_descriptor_sets[set_index];
+        for (uint32_t i = 0; i < p_descriptor_set->descriptor_count; ++i)
+        {
+            p_descriptor_set->descriptors[i].dx_root_parameter_index =
+                p_pipeline->dx_root_parameter_indices[index++];
+        }
+    }
+}
+#endif
+
+// A shared pipeline was created against other descriptor sets. Root signature creation assigns
+// root parameter indices on the sets it's given, so hand them to these sets too. Never blocks,
+// a pipeline that is still compiling applies them when it's marked ready.
+static void tr_internal_share_pipeline(tr_renderer* p_renderer, tr_pipeline* p_pipeline,
+                                       const tr_pipeline_create_info* p_create_info)
+{
+#if defined(TINY_RENDERER_MSW)
+    if ((p_renderer->api == tr_api_d3d12) && (p_create_info->descriptor_set_count > 0))
+    {
+        std::lock_guard<std::mutex> lock(p_renderer->pipeline_mutex);
+        if (!p_pipeline->ready)
+        {
+            p_pipeline->dx_pending_descriptor_sets.insert(
+                p_pipeline->dx_pending_descriptor_sets.end(), p_create_info->descriptor_sets,
+                p_create_info->descriptor_sets + p_create_info->descriptor_set_count);
+            return;
+        }
+        tr_internal_apply_root_parameter_indices(p_pipeline, p_create_info->descriptor_set_count,
+                                                 p_create_info->descriptor_sets);
+    }
+#endif
+}
+
+// Compiles pipelines returned by tr_internal_acquire_pipeline and marks them ready. Vulkan
+// graphics pipelines go through a single vkCreateGraphicsPipelines call.
+static void tr_internal_compile_pipelines(tr_renderer* p_renderer, uint32_t pipeline_count,
+                                          const tr_pipeline_create_info* p_create_infos,
+                                          tr_pipeline** pp_pipelines)
+{
+    std::chrono::high_resolution_clock::time_point start =
+        std::chrono::high_resolution_clock::now();
+
+    std::vector<tr_pipeline_create_info> graphics_infos;
+    std::vector<tr_pipeline*> graphics_pipelines;
+    for (uint32_t i = 0; i < pipeline_count; ++i)
+    {
+        const tr_pipeline_create_info* info = &p_create_infos[i];
+        tr_pipeline* p_pipeline = pp_pipelines[i];
+        if (tr_pipeline_type_graphics == info->type)
+        {
+            if (p_renderer->api == tr_api_vulkan)
+            {
+                graphics_infos.push_back(*info);
+                graphics_pipelines.push_back(p_pipeline);
+            }
+            else
+            {
+                tr_internal_dx_create_pipeline(
+                    p_renderer, info->shader_program, info->vertex_layout,
+                    info->descriptor_set_count, info->descriptor_sets, info->render_target,
+                    info->pipeline_settings, p_pipeline);
+            }
+        }
+        else
+        {
+            if (p_renderer->api == tr_api_vulkan)
+                tr_internal_vk_create_compute_pipeline(
+                    p_renderer, info->shader_program, info->descriptor_set_count,
+                    info->descriptor_sets, info->pipeline_settings, p_pipeline);
+            else
+                tr_internal_dx_create_compute_pipeline(
+                    p_renderer, info->shader_program, info->descriptor_set_count,
+                    info->descriptor_sets, info->pipeline_settings, p_pipeline);
+        }
+    }
+    if (!graphics_infos.empty())
+    {
+        tr_internal_vk_create_pipelines(p_renderer, (uint32_t)graphics_infos.size(),
+                                        graphics_infos.data(), graphics_pipelines.data());
+    }
+
+    std::lock_guard<std::mutex> lock(p_renderer->pipeline_mutex);
+    tr_internal_record_pipeline_create(p_renderer, pipeline_count, start);
+    for (uint32_t i = 0; i < pipeline_count; ++i)
+    {
+        tr_pipeline* p_pipeline = pp_pipelines[i];
+#if defined(TINY_RENDERER_MSW)
+        if (p_renderer->api == tr_api_d3d12)
+        {
+            const tr_pipeline_create_info* info = &p_create_infos[i];
+            for (uint32_t set_index = 0; set_index < info->descriptor_set_count; ++set_index)
+            {
+                tr_descriptor_set* p_descriptor_set = info->descriptor_sets[set_index];
+                for (uint32_t j = 0; j < p_descriptor_set->descriptor_count; ++j)
+                {
+                    p_pipeline->dx_root_parameter_indices.push_back(
+                        p_descriptor_set->descriptors[j].dx_root_parameter_index);
+                }
+            }
+            std::vector<tr_descriptor_set*>& pending = p_pipeline->dx_pending_descriptor_sets;
+            for (size_t first = 0; first < pending.size();
+                 first += p_pipeline->descriptor_set_count)
+            {
+                tr_internal_apply_root_parameter_indices(
+                    p_pipeline, p_pipeline->descriptor_set_count, &pending[first]);
+            }
+            pending.clear();
+        }
+#endif
+        p_pipeline->ready = true;
+    }
+    p_renderer->pipeline_ready_cv.notify_all();
+}
+
+static void tr_internal_create_pipeline(tr_renderer* p_renderer,
+                                        const tr_pipeline_create_info* p_create_info,
+                                        tr_pipeline** pp_pipeline)
+{
+    tr_pipeline* p_pipeline = NULL;
+    if (tr_internal_acquire_pipeline(p_renderer, p_create_info, &p_pipeline))
+    {
+        tr_internal_compile_pipelines(p_renderer, 1, p_create_info, &p_pipeline);
+    }
     else
-        tr_internal_dx_create_pipeline(p_renderer, p_shader_program, p_vertex_layout,
-                                       p_descriptor_set, p_render_target, p_pipeline_settings,
-                                       p_pipeline);
-    p_pipeline->type = tr_pipeline_type_graphics;
+    {
+        tr_internal_share_pipeline(p_renderer, p_pipeline, p_create_info);
+        tr_wait_for_pipeline(p_renderer, p_pipeline);
+    }
 
     *pp_pipeline = p_pipeline;
 }
 
+void tr_create_pipeline(tr_renderer* p_renderer, tr_shader_program* p_shader_program,
+                        const tr_vertex_layout* p_vertex_layout,
+                        tr_descriptor_set* p_descriptor_set, tr_render_target* p_render_target,
+                        const tr_pipeline_settings* p_pipeline_settings, tr_pipeline** pp_pipeline)
+{
+    tr_create_pipeline_n(p_renderer, p_shader_program, p_vertex_layout,
+                         (NULL != p_descriptor_set) ? 1 : 0, &p_descriptor_set, p_render_target,
+                         p_pipeline_settings, pp_pipeline);
+}
+
 void tr_create_compute_pipeline(tr_renderer* p_renderer, tr_shader_program* p_shader_program,
                                 tr_descriptor_set* p_descriptor_set,
                                 const tr_pipeline_settings* p_pipeline_settings,
                                 tr_pipeline** pp_pipeline)
+{
+    tr_create_compute_pipeline_n(p_renderer, p_shader_program, (NULL != p_descriptor_set) ? 1 : 0,
+                                 &p_descriptor_set, p_pipeline_settings, pp_pipeline);
+}
+
+void tr_create_pipeline_n(tr_renderer* p_renderer, tr_shader_program* p_shader_program,
+                          const tr_vertex_layout* p_vertex_layout, uint32_t descriptor_set_count,
+                          tr_descriptor_set** pp_descriptor_sets,
+                          tr_render_target* p_render_target,
+                          const tr_pipeline_settings* p_pipeline_settings,
+                          tr_pipeline** pp_pipeline)
 {
     TINY_RENDERER_RENDERER_PTR_CHECK(p_renderer);
     assert(NULL != p_shader_program);
+    assert(descriptor_set_count <= tr_max_descriptor_sets);
+    assert(NULL != p_render_target);
     assert(NULL != p_pipeline_settings);
 
-    tr_pipeline* p_pipeline = new tr_pipeline();
-    assert(NULL != p_pipeline);
-
-    memcpy(&(p_pipeline->settings), p_pipeline_settings, sizeof(*p_pipeline_settings));
+    tr_pipeline_create_info create_info = {};
+    create_info.type = tr_pipeline_type_graphics;
+    create_info.shader_program = p_shader_program;
+    create_info.vertex_layout = p_vertex_layout;
+    create_info.descriptor_set_count = descriptor_set_count;
+    for (uint32_t i = 0; i < descriptor_set_count; ++i)
+    {
+        assert(NULL != pp_descriptor_sets[i]);
+        create_info.descriptor_sets[i] = pp_descriptor_sets[i];
+    }
+    create_info.render_target = p_render_target;
+    create_info.pipeline_settings = p_pipeline_settings;
+    tr_internal_create_pipeline(p_renderer, &create_info, pp_pipeline);
+}
 
-    if (p_renderer->api == tr_api_vulkan)
-        tr_internal_vk_create_compute_pipeline(p_renderer, p_shader_program, p_descriptor_set,
-                                               p_pipeline_settings, p_pipeline);
-    else
-        tr_internal_dx_create_compute_pipeline(p_renderer, p_shader_program, p_descriptor_set,
-                                               p_pipeline_settings, p_pipeline);
-    p_pipeline->type = tr_pipeline_type_compute;
+void tr_create_compute_pipeline_n(tr_renderer* p_renderer, tr_shader_program* p_shader_program,
+                                  uint32_t descriptor_set_count,
+                                  tr_descriptor_set** pp_descriptor_sets,
+                                  const tr_pipeline_settings* p_pipeline_settings,
+                                  tr_pipeline** pp_pipeline)
+{
+    TINY_RENDERER_RENDERER_PTR_CHECK(p_renderer);
+    assert(NULL != p_shader_program);
+    assert(descriptor_set_count <= tr_max_descriptor_sets);
+    assert(NULL != p_pipeline_settings);
 
-    *pp_pipeline = p_pipeline;
+    tr_pipeline_create_info create_info = {};
+    create_info.type = tr_pipeline_type_compute;
+    create_info.shader_program = p_shader_program;
+    create_info.descriptor_set_count = descriptor_set_count;
+    for (uint32_t i = 0; i < descriptor_set_count; ++i)
+    {
+        assert(NULL != pp_descriptor_sets[i]);
+        create_info.descriptor_sets[i] = pp_descriptor_sets[i];
+    }
+    create_info.pipeline_settings = p_pipeline_settings;
+    tr_internal_create_pipeline(p_renderer, &create_info, pp_pipeline);
 }
 
 void tr_destroy_pipeline(tr_renderer* p_renderer, tr_pipeline* p_pipeline)
@@ -699,6 +1559,17 @@ void tr_destroy_pipeline(tr_renderer* p_renderer, tr_pipeline* p_pipeline)
     TINY_RENDERER_RENDERER_PTR_CHECK(p_renderer);
     assert(NULL != p_pipeline);
 
+    tr_wait_for_pipeline(p_renderer, p_pipeline);
+    {
+        std::lock_guard<std::mutex> lock(p_renderer->pipeline_mutex);
+        assert(p_pipeline->ref_count > 0);
+        if (--p_pipeline->ref_count > 0)
+        {
+            return;
+        }
+        p_renderer->pipelines.erase(p_pipeline->cache_key);
+    }
+
     if (p_renderer->api == tr_api_vulkan)
         tr_internal_vk_destroy_pipeline(p_renderer, p_pipeline);
     else
@@ -707,6 +1578,259 @@ void tr_destroy_pipeline(tr_renderer* p_renderer, tr_pipeline* p_pipeline)
     delete p_pipeline;
 }
 
+// -------------------------------------------------------------------------------------------------
+// Async pipeline functions
+// -------------------------------------------------------------------------------------------------
+// Fixed pool of worker threads running jobs in FIFO order
+struct tr_job_system
+{
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> jobs;
+    std::mutex mutex;
+    std::condition_variable job_cv;
+    bool stop;
+};
+
+static void tr_internal_job_worker(tr_job_system* p_job_system)
+{
+    for (;;)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(p_job_system->mutex);
+            while (!p_job_system->stop && p_job_system->jobs.empty())
+            {
+                p_job_system->job_cv.wait(lock);
+            }
+            // Queued jobs still run after stop so nothing is left half created
+            if (p_job_system->jobs.empty())
+            {
+                return;
+            }
+            job = p_job_system->jobs.front();
+            p_job_system->jobs.pop_front();
+        }
+
+        job();
+    }
+}
+
+static tr_job_system* tr_internal_get_job_system(tr_renderer* p_renderer)
+{
+    if (NULL == p_renderer->job_system)
+    {
+        tr_job_system* p_job_system = new tr_job_system();
+        assert(NULL != p_job_system);
+
+        uint32_t worker_count = tr_max(std::thread::hardware_concurrency(), 2) - 1;
+        for (uint32_t i = 0; i < worker_count; ++i)
+        {
+            p_job_system->workers.push_back(std::thread(tr_internal_job_worker, p_job_system));
+        }
+
+        p_renderer->job_system = p_job_system;
+    }
+    return p_renderer->job_system;
+}
+
+void tr_internal_destroy_job_system(tr_renderer* p_renderer)
+{
+    tr_job_system* p_job_system = p_renderer->job_system;
+    if (NULL == p_job_system)
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(p_job_system->mutex);
+        p_job_system->stop = true;
+    }
+    p_job_system->job_cv.notify_all();
+    for (size_t i = 0; i < p_job_system->workers.size(); ++i)
+    {
+        p_job_system->workers[i].join();
+    }
+
+    delete p_job_system;
+    p_renderer->job_system = NULL;
+}
+
+// Shared by the caller and the jobs of one tr_internal_parallel_for. Jobs can start after the
+// caller returned, they find no range left and only drop their reference.
+struct tr_internal_parallel_for_state
+{
+    std::function<void(uint32_t, uint32_t)> fn;
+    uint32_t count;
+    uint32_t range_size;
+    uint32_t range_count;
+    std::atomic<uint32_t> next_range;
+    std::mutex mutex;
+    std::condition_variable done_cv;
+    uint32_t done_count;
+};
+
+static void tr_internal_parallel_for_run(tr_internal_parallel_for_state* p_state)
+{
+    for (;;)
+    {
+        uint32_t range = p_state->next_range++;
+        if (range >= p_state->range_count)
+        {
+            return;
+        }
+
+        uint32_t first = range * p_state->range_size;
+        p_state->fn(first, tr_min(first + p_state->range_size, p_state->count));
+
+        std::lock_guard<std::mutex> lock(p_state->mutex);
+        if (++(p_state->done_count) == p_state->range_count)
+        {
+            p_state->done_cv.notify_all();
+        }
+    }
+}
+
+void tr_internal_parallel_for(tr_renderer* p_renderer, uint32_t count, uint32_t min_range_size,
+                              const std::function<void(uint32_t, uint32_t)>& fn)
+{
+    assert(NULL != p_renderer);
+    assert(min_range_size > 0);
+
+    // One range per worker plus the calling thread, unless that makes them too small
+    tr_job_system* p_job_system = tr_internal_get_job_system(p_renderer);
+    uint32_t range_count = (uint32_t)p_job_system->workers.size() + 1;
+    range_count = tr_min(range_count, tr_max(count / min_range_size, 1));
+    if (range_count <= 1)
+    {
+        fn(0, count);
+        return;
+    }
+
+    std::shared_ptr<tr_internal_parallel_for_state> state =
+        std::make_shared<tr_internal_parallel_for_state>();
+    state->fn = fn;
+    state->count = count;
+    state->range_size = (count + range_count - 1) / range_count;
+    state->range_count = (count + state->range_size - 1) / state->range_size;
+    state->next_range = 0;
+    state->done_count = 0;
+    {
+        std::lock_guard<std::mutex> lock(p_job_system->mutex);
+        for (uint32_t i = 1; i < state->range_count; ++i)
+        {
+            p_job_system->jobs.push_back([state]() { tr_internal_parallel_for_run(state.get()); });
+        }
+    }
+    p_job_system->job_cv.notify_all();
+
+    // Busy workers don't hold things up, the caller keeps taking ranges until none are left
+    tr_internal_parallel_for_run(state.get());
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    while (state->done_count < state->range_count)
+    {
+        state->done_cv.wait(lock);
+    }
+}
+
+void tr_create_pipelines_async(tr_renderer* p_renderer, uint32_t pipeline_count,
+                               const tr_pipeline_create_info* p_create_infos,
+                               tr_pipeline** pp_pipelines)
+{
+    TINY_RENDERER_RENDERER_PTR_CHECK(p_renderer);
+    assert(NULL != p_create_infos);
+    assert(NULL != pp_pipelines);
+
+    // Vertex layouts are copied so callers can pass temporaries, the settings live in the
+    // pipeline itself
+    std::vector<tr_pipeline_create_info> create_infos;
+    std::vector<tr_vertex_layout> vertex_layouts;
+    std::vector<tr_pipeline*> pipelines;
+    for (uint32_t i = 0; i < pipeline_count; ++i)
+    {
+        const tr_pipeline_create_info* info = &p_create_infos[i];
+        assert(NULL != info->shader_program);
+        assert(NULL != info->pipeline_settings);
+        assert((tr_pipeline_type_compute == info->type) || (NULL != info->render_target));
+
+        if (tr_internal_acquire_pipeline(p_renderer, info, &pp_pipelines[i]))
+        {
+            create_infos.push_back(*info);
+            tr_vertex_layout vertex_layout = {};
+            if (NULL != info->vertex_layout)
+            {
+                vertex_layout = *(info->vertex_layout);
+            }
+            vertex_layouts.push_back(vertex_layout);
+            pipelines.push_back(pp_pipelines[i]);
+        }
+        else
+        {
+            tr_internal_share_pipeline(p_renderer, pp_pipelines[i], info);
+        }
+    }
+
+    if (pipelines.empty())
+    {
+        return;
+    }
+
+    // One job per worker, each batch is a single driver call on Vulkan
+    tr_job_system* p_job_system = tr_internal_get_job_system(p_renderer);
+    size_t worker_count = p_job_system->workers.size();
+    size_t batch_size = (pipelines.size() + worker_count - 1) / worker_count;
+    {
+        std::lock_guard<std::mutex> lock(p_job_system->mutex);
+        for (size_t first = 0; first < pipelines.size(); first += batch_size)
+        {
+            size_t last = tr_min_u64(first + batch_size, pipelines.size());
+            std::vector<tr_pipeline_create_info> batch_infos(create_infos.begin() + first,
+                                                             create_infos.begin() + last);
+            std::vector<tr_vertex_layout> batch_layouts(vertex_layouts.begin() + first,
+                                                        vertex_layouts.begin() + last);
+            std::vector<tr_pipeline*> batch_pipelines(pipelines.begin() + first,
+                                                      pipelines.begin() + last);
+            p_job_system->jobs.push_back(
+                [p_renderer, batch_infos, batch_layouts, batch_pipelines]() mutable {
+                    for (size_t i = 0; i < batch_infos.size(); ++i)
+                    {
+                        batch_infos[i].vertex_layout = &batch_layouts[i];
+                        batch_infos[i].pipeline_settings = &(batch_pipelines[i]->settings);
+                    }
+                    tr_internal_compile_pipelines(p_renderer, (uint32_t)batch_infos.size(),
+                                                  batch_infos.data(), batch_pipelines.data());
+                });
+        }
+    }
+    p_job_system->job_cv.notify_all();
+}
+
+bool tr_is_pipeline_ready(tr_pipeline* p_pipeline)
+{
+    assert(NULL != p_pipeline);
+
+    return p_pipeline->ready;
+}
+
+void tr_wait_for_pipeline(tr_renderer* p_renderer, tr_pipeline* p_pipeline)
+{
+    TINY_RENDERER_RENDERER_PTR_CHECK(p_renderer);
+    assert(NULL != p_pipeline);
+
+    if (p_pipeline->ready)
+    {
+        return;
+    }
+
+    // The pipeline is compiling on a worker or in a synchronous create on another thread, both
+    // mark it ready under pipeline_mutex
+    std::unique_lock<std::mutex> lock(p_renderer->pipeline_mutex);
+    while (!p_pipeline->ready)
+    {
+        p_renderer->pipeline_ready_cv.wait(lock);
+    }
+}
+
 void tr_create_render_target(tr_renderer* p_renderer, uint32_t width, uint32_t height,
                              tr_sample_count sample_count, tr_format color_format,
                              uint32_t color_attachment_count,
@@ -819,12 +1943,515 @@ void tr_destroy_render_target(tr_renderer* p_renderer, tr_render_target* p_rende
 }
 
 // -------------------------------------------------------------------------------------------------
-// Descriptor set functions
+// SPIR-V reflection functions
+// -------------------------------------------------------------------------------------------------
+// The parts of the SPIR-V spec the reflection needs
+enum tr_internal_spirv
+{
+    tr_internal_spirv_magic = 0x07230203,
+    tr_internal_spirv_header_word_count = 5,
+
+    tr_internal_spirv_op_type_bool = 20,
+    tr_internal_spirv_op_type_int = 21,
+    tr_internal_spirv_op_type_float = 22,
+    tr_internal_spirv_op_type_vector = 23,
+    tr_internal_spirv_op_type_matrix = 24,
+    tr_internal_spirv_op_type_image = 25,
+    tr_internal_spirv_op_type_sampler = 26,
+    tr_internal_spirv_op_type_sampled_image = 27,
+    tr_internal_spirv_op_type_array = 28,
+    tr_internal_spirv_op_type_runtime_array = 29,
+    tr_internal_spirv_op_type_struct = 30,
+    tr_internal_spirv_op_type_pointer = 32,
+    tr_internal_spirv_op_constant = 43,
+    tr_internal_spirv_op_spec_constant_true = 48,
+    tr_internal_spirv_op_spec_constant_false = 49,
+    tr_internal_spirv_op_spec_constant = 50,
+    tr_internal_spirv_op_spec_constant_composite = 51,
+    tr_internal_spirv_op_spec_constant_op = 52,
+    tr_internal_spirv_op_variable = 59,
+    tr_internal_spirv_op_decorate = 71,
+    tr_internal_spirv_op_member_decorate = 72,
+    tr_internal_spirv_op_type_acceleration_structure = 5341,
+
+    tr_internal_spirv_decoration_block = 2,
+    tr_internal_spirv_decoration_buffer_block = 3,
+    tr_internal_spirv_decoration_array_stride = 6,
+    tr_internal_spirv_decoration_matrix_stride = 7,
+    tr_internal_spirv_decoration_built_in = 11,
+    tr_internal_spirv_decoration_non_writable = 24,
+    tr_internal_spirv_decoration_location = 30,
+    tr_internal_spirv_decoration_binding = 33,
+    tr_internal_spirv_decoration_descriptor_set = 34,
+    tr_internal_spirv_decoration_offset = 35,
+
+    tr_internal_spirv_storage_class_uniform_constant = 0,
+    tr_internal_spirv_storage_class_input = 1,
+    tr_internal_spirv_storage_class_uniform = 2,
+    tr_internal_spirv_storage_class_push_constant = 9,
+    tr_internal_spirv_storage_class_storage_buffer = 12,
+
+    tr_internal_spirv_dim_buffer = 5,
+    tr_internal_spirv_image_storage = 2,
+};
+
+// Decorations of one id, p_inst points at the instruction that defines it
+struct tr_internal_spirv_id
+{
+    const uint32_t* p_inst;
+    bool has_binding;
+    bool has_location;
+    bool built_in;
+    bool buffer_block;
+    bool non_writable;
+    uint32_t set;
+    uint32_t binding;
+    uint32_t location;
+    uint32_t array_stride;
+    uint32_t non_writable_member_count;
+    std::vector<uint32_t> member_offsets;
+    std::vector<uint32_t> member_matrix_strides;
+};
+
+static uint32_t tr_internal_spirv_opcode(const uint32_t* p_inst) { return p_inst[0] & 0xFFFF; }
+
+static uint32_t tr_internal_spirv_word_count(const uint32_t* p_inst) { return p_inst[0] >> 16; }
+
+static void tr_internal_spirv_set_member(std::vector<uint32_t>& values, uint32_t member,
+                                         uint32_t value)
+{
+    if (values.size() <= member)
+    {
+        values.resize(member + 1);
+    }
+    values[member] = value;
+}
+
+// Array lengths are OpConstant or OpSpecConstant, the latter reads as its default value. Returns
+// false for lengths computed by OpSpecConstantOp.
+static bool tr_internal_spirv_array_length(const std::vector<tr_internal_spirv_id>& ids,
+                                           uint32_t length_id, uint32_t* p_length)
+{
+    const uint32_t* p_inst = ids[length_id].p_inst;
+    const uint32_t opcode = (NULL != p_inst) ? tr_internal_spirv_opcode(p_inst) : 0;
+    if ((tr_internal_spirv_op_constant != opcode) && (tr_internal_spirv_op_spec_constant != opcode))
+    {
+        return false;
+    }
+    *p_length = p_inst[3];
+    return true;
+}
+
+// Byte size of a type as laid out in a block, matrix_stride comes from the member decoration
+static uint32_t tr_internal_spirv_type_size(const std::vector<tr_internal_spirv_id>& ids,
+                                            uint32_t type_id, uint32_t matrix_stride)
+{
+    const tr_internal_spirv_id& type = ids[type_id];
+    const uint32_t* p_inst = type.p_inst;
+    if (NULL == p_inst)
+    {
+        return 0;
+    }
+    switch (tr_internal_spirv_opcode(p_inst))
+    {
+    case tr_internal_spirv_op_type_int:
+    case tr_internal_spirv_op_type_float:
+        return p_inst[2] / 8;
+    case tr_internal_spirv_op_type_vector:
+        return p_inst[3] * tr_internal_spirv_type_size(ids, p_inst[2], 0);
+    case tr_internal_spirv_op_type_matrix:
+        if (0 == matrix_stride)
+        {
+            matrix_stride = tr_internal_spirv_type_size(ids, p_inst[2], 0);
+        }
+        return p_inst[3] * matrix_stride;
+    case tr_internal_spirv_op_type_array:
+    {
+        uint32_t length = 0;
+        tr_internal_spirv_array_length(ids, p_inst[3], &length);
+        uint32_t stride = type.array_stride;
+        if (0 == stride)
+        {
+            stride = tr_internal_spirv_type_size(ids, p_inst[2], matrix_stride);
+        }
+        return length * stride;
+    }
+    case tr_internal_spirv_op_type_struct:
+    {
+        uint32_t size = 0;
+        uint32_t member_count = tr_internal_spirv_word_count(p_inst) - 2;
+        for (uint32_t i = 0; i < member_count; ++i)
+        {
+            uint32_t offset = (i < type.member_offsets.size()) ? type.member_offsets[i] : 0;
+            uint32_t stride =
+                (i < type.member_matrix_strides.size()) ? type.member_matrix_strides[i] : 0;
+            size = tr_max(size, offset + tr_internal_spirv_type_size(ids, p_inst[2 + i], stride));
+        }
+        return size;
+    }
+    }
+    return 0;
+}
+
+static tr_format tr_internal_spirv_input_format(const std::vector<tr_internal_spirv_id>& ids,
+                                                uint32_t type_id)
+{
+    const uint32_t* p_inst = ids[type_id].p_inst;
+    uint32_t component_count = 1;
+    if (tr_internal_spirv_op_type_vector == tr_internal_spirv_opcode(p_inst))
+    {
+        component_count = p_inst[3];
+        p_inst = ids[p_inst[2]].p_inst;
+    }
+    if (32 != p_inst[2])
+    {
+        return tr_format_undefined;
+    }
+
+    bool is_float = (tr_internal_spirv_op_type_float == tr_internal_spirv_opcode(p_inst));
+    switch (component_count)
+    {
+    case 1: return is_float ? tr_format_r32_float : tr_format_r32_uint;
+    case 2: return is_float ? tr_format_r32g32_float : tr_format_r32g32_uint;
+    case 3: return is_float ? tr_format_r32g32b32_float : tr_format_r32g32b32_uint;
+    case 4: return is_float ? tr_format_r32g32b32a32_float : tr_format_r32g32b32a32_uint;
+    }
+    return tr_format_undefined;
+}
+
+static tr_descriptor_type tr_internal_spirv_descriptor_type(
+    const std::vector<tr_internal_spirv_id>& ids, const tr_internal_spirv_id& variable,
+    uint32_t storage_class, uint32_t type_id)
+{
+    const tr_internal_spirv_id& type = ids[type_id];
+    const uint32_t* p_inst = type.p_inst;
+    if (NULL == p_inst)
+    {
+        return tr_descriptor_type_undefined;
+    }
+    switch (storage_class)
+    {
+    case tr_internal_spirv_storage_class_uniform_constant:
+        switch (tr_internal_spirv_opcode(p_inst))
+        {
+        case tr_internal_spirv_op_type_sampler:
+            return tr_descriptor_type_sampler;
+        // Combined image samplers (GLSL sampler2D) have no tr_descriptor_type, textures and
+        // samplers are separate descriptors here
+        case tr_internal_spirv_op_type_sampled_image:
+            return tr_descriptor_type_undefined;
+        case tr_internal_spirv_op_type_image:
+        {
+            bool storage = (tr_internal_spirv_image_storage == p_inst[7]);
+            if (tr_internal_spirv_dim_buffer == p_inst[3])
+            {
+                return storage ? tr_descriptor_type_storage_texel_buffer_uav
+                               : tr_descriptor_type_uniform_texel_buffer_srv;
+            }
+            return storage ? tr_descriptor_type_texture_uav : tr_descriptor_type_texture_srv;
+        }
+        }
+        break;
+    case tr_internal_spirv_storage_class_uniform:
+    case tr_internal_spirv_storage_class_storage_buffer:
+    {
+        if ((tr_internal_spirv_storage_class_uniform == storage_class) && !type.buffer_block)
+        {
+            return tr_descriptor_type_uniform_buffer_cbv;
+        }
+        // Read only buffers have every member marked NonWritable
+        uint32_t member_count = tr_internal_spirv_word_count(p_inst) - 2;
+        bool read_only = variable.non_writable || type.non_writable ||
+                         ((member_count > 0) && (type.non_writable_member_count == member_count));
+        return read_only ? tr_descriptor_type_storage_buffer_srv
+                         : tr_descriptor_type_storage_buffer_uav;
+    }
+    }
+    return tr_descriptor_type_undefined;
+}
+
+static void tr_internal_add_shader_binding(tr_shader_reflection* p_reflection,
+                                           const tr_shader_binding& binding)
+{
+    for (size_t i = 0; i < p_reflection->bindings.size(); ++i)
+    {
+        tr_shader_binding& existing = p_reflection->bindings[i];
+        if ((existing.set == binding.set) && (existing.binding == binding.binding))
+        {
+            assert(existing.type == binding.type);
+            existing.shader_stages |= binding.shader_stages;
+            return;
+        }
+    }
+    p_reflection->bindings.push_back(binding);
+}
+
+void tr_reflect_spirv(uint32_t code_size, const void* code, tr_shader_stage shader_stage,
+                      tr_shader_reflection* p_reflection)
+{
+    assert(NULL != code);
+    assert(NULL != p_reflection);
+
+    const uint32_t* p_words = (const uint32_t*)code;
+    uint32_t word_count = code_size / sizeof(uint32_t);
+    assert(word_count >= tr_internal_spirv_header_word_count);
+    assert(tr_internal_spirv_magic == p_words[0]);
+
+    // Word 3 is the bound of all ids in the module
+    std::vector<tr_internal_spirv_id> ids(p_words[3]);
+    std::vector<uint32_t> variable_ids;
+    for (uint32_t i = tr_internal_spirv_header_word_count; i < word_count;)
+    {
+        const uint32_t* p_inst = p_words + i;
+        uint32_t inst_word_count = tr_internal_spirv_word_count(p_inst);
+        assert((inst_word_count > 0) && (i + inst_word_count <= word_count));
+
+        switch (tr_internal_spirv_opcode(p_inst))
+        {
+        case tr_internal_spirv_op_type_bool:
+        case tr_internal_spirv_op_type_int:
+        case tr_internal_spirv_op_type_float:
+        case tr_internal_spirv_op_type_vector:
+        case tr_internal_spirv_op_type_matrix:
+        case tr_internal_spirv_op_type_image:
+        case tr_internal_spirv_op_type_sampler:
+        case tr_internal_spirv_op_type_sampled_image:
+        case tr_internal_spirv_op_type_array:
+        case tr_internal_spirv_op_type_runtime_array:
+        case tr_internal_spirv_op_type_struct:
+        case tr_internal_spirv_op_type_pointer:
+        case tr_internal_spirv_op_type_acceleration_structure:
+            ids[p_inst[1]].p_inst = p_inst;
+            break;
+        case tr_internal_spirv_op_constant:
+        case tr_internal_spirv_op_spec_constant_true:
+        case tr_internal_spirv_op_spec_constant_false:
+        case tr_internal_spirv_op_spec_constant:
+        case tr_internal_spirv_op_spec_constant_composite:
+        case tr_internal_spirv_op_spec_constant_op:
+            ids[p_inst[2]].p_inst = p_inst;
+            break;
+        case tr_internal_spirv_op_variable:
+            ids[p_inst[2]].p_inst = p_inst;
+            variable_ids.push_back(p_inst[2]);
+            break;
+        case tr_internal_spirv_op_decorate:
+        {
+            tr_internal_spirv_id& id = ids[p_inst[1]];
+            uint32_t literal = (inst_word_count > 3) ? p_inst[3] : 0;
+            switch (p_inst[2])
+            {
+            case tr_internal_spirv_decoration_buffer_block: id.buffer_block = true; break;
+            case tr_internal_spirv_decoration_array_stride: id.array_stride = literal; break;
+            case tr_internal_spirv_decoration_built_in: id.built_in = true; break;
+            case tr_internal_spirv_decoration_non_writable: id.non_writable = true; break;
+            case tr_internal_spirv_decoration_descriptor_set: id.set = literal; break;
+            case tr_internal_spirv_decoration_binding:
+                id.has_binding = true;
+                id.binding = literal;
+                break;
+            case tr_internal_spirv_decoration_location:
+                id.has_location = true;
+                id.location = literal;
+                break;
+            }
+        }
+        break;
+        case tr_internal_spirv_op_member_decorate:
+        {
+            tr_internal_spirv_id& id = ids[p_inst[1]];
+            uint32_t member = p_inst[2];
+            uint32_t literal = (inst_word_count > 4) ? p_inst[4] : 0;
+            switch (p_inst[3])
+            {
+            case tr_internal_spirv_decoration_offset:
+                tr_internal_spirv_set_member(id.member_offsets, member, literal);
+                break;
+            case tr_internal_spirv_decoration_matrix_stride:
+                tr_internal_spirv_set_member(id.member_matrix_strides, member, literal);
+                break;
+            case tr_internal_spirv_decoration_non_writable: ++id.non_writable_member_count; break;
+            // Built in blocks such as gl_PerVertex aren't user inputs
+            case tr_internal_spirv_decoration_built_in: id.built_in = true; break;
+            }
+        }
+        break;
+        }
+
+        i += inst_word_count;
+    }
+
+    for (size_t i = 0; i < variable_ids.size(); ++i)
+    {
+        const tr_internal_spirv_id& variable = ids[variable_ids[i]];
+        uint32_t storage_class = variable.p_inst[3];
+        const uint32_t* p_pointer = ids[variable.p_inst[1]].p_inst;
+        assert(tr_internal_spirv_op_type_pointer == tr_internal_spirv_opcode(p_pointer));
+        uint32_t type_id = p_pointer[3];
+
+        if (tr_internal_spirv_storage_class_push_constant == storage_class)
+        {
+            const tr_internal_spirv_id& type = ids[type_id];
+            uint32_t offset = UINT32_MAX;
+            for (size_t j = 0; j < type.member_offsets.size(); ++j)
+            {
+                offset = tr_min(offset, type.member_offsets[j]);
+            }
+            offset = (UINT32_MAX == offset) ? 0 : offset;
+
+            tr_shader_push_constant_range range = {};
+            range.offset = offset;
+            range.size = tr_internal_spirv_type_size(ids, type_id, 0) - offset;
+            range.shader_stages = shader_stage;
+            p_reflection->push_constant_ranges.push_back(range);
+            continue;
+        }
+
+        if (tr_internal_spirv_storage_class_input == storage_class)
+        {
+            if ((tr_shader_stage_vert == shader_stage) && variable.has_location &&
+                !variable.built_in && !ids[type_id].built_in)
+            {
+                tr_shader_input input = {};
+                input.location = variable.location;
+                input.format = tr_internal_spirv_input_format(ids, type_id);
+                p_reflection->vertex_inputs.push_back(input);
+            }
+            continue;
+        }
+
+        if (!variable.has_binding)
+        {
+            continue;
+        }
+
+        // Arrays of descriptors
+        uint32_t count = 1;
+        bool known_count = true;
+        const uint32_t* p_type = ids[type_id].p_inst;
+        const uint32_t type_opcode = (NULL != p_type) ? tr_internal_spirv_opcode(p_type) : 0;
+        if (tr_internal_spirv_op_type_array == type_opcode)
+        {
+            known_count = tr_internal_spirv_array_length(ids, p_type[3], &count);
+            type_id = p_type[2];
+        }
+        else if (tr_internal_spirv_op_type_runtime_array == type_opcode)
+        {
+            count = 0;
+            type_id = p_type[2];
+        }
+
+        tr_shader_binding binding = {};
+        binding.set = variable.set;
+        binding.binding = variable.binding;
+        binding.type = tr_internal_spirv_descriptor_type(ids, variable, storage_class, type_id);
+        binding.count = count;
+        binding.shader_stages = shader_stage;
+        // Acceleration structures, combined image samplers, arrays sized by spec constant
+        // expressions and other types without a tr_descriptor_type are left out
+        if (!known_count || (tr_descriptor_type_undefined == binding.type))
+        {
+            char msg[128];
+            snprintf(msg, sizeof(msg), "Skipped set %u binding %u, its type isn't supported",
+                     binding.set, binding.binding);
+            tr_internal_log(tr_log_type_warn, msg, "tr_reflect_spirv");
+            continue;
+        }
+        tr_internal_add_shader_binding(p_reflection, binding);
+    }
+
+    std::sort(p_reflection->bindings.begin(), p_reflection->bindings.end(),
+              [](const tr_shader_binding& a, const tr_shader_binding& b) {
+                  return (a.set != b.set) ? (a.set < b.set) : (a.binding < b.binding);
+              });
+    std::sort(p_reflection->vertex_inputs.begin(), p_reflection->vertex_inputs.end(),
+              [](const tr_shader_input& a, const tr_shader_input& b) {
+                  return a.location < b.location;
+              });
+    p_reflection->reflected = true;
+}
+
+void tr_create_descriptor_set_from_program(tr_renderer* p_renderer,
+                                           const tr_shader_program* p_shader_program, uint32_t set,
+                                           tr_descriptor_set** pp_descriptor_set)
+{
+    TINY_RENDERER_RENDERER_PTR_CHECK(p_renderer);
+    assert(NULL != p_shader_program);
+    assert(p_shader_program->reflection.reflected);
+
+    const std::vector<tr_shader_binding>& bindings = p_shader_program->reflection.bindings;
+    std::vector<tr_descriptor> descriptors;
+    for (size_t i = 0; i < bindings.size(); ++i)
+    {
+        if (bindings[i].set != set)
+        {
+            continue;
+        }
+        // Runtime sized arrays need a count from the caller
+        assert(bindings[i].count > 0);
+
+        tr_descriptor descriptor = {};
+        descriptor.type = bindings[i].type;
+        descriptor.binding = bindings[i].binding;
+        descriptor.count = bindings[i].count;
+        descriptor.shader_stages = (tr_shader_stage)bindings[i].shader_stages;
+        descriptors.push_back(descriptor);
+    }
+
+    tr_create_descriptor_set(p_renderer, (uint32_t)descriptors.size(), descriptors.data(),
+                             pp_descriptor_set);
+}
+
+tr_shader_stage tr_get_binding_shader_stages(const tr_shader_program* p_shader_program,
+                                             uint32_t set, uint32_t binding,
+                                             tr_shader_stage default_stages)
+{
+    assert(NULL != p_shader_program);
+
+    const std::vector<tr_shader_binding>& bindings = p_shader_program->reflection.bindings;
+    for (size_t i = 0; i < bindings.size(); ++i)
+    {
+        if ((bindings[i].set == set) && (bindings[i].binding == binding))
+        {
+            return (tr_shader_stage)bindings[i].shader_stages;
+        }
+    }
+    return default_stages;
+}
+
+void tr_get_vertex_layout(const tr_shader_program* p_shader_program,
+                          tr_vertex_layout* p_vertex_layout)
+{
+    assert(NULL != p_shader_program);
+    assert(NULL != p_vertex_layout);
+    assert(p_shader_program->reflection.reflected);
+
+    const std::vector<tr_shader_input>& inputs = p_shader_program->reflection.vertex_inputs;
+    assert(inputs.size() <= tr_max_vertex_attribs);
+
+    *p_vertex_layout = {};
+    uint32_t offset = 0;
+    for (size_t i = 0; i < inputs.size(); ++i)
+    {
+        tr_vertex_attrib& attrib = p_vertex_layout->attribs[i];
+        attrib.format = inputs[i].format;
+        attrib.binding = 0;
+        attrib.location = inputs[i].location;
+        attrib.offset = offset;
+        offset += tr_util_format_stride(inputs[i].format);
+    }
+    p_vertex_layout->attrib_count = (uint32_t)inputs.size();
+}
+
+// -------------------------------------------------------------------------------------------------
+// Descriptor set functions
 // -------------------------------------------------------------------------------------------------
 void tr_update_descriptor_set(tr_renderer* p_renderer, tr_descriptor_set* p_descriptor_set)
 {
     assert(NULL != p_renderer);
     assert(NULL != p_descriptor_set);
+    // The bindless set is written as resources are created
+    assert(p_renderer->bindless_descriptor_set != p_descriptor_set);
 
     if (p_renderer->api == tr_api_vulkan)
         tr_internal_vk_update_descriptor_set(p_renderer, p_descriptor_set);
@@ -832,6 +2459,289 @@ void tr_update_descriptor_set(tr_renderer* p_renderer, tr_descriptor_set* p_desc
         tr_internal_dx_update_descriptor_set(p_renderer, p_descriptor_set);
 }
 
+// -------------------------------------------------------------------------------------------------
+// Linear allocator functions
+// -------------------------------------------------------------------------------------------------
+void tr_create_linear_allocator(tr_renderer* p_renderer, uint64_t frame_size, uint32_t frame_count,
+                                tr_linear_allocator** pp_allocator)
+{
+    TINY_RENDERER_RENDERER_PTR_CHECK(p_renderer);
+    assert(frame_size > 0);
+    assert(frame_count > 0);
+
+    tr_linear_allocator* p_allocator = new tr_linear_allocator();
+    assert(NULL != p_allocator);
+
+    p_allocator->renderer = p_renderer;
+    p_allocator->frame_count = frame_count;
+
+    // D3D12 requires constant buffer views to be placed at multiples of 256 bytes
+    p_allocator->alignment = 256;
+    if (p_renderer->api == tr_api_vulkan)
+    {
+        p_allocator->alignment =
+            tr_max_u64(p_allocator->alignment,
+                       p_renderer->vk_active_gpu_properties.limits.minUniformBufferOffsetAlignment);
+    }
+    p_allocator->frame_size =
+        ((frame_size + p_allocator->alignment - 1) / p_allocator->alignment) *
+        p_allocator->alignment;
+
+    tr_create_uniform_buffer(p_renderer, p_allocator->frame_size * frame_count, true,
+                             &(p_allocator->buffer));
+    assert(NULL != p_allocator->buffer);
+    assert(NULL != p_allocator->buffer->cpu_mapped_address);
+
+    tr_linear_allocator_reset(p_allocator, 0);
+
+    *pp_allocator = p_allocator;
+}
+
+void tr_destroy_linear_allocator(tr_renderer* p_renderer, tr_linear_allocator* p_allocator)
+{
+    TINY_RENDERER_RENDERER_PTR_CHECK(p_renderer);
+    assert(NULL != p_allocator);
+
+    tr_destroy_buffer(p_renderer, p_allocator->buffer);
+
+    delete p_allocator;
+}
+
+void tr_linear_allocator_reset(tr_linear_allocator* p_allocator, uint32_t frame_index)
+{
+    assert(NULL != p_allocator);
+
+    p_allocator->frame_index = frame_index % p_allocator->frame_count;
+    p_allocator->offset = (uint64_t)p_allocator->frame_index * p_allocator->frame_size;
+}
+
+bool tr_linear_allocator_alloc(tr_linear_allocator* p_allocator, uint64_t size,
+                               tr_linear_allocation* p_allocation)
+{
+    assert(NULL != p_allocator);
+    assert(NULL != p_allocation);
+
+    uint64_t aligned_size =
+        ((size + p_allocator->alignment - 1) / p_allocator->alignment) * p_allocator->alignment;
+    uint64_t frame_end = (uint64_t)(p_allocator->frame_index + 1) * p_allocator->frame_size;
+    if ((p_allocator->offset + aligned_size) > frame_end)
+    {
+        tr_internal_log(tr_log_type_warn, "Out of space for this frame",
+                        "tr_linear_allocator_alloc");
+        return false;
+    }
+
+    p_allocation->buffer = p_allocator->buffer;
+    p_allocation->offset = p_allocator->offset;
+    p_allocation->size = aligned_size;
+    p_allocation->cpu_mapped_address =
+        (uint8_t*)p_allocator->buffer->cpu_mapped_address + p_allocator->offset;
+
+    p_allocator->offset += aligned_size;
+
+    return true;
+}
+
+// -------------------------------------------------------------------------------------------------
+// Frame context functions
+// -------------------------------------------------------------------------------------------------
+void tr_create_frame_context(tr_renderer* p_renderer, uint32_t frame_count,
+                             tr_frame_context** pp_frame_context)
+{
+    TINY_RENDERER_RENDERER_PTR_CHECK(p_renderer);
+    assert(frame_count > 0);
+
+    tr_frame_context* p_frame_context = new tr_frame_context();
+    assert(NULL != p_frame_context);
+
+    p_frame_context->renderer = p_renderer;
+    p_frame_context->frame_count = frame_count;
+    // The first begin moves to slot 0
+    p_frame_context->frame_index = frame_count - 1;
+
+    p_frame_context->cmd_pools.resize(frame_count);
+    p_frame_context->cmds.resize(frame_count);
+    p_frame_context->submit_fences.resize(frame_count);
+    p_frame_context->image_acquired_semaphores.resize(frame_count);
+    p_frame_context->render_complete_semaphores.resize(frame_count);
+    p_frame_context->descriptor_pools.resize(frame_count);
+    for (uint32_t i = 0; i < frame_count; ++i)
+    {
+        // One pool per slot so a slot's commands can be reset while other slots are in flight
+        tr_create_cmd_pool(p_renderer, p_renderer->graphics_queue, false,
+                           &(p_frame_context->cmd_pools[i]));
+        tr_create_cmd(p_frame_context->cmd_pools[i], false, &(p_frame_context->cmds[i]));
+        tr_create_fence(p_renderer, &(p_frame_context->submit_fences[i]));
+        tr_create_semaphore(p_renderer, &(p_frame_context->image_acquired_semaphores[i]));
+        tr_create_semaphore(p_renderer, &(p_frame_context->render_complete_semaphores[i]));
+        tr_create_descriptor_pool(p_renderer, true, tr_descriptor_pool_block_set_count,
+                                  &(p_frame_context->descriptor_pools[i]));
+    }
+
+    *pp_frame_context = p_frame_context;
+}
+
+void tr_destroy_frame_context(tr_renderer* p_renderer, tr_frame_context* p_frame_context)
+{
+    TINY_RENDERER_RENDERER_PTR_CHECK(p_renderer);
+    assert(NULL != p_frame_context);
+
+    for (uint32_t i = 0; i < p_frame_context->frame_count; ++i)
+    {
+        tr_wait_for_fence(p_renderer, p_frame_context->submit_fences[i]);
+    }
+    // Presents may still be waiting on the render complete semaphores
+    tr_queue_wait_idle(p_renderer->present_queue);
+    tr_retire_frames(p_renderer, p_frame_context->frame_number);
+
+    for (uint32_t i = 0; i < p_frame_context->frame_count; ++i)
+    {
+        tr_destroy_descriptor_pool(p_renderer, p_frame_context->descriptor_pools[i]);
+        tr_destroy_semaphore(p_renderer, p_frame_context->render_complete_semaphores[i]);
+        tr_destroy_semaphore(p_renderer, p_frame_context->image_acquired_semaphores[i]);
+        tr_destroy_fence(p_renderer, p_frame_context->submit_fences[i]);
+        tr_destroy_cmd(p_frame_context->cmd_pools[i], p_frame_context->cmds[i]);
+        tr_destroy_cmd_pool(p_renderer, p_frame_context->cmd_pools[i]);
+    }
+
+    delete p_frame_context;
+}
+
+tr_cmd* tr_frame_context_begin(tr_frame_context* p_frame_context)
+{
+    assert(NULL != p_frame_context);
+
+    tr_renderer* p_renderer = p_frame_context->renderer;
+    uint32_t frame_index = (p_frame_context->frame_index + 1) % p_frame_context->frame_count;
+    p_frame_context->frame_index = frame_index;
+    ++p_frame_context->frame_number;
+
+    // The slot's command buffer and uniform data are only free once its last submit retired
+    tr_fence* p_fence = p_frame_context->submit_fences[frame_index];
+    if (!tr_get_fence_status(p_renderer, p_fence))
+    {
+        ++p_frame_context->stall_count;
+        tr_wait_for_fence(p_renderer, p_fence);
+    }
+    tr_reset_fence(p_renderer, p_fence);
+    tr_reset_descriptor_pool(p_renderer, p_frame_context->descriptor_pools[frame_index]);
+
+    // Frames complete in submission order, so everything up to the slot's last frame is done
+    if (p_frame_context->frame_number > p_frame_context->frame_count)
+    {
+        tr_retire_frames(p_renderer,
+                         p_frame_context->frame_number - p_frame_context->frame_count);
+    }
+    p_renderer->frame_number = p_frame_context->frame_number;
+
+    tr_acquire_next_image(p_renderer, p_frame_context->image_acquired_semaphores[frame_index],
+                          NULL);
+
+    tr_cmd* p_cmd = p_frame_context->cmds[frame_index];
+    tr_begin_cmd(p_cmd);
+    return p_cmd;
+}
+
+void tr_frame_context_end(tr_frame_context* p_frame_context)
+{
+    assert(NULL != p_frame_context);
+
+    tr_renderer* p_renderer = p_frame_context->renderer;
+    uint32_t frame_index = p_frame_context->frame_index;
+    tr_cmd* p_cmd = p_frame_context->cmds[frame_index];
+    tr_end_cmd(p_cmd);
+
+    tr_semaphore* p_image_acquired = p_frame_context->image_acquired_semaphores[frame_index];
+    tr_semaphore* p_render_complete = p_frame_context->render_complete_semaphores[frame_index];
+    tr_queue_submit(p_renderer->graphics_queue, 1, &p_cmd, 1, &p_image_acquired, 1,
+                    &p_render_complete, p_frame_context->submit_fences[frame_index]);
+    tr_queue_present(p_renderer->present_queue, 1, &p_render_complete);
+}
+
+// -------------------------------------------------------------------------------------------------
+// Deferred destruction functions
+// -------------------------------------------------------------------------------------------------
+static void tr_internal_defer_destroy(tr_renderer* p_renderer, tr_deferred_destroy_type type,
+                                      void* p_object)
+{
+    tr_deferred_destroy deferred = {};
+    deferred.type = type;
+    deferred.frame_number = p_renderer->frame_number;
+    deferred.object = p_object;
+    p_renderer->deferred_destroys.push_back(deferred);
+}
+
+void tr_destroy_buffer_deferred(tr_renderer* p_renderer, tr_buffer* p_buffer)
+{
+    TINY_RENDERER_RENDERER_PTR_CHECK(p_renderer);
+    assert(NULL != p_buffer);
+
+    tr_internal_defer_destroy(p_renderer, tr_deferred_destroy_type_buffer, p_buffer);
+}
+
+void tr_destroy_texture_deferred(tr_renderer* p_renderer, tr_texture* p_texture)
+{
+    TINY_RENDERER_RENDERER_PTR_CHECK(p_renderer);
+    assert(NULL != p_texture);
+
+    tr_internal_defer_destroy(p_renderer, tr_deferred_destroy_type_texture, p_texture);
+}
+
+void tr_destroy_pipeline_deferred(tr_renderer* p_renderer, tr_pipeline* p_pipeline)
+{
+    TINY_RENDERER_RENDERER_PTR_CHECK(p_renderer);
+    assert(NULL != p_pipeline);
+
+    tr_internal_defer_destroy(p_renderer, tr_deferred_destroy_type_pipeline, p_pipeline);
+}
+
+void tr_destroy_descriptor_set_deferred(tr_renderer* p_renderer,
+                                        tr_descriptor_set* p_descriptor_set)
+{
+    TINY_RENDERER_RENDERER_PTR_CHECK(p_renderer);
+    assert(NULL != p_descriptor_set);
+
+    tr_internal_defer_destroy(p_renderer, tr_deferred_destroy_type_descriptor_set,
+                              p_descriptor_set);
+}
+
+void tr_retire_frames(tr_renderer* p_renderer, uint64_t retired_frame_number)
+{
+    TINY_RENDERER_RENDERER_PTR_CHECK(p_renderer);
+
+    p_renderer->retired_frame_number =
+        tr_max_u64(p_renderer->retired_frame_number, retired_frame_number);
+
+    std::vector<tr_deferred_destroy>& deferred_destroys = p_renderer->deferred_destroys;
+    size_t count = 0;
+    while ((count < deferred_destroys.size()) &&
+           (deferred_destroys[count].frame_number <= p_renderer->retired_frame_number))
+    {
+        ++count;
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const tr_deferred_destroy& deferred = deferred_destroys[i];
+        switch (deferred.type)
+        {
+        case tr_deferred_destroy_type_buffer:
+            tr_destroy_buffer(p_renderer, (tr_buffer*)deferred.object);
+            break;
+        case tr_deferred_destroy_type_texture:
+            tr_destroy_texture(p_renderer, (tr_texture*)deferred.object);
+            break;
+        case tr_deferred_destroy_type_pipeline:
+            tr_destroy_pipeline(p_renderer, (tr_pipeline*)deferred.object);
+            break;
+        case tr_deferred_destroy_type_descriptor_set:
+            tr_destroy_descriptor_set(p_renderer, (tr_descriptor_set*)deferred.object);
+            break;
+        }
+    }
+    deferred_destroys.erase(deferred_destroys.begin(), deferred_destroys.begin() + count);
+}
+
 // -------------------------------------------------------------------------------------------------
 // Command buffer functions
 // -------------------------------------------------------------------------------------------------
@@ -946,12 +2856,69 @@ void tr_cmd_bind_descriptor_sets(tr_cmd* p_cmd, tr_pipeline* p_pipeline,
 {
     assert(NULL != p_cmd);
     assert(NULL != p_pipeline);
-    assert(NULL != p_descriptor_set);
+    assert(NULL != p_descriptor_set);
+
+    tr_cmd_bind_descriptor_sets_n(p_cmd, p_pipeline, 0, 1, &p_descriptor_set, 0, NULL);
+}
+
+void tr_cmd_bind_descriptor_sets_dynamic(tr_cmd* p_cmd, tr_pipeline* p_pipeline,
+                                         tr_descriptor_set* p_descriptor_set,
+                                         uint32_t dynamic_offset_count,
+                                         const uint32_t* p_dynamic_offsets)
+{
+    assert(NULL != p_cmd);
+    assert(NULL != p_pipeline);
+    assert(NULL != p_descriptor_set);
+    assert(dynamic_offset_count == p_descriptor_set->dynamic_offset_count);
+
+    tr_cmd_bind_descriptor_sets_n(p_cmd, p_pipeline, 0, 1, &p_descriptor_set,
+                                  dynamic_offset_count, p_dynamic_offsets);
+}
+
+void tr_cmd_bind_descriptor_sets_n(tr_cmd* p_cmd, tr_pipeline* p_pipeline, uint32_t first_set,
+                                   uint32_t descriptor_set_count,
+                                   tr_descriptor_set** pp_descriptor_sets,
+                                   uint32_t dynamic_offset_count,
+                                   const uint32_t* p_dynamic_offsets)
+{
+    assert(NULL != p_cmd);
+    assert(NULL != p_pipeline);
+    assert(NULL != pp_descriptor_sets);
+    assert((first_set + descriptor_set_count) <= p_pipeline->descriptor_set_count);
+    assert((0 == dynamic_offset_count) || (NULL != p_dynamic_offsets));
+
+    uint32_t set_dynamic_offset_count = 0;
+    for (uint32_t i = 0; i < descriptor_set_count; ++i)
+    {
+        assert(NULL != pp_descriptor_sets[i]);
+        set_dynamic_offset_count += pp_descriptor_sets[i]->dynamic_offset_count;
+    }
+    assert((0 == dynamic_offset_count) || (dynamic_offset_count == set_dynamic_offset_count));
+    (void)set_dynamic_offset_count;
+
+    if (p_cmd->cmd_pool->renderer->api == tr_api_vulkan)
+        tr_internal_vk_cmd_bind_descriptor_sets(p_cmd, p_pipeline, first_set, descriptor_set_count,
+                                                pp_descriptor_sets, dynamic_offset_count,
+                                                p_dynamic_offsets);
+    else
+        tr_internal_dx_cmd_bind_descriptor_sets(p_cmd, p_pipeline, first_set, descriptor_set_count,
+                                                pp_descriptor_sets, dynamic_offset_count,
+                                                p_dynamic_offsets);
+}
+
+void tr_cmd_push_constants(tr_cmd* p_cmd, tr_pipeline* p_pipeline, uint32_t offset, uint32_t size,
+                           const void* p_data)
+{
+    assert(NULL != p_cmd);
+    assert(NULL != p_pipeline);
+    assert(NULL != p_data);
+    assert(((offset % 4) == 0) && ((size % 4) == 0));
+    assert(offset + size <= p_pipeline->settings.push_constant_size);
 
     if (p_cmd->cmd_pool->renderer->api == tr_api_vulkan)
-        tr_internal_vk_cmd_bind_descriptor_sets(p_cmd, p_pipeline, p_descriptor_set);
+        tr_internal_vk_cmd_push_constants(p_cmd, p_pipeline, offset, size, p_data);
     else
-        tr_internal_dx_cmd_bind_descriptor_sets(p_cmd, p_pipeline, p_descriptor_set);
+        tr_internal_dx_cmd_push_constants(p_cmd, p_pipeline, offset, size, p_data);
 }
 
 void tr_cmd_bind_index_buffer(tr_cmd* p_cmd, tr_buffer* p_buffer)
@@ -1030,6 +2997,40 @@ void tr_cmd_image_transition(tr_cmd* p_cmd, tr_texture* p_texture, tr_texture_us
         tr_internal_dx_cmd_image_transition(p_cmd, p_texture, old_usage, new_usage);
 }
 
+void tr_cmd_buffer_transition_queue(tr_cmd* p_cmd, tr_buffer* p_buffer, tr_buffer_usage old_usage,
+                                    tr_buffer_usage new_usage, tr_queue* p_src_queue,
+                                    tr_queue* p_dst_queue)
+{
+    assert(NULL != p_cmd);
+    assert(NULL != p_buffer);
+    assert(NULL != p_src_queue);
+    assert(NULL != p_dst_queue);
+
+    if (p_cmd->cmd_pool->renderer->api == tr_api_vulkan)
+        tr_internal_vk_cmd_buffer_transition_queue(p_cmd, p_buffer, old_usage, new_usage,
+                                                   p_src_queue, p_dst_queue);
+    else
+        tr_internal_dx_cmd_buffer_transition_queue(p_cmd, p_buffer, old_usage, new_usage,
+                                                   p_src_queue, p_dst_queue);
+}
+
+void tr_cmd_image_transition_queue(tr_cmd* p_cmd, tr_texture* p_texture,
+                                   tr_texture_usage old_usage, tr_texture_usage new_usage,
+                                   tr_queue* p_src_queue, tr_queue* p_dst_queue)
+{
+    assert(NULL != p_cmd);
+    assert(NULL != p_texture);
+    assert(NULL != p_src_queue);
+    assert(NULL != p_dst_queue);
+
+    if (p_cmd->cmd_pool->renderer->api == tr_api_vulkan)
+        tr_internal_vk_cmd_image_transition_queue(p_cmd, p_texture, old_usage, new_usage,
+                                                  p_src_queue, p_dst_queue);
+    else
+        tr_internal_dx_cmd_image_transition_queue(p_cmd, p_texture, old_usage, new_usage,
+                                                  p_src_queue, p_dst_queue);
+}
+
 void tr_cmd_render_target_transition(tr_cmd* p_cmd, tr_render_target* p_render_target,
                                      tr_texture_usage old_usage, tr_texture_usage new_usage)
 {
@@ -1086,6 +3087,25 @@ void tr_cmd_copy_buffer_to_texture2d(tr_cmd* p_cmd, uint32_t width, uint32_t hei
                                                     mip_level, p_buffer, p_texture);
 }
 
+void tr_cmd_generate_mipmaps(tr_cmd* p_cmd, tr_texture* p_texture)
+{
+    assert(NULL != p_cmd);
+    assert(NULL != p_texture);
+
+    if ((p_cmd->cmd_pool->renderer->api == tr_api_vulkan) &&
+        tr_internal_vk_can_generate_mipmaps(p_cmd->cmd_pool->queue, p_texture))
+    {
+        tr_internal_vk_cmd_generate_mipmaps(p_cmd, p_texture, tr_texture_usage_sampled_image,
+                                            tr_texture_usage_sampled_image);
+    }
+    else
+    {
+        tr_internal_log(tr_log_type_warn,
+                        "Mipmaps can't be generated for this texture on this queue",
+                        "tr_cmd_generate_mipmaps");
+    }
+}
+
 void tr_acquire_next_image(tr_renderer* p_renderer, tr_semaphore* p_signal_semaphore,
                            tr_fence* p_fence)
 {
@@ -1099,7 +3119,36 @@ void tr_acquire_next_image(tr_renderer* p_renderer, tr_semaphore* p_signal_semap
 
 void tr_queue_submit(tr_queue* p_queue, uint32_t cmd_count, tr_cmd** pp_cmds,
                      uint32_t wait_semaphore_count, tr_semaphore** pp_wait_semaphores,
-                     uint32_t signal_semaphore_count, tr_semaphore** pp_signal_semaphores)
+                     uint32_t signal_semaphore_count, tr_semaphore** pp_signal_semaphores,
+                     tr_fence* p_fence)
+{
+    assert(NULL != p_queue);
+    assert(cmd_count > 0);
+    assert(NULL != pp_cmds);
+    if (wait_semaphore_count > 0)
+    {
+        assert(NULL != pp_wait_semaphores);
+    }
+    if (signal_semaphore_count > 0)
+    {
+        assert(NULL != pp_signal_semaphores);
+    }
+
+    if (p_queue->renderer->api == tr_api_vulkan)
+        tr_internal_vk_queue_submit(p_queue, cmd_count, pp_cmds, wait_semaphore_count,
+                                    pp_wait_semaphores, NULL, signal_semaphore_count,
+                                    pp_signal_semaphores, NULL, p_fence);
+    else
+        tr_internal_dx_queue_submit(p_queue, cmd_count, pp_cmds, wait_semaphore_count,
+                                    pp_wait_semaphores, NULL, signal_semaphore_count,
+                                    pp_signal_semaphores, NULL, p_fence);
+}
+
+void tr_queue_submit_timeline(tr_queue* p_queue, uint32_t cmd_count, tr_cmd** pp_cmds,
+                              uint32_t wait_semaphore_count, tr_semaphore** pp_wait_semaphores,
+                              const uint64_t* p_wait_values, uint32_t signal_semaphore_count,
+                              tr_semaphore** pp_signal_semaphores,
+                              const uint64_t* p_signal_values, tr_fence* p_fence)
 {
     assert(NULL != p_queue);
     assert(cmd_count > 0);
@@ -1107,20 +3156,22 @@ void tr_queue_submit(tr_queue* p_queue, uint32_t cmd_count, tr_cmd** pp_cmds,
     if (wait_semaphore_count > 0)
     {
         assert(NULL != pp_wait_semaphores);
+        assert(NULL != p_wait_values);
     }
     if (signal_semaphore_count > 0)
     {
         assert(NULL != pp_signal_semaphores);
+        assert(NULL != p_signal_values);
     }
 
     if (p_queue->renderer->api == tr_api_vulkan)
         tr_internal_vk_queue_submit(p_queue, cmd_count, pp_cmds, wait_semaphore_count,
-                                    pp_wait_semaphores, signal_semaphore_count,
-                                    pp_signal_semaphores);
+                                    pp_wait_semaphores, p_wait_values, signal_semaphore_count,
+                                    pp_signal_semaphores, p_signal_values, p_fence);
     else
         tr_internal_dx_queue_submit(p_queue, cmd_count, pp_cmds, wait_semaphore_count,
-                                    pp_wait_semaphores, signal_semaphore_count,
-                                    pp_signal_semaphores);
+                                    pp_wait_semaphores, p_wait_values, signal_semaphore_count,
+                                    pp_signal_semaphores, p_signal_values, p_fence);
 }
 
 void tr_queue_present(tr_queue* p_queue, uint32_t wait_semaphore_count,
@@ -1131,6 +3182,10 @@ void tr_queue_present(tr_queue* p_queue, uint32_t wait_semaphore_count,
     {
         assert(NULL != pp_wait_semaphores);
     }
+    for (uint32_t i = 0; i < wait_semaphore_count; ++i)
+    {
+        assert(!pp_wait_semaphores[i]->timeline);
+    }
 
     if (p_queue->renderer->api == tr_api_vulkan)
         tr_internal_vk_queue_present(p_queue, wait_semaphore_count, pp_wait_semaphores);
@@ -1148,9 +3203,321 @@ void tr_queue_wait_idle(tr_queue* p_queue)
         tr_internal_dx_queue_wait_idle(p_queue);
 }
 
+// -------------------------------------------------------------------------------------------------
+// Upload functions
+// -------------------------------------------------------------------------------------------------
+static tr_upload_context* tr_internal_get_upload_context(tr_queue* p_queue)
+{
+    assert(NULL != p_queue);
+
+    if (NULL == p_queue->upload_context)
+    {
+        tr_upload_context* p_upload = new tr_upload_context();
+        assert(NULL != p_upload);
+
+        p_upload->queue = p_queue;
+        tr_create_buffer(p_queue->renderer, tr_buffer_usage_transfer_src, tr_upload_staging_size,
+                         true, &(p_upload->staging_buffer));
+        assert(NULL != p_upload->staging_buffer->cpu_mapped_address);
+
+        // Ticket 0 is never handed out so it always counts as complete
+        p_upload->next_ticket = 1;
+        p_upload->completed_ticket = 0;
+
+        p_queue->upload_context = p_upload;
+    }
+
+    return p_queue->upload_context;
+}
+
+static tr_upload_batch* tr_internal_upload_open_batch(tr_upload_context* p_upload)
+{
+    if (NULL == p_upload->open_batch)
+    {
+        tr_upload_batch* p_batch = NULL;
+        if (!p_upload->free_batches.empty())
+        {
+            p_batch = p_upload->free_batches.back();
+            p_upload->free_batches.pop_back();
+        }
+        else
+        {
+            p_batch = new tr_upload_batch();
+            assert(NULL != p_batch);
+
+            tr_renderer* p_renderer = p_upload->queue->renderer;
+            tr_create_cmd_pool(p_renderer, p_upload->queue, true, &(p_batch->cmd_pool));
+            tr_create_cmd(p_batch->cmd_pool, false, &(p_batch->cmd));
+            tr_create_fence(p_renderer, &(p_batch->fence));
+        }
+
+        p_batch->ticket = p_upload->next_ticket;
+        tr_begin_cmd(p_batch->cmd);
+
+        p_upload->open_batch = p_batch;
+    }
+
+    return p_upload->open_batch;
+}
+
+static void tr_internal_upload_submit(tr_upload_context* p_upload)
+{
+    tr_upload_batch* p_batch = p_upload->open_batch;
+    if (NULL == p_batch)
+    {
+        return;
+    }
+
+    tr_queue* p_queue = p_upload->queue;
+    tr_end_cmd(p_batch->cmd);
+    tr_reset_fence(p_queue->renderer, p_batch->fence);
+    if (p_queue->renderer->api == tr_api_vulkan)
+        tr_internal_vk_queue_submit(p_queue, 1, &(p_batch->cmd), 0, NULL, NULL, 0, NULL, NULL,
+                                    p_batch->fence);
+    else
+        tr_internal_dx_queue_submit(p_queue, 1, &(p_batch->cmd), 0, NULL, NULL, 0, NULL, NULL,
+                                    p_batch->fence);
+
+    p_batch->staging_end = p_upload->staging_head;
+    p_upload->pending_batches.push_back(p_batch);
+    p_upload->open_batch = NULL;
+    ++p_upload->next_ticket;
+}
+
+static void tr_internal_upload_retire_oldest(tr_upload_context* p_upload)
+{
+    assert(!p_upload->pending_batches.empty());
+
+    tr_upload_batch* p_batch = p_upload->pending_batches.front();
+    p_upload->pending_batches.erase(p_upload->pending_batches.begin());
+
+    for (size_t i = 0; i < p_batch->oversized_buffers.size(); ++i)
+    {
+        tr_destroy_buffer(p_upload->queue->renderer, p_batch->oversized_buffers[i]);
+    }
+    p_batch->oversized_buffers.clear();
+
+    p_upload->staging_tail = p_batch->staging_end;
+    p_upload->completed_ticket = p_batch->ticket;
+    p_upload->free_batches.push_back(p_batch);
+
+    // Nothing lives in the ring anymore, start over at the beginning
+    if (p_upload->pending_batches.empty() && (NULL == p_upload->open_batch))
+    {
+        p_upload->staging_head = 0;
+        p_upload->staging_tail = 0;
+    }
+}
+
+// Retires every batch the GPU has finished without blocking
+static void tr_internal_upload_poll(tr_upload_context* p_upload)
+{
+    while (!p_upload->pending_batches.empty() &&
+           tr_get_fence_status(p_upload->queue->renderer, p_upload->pending_batches.front()->fence))
+    {
+        tr_internal_upload_retire_oldest(p_upload);
+    }
+}
+
+static void tr_internal_upload_wait(tr_upload_context* p_upload, uint64_t ticket)
+{
+    if ((NULL != p_upload->open_batch) && (ticket >= p_upload->open_batch->ticket))
+    {
+        tr_internal_upload_submit(p_upload);
+    }
+    assert(ticket < p_upload->next_ticket);
+
+    while (p_upload->completed_ticket < ticket)
+    {
+        tr_wait_for_fence(p_upload->queue->renderer, p_upload->pending_batches.front()->fence);
+        tr_internal_upload_retire_oldest(p_upload);
+    }
+}
+
+void tr_internal_destroy_upload_context(tr_queue* p_queue)
+{
+    tr_upload_context* p_upload = p_queue->upload_context;
+    if (NULL == p_upload)
+    {
+        return;
+    }
+
+    assert(0 == p_upload->batch_depth);
+    tr_internal_upload_submit(p_upload);
+    tr_internal_upload_wait(p_upload, p_upload->next_ticket - 1);
+
+    tr_renderer* p_renderer = p_queue->renderer;
+    for (size_t i = 0; i < p_upload->free_batches.size(); ++i)
+    {
+        tr_upload_batch* p_batch = p_upload->free_batches[i];
+        tr_destroy_fence(p_renderer, p_batch->fence);
+        tr_destroy_cmd(p_batch->cmd_pool, p_batch->cmd);
+        tr_destroy_cmd_pool(p_renderer, p_batch->cmd_pool);
+        delete p_batch;
+    }
+    tr_destroy_buffer(p_renderer, p_upload->staging_buffer);
+
+    delete p_upload;
+    p_queue->upload_context = NULL;
+}
+
+static bool tr_internal_upload_try_alloc(tr_upload_context* p_upload, uint64_t size,
+                                         uint64_t alignment, uint64_t* p_offset)
+{
+    const uint64_t capacity = p_upload->staging_buffer->size;
+    uint64_t offset = tr_round_up_u64(p_upload->staging_head, alignment);
+    if (p_upload->staging_head >= p_upload->staging_tail)
+    {
+        // Free space is [head, capacity) followed by [0, tail)
+        if ((offset + size) > capacity)
+        {
+            if (size >= p_upload->staging_tail)
+            {
+                return false;
+            }
+            offset = 0;
+        }
+    }
+    else if ((offset + size) >= p_upload->staging_tail)
+    {
+        // Free space is [head, tail), head must never catch up with tail since that means empty
+        return false;
+    }
+
+    p_upload->staging_head = offset + size;
+    *p_offset = offset;
+    return true;
+}
+
+// Reserves staging memory for one upload. This may submit the uploads recorded so far to make
+// room, so it has to be called before anything for this upload is recorded.
+static void tr_internal_upload_alloc(tr_upload_context* p_upload, uint64_t size, uint64_t alignment,
+                                     tr_buffer** pp_buffer, uint64_t* p_offset,
+                                     uint8_t** pp_mapped_address)
+{
+    assert(size > 0);
+
+    tr_internal_upload_poll(p_upload);
+
+    tr_buffer* p_staging = p_upload->staging_buffer;
+    if (size > p_staging->size)
+    {
+        // Too big for the ring, give it a buffer of its own that lives as long as the batch
+        tr_create_buffer(p_upload->queue->renderer, tr_buffer_usage_transfer_src, size, true,
+                         &p_staging);
+        assert(NULL != p_staging->cpu_mapped_address);
+        tr_internal_upload_open_batch(p_upload)->oversized_buffers.push_back(p_staging);
+
+        *pp_buffer = p_staging;
+        *p_offset = 0;
+        *pp_mapped_address = (uint8_t*)p_staging->cpu_mapped_address;
+        return;
+    }
+
+    uint64_t offset = 0;
+    while (!tr_internal_upload_try_alloc(p_upload, size, alignment, &offset))
+    {
+        if (!p_upload->pending_batches.empty())
+        {
+            tr_wait_for_fence(p_upload->queue->renderer,
+                              p_upload->pending_batches.front()->fence);
+            tr_internal_upload_retire_oldest(p_upload);
+        }
+        else
+        {
+            // The open batch is holding all of the ring
+            assert(NULL != p_upload->open_batch);
+            tr_internal_upload_submit(p_upload);
+        }
+    }
+
+    *pp_buffer = p_staging;
+    *p_offset = offset;
+    *pp_mapped_address = (uint8_t*)p_staging->cpu_mapped_address + offset;
+}
+
+static tr_cmd* tr_internal_upload_begin_cmd(tr_upload_context* p_upload)
+{
+    return tr_internal_upload_open_batch(p_upload)->cmd;
+}
+
+// Submits and waits right away unless the caller has opened a batch
+static void tr_internal_upload_end_cmd(tr_upload_context* p_upload)
+{
+    if (0 == p_upload->batch_depth)
+    {
+        tr_internal_upload_wait(p_upload, p_upload->open_batch->ticket);
+    }
+}
+
+void tr_queue_begin_upload_batch(tr_queue* p_queue)
+{
+    tr_upload_context* p_upload = tr_internal_get_upload_context(p_queue);
+    ++p_upload->batch_depth;
+}
+
+void tr_queue_end_upload_batch(tr_queue* p_queue)
+{
+    uint64_t ticket = tr_queue_end_upload_batch_async(p_queue);
+    if (0 == p_queue->upload_context->batch_depth)
+    {
+        tr_internal_upload_wait(p_queue->upload_context, ticket);
+    }
+}
+
+uint64_t tr_queue_end_upload_batch_async(tr_queue* p_queue)
+{
+    tr_upload_context* p_upload = tr_internal_get_upload_context(p_queue);
+    assert(p_upload->batch_depth > 0);
+
+    // Nothing recorded means the most recently submitted ticket covers it
+    uint64_t ticket =
+        (NULL != p_upload->open_batch) ? p_upload->open_batch->ticket : p_upload->next_ticket - 1;
+
+    --p_upload->batch_depth;
+    if (0 == p_upload->batch_depth)
+    {
+        tr_internal_upload_submit(p_upload);
+    }
+
+    return ticket;
+}
+
+bool tr_queue_is_upload_complete(tr_queue* p_queue, uint64_t ticket)
+{
+    tr_upload_context* p_upload = tr_internal_get_upload_context(p_queue);
+    tr_internal_upload_poll(p_upload);
+
+    return ticket <= p_upload->completed_ticket;
+}
+
+void tr_queue_wait_upload(tr_queue* p_queue, uint64_t ticket)
+{
+    tr_upload_context* p_upload = tr_internal_get_upload_context(p_queue);
+    tr_internal_upload_wait(p_upload, ticket);
+}
+
 // -------------------------------------------------------------------------------------------------
 // Utility functions
 // -------------------------------------------------------------------------------------------------
+void tr_get_memory_stats(tr_renderer* p_renderer, tr_memory_stats* p_stats)
+{
+    TINY_RENDERER_RENDERER_PTR_CHECK(p_renderer);
+    assert(NULL != p_stats);
+
+    // Only the Vulkan backend sub-allocates, D3D12 resources are committed and not tracked
+    *p_stats = p_renderer->memory_stats;
+}
+
+void tr_get_pipeline_stats(tr_renderer* p_renderer, tr_pipeline_stats* p_stats)
+{
+    TINY_RENDERER_RENDERER_PTR_CHECK(p_renderer);
+    assert(NULL != p_stats);
+
+    // D3D12 has no pipeline cache so its pipelines are always cold
+    *p_stats = p_renderer->pipeline_stats;
+}
+
 uint64_t tr_util_calc_storage_counter_offset(uint64_t buffer_size)
 {
     uint64_t alignment = D3D12_UAV_COUNTER_PLACEMENT_ALIGNMENT;
@@ -1169,23 +3536,20 @@ void tr_queue_set_storage_buffer_count(tr_queue* p_queue, uint64_t count_offset,
     assert(NULL != p_buffer);
     assert(NULL != p_buffer->dx_resource || NULL != p_buffer->vk_buffer);
 
-    tr_buffer* buffer = NULL;
-    tr_create_buffer(p_buffer->renderer, tr_buffer_usage_transfer_src, 256, true, &buffer);
-    uint32_t* mapped_ptr = (uint32_t*)buffer->cpu_mapped_address;
-    *(mapped_ptr) = count;
-
-    tr_cmd_pool* p_cmd_pool = NULL;
-    tr_create_cmd_pool(p_queue->renderer, p_queue, true, &p_cmd_pool);
+    tr_upload_context* p_upload = tr_internal_get_upload_context(p_queue);
 
-    tr_cmd* p_cmd = NULL;
-    tr_create_cmd(p_cmd_pool, false, &p_cmd);
+    tr_buffer* buffer = NULL;
+    uint64_t buffer_offset = 0;
+    uint8_t* mapped_ptr = NULL;
+    tr_internal_upload_alloc(p_upload, sizeof(count), 16, &buffer, &buffer_offset, &mapped_ptr);
+    memcpy(mapped_ptr, &count, sizeof(count));
 
-    tr_begin_cmd(p_cmd);
+    tr_cmd* p_cmd = tr_internal_upload_begin_cmd(p_upload);
     if (p_queue->renderer->api == tr_api_vulkan)
     {
         tr_internal_vk_cmd_buffer_transition(p_cmd, p_buffer, tr_buffer_usage_storage_uav,
                                              tr_buffer_usage_transfer_dst);
-        VkBufferCopy region = {0, 0, 4};
+        VkBufferCopy region = {buffer_offset, 0, 4};
         vkCmdCopyBuffer(p_cmd->vk_cmd_buf, buffer->vk_buffer, p_buffer->vk_buffer, 1, &region);
 
         tr_internal_vk_cmd_buffer_transition(p_cmd, p_buffer, tr_buffer_usage_transfer_dst,
@@ -1196,19 +3560,11 @@ void tr_queue_set_storage_buffer_count(tr_queue* p_queue, uint64_t count_offset,
         tr_internal_dx_cmd_buffer_transition(p_cmd, p_buffer, tr_buffer_usage_storage_uav,
                                              tr_buffer_usage_transfer_dst);
         p_cmd->dx_cmd_list->CopyBufferRegion(p_buffer->dx_resource, count_offset,
-                                             buffer->dx_resource, 0, 4);
+                                             buffer->dx_resource, buffer_offset, 4);
         tr_internal_dx_cmd_buffer_transition(p_cmd, p_buffer, tr_buffer_usage_transfer_dst,
                                              tr_buffer_usage_storage_uav);
     }
-    tr_end_cmd(p_cmd);
-
-    tr_queue_submit(p_queue, 1, &p_cmd, 0, NULL, 0, NULL);
-    tr_queue_wait_idle(p_queue);
-
-    tr_destroy_cmd(p_cmd_pool, p_cmd);
-    tr_destroy_cmd_pool(p_queue->renderer, p_cmd_pool);
-
-    tr_destroy_buffer(p_buffer->renderer, buffer);
+    tr_internal_upload_end_cmd(p_upload);
 }
 
 void tr_queue_clear_buffer(tr_queue* p_queue, tr_buffer* p_buffer)
@@ -1217,23 +3573,20 @@ void tr_queue_clear_buffer(tr_queue* p_queue, tr_buffer* p_buffer)
     assert(NULL != p_buffer);
     assert(NULL != p_buffer->dx_resource || NULL != p_buffer->vk_buffer);
 
-    tr_buffer* buffer = NULL;
-    tr_create_buffer(p_buffer->renderer, tr_buffer_usage_transfer_src, p_buffer->size, true,
-                     &buffer);
-    memset(buffer->cpu_mapped_address, 0, buffer->size);
-
-    tr_cmd_pool* p_cmd_pool = NULL;
-    tr_create_cmd_pool(p_queue->renderer, p_queue, true, &p_cmd_pool);
+    tr_upload_context* p_upload = tr_internal_get_upload_context(p_queue);
 
-    tr_cmd* p_cmd = NULL;
-    tr_create_cmd(p_cmd_pool, false, &p_cmd);
+    tr_buffer* buffer = NULL;
+    uint64_t buffer_offset = 0;
+    uint8_t* mapped_ptr = NULL;
+    tr_internal_upload_alloc(p_upload, p_buffer->size, 16, &buffer, &buffer_offset, &mapped_ptr);
+    memset(mapped_ptr, 0, p_buffer->size);
 
-    tr_begin_cmd(p_cmd);
+    tr_cmd* p_cmd = tr_internal_upload_begin_cmd(p_upload);
     if (p_queue->renderer->api == tr_api_vulkan)
     {
         tr_internal_vk_cmd_buffer_transition(p_cmd, p_buffer, p_buffer->usage,
                                              tr_buffer_usage_transfer_dst);
-        VkBufferCopy region = {0, 0, p_buffer->size};
+        VkBufferCopy region = {buffer_offset, 0, p_buffer->size};
         vkCmdCopyBuffer(p_cmd->vk_cmd_buf, buffer->vk_buffer, p_buffer->vk_buffer, 1, &region);
         tr_internal_vk_cmd_buffer_transition(p_cmd, p_buffer, tr_buffer_usage_transfer_dst,
                                              p_buffer->usage);
@@ -1242,20 +3595,12 @@ void tr_queue_clear_buffer(tr_queue* p_queue, tr_buffer* p_buffer)
     {
         tr_internal_dx_cmd_buffer_transition(p_cmd, p_buffer, p_buffer->usage,
                                              tr_buffer_usage_transfer_dst);
-        p_cmd->dx_cmd_list->CopyBufferRegion(p_buffer->dx_resource, 0, buffer->dx_resource, 0,
-                                             p_buffer->size);
+        p_cmd->dx_cmd_list->CopyBufferRegion(p_buffer->dx_resource, 0, buffer->dx_resource,
+                                             buffer_offset, p_buffer->size);
         tr_internal_dx_cmd_buffer_transition(p_cmd, p_buffer, tr_buffer_usage_transfer_dst,
                                              p_buffer->usage);
     }
-    tr_end_cmd(p_cmd);
-
-    tr_queue_submit(p_queue, 1, &p_cmd, 0, NULL, 0, NULL);
-    tr_queue_wait_idle(p_queue);
-
-    tr_destroy_cmd(p_cmd_pool, p_cmd);
-    tr_destroy_cmd_pool(p_queue->renderer, p_cmd_pool);
-
-    tr_destroy_buffer(p_buffer->renderer, buffer);
+    tr_internal_upload_end_cmd(p_upload);
 }
 
 void tr_queue_update_buffer(tr_queue* p_queue, uint64_t size, const void* p_src_data,
@@ -1267,22 +3612,20 @@ void tr_queue_update_buffer(tr_queue* p_queue, uint64_t size, const void* p_src_
     assert(NULL != p_buffer->dx_resource || NULL != p_buffer->vk_buffer);
     assert(p_buffer->size >= size);
 
-    tr_buffer* buffer = NULL;
-    tr_create_buffer(p_buffer->renderer, tr_buffer_usage_transfer_src, size, true, &buffer);
-    memcpy(buffer->cpu_mapped_address, p_src_data, size);
-
-    tr_cmd_pool* p_cmd_pool = NULL;
-    tr_create_cmd_pool(p_queue->renderer, p_queue, true, &p_cmd_pool);
+    tr_upload_context* p_upload = tr_internal_get_upload_context(p_queue);
 
-    tr_cmd* p_cmd = NULL;
-    tr_create_cmd(p_cmd_pool, false, &p_cmd);
+    tr_buffer* buffer = NULL;
+    uint64_t buffer_offset = 0;
+    uint8_t* mapped_ptr = NULL;
+    tr_internal_upload_alloc(p_upload, size, 16, &buffer, &buffer_offset, &mapped_ptr);
+    memcpy(mapped_ptr, p_src_data, size);
 
-    tr_begin_cmd(p_cmd);
+    tr_cmd* p_cmd = tr_internal_upload_begin_cmd(p_upload);
     if (p_queue->renderer->api == tr_api_vulkan)
     {
         tr_internal_vk_cmd_buffer_transition(p_cmd, p_buffer, p_buffer->usage,
                                              tr_buffer_usage_transfer_dst);
-        VkBufferCopy region = {0, 0, size};
+        VkBufferCopy region = {buffer_offset, 0, size};
         vkCmdCopyBuffer(p_cmd->vk_cmd_buf, buffer->vk_buffer, p_buffer->vk_buffer, 1, &region);
         tr_internal_vk_cmd_buffer_transition(p_cmd, p_buffer, tr_buffer_usage_transfer_dst,
                                              p_buffer->usage);
@@ -1291,20 +3634,198 @@ void tr_queue_update_buffer(tr_queue* p_queue, uint64_t size, const void* p_src_
     {
         tr_internal_dx_cmd_buffer_transition(p_cmd, p_buffer, p_buffer->usage,
                                              tr_buffer_usage_transfer_dst);
-        p_cmd->dx_cmd_list->CopyBufferRegion(p_buffer->dx_resource, 0, buffer->dx_resource, 0,
-                                             size);
+        p_cmd->dx_cmd_list->CopyBufferRegion(p_buffer->dx_resource, 0, buffer->dx_resource,
+                                             buffer_offset, size);
         tr_internal_dx_cmd_buffer_transition(p_cmd, p_buffer, tr_buffer_usage_transfer_dst,
                                              p_buffer->usage);
     }
-    tr_end_cmd(p_cmd);
+    tr_internal_upload_end_cmd(p_upload);
+}
+
+// Texture cache files start with this, all of it has to match for the cached blocks to be used
+struct tr_internal_texture_cache_header
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t format;
+    uint32_t quality;
+    uint32_t width;
+    uint32_t height;
+    uint32_t mip_levels;
+    // Keeps the 64 bit fields aligned without padding bytes, always 0
+    uint32_t reserved;
+    uint64_t source_hash;
+    uint64_t data_size;
+};
+
+// MurmurHash64A seeded with the hash so far. Every word is mixed on its own before it's folded in,
+// so any changed bit of the source changes the result.
+static uint64_t tr_internal_hash(uint64_t hash, const void* p_data, size_t size)
+{
+    const uint64_t k_m = 0xC6A4A7935BD1E995ull;
+    const int k_r = 47;
+    const uint8_t* p_bytes = (const uint8_t*)p_data;
+    hash ^= size * k_m;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8)
+    {
+        uint64_t word = 0;
+        memcpy(&word, p_bytes + i, 8);
+        word *= k_m;
+        word ^= word >> k_r;
+        word *= k_m;
+        hash ^= word;
+        hash *= k_m;
+    }
+    if (i < size)
+    {
+        uint64_t tail = 0;
+        memcpy(&tail, p_bytes + i, size - i);
+        hash ^= tail;
+        hash *= k_m;
+    }
+    hash ^= hash >> k_r;
+    hash *= k_m;
+    hash ^= hash >> k_r;
+    return hash;
+}
+
+// Builds RGBA8 mip levels, compresses them and uploads the blocks. p_src_data is RGBA8.
+static void tr_internal_update_texture_compressed(tr_queue* p_queue, uint32_t src_width,
+                                                  uint32_t src_height, uint32_t src_row_stride,
+                                                  const uint8_t* p_src_data, tr_texture* p_texture,
+                                                  tr_image_resize_uint8_fn resize_fn,
+                                                  void* p_user_data)
+{
+    const tr_renderer_settings& settings = p_queue->renderer->settings;
+    const tr_format format = p_texture->format;
+    const uint32_t mip_levels = p_texture->mip_levels;
+    const uint64_t data_size =
+        tr_util_calc_texture_size(format, p_texture->width, p_texture->height, mip_levels);
+
+    tr_internal_texture_cache_header header = {};
+    memcpy(header.magic, "TRBC", 4);
+    header.version = 2;
+    header.format = (uint32_t)format;
+    header.quality = (uint32_t)settings.texture_compression_quality;
+    header.width = p_texture->width;
+    header.height = p_texture->height;
+    header.mip_levels = mip_levels;
+    header.data_size = data_size;
+
+    vector<uint8_t> data;
+    string cache_path;
+    // What a custom resize_fn produces can't be keyed, so those textures are never cached
+    if (!settings.texture_cache_dir.empty() && (NULL == resize_fn))
+    {
+        uint64_t hash = 0;
+        hash = tr_internal_hash(hash, &src_width, sizeof(src_width));
+        hash = tr_internal_hash(hash, &src_height, sizeof(src_height));
+        for (uint32_t y = 0; y < src_height; ++y)
+        {
+            hash = tr_internal_hash(hash, p_src_data + (size_t)y * src_row_stride, src_width * 4);
+        }
+        header.source_hash = hash;
+
+        char file_name[32];
+        snprintf(file_name, sizeof(file_name), "%016llx.trbc",
+                 (unsigned long long)tr_internal_hash(hash, &header, sizeof(header)));
+        cache_path = settings.texture_cache_dir + "/" + file_name;
+
+        std::ifstream is(cache_path.c_str(), std::ios::binary);
+        tr_internal_texture_cache_header file_header = {};
+        if (is.is_open() && is.read((char*)&file_header, sizeof(file_header)) &&
+            (0 == memcmp(&header, &file_header, sizeof(header))))
+        {
+            data.resize((size_t)data_size);
+            if (!is.read((char*)data.data(), data.size()))
+            {
+                data.clear();
+            }
+        }
+    }
+
+    if (data.empty())
+    {
+        data.resize((size_t)data_size);
+        const bool downsample_mips = (NULL == resize_fn);
+        const bool srgb = tr_util_format_is_srgb(format);
+        if (NULL == resize_fn)
+        {
+            resize_fn = &tr_image_resize_uint8_t;
+        }
+
+        vector<uint8_t> mip_data[2];
+        uint32_t dst_width = p_texture->width;
+        uint32_t dst_height = p_texture->height;
+        uint32_t prev_width = 0;
+        uint32_t prev_height = 0;
+        uint64_t offset = 0;
+        for (uint32_t mip_level = 0; mip_level < mip_levels; ++mip_level)
+        {
+            const uint32_t row_stride = dst_width * 4;
+            vector<uint8_t>& level = mip_data[mip_level & 1];
+            level.resize((size_t)row_stride * dst_height);
+            if ((0 == mip_level) || !downsample_mips)
+            {
+                resize_fn(src_width, src_height, src_row_stride, p_src_data, dst_width,
+                          dst_height, row_stride, level.data(), 4, p_user_data);
+            }
+            else
+            {
+                tr_internal_downsample_uint8(p_queue->renderer, prev_width, prev_height,
+                                             prev_width * 4, mip_data[(mip_level - 1) & 1].data(),
+                                             row_stride, level.data(), 4, srgb);
+            }
+            bool compressed = tr_internal_compress_uint8(
+                p_queue->renderer, dst_width, dst_height, row_stride, level.data(), format,
+                settings.texture_compression_quality, data.data() + offset);
+            assert(compressed && "tr_image_compress_uint8 can't encode this format");
+            (void)compressed;
+            offset += tr_util_calc_texture_size(format, dst_width, dst_height, 1);
+
+            prev_width = dst_width;
+            prev_height = dst_height;
+            dst_width = tr_max(dst_width >> 1, 1);
+            dst_height = tr_max(dst_height >> 1, 1);
+        }
+
+        // Written next to the final file and renamed into place, so readers only ever see a
+        // complete file even if this crashes or another upload of the same image races it
+        if (!cache_path.empty())
+        {
+            char tmp_suffix[48];
+            snprintf(tmp_suffix, sizeof(tmp_suffix), ".%016llx.tmp",
+                     (unsigned long long)(
+                         std::hash<std::thread::id>()(std::this_thread::get_id()) ^
+                         (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count()));
+            const string tmp_path = cache_path + tmp_suffix;
+            bool written = false;
+            {
+                std::ofstream os(tmp_path.c_str(), std::ios::binary | std::ios::trunc);
+                if (os.is_open())
+                {
+                    os.write((const char*)&header, sizeof(header));
+                    os.write((const char*)data.data(), data.size());
+                    os.close();
+                    written = !os.fail();
+                }
+            }
+            // rename doesn't replace an existing file on Windows, which then already holds the
+            // same data from a racing upload
+            if (!written || (0 != rename(tmp_path.c_str(), cache_path.c_str())))
+            {
+                remove(tmp_path.c_str());
+                if (!written)
+                {
+                    tr_internal_log(tr_log_type_warn, "Couldn't write the texture cache file",
+                                    "tr_queue_update_texture_uint8");
+                }
+            }
+        }
+    }
 
-    tr_queue_submit(p_queue, 1, &p_cmd, 0, NULL, 0, NULL);
-    tr_queue_wait_idle(p_queue);
-
-    tr_destroy_cmd(p_cmd_pool, p_cmd);
-    tr_destroy_cmd_pool(p_queue->renderer, p_cmd_pool);
-
-    tr_destroy_buffer(p_buffer->renderer, buffer);
+    tr_queue_update_texture_blocks(p_queue, mip_levels, data_size, data.data(), p_texture);
 }
 
 void tr_queue_update_texture_uint8(tr_queue* p_queue, uint32_t src_width, uint32_t src_height,
@@ -1319,8 +3840,13 @@ void tr_queue_update_texture_uint8(tr_queue* p_queue, uint32_t src_width, uint32
     assert((src_width > 0) && (src_height > 0) && (src_row_stride > 0));
     assert(tr_sample_count_1 == p_texture->sample_count);
 
+    // Block compression always starts from RGBA
+    const bool compress = tr_internal_can_compress(p_texture->format);
+    assert((compress || !tr_util_format_is_compressed(p_texture->format)) &&
+           "Use tr_queue_update_texture_blocks for block compressed formats");
     vector<uint8_t> p_expanded_src_data;
-    const uint32_t dst_channel_count = tr_util_format_channel_count(p_texture->format);
+    const uint32_t dst_channel_count =
+        compress ? 4 : tr_util_format_channel_count(p_texture->format);
     assert(src_channel_count <= dst_channel_count);
 
     if (src_channel_count < dst_channel_count)
@@ -1359,18 +3885,61 @@ void tr_queue_update_texture_uint8(tr_queue* p_queue, uint32_t src_width, uint32
         p_src_data = p_expanded_src_data.data();
     }
 
+    if (compress)
+    {
+        tr_internal_update_texture_compressed(p_queue, src_width, src_height, src_row_stride,
+                                              p_src_data, p_texture, resize_fn, p_user_data);
+        return;
+    }
+
+    tr_upload_context* p_upload = tr_internal_get_upload_context(p_queue);
+
+    // When the GPU can build the mip chain only mip 0 goes through the staging buffer. A custom
+    // resize_fn builds every level itself.
+    bool generate_mipmaps = (p_queue->renderer->api == tr_api_vulkan) && (NULL == resize_fn) &&
+                            (p_texture->mip_levels > 1) &&
+                            tr_internal_vk_can_generate_mipmaps(p_queue, p_texture);
+    const uint32_t upload_mip_levels = generate_mipmaps ? 1 : p_texture->mip_levels;
+
     tr_buffer* buffer = NULL;
+    uint64_t base_offset = 0;
+    uint8_t* p_mapped_address = NULL;
     vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> subres_layouts;
+    // Vulkan mip offsets relative to base_offset
+    vector<uint64_t> mip_offsets;
 
+    // Placement alignment D3D12 requires for texture data
+    uint64_t staging_alignment = D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT;
     if (p_queue->renderer->api == tr_api_vulkan)
     {
-        // Get memory requirements that covers all mip levels
-        VkMemoryRequirements mem_reqs = {};
-        vkGetImageMemoryRequirements(p_texture->renderer->vk_device, p_texture->vk_image,
-                                     &mem_reqs);
-        // Create temporary buffer big enough to fit all mip levels
-        tr_create_buffer(p_texture->renderer, tr_buffer_usage_transfer_src, mem_reqs.size, true,
-                         &buffer);
+        // Copy regions must start at a multiple of the texel size, and of 4 on queues without
+        // graphics or compute. The least common multiple covers both, e.g. 12 for RGB8, and the
+        // base offset has to be a multiple of it too.
+        uint64_t region_alignment = 4;
+        while (0 != (region_alignment % dst_channel_count))
+        {
+            region_alignment += 4;
+        }
+        while (0 != (staging_alignment % region_alignment))
+        {
+            staging_alignment += D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT;
+        }
+
+        // Tightly packed rows for all uploaded mip levels
+        uint64_t buffer_size = 0;
+        uint32_t dst_width = p_texture->width;
+        uint32_t dst_height = p_texture->height;
+        mip_offsets.resize(upload_mip_levels);
+        for (uint32_t mip_level = 0; mip_level < upload_mip_levels; ++mip_level)
+        {
+            buffer_size = tr_round_up_u64(buffer_size, region_alignment);
+            mip_offsets[mip_level] = buffer_size;
+            buffer_size += (uint64_t)dst_width * dst_channel_count * dst_height;
+            dst_width = tr_max(dst_width >> 1, 1);
+            dst_height = tr_max(dst_height >> 1, 1);
+        }
+        tr_internal_upload_alloc(p_upload, buffer_size, staging_alignment, &buffer, &base_offset,
+                                 &p_mapped_address);
     }
     else
     {
@@ -1397,11 +3966,19 @@ void tr_queue_update_texture_uint8(tr_queue* p_queue, uint32_t src_width, uint32
         p_queue->renderer->dx_device->GetCopyableFootprints(
             &tex_resource_desc, 0, p_texture->mip_levels, 0, subres_layouts.data(),
             subres_rowcounts.data(), subres_row_strides.data(), &buffer_size);
-        // Create temporary buffer big enough to fit all mip levels
-        tr_create_buffer(p_texture->renderer, tr_buffer_usage_transfer_src, buffer_size, true,
-                         &buffer);
+        tr_internal_upload_alloc(p_upload, buffer_size, staging_alignment, &buffer, &base_offset,
+                                 &p_mapped_address);
+        // Footprint offsets are relative to the start of the staging buffer
+        for (uint32_t mip_level = 0; mip_level < p_texture->mip_levels; ++mip_level)
+        {
+            subres_layouts[mip_level].Offset += base_offset;
+        }
     }
-    // Use default simple resize if a resize function was not supplied
+    // Without a resize function mip 0 is resampled and every later level is box filtered from the
+    // one before it. Levels are built in CPU memory since staging memory is slow to read back.
+    const bool downsample_mips = (NULL == resize_fn) && (upload_mip_levels > 1);
+    const bool srgb = tr_util_format_is_srgb(p_texture->format);
+    vector<uint8_t> mip_data[2];
     if (NULL == resize_fn)
     {
         resize_fn = &tr_image_resize_uint8_t;
@@ -1409,16 +3986,16 @@ void tr_queue_update_texture_uint8(tr_queue* p_queue, uint32_t src_width, uint32
     // Resize image into appropriate mip level
     uint32_t dst_width = p_texture->width;
     uint32_t dst_height = p_texture->height;
-    VkDeviceSize buffer_offset = 0;
-    for (uint32_t mip_level = 0; mip_level < p_texture->mip_levels; ++mip_level)
+    uint32_t prev_width = 0;
+    uint32_t prev_height = 0;
+    for (uint32_t mip_level = 0; mip_level < upload_mip_levels; ++mip_level)
     {
+        uint32_t dst_row_stride = 0;
+        uint8_t* p_dst_data = NULL;
         if (p_queue->renderer->api == tr_api_vulkan)
         {
-            uint32_t dst_row_stride = src_row_stride >> mip_level;
-            uint8_t* p_dst_data = (uint8_t*)buffer->cpu_mapped_address + buffer_offset;
-            resize_fn(src_width, src_height, src_row_stride, p_src_data, dst_width, dst_height,
-                      dst_row_stride, p_dst_data, dst_channel_count, p_user_data);
-            buffer_offset += dst_row_stride * dst_height;
+            dst_row_stride = dst_width * dst_channel_count;
+            p_dst_data = p_mapped_address + mip_offsets[mip_level];
             //
             // If you're coming from D3D12, you might want to do something like:
             //
@@ -1448,103 +4025,290 @@ void tr_queue_update_texture_uint8(tr_queue* p_queue, uint32_t src_width, uint32
         else
         {
             D3D12_PLACED_SUBRESOURCE_FOOTPRINT* subres_layout = &subres_layouts[mip_level];
-            uint32_t dst_row_stride = subres_layout->Footprint.RowPitch;
-            uint8_t* p_dst_data = (uint8_t*)buffer->cpu_mapped_address + subres_layout->Offset;
+            dst_row_stride = subres_layout->Footprint.RowPitch;
+            p_dst_data = p_mapped_address + (subres_layout->Offset - base_offset);
+        }
+
+        if (downsample_mips)
+        {
+            const uint32_t packed_row_stride = dst_width * dst_channel_count;
+            vector<uint8_t>& level = mip_data[mip_level & 1];
+            level.resize(packed_row_stride * dst_height);
+            if (0 == mip_level)
+            {
+                resize_fn(src_width, src_height, src_row_stride, p_src_data, dst_width,
+                          dst_height, packed_row_stride, level.data(), dst_channel_count,
+                          p_user_data);
+            }
+            else
+            {
+                tr_internal_downsample_uint8(p_queue->renderer, prev_width, prev_height,
+                                             prev_width * dst_channel_count,
+                                             mip_data[(mip_level - 1) & 1].data(),
+                                             packed_row_stride, level.data(), dst_channel_count,
+                                             srgb);
+            }
+            for (uint32_t y = 0; y < dst_height; ++y)
+            {
+                memcpy(p_dst_data + y * dst_row_stride, level.data() + y * packed_row_stride,
+                       packed_row_stride);
+            }
+        }
+        else
+        {
             resize_fn(src_width, src_height, src_row_stride, p_src_data, dst_width, dst_height,
                       dst_row_stride, p_dst_data, dst_channel_count, p_user_data);
         }
-        dst_width >>= 1;
-        dst_height >>= 1;
+        prev_width = dst_width;
+        prev_height = dst_height;
+        dst_width = tr_max(dst_width >> 1, 1);
+        dst_height = tr_max(dst_height >> 1, 1);
     }
 
     // Copy buffer to texture
+    tr_cmd* p_cmd = tr_internal_upload_begin_cmd(p_upload);
+    if (p_queue->renderer->api == tr_api_vulkan)
+    {
+        VkFormat format = tr_util_to_vk_format(p_texture->format);
+        VkImageAspectFlags aspect_mask = tr_util_vk_determine_aspect_mask(format);
+        const uint32_t region_count = upload_mip_levels;
+        vector<VkBufferImageCopy> regions(region_count);
+
+        dst_width = p_texture->width;
+        dst_height = p_texture->height;
+        for (uint32_t mip_level = 0; mip_level < upload_mip_levels; ++mip_level)
+        {
+            regions[mip_level].bufferOffset = base_offset + mip_offsets[mip_level];
+            regions[mip_level].bufferRowLength = dst_width;
+            regions[mip_level].bufferImageHeight = dst_height;
+            regions[mip_level].imageSubresource.aspectMask = aspect_mask;
+            regions[mip_level].imageSubresource.mipLevel = mip_level;
+            regions[mip_level].imageSubresource.baseArrayLayer = 0;
+            regions[mip_level].imageSubresource.layerCount = 1;
+            regions[mip_level].imageOffset.x = 0;
+            regions[mip_level].imageOffset.y = 0;
+            regions[mip_level].imageOffset.z = 0;
+            regions[mip_level].imageExtent.width = dst_width;
+            regions[mip_level].imageExtent.height = dst_height;
+            regions[mip_level].imageExtent.depth = 1;
+            dst_width = tr_max(dst_width >> 1, 1);
+            dst_height = tr_max(dst_height >> 1, 1);
+        }
+        // Vulkan textures are created with VK_IMAGE_LAYOUT_UNDEFFINED
+        // (tr_texture_usage_undefined)
+
+        tr_internal_vk_cmd_image_transition(p_cmd, p_texture, tr_texture_usage_undefined,
+                                            tr_texture_usage_transfer_dst);
+        vkCmdCopyBufferToImage(p_cmd->vk_cmd_buf, buffer->vk_buffer, p_texture->vk_image,
+                               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, region_count,
+                               regions.data());
+        if (generate_mipmaps)
+        {
+            tr_internal_vk_cmd_generate_mipmaps(p_cmd, p_texture, tr_texture_usage_transfer_dst,
+                                                tr_texture_usage_sampled_image);
+        }
+        else
+        {
+            tr_internal_vk_cmd_image_transition(p_cmd, p_texture, tr_texture_usage_transfer_dst,
+                                                tr_texture_usage_sampled_image);
+        }
+    }
+    else
     {
-        tr_cmd_pool* p_cmd_pool = NULL;
-        tr_create_cmd_pool(p_queue->renderer, p_queue, true, &p_cmd_pool);
+        //
+        // D3D12 textures are created with the following resources states
+        // (tr_texture_usage_sampled_image):
+        //     D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE |
+        //     D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE
+        //
+        tr_internal_dx_cmd_image_transition(p_cmd, p_texture, tr_texture_usage_sampled_image,
+                                            tr_texture_usage_transfer_dst);
+        for (uint32_t mip_level = 0; mip_level < p_texture->mip_levels; ++mip_level)
+        {
+            const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& layout = subres_layouts[mip_level];
+            D3D12_TEXTURE_COPY_LOCATION src = {};
+            src.pResource = buffer->dx_resource;
+            src.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+            src.PlacedFootprint = layout;
+            D3D12_TEXTURE_COPY_LOCATION dst = {};
+            dst.pResource = p_texture->dx_resource;
+            dst.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+            dst.SubresourceIndex = mip_level;
+
+            p_cmd->dx_cmd_list->CopyTextureRegion(&dst, 0, 0, 0, &src, NULL);
+        }
 
-        tr_cmd* p_cmd = NULL;
-        tr_create_cmd(p_cmd_pool, false, &p_cmd);
+        tr_internal_dx_cmd_image_transition(p_cmd, p_texture, tr_texture_usage_transfer_dst,
+                                            tr_texture_usage_sampled_image);
+    }
+    tr_internal_upload_end_cmd(p_upload);
+}
 
-        tr_begin_cmd(p_cmd);
+void tr_queue_update_texture_blocks(tr_queue* p_queue, uint32_t mip_level_count,
+                                    uint64_t src_size, const void* p_src_data,
+                                    tr_texture* p_texture)
+{
+    assert(NULL != p_queue);
+    assert(NULL != p_src_data);
+    assert(NULL != p_texture);
+    assert(NULL != p_texture->dx_resource || NULL != p_texture->vk_image);
+    assert((mip_level_count > 0) && (mip_level_count <= p_texture->mip_levels));
+    assert(tr_sample_count_1 == p_texture->sample_count);
+    assert(src_size >= tr_util_calc_texture_size(p_texture->format, p_texture->width,
+                                                 p_texture->height, mip_level_count));
 
-        if (p_queue->renderer->api == tr_api_vulkan)
+    const uint32_t block_width = tr_util_format_block_width(p_texture->format);
+    const uint32_t block_height = tr_util_format_block_height(p_texture->format);
+    const uint32_t block_size = tr_util_format_block_size(p_texture->format);
+    assert(block_size > 0);
+
+    tr_upload_context* p_upload = tr_internal_get_upload_context(p_queue);
+
+    tr_buffer* buffer = NULL;
+    uint64_t base_offset = 0;
+    uint8_t* p_mapped_address = NULL;
+    const uint8_t* p_src = (const uint8_t*)p_src_data;
+    uint64_t staging_alignment = D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT;
+
+    tr_cmd* p_cmd = NULL;
+    if (p_queue->renderer->api == tr_api_vulkan)
+    {
+        // Same rule as tr_queue_update_texture_uint8: every region starts at a multiple of the
+        // block size and of 4, which only adds padding for uncompressed formats like R8 or RGB8
+        uint64_t region_alignment = 4;
+        while (0 != (region_alignment % block_size))
+        {
+            region_alignment += 4;
+        }
+        while (0 != (staging_alignment % region_alignment))
         {
-            buffer_offset = 0;
-            VkFormat format = tr_util_to_vk_format(p_texture->format);
-            VkImageAspectFlags aspect_mask = tr_util_vk_determine_aspect_mask(format);
-            const uint32_t region_count = p_texture->mip_levels;
-            vector<VkBufferImageCopy> regions(region_count);
+            staging_alignment += D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT;
+        }
 
-            dst_width = p_texture->width;
-            dst_height = p_texture->height;
-            for (uint32_t mip_level = 0; mip_level < p_texture->mip_levels; ++mip_level)
-            {
-                regions[mip_level].bufferOffset = buffer_offset;
-                regions[mip_level].bufferRowLength = dst_width;
-                regions[mip_level].bufferImageHeight = dst_height;
-                regions[mip_level].imageSubresource.aspectMask = aspect_mask;
-                regions[mip_level].imageSubresource.mipLevel = mip_level;
-                regions[mip_level].imageSubresource.baseArrayLayer = 0;
-                regions[mip_level].imageSubresource.layerCount = 1;
-                regions[mip_level].imageOffset.x = 0;
-                regions[mip_level].imageOffset.y = 0;
-                regions[mip_level].imageOffset.z = 0;
-                regions[mip_level].imageExtent.width = dst_width;
-                regions[mip_level].imageExtent.height = dst_height;
-                regions[mip_level].imageExtent.depth = 1;
-                buffer_offset += (src_row_stride >> mip_level) * dst_height;
-                dst_width >>= 1;
-                dst_height >>= 1;
-            }
-            // Vulkan textures are created with VK_IMAGE_LAYOUT_UNDEFFINED
-            // (tr_texture_usage_undefined)
-
-            tr_internal_vk_cmd_image_transition(p_cmd, p_texture, tr_texture_usage_undefined,
-                                                tr_texture_usage_transfer_dst);
-            vkCmdCopyBufferToImage(p_cmd->vk_cmd_buf, buffer->vk_buffer, p_texture->vk_image,
-                                   VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, region_count,
-                                   regions.data());
-            tr_internal_vk_cmd_image_transition(p_cmd, p_texture, tr_texture_usage_transfer_dst,
-                                                tr_texture_usage_sampled_image);
+        // Levels stay tightly packed rows of blocks, the way vkCmdCopyBufferToImage reads them
+        uint64_t buffer_size = 0;
+        uint32_t dst_width = p_texture->width;
+        uint32_t dst_height = p_texture->height;
+        vector<uint64_t> mip_offsets(mip_level_count);
+        vector<uint64_t> mip_sizes(mip_level_count);
+        for (uint32_t mip_level = 0; mip_level < mip_level_count; ++mip_level)
+        {
+            const uint64_t blocks_x = (dst_width + block_width - 1) / block_width;
+            const uint64_t blocks_y = (dst_height + block_height - 1) / block_height;
+            buffer_size = tr_round_up_u64(buffer_size, region_alignment);
+            mip_offsets[mip_level] = buffer_size;
+            mip_sizes[mip_level] = blocks_x * blocks_y * block_size;
+            buffer_size += mip_sizes[mip_level];
+            dst_width = tr_max(dst_width >> 1, 1);
+            dst_height = tr_max(dst_height >> 1, 1);
         }
-        else
+        tr_internal_upload_alloc(p_upload, buffer_size, staging_alignment, &buffer, &base_offset,
+                                 &p_mapped_address);
+        for (uint32_t mip_level = 0; mip_level < mip_level_count; ++mip_level)
         {
-            //
-            // D3D12 textures are created with the following resources states
-            // (tr_texture_usage_sampled_image):
-            //     D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE |
-            //     D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE
-            //
-            tr_internal_dx_cmd_image_transition(p_cmd, p_texture, tr_texture_usage_sampled_image,
-                                                tr_texture_usage_transfer_dst);
-            for (uint32_t mip_level = 0; mip_level < p_texture->mip_levels; ++mip_level)
-            {
-                const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& layout = subres_layouts[mip_level];
-                D3D12_TEXTURE_COPY_LOCATION src = {};
-                src.pResource = buffer->dx_resource;
-                src.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
-                src.PlacedFootprint = layout;
-                D3D12_TEXTURE_COPY_LOCATION dst = {};
-                dst.pResource = p_texture->dx_resource;
-                dst.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
-                dst.SubresourceIndex = mip_level;
-
-                p_cmd->dx_cmd_list->CopyTextureRegion(&dst, 0, 0, 0, &src, NULL);
-            }
+            memcpy(p_mapped_address + mip_offsets[mip_level], p_src,
+                   (size_t)mip_sizes[mip_level]);
+            p_src += mip_sizes[mip_level];
+        }
 
-            tr_internal_dx_cmd_image_transition(p_cmd, p_texture, tr_texture_usage_transfer_dst,
-                                                tr_texture_usage_sampled_image);
+        VkFormat format = tr_util_to_vk_format(p_texture->format);
+        VkImageAspectFlags aspect_mask = tr_util_vk_determine_aspect_mask(format);
+        vector<VkBufferImageCopy> regions(mip_level_count);
+
+        dst_width = p_texture->width;
+        dst_height = p_texture->height;
+        for (uint32_t mip_level = 0; mip_level < mip_level_count; ++mip_level)
+        {
+            // Row length and image height are in texels but must cover whole blocks, the extent
+            // may stop short of a block at the edge of the image
+            const uint32_t blocks_x = (dst_width + block_width - 1) / block_width;
+            const uint32_t blocks_y = (dst_height + block_height - 1) / block_height;
+            regions[mip_level].bufferOffset = base_offset + mip_offsets[mip_level];
+            regions[mip_level].bufferRowLength = blocks_x * block_width;
+            regions[mip_level].bufferImageHeight = blocks_y * block_height;
+            regions[mip_level].imageSubresource.aspectMask = aspect_mask;
+            regions[mip_level].imageSubresource.mipLevel = mip_level;
+            regions[mip_level].imageSubresource.baseArrayLayer = 0;
+            regions[mip_level].imageSubresource.layerCount = 1;
+            regions[mip_level].imageOffset.x = 0;
+            regions[mip_level].imageOffset.y = 0;
+            regions[mip_level].imageOffset.z = 0;
+            regions[mip_level].imageExtent.width = dst_width;
+            regions[mip_level].imageExtent.height = dst_height;
+            regions[mip_level].imageExtent.depth = 1;
+            dst_width = tr_max(dst_width >> 1, 1);
+            dst_height = tr_max(dst_height >> 1, 1);
         }
-        tr_end_cmd(p_cmd);
 
-        tr_queue_submit(p_queue, 1, &p_cmd, 0, NULL, 0, NULL);
-        tr_queue_wait_idle(p_queue);
+        p_cmd = tr_internal_upload_begin_cmd(p_upload);
+        tr_internal_vk_cmd_image_transition(p_cmd, p_texture, tr_texture_usage_undefined,
+                                            tr_texture_usage_transfer_dst);
+        vkCmdCopyBufferToImage(p_cmd->vk_cmd_buf, buffer->vk_buffer, p_texture->vk_image,
+                               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, mip_level_count,
+                               regions.data());
+        tr_internal_vk_cmd_image_transition(p_cmd, p_texture, tr_texture_usage_transfer_dst,
+                                            tr_texture_usage_sampled_image);
+    }
+    else
+    {
+        // Footprint rows are rows of blocks, only the row pitch differs from the source
+        D3D12_RESOURCE_DESC tex_resource_desc = {};
+        tex_resource_desc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+        tex_resource_desc.Alignment = 0;
+        tex_resource_desc.Width = (UINT)p_texture->width;
+        tex_resource_desc.Height = (UINT)p_texture->height;
+        tex_resource_desc.DepthOrArraySize = (UINT16)p_texture->depth;
+        tex_resource_desc.MipLevels = (UINT16)p_texture->mip_levels;
+        tex_resource_desc.Format = tr_util_to_dx_format(p_texture->format);
+        tex_resource_desc.SampleDesc.Count = (UINT)p_texture->sample_count;
+        tex_resource_desc.SampleDesc.Quality = (UINT)p_texture->sample_quality;
+        tex_resource_desc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+        tex_resource_desc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+        vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> subres_layouts(mip_level_count);
+        vector<UINT> subres_rowcounts(mip_level_count);
+        vector<UINT64> subres_row_sizes(mip_level_count);
+        UINT64 buffer_size = 0;
+        p_queue->renderer->dx_device->GetCopyableFootprints(
+            &tex_resource_desc, 0, mip_level_count, 0, subres_layouts.data(),
+            subres_rowcounts.data(), subres_row_sizes.data(), &buffer_size);
+        tr_internal_upload_alloc(p_upload, buffer_size, staging_alignment, &buffer, &base_offset,
+                                 &p_mapped_address);
 
-        tr_destroy_cmd(p_cmd_pool, p_cmd);
-        tr_destroy_cmd_pool(p_queue->renderer, p_cmd_pool);
+        for (uint32_t mip_level = 0; mip_level < mip_level_count; ++mip_level)
+        {
+            const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& layout = subres_layouts[mip_level];
+            const size_t src_row_size = (size_t)subres_row_sizes[mip_level];
+            uint8_t* p_dst = p_mapped_address + layout.Offset;
+            for (UINT row = 0; row < subres_rowcounts[mip_level]; ++row)
+            {
+                memcpy(p_dst, p_src, src_row_size);
+                p_dst += layout.Footprint.RowPitch;
+                p_src += src_row_size;
+            }
+        }
 
-        tr_destroy_buffer(p_texture->renderer, buffer);
+        p_cmd = tr_internal_upload_begin_cmd(p_upload);
+        tr_internal_dx_cmd_image_transition(p_cmd, p_texture, tr_texture_usage_sampled_image,
+                                            tr_texture_usage_transfer_dst);
+        for (uint32_t mip_level = 0; mip_level < mip_level_count; ++mip_level)
+        {
+            D3D12_TEXTURE_COPY_LOCATION src = {};
+            src.pResource = buffer->dx_resource;
+            src.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+            src.PlacedFootprint = subres_layouts[mip_level];
+            src.PlacedFootprint.Offset += base_offset;
+            D3D12_TEXTURE_COPY_LOCATION dst = {};
+            dst.pResource = p_texture->dx_resource;
+            dst.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+            dst.SubresourceIndex = mip_level;
+
+            p_cmd->dx_cmd_list->CopyTextureRegion(&dst, 0, 0, 0, &src, NULL);
+        }
+        tr_internal_dx_cmd_image_transition(p_cmd, p_texture, tr_texture_usage_transfer_dst,
+                                            tr_texture_usage_sampled_image);
     }
+    tr_internal_upload_end_cmd(p_upload);
 }
 
 bool tr_vertex_layout_support_format(tr_format format)
@@ -1714,6 +4478,12 @@ uint32_t tr_util_format_stride(tr_format format)
     case tr_format_r8g8b8a8_unorm:
         result = 4;
         break;
+    case tr_format_b8g8r8a8_srgb:
+        result = 4;
+        break;
+    case tr_format_r8g8b8a8_srgb:
+        result = 4;
+        break;
     case tr_format_r16g16b16a16_unorm:
         result = 8;
         break;
@@ -1748,6 +4518,143 @@ uint32_t tr_util_format_stride(tr_format format)
     case tr_format_d32_float_s8_uint:
         result = 0;
         break;
+        // Block compressed, see tr_util_format_block_size
+    case tr_format_bc1_rgba_unorm:
+    case tr_format_bc1_rgba_srgb:
+    case tr_format_bc3_unorm:
+    case tr_format_bc3_srgb:
+    case tr_format_bc4_unorm:
+    case tr_format_bc5_unorm:
+    case tr_format_bc6h_ufloat:
+    case tr_format_bc7_unorm:
+    case tr_format_bc7_srgb:
+    case tr_format_etc2_r8g8b8_unorm:
+    case tr_format_etc2_r8g8b8a8_unorm:
+    case tr_format_etc2_r8g8b8a8_srgb:
+    case tr_format_astc_4x4_unorm:
+    case tr_format_astc_4x4_srgb:
+        result = 0;
+        break;
+    }
+    return result;
+}
+
+bool tr_util_format_is_srgb(tr_format format)
+{
+    bool result = false;
+    switch (format)
+    {
+    case tr_format_b8g8r8a8_srgb:
+    case tr_format_r8g8b8a8_srgb:
+    case tr_format_bc1_rgba_srgb:
+    case tr_format_bc3_srgb:
+    case tr_format_bc7_srgb:
+    case tr_format_etc2_r8g8b8a8_srgb:
+    case tr_format_astc_4x4_srgb:
+        result = true;
+        break;
+    }
+    return result;
+}
+
+bool tr_util_format_is_compressed(tr_format format)
+{
+    return tr_util_format_block_width(format) > 1;
+}
+
+uint32_t tr_util_format_block_width(tr_format format)
+{
+    uint32_t result = 1;
+    switch (format)
+    {
+    case tr_format_bc1_rgba_unorm:
+    case tr_format_bc1_rgba_srgb:
+    case tr_format_bc3_unorm:
+    case tr_format_bc3_srgb:
+    case tr_format_bc4_unorm:
+    case tr_format_bc5_unorm:
+    case tr_format_bc6h_ufloat:
+    case tr_format_bc7_unorm:
+    case tr_format_bc7_srgb:
+    case tr_format_etc2_r8g8b8_unorm:
+    case tr_format_etc2_r8g8b8a8_unorm:
+    case tr_format_etc2_r8g8b8a8_srgb:
+    case tr_format_astc_4x4_unorm:
+    case tr_format_astc_4x4_srgb:
+        result = 4;
+        break;
+    }
+    return result;
+}
+
+uint32_t tr_util_format_block_height(tr_format format)
+{
+    // Every supported block format is square
+    return tr_util_format_block_width(format);
+}
+
+uint32_t tr_util_format_block_size(tr_format format)
+{
+    uint32_t result = 0;
+    switch (format)
+    {
+    case tr_format_bc1_rgba_unorm:
+    case tr_format_bc1_rgba_srgb:
+    case tr_format_bc4_unorm:
+    case tr_format_etc2_r8g8b8_unorm:
+        result = 8;
+        break;
+    case tr_format_bc3_unorm:
+    case tr_format_bc3_srgb:
+    case tr_format_bc5_unorm:
+    case tr_format_bc6h_ufloat:
+    case tr_format_bc7_unorm:
+    case tr_format_bc7_srgb:
+    case tr_format_etc2_r8g8b8a8_unorm:
+    case tr_format_etc2_r8g8b8a8_srgb:
+    case tr_format_astc_4x4_unorm:
+    case tr_format_astc_4x4_srgb:
+        result = 16;
+        break;
+    default:
+        result = tr_util_format_stride(format);
+        break;
+    }
+    return result;
+}
+
+uint64_t tr_util_calc_texture_size(tr_format format, uint32_t width, uint32_t height,
+                                   uint32_t mip_levels)
+{
+    const uint32_t block_width = tr_util_format_block_width(format);
+    const uint32_t block_height = tr_util_format_block_height(format);
+    const uint32_t block_size = tr_util_format_block_size(format);
+
+    uint64_t result = 0;
+    for (uint32_t mip_level = 0; mip_level < mip_levels; ++mip_level)
+    {
+        uint64_t blocks_x = (width + block_width - 1) / block_width;
+        uint64_t blocks_y = (height + block_height - 1) / block_height;
+        result += blocks_x * blocks_y * block_size;
+        width = tr_max(width >> 1, 1);
+        height = tr_max(height >> 1, 1);
+    }
+    return result;
+}
+
+bool tr_renderer_supports_format(tr_renderer* p_renderer, tr_format format,
+                                 tr_texture_usage_flags usage)
+{
+    assert(NULL != p_renderer);
+
+    bool result = false;
+    if (p_renderer->api == tr_api_vulkan)
+    {
+        result = tr_internal_vk_supports_format(p_renderer, format, usage);
+    }
+    else
+    {
+        result = tr_internal_dx_supports_format(p_renderer, format, usage);
     }
     return result;
 }
@@ -1812,6 +4719,12 @@ uint32_t tr_util_format_channel_count(tr_format format)
     case tr_format_r8g8b8a8_unorm:
         result = 4;
         break;
+    case tr_format_b8g8r8a8_srgb:
+        result = 4;
+        break;
+    case tr_format_r8g8b8a8_srgb:
+        result = 4;
+        break;
     case tr_format_r16g16b16a16_unorm:
         result = 4;
         break;
@@ -1846,6 +4759,29 @@ uint32_t tr_util_format_channel_count(tr_format format)
     case tr_format_d32_float_s8_uint:
         result = 0;
         break;
+        // Block compressed
+    case tr_format_bc4_unorm:
+        result = 1;
+        break;
+    case tr_format_bc5_unorm:
+        result = 2;
+        break;
+    case tr_format_bc6h_ufloat:
+    case tr_format_etc2_r8g8b8_unorm:
+        result = 3;
+        break;
+    case tr_format_bc1_rgba_unorm:
+    case tr_format_bc1_rgba_srgb:
+    case tr_format_bc3_unorm:
+    case tr_format_bc3_srgb:
+    case tr_format_bc7_unorm:
+    case tr_format_bc7_srgb:
+    case tr_format_etc2_r8g8b8a8_unorm:
+    case tr_format_etc2_r8g8b8a8_srgb:
+    case tr_format_astc_4x4_unorm:
+    case tr_format_astc_4x4_srgb:
+        result = 4;
+        break;
     }
     return result;
 }
@@ -1856,21 +4792,10 @@ void tr_queue_transition_buffer(tr_queue* p_queue, tr_buffer* p_buffer, tr_buffe
     assert(NULL != p_queue);
     assert(NULL != p_buffer);
 
-    tr_cmd_pool* p_cmd_pool = NULL;
-    tr_create_cmd_pool(p_queue->renderer, p_queue, true, &p_cmd_pool);
-
-    tr_cmd* p_cmd = NULL;
-    tr_create_cmd(p_cmd_pool, false, &p_cmd);
-
-    tr_begin_cmd(p_cmd);
+    tr_upload_context* p_upload = tr_internal_get_upload_context(p_queue);
+    tr_cmd* p_cmd = tr_internal_upload_begin_cmd(p_upload);
     tr_cmd_buffer_transition(p_cmd, p_buffer, old_usage, new_usage);
-    tr_end_cmd(p_cmd);
-
-    tr_queue_submit(p_queue, 1, &p_cmd, 0, NULL, 0, NULL);
-    tr_queue_wait_idle(p_queue);
-
-    tr_destroy_cmd(p_cmd_pool, p_cmd);
-    tr_destroy_cmd_pool(p_queue->renderer, p_cmd_pool);
+    tr_internal_upload_end_cmd(p_upload);
 }
 
 void tr_queue_transition_image(tr_queue* p_queue, tr_texture* p_texture, tr_texture_usage old_usage,
@@ -1893,21 +4818,10 @@ void tr_queue_transition_image(tr_queue* p_queue, tr_texture* p_texture, tr_text
         return;
     }
 
-    tr_cmd_pool* p_cmd_pool = NULL;
-    tr_create_cmd_pool(p_queue->renderer, p_queue, true, &p_cmd_pool);
-
-    tr_cmd* p_cmd = NULL;
-    tr_create_cmd(p_cmd_pool, false, &p_cmd);
-
-    tr_begin_cmd(p_cmd);
+    tr_upload_context* p_upload = tr_internal_get_upload_context(p_queue);
+    tr_cmd* p_cmd = tr_internal_upload_begin_cmd(p_upload);
     tr_cmd_image_transition(p_cmd, p_texture, old_usage, new_usage);
-    tr_end_cmd(p_cmd);
-
-    tr_queue_submit(p_queue, 1, &p_cmd, 0, NULL, 0, NULL);
-    tr_queue_wait_idle(p_queue);
-
-    tr_destroy_cmd(p_cmd_pool, p_cmd);
-    tr_destroy_cmd_pool(p_queue->renderer, p_cmd_pool);
+    tr_internal_upload_end_cmd(p_upload);
 }
 
 void tr_queue_update_texture_float(tr_queue* p_queue, uint32_t src_width, uint32_t src_height,
@@ -1973,6 +4887,7 @@ void tr_create_renderer(const char* app_name, const tr_renderer_settings* settin
             tr_internal_vk_create_instance(app_name, p_renderer);
             tr_internal_vk_create_surface(p_renderer);
             tr_internal_vk_create_device(p_renderer);
+            tr_internal_vk_create_pipeline_cache(p_renderer);
             tr_internal_vk_create_swapchain(p_renderer);
         }
         else
@@ -2013,6 +4928,11 @@ void tr_create_renderer(const char* app_name, const tr_renderer_settings* settin
             tr_create_semaphore(p_renderer, &(p_renderer->render_complete_semaphores[i]));
         }
 
+        tr_create_descriptor_pool(p_renderer, false, tr_descriptor_pool_block_set_count,
+                                  &(p_renderer->descriptor_pool));
+
+        tr_internal_create_bindless(p_renderer);
+
         // Renderer is good! Assign it to result!
         *(pp_renderer) = p_renderer;
     }
@@ -2023,7 +4943,8 @@ tr_renderer* s_tr_internal = NULL;
 // Proxy log callback
 void tr_internal_log(tr_log_type type, const char* msg, const char* component)
 {
-    if (s_tr_internal->settings.log_fn)
+    // tr_reflect_spirv can run before a renderer exists
+    if ((NULL != s_tr_internal) && s_tr_internal->settings.log_fn)
     {
         s_tr_internal->settings.log_fn(type, msg, component);
     }
@@ -2064,6 +4985,199 @@ bool tr_image_resize_uint8_t(uint32_t src_width, uint32_t src_height, uint32_t s
     return true;
 }
 
+// -------------------------------------------------------------------------------------------------
+// CPU mip generation
+// -------------------------------------------------------------------------------------------------
+// sRGB <-> linear tables. Linear values are fixed point with 4 fractional bits over a 12 bit
+// range, so the sum of a 2x2 block shifted down by 6 indexes to_srgb. That lands within one step
+// of the exact result.
+struct tr_internal_srgb_tables
+{
+    uint16_t to_linear[256];
+    uint8_t to_srgb[4096];
+
+    tr_internal_srgb_tables()
+    {
+        for (uint32_t i = 0; i < 256; ++i)
+        {
+            float c = (float)i / 255.0f;
+            float l = (c <= 0.04045f) ? (c / 12.92f) : powf((c + 0.055f) / 1.055f, 2.4f);
+            to_linear[i] = (uint16_t)(l * (4095.0f * 16.0f) + 0.5f);
+        }
+        for (uint32_t i = 0; i < 4096; ++i)
+        {
+            float l = (float)i / 4095.0f;
+            float c = (l <= 0.0031308f) ? (l * 12.92f) : (1.055f * powf(l, 1.0f / 2.4f) - 0.055f);
+            to_srgb[i] = (uint8_t)(c * 255.0f + 0.5f);
+        }
+    }
+};
+
+static const tr_internal_srgb_tables& tr_internal_get_srgb_tables()
+{
+    static const tr_internal_srgb_tables s_tables;
+    return s_tables;
+}
+
+// Averages 2x2 source blocks into rows [first_row, last_row) of the destination. Odd sizes drop
+// the last source row or column like a GPU blit does, a source 1 pixel across repeats it.
+static void tr_internal_downsample_rows_uint8(uint32_t src_width, uint32_t src_height,
+                                              uint32_t src_row_stride, const uint8_t* src_data,
+                                              uint32_t dst_width, uint32_t dst_row_stride,
+                                              uint8_t* dst_data, uint32_t channel_count, bool srgb,
+                                              uint32_t first_row, uint32_t last_row)
+{
+    const tr_internal_srgb_tables* p_tables = srgb ? &tr_internal_get_srgb_tables() : NULL;
+    // Alpha is linear in sRGB formats
+    const uint32_t color_channel_count = (4 == channel_count) ? 3 : channel_count;
+
+    for (uint32_t y = first_row; y < last_row; ++y)
+    {
+        const uint8_t* row0 = src_data + (2 * y) * src_row_stride;
+        const uint8_t* row1 = src_data + tr_min(2 * y + 1, src_height - 1) * src_row_stride;
+        uint8_t* dst = dst_data + y * dst_row_stride;
+
+        uint32_t x = 0;
+#if defined(TINY_RENDERER_SSE2)
+        // Four RGBA pixels per iteration, widened to 16 bits so the sum is exact
+        if (!srgb && (4 == channel_count))
+        {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i round = _mm_set1_epi16(2);
+            const uint32_t sse_width = (src_width / 8) * 4;
+            for (; x < sse_width; x += 4)
+            {
+                __m128i a0 = _mm_loadu_si128((const __m128i*)(row0 + 8 * x));
+                __m128i a1 = _mm_loadu_si128((const __m128i*)(row0 + 8 * x + 16));
+                __m128i b0 = _mm_loadu_si128((const __m128i*)(row1 + 8 * x));
+                __m128i b1 = _mm_loadu_si128((const __m128i*)(row1 + 8 * x + 16));
+                // Vertical sums, two source pixels per register
+                __m128i v0 =
+                    _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(b0, zero));
+                __m128i v1 =
+                    _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(b0, zero));
+                __m128i v2 =
+                    _mm_add_epi16(_mm_unpacklo_epi8(a1, zero), _mm_unpacklo_epi8(b1, zero));
+                __m128i v3 =
+                    _mm_add_epi16(_mm_unpackhi_epi8(a1, zero), _mm_unpackhi_epi8(b1, zero));
+                // Horizontal sums, one destination pixel per 64 bit half
+                __m128i h0 =
+                    _mm_add_epi16(_mm_unpacklo_epi64(v0, v1), _mm_unpackhi_epi64(v0, v1));
+                __m128i h1 =
+                    _mm_add_epi16(_mm_unpacklo_epi64(v2, v3), _mm_unpackhi_epi64(v2, v3));
+                h0 = _mm_srli_epi16(_mm_add_epi16(h0, round), 2);
+                h1 = _mm_srli_epi16(_mm_add_epi16(h1, round), 2);
+                _mm_storeu_si128((__m128i*)(dst + 4 * x), _mm_packus_epi16(h0, h1));
+            }
+        }
+#endif
+        // RGBA8 sRGB, the common case for color textures
+        if ((NULL != p_tables) && (4 == channel_count))
+        {
+            const uint16_t* to_linear = p_tables->to_linear;
+            const uint8_t* to_srgb = p_tables->to_srgb;
+            const uint32_t last_x = (src_width > 1) ? dst_width : 0;
+            for (; x < last_x; ++x)
+            {
+                const uint8_t* a = row0 + 8 * x;
+                const uint8_t* b = row1 + 8 * x;
+                uint8_t* d = dst + 4 * x;
+                d[0] = to_srgb[(to_linear[a[0]] + to_linear[a[4]] + to_linear[b[0]] +
+                                to_linear[b[4]] + 32) >> 6];
+                d[1] = to_srgb[(to_linear[a[1]] + to_linear[a[5]] + to_linear[b[1]] +
+                                to_linear[b[5]] + 32) >> 6];
+                d[2] = to_srgb[(to_linear[a[2]] + to_linear[a[6]] + to_linear[b[2]] +
+                                to_linear[b[6]] + 32) >> 6];
+                d[3] = (uint8_t)((a[3] + a[7] + b[3] + b[7] + 2) >> 2);
+            }
+        }
+        for (; x < dst_width; ++x)
+        {
+            const uint32_t x0 = (2 * x) * channel_count;
+            const uint32_t x1 = tr_min(2 * x + 1, src_width - 1) * channel_count;
+            uint32_t c = 0;
+            if (NULL != p_tables)
+            {
+                const uint16_t* to_linear = p_tables->to_linear;
+                for (; c < color_channel_count; ++c)
+                {
+                    uint32_t sum = to_linear[row0[x0 + c]] + to_linear[row0[x1 + c]] +
+                                   to_linear[row1[x0 + c]] + to_linear[row1[x1 + c]];
+                    dst[x * channel_count + c] = p_tables->to_srgb[(sum + 32) >> 6];
+                }
+            }
+            for (; c < channel_count; ++c)
+            {
+                uint32_t sum = row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c];
+                dst[x * channel_count + c] = (uint8_t)((sum + 2) >> 2);
+            }
+        }
+    }
+}
+
+void tr_image_downsample_uint8(uint32_t src_width, uint32_t src_height, uint32_t src_row_stride,
+                               const uint8_t* src_data, uint32_t dst_row_stride, uint8_t* dst_data,
+                               uint32_t channel_count, bool srgb, uint32_t thread_count)
+{
+    assert((src_width > 0) && (src_height > 0));
+    assert(NULL != src_data);
+    assert(NULL != dst_data);
+    assert((channel_count > 0) && (channel_count <= 4));
+
+    const uint32_t dst_width = tr_max(src_width >> 1, 1);
+    const uint32_t dst_height = tr_max(src_height >> 1, 1);
+    if (0 == thread_count)
+    {
+        thread_count = tr_max(std::thread::hardware_concurrency(), 1);
+    }
+    // Not worth waking threads for small levels
+    const uint32_t min_rows_per_thread = tr_max((64 * 1024) / dst_width, 1);
+    thread_count = tr_min(thread_count, tr_max(dst_height / min_rows_per_thread, 1));
+
+    const uint32_t rows_per_thread = (dst_height + thread_count - 1) / thread_count;
+    std::vector<std::thread> threads;
+    threads.reserve(thread_count - 1);
+    for (uint32_t i = 1; i < thread_count; ++i)
+    {
+        uint32_t first_row = i * rows_per_thread;
+        uint32_t last_row = tr_min(first_row + rows_per_thread, dst_height);
+        if (first_row < last_row)
+        {
+            threads.push_back(std::thread(tr_internal_downsample_rows_uint8, src_width, src_height,
+                                          src_row_stride, src_data, dst_width, dst_row_stride,
+                                          dst_data, channel_count, srgb, first_row, last_row));
+        }
+    }
+    tr_internal_downsample_rows_uint8(src_width, src_height, src_row_stride, src_data, dst_width,
+                                      dst_row_stride, dst_data, channel_count, srgb, 0,
+                                      tr_min(rows_per_thread, dst_height));
+    for (size_t i = 0; i < threads.size(); ++i)
+    {
+        threads[i].join();
+    }
+}
+
+void tr_internal_downsample_uint8(tr_renderer* p_renderer, uint32_t src_width, uint32_t src_height,
+                                  uint32_t src_row_stride, const uint8_t* src_data,
+                                  uint32_t dst_row_stride, uint8_t* dst_data,
+                                  uint32_t channel_count, bool srgb)
+{
+    assert((src_width > 0) && (src_height > 0));
+    assert(NULL != src_data);
+    assert(NULL != dst_data);
+    assert((channel_count > 0) && (channel_count <= 4));
+
+    const uint32_t dst_width = tr_max(src_width >> 1, 1);
+    const uint32_t dst_height = tr_max(src_height >> 1, 1);
+    // Same minimum range as the thread split above
+    const uint32_t min_rows = tr_max((64 * 1024) / dst_width, 1);
+    tr_internal_parallel_for(p_renderer, dst_height, min_rows, [=](uint32_t first, uint32_t last) {
+        tr_internal_downsample_rows_uint8(src_width, src_height, src_row_stride, src_data,
+                                          dst_width, dst_row_stride, dst_data, channel_count, srgb,
+                                          first, last);
+    });
+}
+
 void tr_internal_create_swapchain_renderpass(tr_renderer* p_renderer)
 {
     TINY_RENDERER_RENDERER_PTR_CHECK(p_renderer);
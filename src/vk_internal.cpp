@@ -1,5 +1,10 @@
 #include "vk_internal.h"
 
+#include <algorithm>
+#include <fstream>
+#include <stddef.h>
+#include <string.h>
+
 #pragma comment(lib, "vulkan-1.lib")
 
 using namespace std;
@@ -277,7 +282,7 @@ bool tr_internal_vk_find_queue_family(VkPhysicalDevice gpu, const VkQueueFlags q
     vkGetPhysicalDeviceQueueFamilyProperties(gpu, &count, properties.data());
 
     VkBool32 found = VK_FALSE;
-    for (uint32_t index = 0; 0 < count; ++index)
+    for (uint32_t index = 0; index < count; ++index)
     {
         if (queue_flags == (properties[index].queueFlags & queue_flags))
         {
@@ -299,7 +304,8 @@ bool tr_internal_vk_find_queue_family(VkPhysicalDevice gpu, const VkQueueFlags q
 }
 
 bool tr_internal_vk_find_present_queue_family(VkPhysicalDevice gpu, VkSurfaceKHR surface,
-                                              uint32_t* p_queue_family_index)
+                                              uint32_t* p_queue_family_index,
+                                              VkQueueFamilyProperties* p_queue_family_properties)
 {
     uint32_t count = 0;
     vkGetPhysicalDeviceQueueFamilyProperties(gpu, &count, NULL);
@@ -308,6 +314,10 @@ bool tr_internal_vk_find_present_queue_family(VkPhysicalDevice gpu, VkSurfaceKHR
         return false;
     }
 
+    vector<VkQueueFamilyProperties> properties(count);
+
+    vkGetPhysicalDeviceQueueFamilyProperties(gpu, &count, properties.data());
+
     VkBool32 found = VK_FALSE;
     for (uint32_t index = 0; index < count; ++index)
     {
@@ -320,6 +330,11 @@ bool tr_internal_vk_find_present_queue_family(VkPhysicalDevice gpu, VkSurfaceKHR
             {
                 *p_queue_family_index = index;
             }
+            if (NULL != p_queue_family_properties)
+            {
+                memcpy(p_queue_family_properties, &properties[index],
+                       sizeof(*p_queue_family_properties));
+            }
             break;
         }
     }
@@ -327,30 +342,86 @@ bool tr_internal_vk_find_present_queue_family(VkPhysicalDevice gpu, VkSurfaceKHR
     return (VK_TRUE == found) ? true : false;
 }
 
+// Finds a family that has queue_flags but none of excluded_flags, e.g. transfer-only queues
+bool tr_internal_vk_find_dedicated_queue_family(VkPhysicalDevice gpu,
+                                                const VkQueueFlags queue_flags,
+                                                const VkQueueFlags excluded_flags,
+                                                uint32_t* p_queue_family_index,
+                                                VkQueueFamilyProperties* p_queue_family_properties)
+{
+    uint32_t count = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(gpu, &count, NULL);
+    if (0 == count)
+    {
+        return false;
+    }
+
+    vector<VkQueueFamilyProperties> properties(count);
+
+    vkGetPhysicalDeviceQueueFamilyProperties(gpu, &count, properties.data());
+
+    for (uint32_t index = 0; index < count; ++index)
+    {
+        if ((queue_flags == (properties[index].queueFlags & queue_flags)) &&
+            (0 == (properties[index].queueFlags & excluded_flags)))
+        {
+            if (NULL != p_queue_family_index)
+            {
+                *p_queue_family_index = index;
+            }
+            if (NULL != p_queue_family_properties)
+            {
+                memcpy(p_queue_family_properties, &properties[index],
+                       sizeof(*p_queue_family_properties));
+            }
+            return true;
+        }
+    }
+
+    return false;
+}
+
 void tr_internal_vk_create_instance(const char* app_name, tr_renderer* p_renderer)
 {
     uint32_t count = 0;
-    VkLayerProperties layers[100];
-    VkExtensionProperties exts[100];
     vkEnumerateInstanceLayerProperties(&count, NULL);
-    vkEnumerateInstanceLayerProperties(&count, layers);
+    vector<VkLayerProperties> layers(count);
+    vkEnumerateInstanceLayerProperties(&count, layers.data());
     for (uint32_t i = 0; i < count; ++i)
     {
         tr_internal_log(tr_log_type_info, layers[i].layerName, "vkinstance-layer");
     }
+    count = 0;
     vkEnumerateInstanceExtensionProperties(NULL, &count, NULL);
-    vkEnumerateInstanceExtensionProperties(NULL, &count, exts);
+    vector<VkExtensionProperties> exts(count);
+    vkEnumerateInstanceExtensionProperties(NULL, &count, exts.data());
     for (uint32_t i = 0; i < count; ++i)
     {
         tr_internal_log(tr_log_type_info, exts[i].extensionName, "vkinstance-ext");
     }
 
+    // Ask for 1.1 when the loader has it, features2/properties2 are core there. A 1.0 loader
+    // doesn't export vkEnumerateInstanceVersion and would reject anything above 1.0.
+    uint32_t api_version = VK_MAKE_VERSION(1, 0, 3);
+#if defined(VK_VERSION_1_1)
+    PFN_vkEnumerateInstanceVersion enumerate_instance_version =
+        (PFN_vkEnumerateInstanceVersion)vkGetInstanceProcAddr(NULL, "vkEnumerateInstanceVersion");
+    uint32_t loader_version = 0;
+    if ((NULL != enumerate_instance_version) &&
+        (VK_SUCCESS == enumerate_instance_version(&loader_version)) &&
+        (loader_version >= VK_API_VERSION_1_1))
+    {
+        api_version = VK_API_VERSION_1_1;
+    }
+#endif
+    p_renderer->vk_api_version = api_version;
+
     VkApplicationInfo app_info = { VK_STRUCTURE_TYPE_APPLICATION_INFO };
     app_info.pApplicationName = app_name;
     app_info.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
     app_info.pEngineName = "vgfx";
     app_info.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-    app_info.apiVersion = VK_MAKE_VERSION(1, 0, 3);
+    app_info.apiVersion = api_version;
 
     // Instance
     {
@@ -480,6 +551,21 @@ void tr_internal_vk_create_surface(tr_renderer* p_renderer)
 #endif
 }
 
+// Appends name to the device extensions unless the settings already asked for it
+static void tr_internal_vk_request_device_extension(const char** extensions,
+                                                    uint32_t* p_extension_count, const char* name)
+{
+    for (uint32_t i = 0; i < *p_extension_count; ++i)
+    {
+        if (0 == strcmp(extensions[i], name))
+        {
+            return;
+        }
+    }
+    assert(*p_extension_count < tr_max_instance_extensions);
+    extensions[(*p_extension_count)++] = name;
+}
+
 void tr_internal_vk_create_device(tr_renderer* p_renderer)
 {
     assert(VK_NULL_HANDLE != p_renderer->vk_instance);
@@ -506,16 +592,20 @@ void tr_internal_vk_create_device(tr_renderer* p_renderer)
 
         // Make sure GPU supports graphics queue
         uint32_t graphics_queue_family_index = UINT32_MAX;
+        VkQueueFamilyProperties graphics_queue_family_properties = {};
         if (!tr_internal_vk_find_queue_family(gpu, VK_QUEUE_GRAPHICS_BIT,
-                                              &graphics_queue_family_index, NULL))
+                                              &graphics_queue_family_index,
+                                              &graphics_queue_family_properties))
         {
             continue;
         }
 
         // Make sure GPU supports present
         uint32_t present_queue_family_index = UINT32_MAX;
+        VkQueueFamilyProperties present_queue_family_properties = {};
         if (!tr_internal_vk_find_present_queue_family(gpu, p_renderer->vk_surface,
-                                                      &present_queue_family_index))
+                                                      &present_queue_family_index,
+                                                      &present_queue_family_properties))
         {
             continue;
         }
@@ -526,7 +616,10 @@ void tr_internal_vk_create_device(tr_renderer* p_renderer)
             p_renderer->vk_active_gpu = gpu;
             p_renderer->vk_active_gpu_index = gpu_index;
             p_renderer->graphics_queue->vk_queue_family_index = graphics_queue_family_index;
+            p_renderer->graphics_queue->vk_queue_flags =
+                graphics_queue_family_properties.queueFlags;
             p_renderer->present_queue->vk_queue_family_index = present_queue_family_index;
+            p_renderer->present_queue->vk_queue_flags = present_queue_family_properties.queueFlags;
             break;
         }
     }
@@ -535,13 +628,34 @@ void tr_internal_vk_create_device(tr_renderer* p_renderer)
     // to pick the integrated GPU instead of the discrete one.
     assert(VK_NULL_HANDLE != p_renderer->vk_active_gpu);
 
+    // Drivers expose well over 100 device extensions these days, size the list from the count
     uint32_t count = 0;
-    VkExtensionProperties exts[100];
     vkEnumerateDeviceExtensionProperties(p_renderer->vk_active_gpu, NULL, &count, NULL);
-    vkEnumerateDeviceExtensionProperties(p_renderer->vk_active_gpu, NULL, &count, exts);
+    vector<VkExtensionProperties> exts(count);
+    vkEnumerateDeviceExtensionProperties(p_renderer->vk_active_gpu, NULL, &count, exts.data());
     for (uint32_t i = 0; i < count; ++i)
     {
         tr_internal_log(tr_log_type_info, exts[i].extensionName, "vkdevice-ext");
+#if defined(VK_KHR_timeline_semaphore)
+        if (0 == strcmp(exts[i].extensionName, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME))
+        {
+            p_renderer->vk_device_ext_VK_KHR_timeline_semaphore = true;
+        }
+#endif
+#if defined(VK_KHR_descriptor_update_template)
+        if (0 == strcmp(exts[i].extensionName, VK_KHR_DESCRIPTOR_UPDATE_TEMPLATE_EXTENSION_NAME))
+        {
+            p_renderer->vk_device_ext_VK_KHR_descriptor_update_template = true;
+        }
+#endif
+#if defined(VK_EXT_descriptor_indexing)
+        // Only turned on for renderers that asked for bindless
+        if (p_renderer->settings.bindless &&
+            (0 == strcmp(exts[i].extensionName, VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME)))
+        {
+            p_renderer->vk_device_ext_VK_EXT_descriptor_indexing = true;
+        }
+#endif
     }
 
     // Get memory properties
@@ -552,25 +666,87 @@ void tr_internal_vk_create_device(tr_renderer* p_renderer)
     vkGetPhysicalDeviceProperties(p_renderer->vk_active_gpu,
                                   &(p_renderer->vk_active_gpu_properties));
 
+    // The *2 queries are only usable when both the instance and the device are 1.1, they stay
+    // NULL otherwise and callers fall back to the 1.0 queries
+    p_renderer->vk_api_version =
+        tr_min(p_renderer->vk_api_version, p_renderer->vk_active_gpu_properties.apiVersion);
+#if defined(VK_VERSION_1_1)
+    if (p_renderer->vk_api_version >= VK_API_VERSION_1_1)
+    {
+        p_renderer->vkGetPhysicalDeviceFeatures2 =
+            (PFN_vkGetPhysicalDeviceFeatures2)vkGetInstanceProcAddr(
+                p_renderer->vk_instance, "vkGetPhysicalDeviceFeatures2");
+        p_renderer->vkGetPhysicalDeviceProperties2 =
+            (PFN_vkGetPhysicalDeviceProperties2)vkGetInstanceProcAddr(
+                p_renderer->vk_instance, "vkGetPhysicalDeviceProperties2");
+    }
+#endif
+
+    // Dedicated transfer and async compute queues are optional, they stay NULL when the GPU
+    // doesn't expose a separate family for them
+    uint32_t transfer_queue_family_index = UINT32_MAX;
+    VkQueueFamilyProperties transfer_queue_family_properties = {};
+    if (tr_internal_vk_find_dedicated_queue_family(
+            p_renderer->vk_active_gpu, VK_QUEUE_TRANSFER_BIT,
+            VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT, &transfer_queue_family_index,
+            &transfer_queue_family_properties))
+    {
+        p_renderer->transfer_queue = new tr_queue();
+        assert(NULL != p_renderer->transfer_queue);
+
+        p_renderer->transfer_queue->renderer = p_renderer;
+        p_renderer->transfer_queue->vk_queue_family_index = transfer_queue_family_index;
+        p_renderer->transfer_queue->vk_queue_flags = transfer_queue_family_properties.queueFlags;
+    }
+
+    uint32_t compute_queue_family_index = UINT32_MAX;
+    VkQueueFamilyProperties compute_queue_family_properties = {};
+    if (tr_internal_vk_find_dedicated_queue_family(
+            p_renderer->vk_active_gpu, VK_QUEUE_COMPUTE_BIT, VK_QUEUE_GRAPHICS_BIT,
+            &compute_queue_family_index, &compute_queue_family_properties))
+    {
+        p_renderer->compute_queue = new tr_queue();
+        assert(NULL != p_renderer->compute_queue);
+
+        p_renderer->compute_queue->renderer = p_renderer;
+        p_renderer->compute_queue->vk_queue_family_index = compute_queue_family_index;
+        p_renderer->compute_queue->vk_queue_flags = compute_queue_family_properties.queueFlags;
+    }
+
+    // One VkDeviceQueueCreateInfo per distinct family
+    uint32_t queue_family_indices[4] = {
+        p_renderer->graphics_queue->vk_queue_family_index,
+        p_renderer->present_queue->vk_queue_family_index,
+        transfer_queue_family_index,
+        compute_queue_family_index,
+    };
     float queue_priorites[1] = {1.0f};
-    uint32_t queue_create_infos_count = 1;
-    VkDeviceQueueCreateInfo queue_create_infos[2] = {};
-    queue_create_infos[0].sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-    queue_create_infos[0].pNext = NULL;
-    queue_create_infos[0].flags = 0;
-    queue_create_infos[0].queueFamilyIndex = p_renderer->graphics_queue->vk_queue_family_index;
-    queue_create_infos[0].queueCount = 1;
-    queue_create_infos[0].pQueuePriorities = queue_priorites;
-    if (p_renderer->graphics_queue->vk_queue_family_index !=
-        p_renderer->present_queue->vk_queue_family_index)
-    {
-        queue_create_infos_count = 2;
-        queue_create_infos[1].sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-        queue_create_infos[1].pNext = NULL;
-        queue_create_infos[1].flags = 0;
-        queue_create_infos[1].queueFamilyIndex = p_renderer->present_queue->vk_queue_family_index;
-        queue_create_infos[1].queueCount = 1;
-        queue_create_infos[1].pQueuePriorities = queue_priorites;
+    uint32_t queue_create_infos_count = 0;
+    VkDeviceQueueCreateInfo queue_create_infos[4] = {};
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        if (UINT32_MAX == queue_family_indices[i])
+        {
+            continue;
+        }
+
+        bool duplicate = false;
+        for (uint32_t j = 0; j < queue_create_infos_count; ++j)
+        {
+            duplicate |= (queue_create_infos[j].queueFamilyIndex == queue_family_indices[i]);
+        }
+        if (duplicate)
+        {
+            continue;
+        }
+
+        VkDeviceQueueCreateInfo* p_info = &queue_create_infos[queue_create_infos_count++];
+        p_info->sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+        p_info->pNext = NULL;
+        p_info->flags = 0;
+        p_info->queueFamilyIndex = queue_family_indices[i];
+        p_info->queueCount = 1;
+        p_info->pQueuePriorities = queue_priorites;
     }
 
     // Device extensions
@@ -597,7 +773,83 @@ void tr_internal_vk_create_device(tr_renderer* p_renderer)
     gpu_features.multiViewport = VK_FALSE;
     gpu_features.geometryShader = VK_TRUE;
 
+    const void* p_device_next = NULL;
+#if defined(VK_KHR_timeline_semaphore)
+    VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timeline_features = {
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR};
+    // Querying the feature needs features2, without it stay on binary semaphores
+    if (NULL == p_renderer->vkGetPhysicalDeviceFeatures2)
+    {
+        p_renderer->vk_device_ext_VK_KHR_timeline_semaphore = false;
+    }
+    if (p_renderer->vk_device_ext_VK_KHR_timeline_semaphore)
+    {
+        VkPhysicalDeviceFeatures2 features2 = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
+        features2.pNext = &timeline_features;
+        p_renderer->vkGetPhysicalDeviceFeatures2(p_renderer->vk_active_gpu, &features2);
+        p_renderer->vk_device_ext_VK_KHR_timeline_semaphore =
+            (VK_TRUE == timeline_features.timelineSemaphore);
+    }
+    if (p_renderer->vk_device_ext_VK_KHR_timeline_semaphore)
+    {
+        tr_internal_vk_request_device_extension(extensions, &extension_count,
+                                                VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+        timeline_features.pNext = NULL;
+        p_device_next = &timeline_features;
+    }
+#endif
+#if defined(VK_KHR_descriptor_update_template)
+    if (p_renderer->vk_device_ext_VK_KHR_descriptor_update_template)
+    {
+        tr_internal_vk_request_device_extension(extensions, &extension_count,
+                                                VK_KHR_DESCRIPTOR_UPDATE_TEMPLATE_EXTENSION_NAME);
+    }
+#endif
+#if defined(VK_EXT_descriptor_indexing)
+    // Only what the bindless set needs, plus non-uniform indexing when it's there
+    VkPhysicalDeviceDescriptorIndexingFeaturesEXT indexing_features = {
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT};
+    if (NULL == p_renderer->vkGetPhysicalDeviceFeatures2)
+    {
+        p_renderer->vk_device_ext_VK_EXT_descriptor_indexing = false;
+    }
+    if (p_renderer->vk_device_ext_VK_EXT_descriptor_indexing)
+    {
+        VkPhysicalDeviceFeatures2 features2 = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
+        features2.pNext = &indexing_features;
+        p_renderer->vkGetPhysicalDeviceFeatures2(p_renderer->vk_active_gpu, &features2);
+        p_renderer->vk_device_ext_VK_EXT_descriptor_indexing =
+            (VK_TRUE == indexing_features.runtimeDescriptorArray) &&
+            (VK_TRUE == indexing_features.descriptorBindingPartiallyBound) &&
+            (VK_TRUE == indexing_features.descriptorBindingSampledImageUpdateAfterBind) &&
+            (VK_TRUE == indexing_features.descriptorBindingStorageBufferUpdateAfterBind) &&
+            (VK_TRUE == indexing_features.descriptorBindingUpdateUnusedWhilePending);
+    }
+    if (p_renderer->vk_device_ext_VK_EXT_descriptor_indexing)
+    {
+        tr_internal_vk_request_device_extension(extensions, &extension_count,
+                                                VK_KHR_MAINTENANCE3_EXTENSION_NAME);
+        tr_internal_vk_request_device_extension(extensions, &extension_count,
+                                                VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+
+        VkPhysicalDeviceDescriptorIndexingFeaturesEXT supported = indexing_features;
+        indexing_features = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT};
+        indexing_features.pNext = (void*)p_device_next;
+        indexing_features.runtimeDescriptorArray = VK_TRUE;
+        indexing_features.descriptorBindingPartiallyBound = VK_TRUE;
+        indexing_features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+        indexing_features.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+        indexing_features.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+        indexing_features.shaderSampledImageArrayNonUniformIndexing =
+            supported.shaderSampledImageArrayNonUniformIndexing;
+        indexing_features.shaderStorageBufferArrayNonUniformIndexing =
+            supported.shaderStorageBufferArrayNonUniformIndexing;
+        p_device_next = &indexing_features;
+    }
+#endif
+
     VkDeviceCreateInfo create_info = { VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO };
+    create_info.pNext = p_device_next;
     create_info.flags = 0;
     create_info.queueCreateInfoCount = queue_create_infos_count;
     create_info.pQueueCreateInfos = queue_create_infos;
@@ -618,6 +870,20 @@ void tr_internal_vk_create_device(tr_renderer* p_renderer)
                      &(p_renderer->present_queue->vk_queue));
     assert(VK_NULL_HANDLE != p_renderer->present_queue->vk_queue);
 
+    if (NULL != p_renderer->transfer_queue)
+    {
+        vkGetDeviceQueue(p_renderer->vk_device, p_renderer->transfer_queue->vk_queue_family_index,
+                         0, &(p_renderer->transfer_queue->vk_queue));
+        assert(VK_NULL_HANDLE != p_renderer->transfer_queue->vk_queue);
+    }
+
+    if (NULL != p_renderer->compute_queue)
+    {
+        vkGetDeviceQueue(p_renderer->vk_device, p_renderer->compute_queue->vk_queue_family_index,
+                         0, &(p_renderer->compute_queue->vk_queue));
+        assert(VK_NULL_HANDLE != p_renderer->compute_queue->vk_queue);
+    }
+
     VGFX_VK_LOAD_PROC(p_renderer->vk_device, vkCreateAccelerationStructureNVX);
     VGFX_VK_LOAD_PROC(p_renderer->vk_device, vkDestroyAccelerationStructureNVX);
     VGFX_VK_LOAD_PROC(p_renderer->vk_device, vkGetAccelerationStructureMemoryRequirementsNVX);
@@ -631,11 +897,33 @@ void tr_internal_vk_create_device(tr_renderer* p_renderer)
     VGFX_VK_LOAD_PROC(p_renderer->vk_device, vkCreateRaytracingPipelinesNVX);
     VGFX_VK_LOAD_PROC(p_renderer->vk_device, vkGetAccelerationStructureHandleNVX);
 
+#if defined(VK_KHR_timeline_semaphore)
+    if (p_renderer->vk_device_ext_VK_KHR_timeline_semaphore)
+    {
+        VGFX_VK_LOAD_PROC(p_renderer->vk_device, vkGetSemaphoreCounterValueKHR);
+        VGFX_VK_LOAD_PROC(p_renderer->vk_device, vkWaitSemaphoresKHR);
+        VGFX_VK_LOAD_PROC(p_renderer->vk_device, vkSignalSemaphoreKHR);
+    }
+#endif
+#if defined(VK_KHR_descriptor_update_template)
+    if (p_renderer->vk_device_ext_VK_KHR_descriptor_update_template)
+    {
+        VGFX_VK_LOAD_PROC(p_renderer->vk_device, vkCreateDescriptorUpdateTemplateKHR);
+        VGFX_VK_LOAD_PROC(p_renderer->vk_device, vkDestroyDescriptorUpdateTemplateKHR);
+        VGFX_VK_LOAD_PROC(p_renderer->vk_device, vkUpdateDescriptorSetWithTemplateKHR);
+    }
+#endif
+
     // Query values of shaderHeaderSize and maxRecursionDepth in current implementation
-    VkPhysicalDeviceProperties2 props;
-    props.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
-    props.pNext = &p_renderer->_raytracingProperties;
-    vkGetPhysicalDeviceProperties2(p_renderer->vk_active_gpu, &props);
+#if defined(VK_VERSION_1_1)
+    if (NULL != p_renderer->vkGetPhysicalDeviceProperties2)
+    {
+        VkPhysicalDeviceProperties2 props;
+        props.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        props.pNext = &p_renderer->_raytracingProperties;
+        p_renderer->vkGetPhysicalDeviceProperties2(p_renderer->vk_active_gpu, &props);
+    }
+#endif
 }
 
 void tr_internal_vk_create_swapchain(tr_renderer* p_renderer)
@@ -853,6 +1141,144 @@ void tr_internal_vk_create_swapchain_renderpass(tr_renderer* p_renderer)
     }
 }
 
+// Prefix of the pipeline cache file. VkPipelineCache data carries the pipeline cache UUID but not
+// the driver version, so a driver update could otherwise hand stale data to the driver.
+struct tr_internal_vk_pipeline_cache_header
+{
+    uint32_t magic;
+    uint32_t header_size;
+    uint32_t vendor_id;
+    uint32_t device_id;
+    uint32_t driver_version;
+    uint8_t device_uuid[VK_UUID_SIZE];
+    uint8_t pipeline_cache_uuid[VK_UUID_SIZE];
+    uint64_t data_size;
+};
+
+static const uint32_t tr_internal_vk_pipeline_cache_magic = 0x43505254; // 'TRPC'
+
+static void
+tr_internal_vk_fill_pipeline_cache_header(tr_renderer* p_renderer,
+                                          tr_internal_vk_pipeline_cache_header* p_header)
+{
+    const VkPhysicalDeviceProperties* p_props = &(p_renderer->vk_active_gpu_properties);
+
+    memset(p_header, 0, sizeof(*p_header));
+    p_header->magic = tr_internal_vk_pipeline_cache_magic;
+    p_header->header_size = sizeof(*p_header);
+    p_header->vendor_id = p_props->vendorID;
+    p_header->device_id = p_props->deviceID;
+    p_header->driver_version = p_props->driverVersion;
+    memcpy(p_header->pipeline_cache_uuid, p_props->pipelineCacheUUID, VK_UUID_SIZE);
+
+    // deviceUUID needs 1.1, on 1.0 it stays zero and vendor/device/driver have to do
+#if defined(VK_VERSION_1_1)
+    if (NULL != p_renderer->vkGetPhysicalDeviceProperties2)
+    {
+        VkPhysicalDeviceIDProperties id_props = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES};
+        VkPhysicalDeviceProperties2 props = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2};
+        props.pNext = &id_props;
+        p_renderer->vkGetPhysicalDeviceProperties2(p_renderer->vk_active_gpu, &props);
+        memcpy(p_header->device_uuid, id_props.deviceUUID, VK_UUID_SIZE);
+    }
+#endif
+}
+
+void tr_internal_vk_create_pipeline_cache(tr_renderer* p_renderer)
+{
+    assert(VK_NULL_HANDLE != p_renderer->vk_device);
+
+    std::vector<uint8_t> data;
+    const std::string& path = p_renderer->settings.vk_pipeline_cache_path;
+    if (!path.empty())
+    {
+        std::ifstream is(path.c_str(), std::ios::binary);
+        tr_internal_vk_pipeline_cache_header file_header = {};
+        if (is.is_open() && is.read((char*)&file_header, sizeof(file_header)))
+        {
+            tr_internal_vk_pipeline_cache_header header = {};
+            tr_internal_vk_fill_pipeline_cache_header(p_renderer, &header);
+            header.data_size = file_header.data_size;
+            // data_size comes from disk, a corrupt file mustn't turn into a huge allocation
+            std::streampos data_start = is.tellg();
+            is.seekg(0, std::ios::end);
+            std::streamoff remaining = is.tellg() - data_start;
+            is.seekg(data_start);
+            if ((remaining < 0) || (file_header.data_size > (uint64_t)remaining))
+            {
+                tr_internal_log(tr_log_type_warn, "Pipeline cache file is truncated, ignoring it",
+                                "tr_internal_vk_create_pipeline_cache");
+            }
+            else if (0 == memcmp(&header, &file_header, sizeof(header)))
+            {
+                data.resize((size_t)file_header.data_size);
+                if (!is.read((char*)data.data(), data.size()))
+                {
+                    data.clear();
+                }
+            }
+            else
+            {
+                tr_internal_log(tr_log_type_warn,
+                                "Pipeline cache was saved by another device or driver, ignoring it",
+                                "tr_internal_vk_create_pipeline_cache");
+            }
+        }
+    }
+
+    VkPipelineCacheCreateInfo create_info = {};
+    create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    create_info.pNext = NULL;
+    create_info.flags = 0;
+    create_info.initialDataSize = data.size();
+    create_info.pInitialData = data.empty() ? NULL : data.data();
+    VkResult vk_res = vkCreatePipelineCache(p_renderer->vk_device, &create_info, NULL,
+                                            &(p_renderer->vk_pipeline_cache));
+    assert(VK_SUCCESS == vk_res);
+
+    p_renderer->pipeline_stats.cache_warm = !data.empty();
+    p_renderer->pipeline_stats.cache_loaded_bytes = data.size();
+}
+
+void tr_internal_vk_destroy_pipeline_cache(tr_renderer* p_renderer)
+{
+    assert(VK_NULL_HANDLE != p_renderer->vk_device);
+    assert(VK_NULL_HANDLE != p_renderer->vk_pipeline_cache);
+
+    const std::string& path = p_renderer->settings.vk_pipeline_cache_path;
+    if (!path.empty())
+    {
+        size_t size = 0;
+        VkResult vk_res =
+            vkGetPipelineCacheData(p_renderer->vk_device, p_renderer->vk_pipeline_cache, &size,
+                                   NULL);
+        assert(VK_SUCCESS == vk_res);
+
+        std::vector<uint8_t> data(size);
+        vk_res = vkGetPipelineCacheData(p_renderer->vk_device, p_renderer->vk_pipeline_cache,
+                                        &size, data.data());
+        assert(VK_SUCCESS == vk_res);
+
+        tr_internal_vk_pipeline_cache_header header = {};
+        tr_internal_vk_fill_pipeline_cache_header(p_renderer, &header);
+        header.data_size = size;
+
+        std::ofstream os(path.c_str(), std::ios::binary | std::ios::trunc);
+        if (os.is_open())
+        {
+            os.write((const char*)&header, sizeof(header));
+            os.write((const char*)data.data(), size);
+        }
+        else
+        {
+            tr_internal_log(tr_log_type_warn, "Couldn't write the pipeline cache file",
+                            "tr_internal_vk_destroy_pipeline_cache");
+        }
+    }
+
+    vkDestroyPipelineCache(p_renderer->vk_device, p_renderer->vk_pipeline_cache, NULL);
+}
+
 void tr_internal_vk_destroy_instance(tr_renderer* p_renderer)
 {
     assert(VK_NULL_HANDLE != p_renderer->vk_instance);
@@ -888,6 +1314,259 @@ void tr_internal_vk_destroy_swapchain(tr_renderer* p_renderer)
     vkDestroySwapchainKHR(p_renderer->vk_device, p_renderer->vk_swapchain, NULL);
 }
 
+// -------------------------------------------------------------------------------------------------
+// Internal memory functions
+// -------------------------------------------------------------------------------------------------
+static uint32_t tr_internal_vk_memory_order_count()
+{
+    uint32_t count = 1;
+    while (((VkDeviceSize)tr_memory_min_allocation_size << (count - 1)) <
+           (VkDeviceSize)tr_memory_block_size)
+    {
+        ++count;
+    }
+    return count;
+}
+
+static tr_memory_block* tr_internal_vk_create_memory_block(tr_renderer* p_renderer,
+                                                           uint32_t memory_type_index, bool linear)
+{
+    VkMemoryAllocateInfo alloc_info = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+    alloc_info.allocationSize = tr_memory_block_size;
+    alloc_info.memoryTypeIndex = memory_type_index;
+
+    VkDeviceMemory vk_memory = VK_NULL_HANDLE;
+    VkResult vk_res = vkAllocateMemory(p_renderer->vk_device, &alloc_info, NULL, &vk_memory);
+    if (VK_SUCCESS != vk_res)
+    {
+        return NULL;
+    }
+
+    tr_memory_block* p_block = new tr_memory_block();
+    assert(NULL != p_block);
+
+    p_block->vk_memory = vk_memory;
+    p_block->memory_type_index = memory_type_index;
+    p_block->linear = linear;
+    p_block->allocation_count = 0;
+
+    // Host visible blocks stay mapped for their whole lifetime
+    const VkMemoryPropertyFlags property_flags =
+        p_renderer->vk_memory_properties.memoryTypes[memory_type_index].propertyFlags;
+    if (property_flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+    {
+        vk_res = vkMapMemory(p_renderer->vk_device, p_block->vk_memory, 0, VK_WHOLE_SIZE, 0,
+                             &(p_block->cpu_mapped_address));
+        assert(VK_SUCCESS == vk_res);
+    }
+
+    // The whole block starts out as one free entry of the largest order
+    p_block->free_lists.resize(tr_internal_vk_memory_order_count());
+    p_block->free_lists.back().push_back(0);
+
+    p_renderer->vk_memory_blocks.push_back(p_block);
+    p_renderer->memory_stats.device_memory_count += 1;
+    p_renderer->memory_stats.block_count += 1;
+    p_renderer->memory_stats.reserved_bytes += tr_memory_block_size;
+
+    return p_block;
+}
+
+static bool tr_internal_vk_memory_block_alloc(tr_memory_block* p_block, uint32_t order,
+                                              VkDeviceSize* p_offset)
+{
+    uint32_t free_order = order;
+    while ((free_order < p_block->free_lists.size()) && p_block->free_lists[free_order].empty())
+    {
+        ++free_order;
+    }
+    if (free_order >= p_block->free_lists.size())
+    {
+        return false;
+    }
+
+    VkDeviceSize offset = p_block->free_lists[free_order].back();
+    p_block->free_lists[free_order].pop_back();
+
+    // Split until the entry is the requested size, upper halves go back on the free lists
+    while (free_order > order)
+    {
+        --free_order;
+        VkDeviceSize half_size = (VkDeviceSize)tr_memory_min_allocation_size << free_order;
+        p_block->free_lists[free_order].push_back(offset + half_size);
+    }
+
+    *p_offset = offset;
+    return true;
+}
+
+static void tr_internal_vk_memory_block_free(tr_memory_block* p_block, uint32_t order,
+                                             VkDeviceSize offset)
+{
+    // Merge with the buddy for as long as it's free
+    while ((order + 1) < p_block->free_lists.size())
+    {
+        VkDeviceSize buddy = offset ^ ((VkDeviceSize)tr_memory_min_allocation_size << order);
+        std::vector<VkDeviceSize>& free_list = p_block->free_lists[order];
+        auto it = std::find(free_list.begin(), free_list.end(), buddy);
+        if (it == free_list.end())
+        {
+            break;
+        }
+        free_list.erase(it);
+        offset = tr_min_u64(offset, buddy);
+        ++order;
+    }
+    p_block->free_lists[order].push_back(offset);
+}
+
+void tr_internal_vk_allocate_memory(tr_renderer* p_renderer, const VkMemoryRequirements& mem_reqs,
+                                    VkMemoryPropertyFlags mem_flags, bool linear,
+                                    tr_memory_allocation* p_allocation)
+{
+    assert(VK_NULL_HANDLE != p_renderer->vk_device);
+
+    uint32_t memory_type_index = UINT32_MAX;
+    bool found_memory = tr_util_vk_get_memory_type(mem_reqs, mem_flags, &memory_type_index);
+    assert(found_memory);
+
+    *p_allocation = {};
+
+    // Buddy blocks are naturally aligned to their size, so rounding up to the alignment is enough
+    VkDeviceSize size = tr_max_u64(mem_reqs.size, mem_reqs.alignment);
+    uint32_t order = 0;
+    while (((VkDeviceSize)tr_memory_min_allocation_size << order) < size)
+    {
+        ++order;
+    }
+    size = (VkDeviceSize)tr_memory_min_allocation_size << order;
+
+    if (size <= (VkDeviceSize)tr_memory_block_size)
+    {
+        for (tr_memory_block* p_block : p_renderer->vk_memory_blocks)
+        {
+            if ((p_block->memory_type_index != memory_type_index) || (p_block->linear != linear))
+            {
+                continue;
+            }
+            if (tr_internal_vk_memory_block_alloc(p_block, order, &(p_allocation->offset)))
+            {
+                p_allocation->block = p_block;
+                break;
+            }
+        }
+
+        if (NULL == p_allocation->block)
+        {
+            tr_memory_block* p_block =
+                tr_internal_vk_create_memory_block(p_renderer, memory_type_index, linear);
+            if ((NULL != p_block) &&
+                tr_internal_vk_memory_block_alloc(p_block, order, &(p_allocation->offset)))
+            {
+                p_allocation->block = p_block;
+            }
+        }
+    }
+
+    if (NULL != p_allocation->block)
+    {
+        tr_memory_block* p_block = p_allocation->block;
+        p_block->allocation_count += 1;
+        p_allocation->vk_memory = p_block->vk_memory;
+        p_allocation->size = size;
+        if (NULL != p_block->cpu_mapped_address)
+        {
+            p_allocation->cpu_mapped_address =
+                (uint8_t*)p_block->cpu_mapped_address + p_allocation->offset;
+        }
+    }
+    else
+    {
+        // Too large for a block (or the block allocation failed), fall back to a dedicated
+        // allocation
+        VkMemoryAllocateInfo alloc_info = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+        alloc_info.allocationSize = mem_reqs.size;
+        alloc_info.memoryTypeIndex = memory_type_index;
+        VkResult vk_res = vkAllocateMemory(p_renderer->vk_device, &alloc_info, NULL,
+                                           &(p_allocation->vk_memory));
+        assert(VK_SUCCESS == vk_res);
+
+        p_allocation->offset = 0;
+        p_allocation->size = mem_reqs.size;
+        if (mem_flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+        {
+            vk_res = vkMapMemory(p_renderer->vk_device, p_allocation->vk_memory, 0,
+                                 VK_WHOLE_SIZE, 0, &(p_allocation->cpu_mapped_address));
+            assert(VK_SUCCESS == vk_res);
+        }
+
+        p_renderer->memory_stats.device_memory_count += 1;
+        p_renderer->memory_stats.dedicated_count += 1;
+        p_renderer->memory_stats.reserved_bytes += p_allocation->size;
+    }
+
+    p_renderer->memory_stats.allocation_count += 1;
+    p_renderer->memory_stats.used_bytes += p_allocation->size;
+}
+
+void tr_internal_vk_free_memory(tr_renderer* p_renderer, tr_memory_allocation* p_allocation)
+{
+    assert(VK_NULL_HANDLE != p_renderer->vk_device);
+    assert(VK_NULL_HANDLE != p_allocation->vk_memory);
+
+    if (NULL != p_allocation->block)
+    {
+        tr_memory_block* p_block = p_allocation->block;
+        uint32_t order = 0;
+        while (((VkDeviceSize)tr_memory_min_allocation_size << order) < p_allocation->size)
+        {
+            ++order;
+        }
+        tr_internal_vk_memory_block_free(p_block, order, p_allocation->offset);
+
+        assert(p_block->allocation_count > 0);
+        p_block->allocation_count -= 1;
+
+        // Empty blocks are kept around so that steady state streaming never hits
+        // vkAllocateMemory, they're released in tr_internal_vk_destroy_memory_blocks
+    }
+    else
+    {
+        vkFreeMemory(p_renderer->vk_device, p_allocation->vk_memory, NULL);
+
+        p_renderer->memory_stats.device_memory_count -= 1;
+        p_renderer->memory_stats.dedicated_count -= 1;
+        p_renderer->memory_stats.reserved_bytes -= p_allocation->size;
+    }
+
+    p_renderer->memory_stats.allocation_count -= 1;
+    p_renderer->memory_stats.used_bytes -= p_allocation->size;
+
+    *p_allocation = {};
+}
+
+void tr_internal_vk_destroy_memory_blocks(tr_renderer* p_renderer)
+{
+    assert(VK_NULL_HANDLE != p_renderer->vk_device);
+
+    for (tr_memory_block* p_block : p_renderer->vk_memory_blocks)
+    {
+        if (p_block->allocation_count > 0)
+        {
+            tr_internal_log(tr_log_type_warn, "Memory block destroyed with live allocations",
+                            "tr_internal_vk_destroy_memory_blocks");
+        }
+        vkFreeMemory(p_renderer->vk_device, p_block->vk_memory, NULL);
+        delete p_block;
+    }
+    p_renderer->vk_memory_blocks.clear();
+
+    p_renderer->memory_stats.device_memory_count -= p_renderer->memory_stats.block_count;
+    p_renderer->memory_stats.reserved_bytes -=
+        (uint64_t)p_renderer->memory_stats.block_count * tr_memory_block_size;
+    p_renderer->memory_stats.block_count = 0;
+}
+
 // -------------------------------------------------------------------------------------------------
 // Internal create functions
 // -------------------------------------------------------------------------------------------------
@@ -933,162 +1612,478 @@ void tr_internal_vk_destroy_semaphore(tr_renderer* p_renderer, tr_semaphore* p_s
     vkDestroySemaphore(p_renderer->vk_device, p_semaphore->vk_semaphore, NULL);
 }
 
+void tr_internal_vk_create_timeline_semaphore(tr_renderer* p_renderer, uint64_t initial_value,
+                                             tr_semaphore* p_semaphore)
+{
+    assert(VK_NULL_HANDLE != p_renderer->vk_device);
+    assert(p_renderer->vk_device_ext_VK_KHR_timeline_semaphore);
+
+#if defined(VK_KHR_timeline_semaphore)
+    VkSemaphoreTypeCreateInfoKHR type_create_info = {};
+    type_create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR;
+    type_create_info.pNext = NULL;
+    type_create_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR;
+    type_create_info.initialValue = initial_value;
+
+    VkSemaphoreCreateInfo create_info = {};
+    create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    create_info.pNext = &type_create_info;
+    create_info.flags = 0;
+    VkResult vk_res =
+        vkCreateSemaphore(p_renderer->vk_device, &create_info, NULL, &(p_semaphore->vk_semaphore));
+    assert(VK_SUCCESS == vk_res);
+#endif
+}
+
+// Descriptor types in pool sizes, VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT is the last core one
+static const uint32_t tr_internal_vk_descriptor_type_count = 11;
+
+// Descriptors per set a block is sized for, by VkDescriptorType
+static const uint32_t tr_internal_vk_descriptors_per_set[tr_internal_vk_descriptor_type_count] = {
+    2, // VK_DESCRIPTOR_TYPE_SAMPLER
+    0, // VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER
+    4, // VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE
+    1, // VK_DESCRIPTOR_TYPE_STORAGE_IMAGE
+    1, // VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER
+    1, // VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER
+    2, // VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER
+    2, // VK_DESCRIPTOR_TYPE_STORAGE_BUFFER
+    2, // VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC
+    0, // VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC
+    0, // VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT
+};
+
+// Adds a block big enough for sets_per_block average sets and at least one set of p_set_sizes
+static VkDescriptorPool tr_internal_vk_add_descriptor_pool_block(
+    tr_renderer* p_renderer, tr_descriptor_pool* p_descriptor_pool, const uint32_t* p_set_sizes)
+{
+    uint32_t pool_size_count = 0;
+    VkDescriptorPoolSize pool_sizes[tr_internal_vk_descriptor_type_count] = {};
+    for (uint32_t i = 0; i < tr_internal_vk_descriptor_type_count; ++i)
+    {
+        uint32_t count = tr_max(p_descriptor_pool->sets_per_block *
+                                    tr_internal_vk_descriptors_per_set[i],
+                                p_set_sizes[i]);
+        if (count > 0)
+        {
+            pool_sizes[pool_size_count].type = (VkDescriptorType)i;
+            pool_sizes[pool_size_count].descriptorCount = count;
+            ++pool_size_count;
+        }
+    }
+
+    VkDescriptorPoolCreateInfo create_info = {};
+    create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    create_info.pNext = NULL;
+    // Transient blocks are only ever reset as a whole
+    create_info.flags =
+        p_descriptor_pool->transient ? 0 : VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+    create_info.maxSets = p_descriptor_pool->sets_per_block;
+    create_info.poolSizeCount = pool_size_count;
+    create_info.pPoolSizes = pool_sizes;
+    VkDescriptorPool vk_descriptor_pool = VK_NULL_HANDLE;
+    VkResult vk_res =
+        vkCreateDescriptorPool(p_renderer->vk_device, &create_info, NULL, &vk_descriptor_pool);
+    assert(VK_SUCCESS == vk_res);
+
+    p_descriptor_pool->vk_descriptor_pools.push_back(vk_descriptor_pool);
+    return vk_descriptor_pool;
+}
+
+// Tries the blocks from vk_pool_index on and adds a block when they're all full
+static void tr_internal_vk_allocate_descriptor_set(tr_renderer* p_renderer,
+                                                   tr_descriptor_set* p_descriptor_set,
+                                                   const uint32_t* p_set_sizes)
+{
+    tr_descriptor_pool* p_descriptor_pool = p_descriptor_set->descriptor_pool;
+    std::lock_guard<std::mutex> lock(p_descriptor_pool->mutex);
+
+    VkDescriptorSetAllocateInfo alloc_info = {};
+    alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    alloc_info.pNext = NULL;
+    alloc_info.descriptorSetCount = 1;
+    alloc_info.pSetLayouts = &(p_descriptor_set->vk_descriptor_set_layout);
+
+    std::vector<VkDescriptorPool>& pools = p_descriptor_pool->vk_descriptor_pools;
+    for (; p_descriptor_pool->vk_pool_index < pools.size(); ++p_descriptor_pool->vk_pool_index)
+    {
+        // Full or fragmented blocks fail with VK_ERROR_OUT_OF_POOL_MEMORY or
+        // VK_ERROR_FRAGMENTED_POOL, move on to the next one
+        alloc_info.descriptorPool = pools[p_descriptor_pool->vk_pool_index];
+        VkResult vk_res = vkAllocateDescriptorSets(p_renderer->vk_device, &alloc_info,
+                                                   &(p_descriptor_set->vk_descriptor_set));
+        if (VK_SUCCESS == vk_res)
+        {
+            p_descriptor_set->vk_descriptor_pool = alloc_info.descriptorPool;
+            return;
+        }
+    }
+
+    alloc_info.descriptorPool =
+        tr_internal_vk_add_descriptor_pool_block(p_renderer, p_descriptor_pool, p_set_sizes);
+    VkResult vk_res = vkAllocateDescriptorSets(p_renderer->vk_device, &alloc_info,
+                                               &(p_descriptor_set->vk_descriptor_set));
+    assert(VK_SUCCESS == vk_res);
+    p_descriptor_set->vk_descriptor_pool = alloc_info.descriptorPool;
+}
+
+void tr_internal_vk_destroy_descriptor_pool(tr_renderer* p_renderer,
+                                            tr_descriptor_pool* p_descriptor_pool)
+{
+    assert(VK_NULL_HANDLE != p_renderer->vk_device);
+
+    for (size_t i = 0; i < p_descriptor_pool->vk_descriptor_pools.size(); ++i)
+    {
+        vkDestroyDescriptorPool(p_renderer->vk_device, p_descriptor_pool->vk_descriptor_pools[i],
+                                NULL);
+    }
+    p_descriptor_pool->vk_descriptor_pools.clear();
+}
+
+void tr_internal_vk_reset_descriptor_pool(tr_renderer* p_renderer,
+                                          tr_descriptor_pool* p_descriptor_pool)
+{
+    assert(VK_NULL_HANDLE != p_renderer->vk_device);
+
+    std::lock_guard<std::mutex> lock(p_descriptor_pool->mutex);
+    for (size_t i = 0; i < p_descriptor_pool->vk_descriptor_pools.size(); ++i)
+    {
+        VkResult vk_res = vkResetDescriptorPool(p_renderer->vk_device,
+                                                p_descriptor_pool->vk_descriptor_pools[i], 0);
+        assert(VK_SUCCESS == vk_res);
+    }
+    p_descriptor_pool->vk_pool_index = 0;
+}
+
+// Returns VK_DESCRIPTOR_TYPE_MAX_ENUM for types Vulkan has no descriptor for
+static VkDescriptorType tr_internal_vk_to_descriptor_type(tr_descriptor_type type)
+{
+    switch (type)
+    {
+    case tr_descriptor_type_sampler:
+        return VK_DESCRIPTOR_TYPE_SAMPLER;
+    case tr_descriptor_type_uniform_buffer_cbv:
+        return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    case tr_descriptor_type_uniform_buffer_dynamic_cbv:
+        return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    case tr_descriptor_type_storage_buffer_srv:
+        return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    case tr_descriptor_type_storage_buffer_uav:
+        return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    case tr_descriptor_type_uniform_texel_buffer_srv:
+        return VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+    case tr_descriptor_type_storage_texel_buffer_uav:
+        return VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER;
+    case tr_descriptor_type_texture_srv:
+        return VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+    case tr_descriptor_type_texture_uav:
+        return VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    default:
+        break;
+    }
+    return VK_DESCRIPTOR_TYPE_MAX_ENUM;
+}
+
 void tr_internal_vk_create_descriptor_set(tr_renderer* p_renderer,
                                           tr_descriptor_set* p_descriptor_set)
 {
     assert(VK_NULL_HANDLE != p_renderer->vk_device);
 
-    enum
-    {
-        max_types = 12
-    };
-
-    VkDescriptorPoolSize pool_sizes_by_type[max_types] = {};
-    pool_sizes_by_type[VK_DESCRIPTOR_TYPE_SAMPLER].type = VK_DESCRIPTOR_TYPE_SAMPLER;
-    pool_sizes_by_type[VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER].type =
-        VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    pool_sizes_by_type[VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE].type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
-    pool_sizes_by_type[VK_DESCRIPTOR_TYPE_STORAGE_IMAGE].type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
-    pool_sizes_by_type[VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER].type =
-        VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
-    pool_sizes_by_type[VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER].type =
-        VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER;
-    pool_sizes_by_type[VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    pool_sizes_by_type[VK_DESCRIPTOR_TYPE_STORAGE_BUFFER].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-    pool_sizes_by_type[VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC].type =
-        VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
-    pool_sizes_by_type[VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC].type =
-        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
-    pool_sizes_by_type[VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT].type =
-        VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+    // Descriptors of each VkDescriptorType the set needs
+    uint32_t set_sizes[tr_internal_vk_descriptor_type_count] = {};
 
     vector<VkDescriptorSetLayoutBinding> bindings(p_descriptor_set->descriptor_count);
 
+    uint32_t info_count = 0;
+    p_descriptor_set->vk_descriptor_info_offsets.resize(p_descriptor_set->descriptor_count);
     for (uint32_t i = 0; i < p_descriptor_set->descriptor_count; ++i)
     {
         const tr_descriptor* descriptor = &(p_descriptor_set->descriptors[i]);
         VkDescriptorSetLayoutBinding* binding = &(bindings[i]);
-        uint32_t type_index = UINT32_MAX;
-        switch (descriptor->type)
-        {
-        case tr_descriptor_type_sampler:
-            type_index = VK_DESCRIPTOR_TYPE_SAMPLER;
-            break;
-        case tr_descriptor_type_uniform_buffer_cbv:
-            type_index = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-            break;
-        case tr_descriptor_type_storage_buffer_srv:
-            type_index = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-            break;
-        case tr_descriptor_type_storage_buffer_uav:
-            type_index = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-            break;
-        case tr_descriptor_type_uniform_texel_buffer_srv:
-            type_index = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
-            break;
-        case tr_descriptor_type_storage_texel_buffer_uav:
-            type_index = VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER;
-            break;
-        case tr_descriptor_type_texture_srv:
-            type_index = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
-            break;
-        case tr_descriptor_type_texture_uav:
-            type_index = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
-            break;
-        }
-        if (UINT32_MAX != type_index)
+        VkDescriptorType type = tr_internal_vk_to_descriptor_type(descriptor->type);
+        if (VK_DESCRIPTOR_TYPE_MAX_ENUM != type)
         {
             binding->binding = descriptor->binding;
-            binding->descriptorType = (VkDescriptorType)type_index;
+            binding->descriptorType = type;
             binding->descriptorCount = descriptor->count;
             binding->stageFlags = tr_util_to_vk_shader_stages(descriptor->shader_stages);
             binding->pImmutableSamplers = NULL;
 
-            pool_sizes_by_type[type_index].descriptorCount += descriptor->count;
+            set_sizes[type] += descriptor->count;
         }
+
+        // Each descriptor owns a run of elements in the cached infos
+        p_descriptor_set->vk_descriptor_info_offsets[i] = info_count;
+        info_count += descriptor->count;
     }
+    p_descriptor_set->vk_descriptor_infos.resize(info_count);
+    p_descriptor_set->vk_descriptor_resource_ids.resize(info_count);
+    p_descriptor_set->vk_descriptors_written = false;
 
-    uint32_t pool_size_count = 0;
-    VkDescriptorPoolSize pool_sizes[max_types] = {};
-    for (uint32_t i = 0; i < max_types; ++i)
+    // Descriptor set layout
+    {
+        VkDescriptorSetLayoutCreateInfo create_info = {};
+        create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        create_info.pNext = NULL;
+        create_info.flags = 0;
+        create_info.bindingCount = p_descriptor_set->descriptor_count;
+        create_info.pBindings = bindings.data();
+        VkResult vk_res =
+            vkCreateDescriptorSetLayout(p_renderer->vk_device, &create_info, NULL,
+                                        &(p_descriptor_set->vk_descriptor_set_layout));
+        assert(VK_SUCCESS == vk_res);
+    }
+
+    tr_internal_vk_allocate_descriptor_set(p_renderer, p_descriptor_set, set_sizes);
+
+#if defined(VK_KHR_descriptor_update_template)
+    // Update template reading straight out of the cached infos
+    if (p_renderer->vk_device_ext_VK_KHR_descriptor_update_template && (0 != info_count))
     {
-        if (pool_sizes_by_type[i].descriptorCount > 0)
+        vector<VkDescriptorUpdateTemplateEntryKHR> entries;
+        for (uint32_t i = 0; i < p_descriptor_set->descriptor_count; ++i)
         {
-            pool_sizes[pool_size_count].type = pool_sizes_by_type[i].type;
-            pool_sizes[pool_size_count].descriptorCount = pool_sizes_by_type[i].descriptorCount;
-            ++pool_size_count;
+            const tr_descriptor* descriptor = &(p_descriptor_set->descriptors[i]);
+            VkDescriptorType type = tr_internal_vk_to_descriptor_type(descriptor->type);
+            if ((VK_DESCRIPTOR_TYPE_MAX_ENUM == type) || (0 == descriptor->count))
+            {
+                continue;
+            }
+
+            VkDescriptorUpdateTemplateEntryKHR entry = {};
+            entry.dstBinding = descriptor->binding;
+            entry.dstArrayElement = 0;
+            entry.descriptorCount = descriptor->count;
+            entry.descriptorType = type;
+            entry.offset =
+                p_descriptor_set->vk_descriptor_info_offsets[i] * sizeof(tr_vk_descriptor_info);
+            entry.stride = sizeof(tr_vk_descriptor_info);
+            entries.push_back(entry);
         }
+
+        VkDescriptorUpdateTemplateCreateInfoKHR create_info = {};
+        create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO_KHR;
+        create_info.pNext = NULL;
+        create_info.flags = 0;
+        create_info.descriptorUpdateEntryCount = (uint32_t)entries.size();
+        create_info.pDescriptorUpdateEntries = entries.data();
+        create_info.templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET_KHR;
+        create_info.descriptorSetLayout = p_descriptor_set->vk_descriptor_set_layout;
+        VkResult vk_res = p_renderer->vkCreateDescriptorUpdateTemplateKHR(
+            p_renderer->vk_device, &create_info, NULL, &(p_descriptor_set->vk_update_template));
+        assert(VK_SUCCESS == vk_res);
     }
+#endif
+}
 
-    assert(0 != pool_size_count);
+void tr_internal_vk_destroy_descriptor_set(tr_renderer* p_renderer,
+                                           tr_descriptor_set* p_descriptor_set)
+{
+    assert(VK_NULL_HANDLE != p_renderer->vk_device);
+    assert(VK_NULL_HANDLE != p_descriptor_set->vk_descriptor_set_layout);
+    assert(VK_NULL_HANDLE != p_descriptor_set->vk_descriptor_set);
+    assert(VK_NULL_HANDLE != p_descriptor_set->vk_descriptor_pool);
 
-    // Descriptor pool
+    // Transient sets go back to their block when the whole pool is reset
+    tr_descriptor_pool* p_descriptor_pool = p_descriptor_set->descriptor_pool;
+    if (!p_descriptor_pool->transient)
     {
-        VkDescriptorPoolCreateInfo create_info = {};
-        create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-        create_info.pNext = NULL;
-        create_info.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
-        create_info.maxSets = 1;
-        create_info.poolSizeCount = pool_size_count;
-        create_info.pPoolSizes = pool_sizes;
-        VkResult vk_res = vkCreateDescriptorPool(p_renderer->vk_device, &create_info, NULL,
-                                                 &(p_descriptor_set->vk_descriptor_pool));
+        std::lock_guard<std::mutex> lock(p_descriptor_pool->mutex);
+        VkResult vk_res =
+            vkFreeDescriptorSets(p_renderer->vk_device, p_descriptor_set->vk_descriptor_pool, 1,
+                                 &(p_descriptor_set->vk_descriptor_set));
         assert(VK_SUCCESS == vk_res);
+
+        // Try the block with the freed space first on the next allocation
+        std::vector<VkDescriptorPool>& pools = p_descriptor_pool->vk_descriptor_pools;
+        for (uint32_t i = 0; i < p_descriptor_pool->vk_pool_index; ++i)
+        {
+            if (pools[i] == p_descriptor_set->vk_descriptor_pool)
+            {
+                p_descriptor_pool->vk_pool_index = i;
+                break;
+            }
+        }
+    }
+
+#if defined(VK_KHR_descriptor_update_template)
+    if (VK_NULL_HANDLE != p_descriptor_set->vk_update_template)
+    {
+        p_renderer->vkDestroyDescriptorUpdateTemplateKHR(
+            p_renderer->vk_device, p_descriptor_set->vk_update_template, NULL);
+    }
+#endif
+
+    vkDestroyDescriptorSetLayout(p_renderer->vk_device, p_descriptor_set->vk_descriptor_set_layout,
+                                 NULL);
+}
+
+void tr_internal_vk_create_bindless_descriptor_set(tr_renderer* p_renderer,
+                                                   tr_descriptor_set* p_descriptor_set)
+{
+    assert(VK_NULL_HANDLE != p_renderer->vk_device);
+    assert(p_renderer->vk_device_ext_VK_EXT_descriptor_indexing);
+    // Binding 0 is the texture array and binding 1 the storage buffer array
+    assert(2 == p_descriptor_set->descriptor_count);
+
+#if defined(VK_EXT_descriptor_indexing)
+    tr_descriptor* p_textures = &(p_descriptor_set->descriptors[0]);
+    tr_descriptor* p_buffers = &(p_descriptor_set->descriptors[1]);
+
+    // Update-after-bind arrays have their own, usually much larger, limits
+    {
+        VkPhysicalDeviceDescriptorIndexingPropertiesEXT indexing_props = {
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT};
+        VkPhysicalDeviceProperties2 props = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2};
+        props.pNext = &indexing_props;
+        // Descriptor indexing is only turned on when the *2 queries were loaded
+        assert(NULL != p_renderer->vkGetPhysicalDeviceProperties2);
+        p_renderer->vkGetPhysicalDeviceProperties2(p_renderer->vk_active_gpu, &props);
+
+        uint32_t max_textures =
+            tr_min(indexing_props.maxPerStageDescriptorUpdateAfterBindSampledImages,
+                   indexing_props.maxDescriptorSetUpdateAfterBindSampledImages);
+        uint32_t max_buffers =
+            tr_min(indexing_props.maxPerStageDescriptorUpdateAfterBindStorageBuffers,
+                   indexing_props.maxDescriptorSetUpdateAfterBindStorageBuffers);
+        p_textures->count = tr_min(p_textures->count, max_textures);
+        p_buffers->count = tr_min(p_buffers->count, max_buffers);
+
+        // Both arrays are visible to every stage, so they share the per stage budget
+        uint32_t max_resources = indexing_props.maxPerStageUpdateAfterBindResources;
+        if (p_textures->count + p_buffers->count > max_resources)
+        {
+            p_textures->count = tr_min(p_textures->count, max_resources / 2);
+            p_buffers->count = tr_min(p_buffers->count, max_resources - p_textures->count);
+        }
     }
 
+    VkDescriptorSetLayoutBinding bindings[2] = {};
+    bindings[0].binding = p_textures->binding;
+    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+    bindings[0].descriptorCount = p_textures->count;
+    bindings[0].stageFlags = VK_SHADER_STAGE_ALL;
+    bindings[1].binding = p_buffers->binding;
+    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    bindings[1].descriptorCount = p_buffers->count;
+    bindings[1].stageFlags = VK_SHADER_STAGE_ALL;
+
+    // Elements can be written while the set is bound and in use by pending command buffers, as
+    // long as those don't read them, and unused ones may stay empty
+    const VkDescriptorBindingFlagsEXT binding_flag_bits =
+        VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT |
+        VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT |
+        VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT_EXT;
+    VkDescriptorBindingFlagsEXT binding_flags[2] = {binding_flag_bits, binding_flag_bits};
+
     // Descriptor set layout
     {
+        VkDescriptorSetLayoutBindingFlagsCreateInfoEXT flags_info = {
+            VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT};
+        flags_info.bindingCount = 2;
+        flags_info.pBindingFlags = binding_flags;
+
         VkDescriptorSetLayoutCreateInfo create_info = {};
         create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-        create_info.pNext = NULL;
-        create_info.flags = 0;
-        create_info.bindingCount = p_descriptor_set->descriptor_count;
-        create_info.pBindings = bindings.data();
+        create_info.pNext = &flags_info;
+        create_info.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT;
+        create_info.bindingCount = 2;
+        create_info.pBindings = bindings;
         VkResult vk_res =
             vkCreateDescriptorSetLayout(p_renderer->vk_device, &create_info, NULL,
                                         &(p_descriptor_set->vk_descriptor_set_layout));
         assert(VK_SUCCESS == vk_res);
     }
 
-    // Allocate descriptor set
+    // The set lives for as long as the renderer, so it gets a pool to itself
+    {
+        VkDescriptorPoolSize pool_sizes[2] = {};
+        pool_sizes[0].type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+        pool_sizes[0].descriptorCount = p_textures->count;
+        pool_sizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        pool_sizes[1].descriptorCount = p_buffers->count;
+
+        VkDescriptorPoolCreateInfo create_info = {};
+        create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        create_info.pNext = NULL;
+        create_info.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
+        create_info.maxSets = 1;
+        create_info.poolSizeCount = 2;
+        create_info.pPoolSizes = pool_sizes;
+        VkResult vk_res = vkCreateDescriptorPool(p_renderer->vk_device, &create_info, NULL,
+                                                 &(p_renderer->vk_bindless_descriptor_pool));
+        assert(VK_SUCCESS == vk_res);
+    }
+
     {
         VkDescriptorSetAllocateInfo alloc_info = {};
         alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
         alloc_info.pNext = NULL;
-        alloc_info.descriptorPool = p_descriptor_set->vk_descriptor_pool;
+        alloc_info.descriptorPool = p_renderer->vk_bindless_descriptor_pool;
         alloc_info.descriptorSetCount = 1;
         alloc_info.pSetLayouts = &(p_descriptor_set->vk_descriptor_set_layout);
         VkResult vk_res = vkAllocateDescriptorSets(p_renderer->vk_device, &alloc_info,
                                                    &(p_descriptor_set->vk_descriptor_set));
         assert(VK_SUCCESS == vk_res);
     }
+    p_descriptor_set->vk_descriptor_pool = p_renderer->vk_bindless_descriptor_pool;
+#endif
 }
 
-void tr_internal_vk_destroy_descriptor_set(tr_renderer* p_renderer,
-                                           tr_descriptor_set* p_descriptor_set)
+void tr_internal_vk_destroy_bindless_descriptor_set(tr_renderer* p_renderer,
+                                                    tr_descriptor_set* p_descriptor_set)
 {
     assert(VK_NULL_HANDLE != p_renderer->vk_device);
-    assert(VK_NULL_HANDLE != p_descriptor_set->vk_descriptor_set_layout);
-    assert(VK_NULL_HANDLE != p_descriptor_set->vk_descriptor_set);
-    assert(VK_NULL_HANDLE != p_descriptor_set->vk_descriptor_pool);
+    assert(VK_NULL_HANDLE != p_renderer->vk_bindless_descriptor_pool);
 
-    VkResult vk_res =
-        vkFreeDescriptorSets(p_renderer->vk_device, p_descriptor_set->vk_descriptor_pool, 1,
-                             &(p_descriptor_set->vk_descriptor_set));
-    assert(VK_SUCCESS == vk_res);
+    // Destroying the pool frees the set with it
+    vkDestroyDescriptorPool(p_renderer->vk_device, p_renderer->vk_bindless_descriptor_pool, NULL);
+    p_renderer->vk_bindless_descriptor_pool = VK_NULL_HANDLE;
 
     vkDestroyDescriptorSetLayout(p_renderer->vk_device, p_descriptor_set->vk_descriptor_set_layout,
                                  NULL);
-    vkDestroyDescriptorPool(p_renderer->vk_device, p_descriptor_set->vk_descriptor_pool, NULL);
+}
+
+void tr_internal_vk_update_bindless_texture(tr_renderer* p_renderer, tr_texture* p_texture)
+{
+    tr_descriptor_set* p_descriptor_set = p_renderer->bindless_descriptor_set;
+    assert(NULL != p_descriptor_set);
+    assert(tr_bindless_invalid_index != p_texture->bindless_index);
+
+    VkWriteDescriptorSet write = {};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = p_descriptor_set->vk_descriptor_set;
+    write.dstBinding = p_descriptor_set->descriptors[0].binding;
+    write.dstArrayElement = p_texture->bindless_index;
+    write.descriptorCount = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+    write.pImageInfo = &(p_texture->vk_texture_view);
+    vkUpdateDescriptorSets(p_renderer->vk_device, 1, &write, 0, NULL);
+}
+
+void tr_internal_vk_update_bindless_buffer(tr_renderer* p_renderer, tr_buffer* p_buffer)
+{
+    tr_descriptor_set* p_descriptor_set = p_renderer->bindless_descriptor_set;
+    assert(NULL != p_descriptor_set);
+    assert(tr_bindless_invalid_index != p_buffer->bindless_index);
+
+    VkWriteDescriptorSet write = {};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = p_descriptor_set->vk_descriptor_set;
+    write.dstBinding = p_descriptor_set->descriptors[1].binding;
+    write.dstArrayElement = p_buffer->bindless_index;
+    write.descriptorCount = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    write.pBufferInfo = &(p_buffer->vk_buffer_info);
+    vkUpdateDescriptorSets(p_renderer->vk_device, 1, &write, 0, NULL);
 }
 
 void tr_internal_vk_create_cmd_pool(tr_renderer* p_renderer, tr_queue* p_queue, bool transient,
                                     tr_cmd_pool* p_cmd_pool)
 {
     assert(VK_NULL_HANDLE != p_renderer->vk_device);
-    assert(p_renderer->graphics_queue->vk_queue_family_index == p_queue->vk_queue_family_index);
-    assert((p_queue->vk_queue_family_index == p_renderer->graphics_queue->vk_queue_family_index) ||
-           (p_queue->vk_queue_family_index == p_renderer->present_queue->vk_queue_family_index));
+    assert((p_queue == p_renderer->graphics_queue) || (p_queue == p_renderer->present_queue) ||
+           (p_queue == p_renderer->transfer_queue) || (p_queue == p_renderer->compute_queue));
 
     VkCommandPoolCreateInfo create_info = {};
     create_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
@@ -1143,6 +2138,8 @@ void tr_internal_vk_create_buffer(tr_renderer* p_renderer, tr_buffer* p_buffer)
 {
     assert(VK_NULL_HANDLE != p_renderer->vk_device);
 
+    p_buffer->vk_resource_id = ++(p_renderer->vk_next_resource_id);
+
     // Align the buffer size to multiples of the dynamic uniform buffer minimum size
     if (p_buffer->usage & tr_buffer_usage_uniform_cbv)
     {
@@ -1179,24 +2176,17 @@ void tr_internal_vk_create_buffer(tr_renderer* p_renderer, tr_buffer* p_buffer)
         mem_flags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
     }
 
-    uint32_t memory_type_index = UINT32_MAX;
-    bool found_memmory = tr_util_vk_get_memory_type(mem_reqs, mem_flags, &memory_type_index);
-    assert(found_memmory);
-
-    VkMemoryAllocateInfo alloc_info = { VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
-    alloc_info.allocationSize = mem_reqs.size;
-    alloc_info.memoryTypeIndex = memory_type_index;
-    vk_res = vkAllocateMemory(p_renderer->vk_device, &alloc_info, NULL, &(p_buffer->vk_memory));
-    assert(VK_SUCCESS == vk_res);
+    tr_internal_vk_allocate_memory(p_renderer, mem_reqs, mem_flags, true,
+                                   &(p_buffer->vk_allocation));
 
-    vk_res = vkBindBufferMemory(p_renderer->vk_device, p_buffer->vk_buffer, p_buffer->vk_memory, 0);
+    vk_res = vkBindBufferMemory(p_renderer->vk_device, p_buffer->vk_buffer,
+                                p_buffer->vk_allocation.vk_memory, p_buffer->vk_allocation.offset);
     assert(VK_SUCCESS == vk_res);
 
     if (p_buffer->host_visible)
     {
-        vk_res = vkMapMemory(p_renderer->vk_device, p_buffer->vk_memory, 0, VK_WHOLE_SIZE, 0,
-                             &(p_buffer->cpu_mapped_address));
-        assert(VK_SUCCESS == vk_res);
+        p_buffer->cpu_mapped_address = p_buffer->vk_allocation.cpu_mapped_address;
+        assert(NULL != p_buffer->cpu_mapped_address);
     }
 
     switch (p_buffer->usage)
@@ -1234,6 +2224,11 @@ void tr_internal_vk_destroy_buffer(tr_renderer* p_renderer, tr_buffer* p_buffer)
     assert(VK_NULL_HANDLE != p_buffer->vk_buffer);
 
     vkDestroyBuffer(p_renderer->vk_device, p_buffer->vk_buffer, NULL);
+
+    if (VK_NULL_HANDLE != p_buffer->vk_allocation.vk_memory)
+    {
+        tr_internal_vk_free_memory(p_renderer, &(p_buffer->vk_allocation));
+    }
 }
 
 void tr_internal_vk_create_texture(tr_renderer* p_renderer, tr_texture* p_texture)
@@ -1241,6 +2236,7 @@ void tr_internal_vk_create_texture(tr_renderer* p_renderer, tr_texture* p_textur
     assert(VK_NULL_HANDLE != p_renderer->vk_device);
 
     p_texture->renderer = p_renderer;
+    p_texture->vk_resource_id = ++(p_renderer->vk_next_resource_id);
 
     if (VK_NULL_HANDLE == p_texture->vk_image)
     {
@@ -1327,26 +2323,19 @@ void tr_internal_vk_create_texture(tr_renderer* p_renderer, tr_texture* p_textur
             mem_flags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
         }
 
-        uint32_t memory_type_index = UINT32_MAX;
-        bool found_memory = tr_util_vk_get_memory_type(mem_reqs, mem_flags, &memory_type_index);
-        assert(found_memory);
-
-        VkMemoryAllocateInfo alloc_info = { VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
-        alloc_info.allocationSize = mem_reqs.size;
-        alloc_info.memoryTypeIndex = memory_type_index;
-        vk_res =
-            vkAllocateMemory(p_renderer->vk_device, &alloc_info, NULL, &(p_texture->vk_memory));
-        assert(VK_SUCCESS == vk_res);
+        tr_internal_vk_allocate_memory(p_renderer, mem_reqs, mem_flags,
+                                       VK_IMAGE_TILING_LINEAR == create_info.tiling,
+                                       &(p_texture->vk_allocation));
 
-        vk_res =
-            vkBindImageMemory(p_renderer->vk_device, p_texture->vk_image, p_texture->vk_memory, 0);
+        vk_res = vkBindImageMemory(p_renderer->vk_device, p_texture->vk_image,
+                                   p_texture->vk_allocation.vk_memory,
+                                   p_texture->vk_allocation.offset);
         assert(VK_SUCCESS == vk_res);
 
         if (p_texture->host_visible)
         {
-            vk_res = vkMapMemory(p_renderer->vk_device, p_texture->vk_memory, 0, VK_WHOLE_SIZE, 0,
-                                 &(p_texture->cpu_mapped_address));
-            assert(VK_SUCCESS == vk_res);
+            p_texture->cpu_mapped_address = p_texture->vk_allocation.cpu_mapped_address;
+            assert(NULL != p_texture->cpu_mapped_address);
         }
 
         p_texture->owns_image = true;
@@ -1408,17 +2397,17 @@ void tr_internal_vk_destroy_texture(tr_renderer* p_renderer, tr_texture* p_textu
     assert(VK_NULL_HANDLE != p_texture->vk_image_view);
     if (p_texture->owns_image)
     {
-        assert(VK_NULL_HANDLE != p_texture->vk_memory);
+        assert(VK_NULL_HANDLE != p_texture->vk_allocation.vk_memory);
     }
 
-    if (VK_NULL_HANDLE != p_texture->vk_memory)
+    if ((VK_NULL_HANDLE != p_texture->vk_image) && (p_texture->owns_image))
     {
-        vkFreeMemory(p_renderer->vk_device, p_texture->vk_memory, NULL);
+        vkDestroyImage(p_renderer->vk_device, p_texture->vk_image, NULL);
     }
 
-    if ((VK_NULL_HANDLE != p_texture->vk_image) && (p_texture->owns_image))
+    if (VK_NULL_HANDLE != p_texture->vk_allocation.vk_memory)
     {
-        vkDestroyImage(p_renderer->vk_device, p_texture->vk_image, NULL);
+        tr_internal_vk_free_memory(p_renderer, &(p_texture->vk_allocation));
     }
 
     if (VK_NULL_HANDLE != p_texture->vk_image_view)
@@ -1427,28 +2416,89 @@ void tr_internal_vk_destroy_texture(tr_renderer* p_renderer, tr_texture* p_textu
     }
 }
 
+static VkSamplerAddressMode tr_internal_vk_to_address_mode(tr_address_mode address_mode)
+{
+    switch (address_mode)
+    {
+    case tr_address_mode_repeat:
+        return VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    case tr_address_mode_mirrored_repeat:
+        return VK_SAMPLER_ADDRESS_MODE_MIRRORED_REPEAT;
+    case tr_address_mode_clamp_to_edge:
+        return VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    case tr_address_mode_clamp_to_border:
+        return VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+    }
+    return VK_SAMPLER_ADDRESS_MODE_REPEAT;
+}
+
+static VkCompareOp tr_internal_vk_to_compare_op(tr_compare_op compare_op)
+{
+    switch (compare_op)
+    {
+    case tr_compare_op_never:
+        return VK_COMPARE_OP_NEVER;
+    case tr_compare_op_less:
+        return VK_COMPARE_OP_LESS;
+    case tr_compare_op_equal:
+        return VK_COMPARE_OP_EQUAL;
+    case tr_compare_op_less_or_equal:
+        return VK_COMPARE_OP_LESS_OR_EQUAL;
+    case tr_compare_op_greater:
+        return VK_COMPARE_OP_GREATER;
+    case tr_compare_op_not_equal:
+        return VK_COMPARE_OP_NOT_EQUAL;
+    case tr_compare_op_greater_or_equal:
+        return VK_COMPARE_OP_GREATER_OR_EQUAL;
+    case tr_compare_op_always:
+        return VK_COMPARE_OP_ALWAYS;
+    }
+    return VK_COMPARE_OP_NEVER;
+}
+
 void tr_internal_vk_create_sampler(tr_renderer* p_renderer, tr_sampler* p_sampler)
 {
     assert(VK_NULL_HANDLE != p_renderer->vk_device);
 
+    p_sampler->vk_resource_id = ++(p_renderer->vk_next_resource_id);
+
+    const tr_sampler_desc* p_desc = &(p_sampler->desc);
+
+    // Device creation turns samplerAnisotropy on whenever the GPU has it
+    float max_anisotropy = 1.0f;
+    if (p_desc->max_anisotropy > 1.0f)
+    {
+        VkPhysicalDeviceFeatures gpu_features = {};
+        vkGetPhysicalDeviceFeatures(p_renderer->vk_active_gpu, &gpu_features);
+        if (VK_TRUE == gpu_features.samplerAnisotropy)
+        {
+            const VkPhysicalDeviceLimits& limits = p_renderer->vk_active_gpu_properties.limits;
+            max_anisotropy = std::min(p_desc->max_anisotropy, limits.maxSamplerAnisotropy);
+        }
+    }
+
     VkSamplerCreateInfo create_info = {};
     create_info.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
     create_info.pNext = NULL;
     create_info.flags = 0;
-    create_info.magFilter = VK_FILTER_LINEAR;
-    create_info.minFilter = VK_FILTER_LINEAR;
-    create_info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
-    create_info.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-    create_info.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-    create_info.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-    create_info.mipLodBias = 0.0f;
-    create_info.anisotropyEnable = VK_FALSE;
-    create_info.maxAnisotropy = 1.0f;
-    create_info.compareEnable = VK_FALSE;
-    create_info.compareOp = VK_COMPARE_OP_NEVER;
-    create_info.minLod = 0.0f;
-    create_info.maxLod = 0.0f;
-    create_info.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_BLACK;
+    create_info.magFilter =
+        (tr_filter_linear == p_desc->mag_filter) ? VK_FILTER_LINEAR : VK_FILTER_NEAREST;
+    create_info.minFilter =
+        (tr_filter_linear == p_desc->min_filter) ? VK_FILTER_LINEAR : VK_FILTER_NEAREST;
+    create_info.mipmapMode = (tr_mipmap_mode_linear == p_desc->mipmap_mode)
+                                 ? VK_SAMPLER_MIPMAP_MODE_LINEAR
+                                 : VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    create_info.addressModeU = tr_internal_vk_to_address_mode(p_desc->address_u);
+    create_info.addressModeV = tr_internal_vk_to_address_mode(p_desc->address_v);
+    create_info.addressModeW = tr_internal_vk_to_address_mode(p_desc->address_w);
+    create_info.mipLodBias = p_desc->mip_lod_bias;
+    create_info.anisotropyEnable = (max_anisotropy > 1.0f) ? VK_TRUE : VK_FALSE;
+    create_info.maxAnisotropy = max_anisotropy;
+    create_info.compareEnable = p_desc->compare_enable ? VK_TRUE : VK_FALSE;
+    create_info.compareOp = tr_internal_vk_to_compare_op(p_desc->compare_op);
+    create_info.minLod = p_desc->min_lod;
+    create_info.maxLod = p_desc->max_lod;
+    create_info.borderColor = VK_BORDER_COLOR_FLOAT_TRANSPARENT_BLACK;
     create_info.unnormalizedCoordinates = VK_FALSE;
     VkResult vk_res =
         vkCreateSampler(p_renderer->vk_device, &create_info, NULL, &(p_sampler->vk_sampler));
@@ -1576,12 +2626,119 @@ void tr_internal_vk_destroy_shader_program(tr_renderer* p_renderer,
     }
 }
 
-void tr_internal_vk_create_pipeline(tr_renderer* p_renderer, tr_shader_program* p_shader_program,
-                                    const tr_vertex_layout* p_vertex_layout,
-                                    tr_descriptor_set* p_descriptor_set,
-                                    tr_render_target* p_render_target,
-                                    const tr_pipeline_settings* p_pipeline_settings,
-                                    tr_pipeline* p_pipeline)
+// Everything a VkGraphicsPipelineCreateInfo points to, so several can be created in one call
+struct tr_internal_vk_graphics_pipeline_state
+{
+    VkPipelineShaderStageCreateInfo stages[5];
+    VkSpecializationMapEntry specialization_entries[tr_max_specialization_constants];
+    VkSpecializationInfo specialization_info;
+    VkVertexInputBindingDescription input_bindings[tr_max_vertex_bindings];
+    VkVertexInputAttributeDescription input_attributes[tr_max_vertex_attribs];
+    VkPipelineVertexInputStateCreateInfo vi;
+    VkPipelineInputAssemblyStateCreateInfo ia;
+    VkPipelineTessellationStateCreateInfo ts;
+    VkPipelineViewportStateCreateInfo vs;
+    VkPipelineRasterizationStateCreateInfo rs;
+    VkPipelineMultisampleStateCreateInfo ms;
+    VkPipelineDepthStencilStateCreateInfo ds;
+    VkPipelineColorBlendAttachmentState cbas;
+    VkPipelineColorBlendStateCreateInfo cb;
+    VkDynamicState dyn_states[9];
+    VkPipelineDynamicStateCreateInfo dy;
+    VkGraphicsPipelineCreateInfo create_info;
+};
+
+// Push constants are a single range at offset 0. The stages come from the SPIR-V reflection when
+// the program declares push constants, otherwise every stage of the program sees them.
+static void tr_internal_vk_create_pipeline_layout(tr_renderer* p_renderer,
+                                                  tr_shader_program* p_shader_program,
+                                                  uint32_t descriptor_set_count,
+                                                  tr_descriptor_set* const* pp_descriptor_sets,
+                                                  const tr_pipeline_settings* p_pipeline_settings,
+                                                  tr_pipeline* p_pipeline)
+{
+    // tr_max_descriptor_sets keeps the D3D12 push constant space fixed, Vulkan devices only have
+    // to support 4 bound sets
+    assert(descriptor_set_count <= tr_max_descriptor_sets);
+    assert(descriptor_set_count <=
+           p_renderer->vk_active_gpu_properties.limits.maxBoundDescriptorSets);
+    VkDescriptorSetLayout set_layouts[tr_max_descriptor_sets];
+    for (uint32_t i = 0; i < descriptor_set_count; ++i)
+    {
+        assert(NULL != pp_descriptor_sets[i]);
+        set_layouts[i] = pp_descriptor_sets[i]->vk_descriptor_set_layout;
+    }
+
+    uint32_t push_constant_size = p_pipeline_settings->push_constant_size;
+    assert((push_constant_size % 4) == 0);
+    assert(push_constant_size <= tr_max_push_constant_size);
+
+    uint32_t shader_stages = p_shader_program->shader_stages;
+    const tr_shader_reflection& reflection = p_shader_program->reflection;
+    if (!reflection.push_constant_ranges.empty())
+    {
+        shader_stages = 0;
+        for (size_t i = 0; i < reflection.push_constant_ranges.size(); ++i)
+        {
+            shader_stages |= reflection.push_constant_ranges[i].shader_stages;
+        }
+    }
+
+    VkPushConstantRange push_constant_range = {};
+    push_constant_range.stageFlags = tr_util_to_vk_shader_stages((tr_shader_stage)shader_stages);
+    push_constant_range.offset = 0;
+    push_constant_range.size = push_constant_size;
+    p_pipeline->vk_push_constant_stages =
+        (push_constant_size > 0) ? push_constant_range.stageFlags : 0;
+
+    VkPipelineLayoutCreateInfo create_info = {};
+    create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    create_info.pNext = NULL;
+    create_info.flags = 0;
+    create_info.setLayoutCount = descriptor_set_count;
+    create_info.pSetLayouts = (descriptor_set_count > 0) ? set_layouts : NULL;
+    create_info.pushConstantRangeCount = (push_constant_size > 0) ? 1 : 0;
+    create_info.pPushConstantRanges = (push_constant_size > 0) ? &push_constant_range : NULL;
+    VkResult vk_res = vkCreatePipelineLayout(p_renderer->vk_device, &create_info, NULL,
+                                             &(p_pipeline->vk_pipeline_layout));
+    assert(VK_SUCCESS == vk_res);
+}
+
+// Returns the specialization info for p_pipeline_settings or NULL if it has no constants. The data
+// is read straight out of p_pipeline_settings, so it has to outlive the pipeline create call.
+static const VkSpecializationInfo* tr_internal_vk_fill_specialization_info(
+    const tr_pipeline_settings* p_pipeline_settings, VkSpecializationMapEntry* p_entries,
+    VkSpecializationInfo* p_specialization_info)
+{
+    uint32_t constant_count = p_pipeline_settings->specialization_constant_count;
+    assert(constant_count <= tr_max_specialization_constants);
+    if (0 == constant_count)
+    {
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < constant_count; ++i)
+    {
+        p_entries[i].constantID = p_pipeline_settings->specialization_constants[i].constant_id;
+        p_entries[i].offset = (uint32_t)(i * sizeof(tr_specialization_constant) +
+                                         offsetof(tr_specialization_constant, value));
+        p_entries[i].size = sizeof(uint32_t);
+    }
+
+    p_specialization_info->mapEntryCount = constant_count;
+    p_specialization_info->pMapEntries = p_entries;
+    p_specialization_info->dataSize = constant_count * sizeof(tr_specialization_constant);
+    p_specialization_info->pData = p_pipeline_settings->specialization_constants;
+    return p_specialization_info;
+}
+
+// Creates the pipeline layout and fills p_state->create_info, which points into p_state
+static void tr_internal_vk_fill_graphics_pipeline_state(
+    tr_renderer* p_renderer, tr_shader_program* p_shader_program,
+    const tr_vertex_layout* p_vertex_layout, uint32_t descriptor_set_count,
+    tr_descriptor_set* const* pp_descriptor_sets, tr_render_target* p_render_target,
+    const tr_pipeline_settings* p_pipeline_settings, tr_pipeline* p_pipeline,
+    tr_internal_vk_graphics_pipeline_state* p_state)
 {
     assert(VK_NULL_HANDLE != p_renderer->vk_device);
     assert((VK_NULL_HANDLE != p_shader_program->vk_vert) ||
@@ -1592,25 +2749,18 @@ void tr_internal_vk_create_pipeline(tr_renderer* p_renderer, tr_shader_program*
     assert(VK_NULL_HANDLE != p_render_target->vk_render_pass);
 
     // Pipeline layout
-    {
-        VkPipelineLayoutCreateInfo create_info = {};
-        create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-        create_info.pNext = NULL;
-        create_info.flags = 0;
-        create_info.setLayoutCount = (NULL != p_descriptor_set) ? 1 : 0;
-        create_info.pSetLayouts =
-            (NULL != p_descriptor_set) ? &(p_descriptor_set->vk_descriptor_set_layout) : NULL;
-        create_info.pushConstantRangeCount = 0;
-        create_info.pPushConstantRanges = NULL;
-        VkResult vk_res = vkCreatePipelineLayout(p_renderer->vk_device, &create_info, NULL,
-                                                 &(p_pipeline->vk_pipeline_layout));
-        assert(VK_SUCCESS == vk_res);
-    }
+    tr_internal_vk_create_pipeline_layout(p_renderer, p_shader_program, descriptor_set_count,
+                                          pp_descriptor_sets, p_pipeline_settings, p_pipeline);
 
     // Pipeline
     {
+        const VkSpecializationInfo* p_specialization_info =
+            tr_internal_vk_fill_specialization_info(p_pipeline_settings,
+                                                    p_state->specialization_entries,
+                                                    &(p_state->specialization_info));
+
         uint32_t stage_count = 0;
-        VkPipelineShaderStageCreateInfo stages[5] = {};
+        VkPipelineShaderStageCreateInfo* stages = p_state->stages;
         for (uint32_t i = 0; i < 5; ++i)
         {
             tr_shader_stage stage_mask = (tr_shader_stage)(1 << i);
@@ -1619,7 +2769,7 @@ void tr_internal_vk_create_pipeline(tr_renderer* p_renderer, tr_shader_program*
                 stages[stage_count].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
                 stages[stage_count].pNext = NULL;
                 stages[stage_count].flags = 0;
-                stages[stage_count].pSpecializationInfo = NULL;
+                stages[stage_count].pSpecializationInfo = p_specialization_info;
                 switch (stage_mask)
                 {
                 case tr_shader_stage_vert:
@@ -1669,9 +2819,9 @@ void tr_internal_vk_create_pipeline(tr_renderer* p_renderer, tr_shader_program*
         assert(0 != p_vertex_layout->attrib_count);
 
         uint32_t input_binding_count = 0;
-        VkVertexInputBindingDescription input_bindings[tr_max_vertex_bindings] = {0};
+        VkVertexInputBindingDescription* input_bindings = p_state->input_bindings;
         uint32_t input_attribute_count = 0;
-        VkVertexInputAttributeDescription input_attributes[tr_max_vertex_attribs] = {0};
+        VkVertexInputAttributeDescription* input_attributes = p_state->input_attributes;
         // Ignore everything that's beyond tr_max_vertex_attribs
         uint32_t attrib_count = p_vertex_layout->attrib_count > tr_max_vertex_attribs
                                     ? tr_max_vertex_attribs
@@ -1698,7 +2848,7 @@ void tr_internal_vk_create_pipeline(tr_renderer* p_renderer, tr_shader_program*
             ++input_attribute_count;
         }
 
-        VkPipelineVertexInputStateCreateInfo vi = {};
+        VkPipelineVertexInputStateCreateInfo& vi = p_state->vi;
         vi.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
         vi.pNext = NULL;
         vi.flags = 0;
@@ -1738,7 +2888,7 @@ void tr_internal_vk_create_pipeline(tr_renderer* p_renderer, tr_shader_program*
             topology = VK_PRIMITIVE_TOPOLOGY_PATCH_LIST;
             break;
         }
-        VkPipelineInputAssemblyStateCreateInfo ia = {};
+        VkPipelineInputAssemblyStateCreateInfo& ia = p_state->ia;
         ia.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
         ia.pNext = NULL;
         ia.flags = 0;
@@ -1757,7 +2907,7 @@ void tr_internal_vk_create_pipeline(tr_renderer* p_renderer, tr_shader_program*
             domain_origin.domainOrigin = VK_TESSELLATION_DOMAIN_ORIGIN_LOWER_LEFT_KHR;
             break;
         }
-        VkPipelineTessellationStateCreateInfo ts = {};
+        VkPipelineTessellationStateCreateInfo& ts = p_state->ts;
         ts.sType = VK_STRUCTURE_TYPE_PIPELINE_TESSELLATION_STATE_CREATE_INFO;
         ts.pNext = NULL; //&domain_origin;
         ts.flags = 0;
@@ -1778,7 +2928,7 @@ void tr_internal_vk_create_pipeline(tr_renderer* p_renderer, tr_shader_program*
             break;
         }
 
-        VkPipelineViewportStateCreateInfo vs = {};
+        VkPipelineViewportStateCreateInfo& vs = p_state->vs;
         vs.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
         vs.pNext = NULL;
         vs.flags = 0;
@@ -1803,7 +2953,7 @@ void tr_internal_vk_create_pipeline(tr_renderer* p_renderer, tr_shader_program*
         VkFrontFace front_face = (tr_front_face_cw == p_pipeline_settings->front_face)
                                      ? VK_FRONT_FACE_CLOCKWISE
                                      : VK_FRONT_FACE_COUNTER_CLOCKWISE;
-        VkPipelineRasterizationStateCreateInfo rs = {};
+        VkPipelineRasterizationStateCreateInfo& rs = p_state->rs;
         rs.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
         rs.pNext = NULL;
         rs.flags = 0;
@@ -1818,7 +2968,7 @@ void tr_internal_vk_create_pipeline(tr_renderer* p_renderer, tr_shader_program*
         rs.depthBiasSlopeFactor = 0.0f;
         rs.lineWidth = 1.0f;
 
-        VkPipelineMultisampleStateCreateInfo ms = {};
+        VkPipelineMultisampleStateCreateInfo& ms = p_state->ms;
         ms.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
         ms.pNext = NULL;
         ms.flags = 0;
@@ -1829,7 +2979,7 @@ void tr_internal_vk_create_pipeline(tr_renderer* p_renderer, tr_shader_program*
         ms.alphaToCoverageEnable = VK_FALSE;
         ms.alphaToOneEnable = VK_FALSE;
 
-        VkPipelineDepthStencilStateCreateInfo ds = {};
+        VkPipelineDepthStencilStateCreateInfo& ds = p_state->ds;
         ds.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
         ds.pNext = NULL;
         ds.flags = 0;
@@ -1855,7 +3005,7 @@ void tr_internal_vk_create_pipeline(tr_renderer* p_renderer, tr_shader_program*
         ds.minDepthBounds = 0.0f;
         ds.maxDepthBounds = 0.0;
 
-        VkPipelineColorBlendAttachmentState cbas = {};
+        VkPipelineColorBlendAttachmentState& cbas = p_state->cbas;
         cbas.colorWriteMask = 0xf;
         cbas.blendEnable = VK_FALSE;
         cbas.alphaBlendOp = VK_BLEND_OP_ADD;
@@ -1864,7 +3014,7 @@ void tr_internal_vk_create_pipeline(tr_renderer* p_renderer, tr_shader_program*
         cbas.dstColorBlendFactor = VK_BLEND_FACTOR_ZERO;
         cbas.srcAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
         cbas.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
-        VkPipelineColorBlendStateCreateInfo cb = {};
+        VkPipelineColorBlendStateCreateInfo& cb = p_state->cb;
         cb.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
         cb.pNext = NULL;
         cb.flags = 0;
@@ -1877,7 +3027,7 @@ void tr_internal_vk_create_pipeline(tr_renderer* p_renderer, tr_shader_program*
         cb.blendConstants[2] = 0.0f;
         cb.blendConstants[3] = 0.0f;
 
-        VkDynamicState dyn_states[9] = {};
+        VkDynamicState* dyn_states = p_state->dyn_states;
         dyn_states[0] = VK_DYNAMIC_STATE_VIEWPORT;
         dyn_states[1] = VK_DYNAMIC_STATE_SCISSOR;
         dyn_states[2] = VK_DYNAMIC_STATE_LINE_WIDTH;
@@ -1887,14 +3037,14 @@ void tr_internal_vk_create_pipeline(tr_renderer* p_renderer, tr_shader_program*
         dyn_states[6] = VK_DYNAMIC_STATE_STENCIL_COMPARE_MASK;
         dyn_states[7] = VK_DYNAMIC_STATE_STENCIL_WRITE_MASK;
         dyn_states[8] = VK_DYNAMIC_STATE_STENCIL_REFERENCE;
-        VkPipelineDynamicStateCreateInfo dy = {};
+        VkPipelineDynamicStateCreateInfo& dy = p_state->dy;
         dy.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
         dy.pNext = NULL;
         dy.flags = 0;
         dy.dynamicStateCount = 9;
         dy.pDynamicStates = dyn_states;
 
-        VkGraphicsPipelineCreateInfo create_info = {};
+        VkGraphicsPipelineCreateInfo& create_info = p_state->create_info;
         create_info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
         create_info.pNext = NULL;
         create_info.flags = 0;
@@ -1914,15 +3064,62 @@ void tr_internal_vk_create_pipeline(tr_renderer* p_renderer, tr_shader_program*
         create_info.subpass = 0;
         create_info.basePipelineHandle = VK_NULL_HANDLE;
         create_info.basePipelineIndex = -1;
-        VkResult vk_res = vkCreateGraphicsPipelines(p_renderer->vk_device, VK_NULL_HANDLE, 1,
-                                                    &create_info, NULL, &(p_pipeline->vk_pipeline));
-        assert(VK_SUCCESS == vk_res);
+    }
+}
+
+void tr_internal_vk_create_pipeline(tr_renderer* p_renderer, tr_shader_program* p_shader_program,
+                                    const tr_vertex_layout* p_vertex_layout,
+                                    uint32_t descriptor_set_count,
+                                    tr_descriptor_set* const* pp_descriptor_sets,
+                                    tr_render_target* p_render_target,
+                                    const tr_pipeline_settings* p_pipeline_settings,
+                                    tr_pipeline* p_pipeline)
+{
+    tr_internal_vk_graphics_pipeline_state state = {};
+    tr_internal_vk_fill_graphics_pipeline_state(p_renderer, p_shader_program, p_vertex_layout,
+                                                descriptor_set_count, pp_descriptor_sets,
+                                                p_render_target, p_pipeline_settings, p_pipeline,
+                                                &state);
+
+    VkResult vk_res =
+        vkCreateGraphicsPipelines(p_renderer->vk_device, p_renderer->vk_pipeline_cache, 1,
+                                  &(state.create_info), NULL, &(p_pipeline->vk_pipeline));
+    assert(VK_SUCCESS == vk_res);
+}
+
+void tr_internal_vk_create_pipelines(tr_renderer* p_renderer, uint32_t pipeline_count,
+                                     const tr_pipeline_create_info* p_create_infos,
+                                     tr_pipeline** pp_pipelines)
+{
+    std::vector<tr_internal_vk_graphics_pipeline_state> states(pipeline_count);
+    std::vector<VkGraphicsPipelineCreateInfo> create_infos(pipeline_count);
+    std::vector<VkPipeline> pipelines(pipeline_count);
+    for (uint32_t i = 0; i < pipeline_count; ++i)
+    {
+        const tr_pipeline_create_info* info = &p_create_infos[i];
+        assert(tr_pipeline_type_graphics == info->type);
+        tr_internal_vk_fill_graphics_pipeline_state(
+            p_renderer, info->shader_program, info->vertex_layout, info->descriptor_set_count,
+            info->descriptor_sets, info->render_target, info->pipeline_settings, pp_pipelines[i],
+            &states[i]);
+        create_infos[i] = states[i].create_info;
+    }
+
+    VkResult vk_res =
+        vkCreateGraphicsPipelines(p_renderer->vk_device, p_renderer->vk_pipeline_cache,
+                                  pipeline_count, create_infos.data(), NULL, pipelines.data());
+    assert(VK_SUCCESS == vk_res);
+
+    for (uint32_t i = 0; i < pipeline_count; ++i)
+    {
+        pp_pipelines[i]->vk_pipeline = pipelines[i];
     }
 }
 
 void tr_internal_vk_create_compute_pipeline(tr_renderer* p_renderer,
                                             tr_shader_program* p_shader_program,
-                                            tr_descriptor_set* p_descriptor_set,
+                                            uint32_t descriptor_set_count,
+                                            tr_descriptor_set* const* pp_descriptor_sets,
                                             const tr_pipeline_settings* p_pipeline_settings,
                                             tr_pipeline* p_pipeline)
 {
@@ -1930,23 +3127,14 @@ void tr_internal_vk_create_compute_pipeline(tr_renderer* p_renderer,
     assert(p_shader_program->vk_comp != VK_NULL_HANDLE);
 
     // Pipeline layout
-    {
-        VkPipelineLayoutCreateInfo create_info = {};
-        create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-        create_info.pNext = NULL;
-        create_info.flags = 0;
-        create_info.setLayoutCount = (NULL != p_descriptor_set) ? 1 : 0;
-        create_info.pSetLayouts =
-            (NULL != p_descriptor_set) ? &(p_descriptor_set->vk_descriptor_set_layout) : NULL;
-        create_info.pushConstantRangeCount = 0;
-        create_info.pPushConstantRanges = NULL;
-        VkResult vk_res = vkCreatePipelineLayout(p_renderer->vk_device, &create_info, NULL,
-                                                 &(p_pipeline->vk_pipeline_layout));
-        assert(VK_SUCCESS == vk_res);
-    }
+    tr_internal_vk_create_pipeline_layout(p_renderer, p_shader_program, descriptor_set_count,
+                                          pp_descriptor_sets, p_pipeline_settings, p_pipeline);
 
     // Pipeline
     {
+        VkSpecializationMapEntry specialization_entries[tr_max_specialization_constants];
+        VkSpecializationInfo specialization_info = {};
+
         VkPipelineShaderStageCreateInfo stage = {};
         stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
         stage.pNext = NULL;
@@ -1954,7 +3142,8 @@ void tr_internal_vk_create_compute_pipeline(tr_renderer* p_renderer,
         stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
         stage.module = p_shader_program->vk_comp;
         stage.pName = p_shader_program->comp_entry_point.c_str();
-        stage.pSpecializationInfo = NULL;
+        stage.pSpecializationInfo = tr_internal_vk_fill_specialization_info(
+            p_pipeline_settings, specialization_entries, &specialization_info);
 
         VkComputePipelineCreateInfo create_info = {};
         create_info.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
@@ -1964,8 +3153,9 @@ void tr_internal_vk_create_compute_pipeline(tr_renderer* p_renderer,
         create_info.layout = p_pipeline->vk_pipeline_layout;
         create_info.basePipelineHandle = 0;
         create_info.basePipelineIndex = 0;
-        VkResult vk_res = vkCreateComputePipelines(p_renderer->vk_device, VK_NULL_HANDLE, 1,
-                                                   &create_info, NULL, &(p_pipeline->vk_pipeline));
+        VkResult vk_res =
+            vkCreateComputePipelines(p_renderer->vk_device, p_renderer->vk_pipeline_cache, 1,
+                                     &create_info, NULL, &(p_pipeline->vk_pipeline));
         assert(VK_SUCCESS == vk_res);
     }
 }
@@ -2260,219 +3450,184 @@ void tr_internal_vk_destroy_render_target(tr_renderer* p_renderer,
 // -------------------------------------------------------------------------------------------------
 // Internal descriptor set functions
 // -------------------------------------------------------------------------------------------------
-void tr_internal_vk_update_descriptor_set(tr_renderer* p_renderer,
-                                          tr_descriptor_set* p_descriptor_set)
+// Resolves the elements of p_descriptor into what Vulkan writes, one entry per element, along
+// with the vk_resource_id of the object behind each one
+static void tr_internal_vk_resolve_descriptor(tr_renderer* p_renderer,
+                                              const tr_descriptor* p_descriptor,
+                                              tr_vk_descriptor_info* p_infos,
+                                              uint64_t* p_resource_ids)
 {
-    assert(VK_NULL_HANDLE != p_renderer->vk_device);
-    assert(VK_NULL_HANDLE != p_descriptor_set->vk_descriptor_set);
-
-    // Not really efficient, just write less frequently ;)
-    uint32_t write_count = 0;
-    uint32_t sampler_view_count = 0;
-    uint32_t image_view_count = 0;
-    uint32_t buffer_view_count = 0;
-    for (uint32_t descriptor_index = 0; descriptor_index < p_descriptor_set->descriptor_count;
-         ++descriptor_index)
-    {
-        tr_descriptor* descriptor = &(p_descriptor_set->descriptors[descriptor_index]);
-        switch (descriptor->type)
-        {
-        case tr_descriptor_type_sampler:
-        {
-            sampler_view_count += descriptor->count;
-            ++write_count;
-        }
-        break;
-
-        case tr_descriptor_type_uniform_buffer_cbv:
-        case tr_descriptor_type_storage_buffer_srv:
-        case tr_descriptor_type_storage_buffer_uav:
-        case tr_descriptor_type_uniform_texel_buffer_srv:
-        case tr_descriptor_type_storage_texel_buffer_uav:
-        {
-            buffer_view_count += descriptor->count;
-            ++write_count;
-        }
-        break;
-
-        case tr_descriptor_type_texture_srv:
-        case tr_descriptor_type_texture_uav:
-        {
-            image_view_count += descriptor->count;
-            ++write_count;
-        }
-        break;
-        }
-    }
-    // Bail if there's nothing to write
-    if (0 == write_count)
-    {
-        return;
-    }
-
-    vector<VkWriteDescriptorSet> writes(write_count);
-    vector<VkDescriptorImageInfo> sampler_views(sampler_view_count);
-    vector<VkDescriptorImageInfo> image_views(image_view_count);
-    vector<VkDescriptorBufferInfo> buffer_views(buffer_view_count);
-
-    uint32_t write_index = 0;
-    uint32_t sampler_view_index = 0;
-    uint32_t texture_view_index = 0;
-    uint32_t buffer_view_index = 0;
-    for (uint32_t descriptor_index = 0; descriptor_index < p_descriptor_set->descriptor_count;
-         ++descriptor_index)
+    for (uint32_t i = 0; i < p_descriptor->count; ++i)
     {
-        tr_descriptor* descriptor = &(p_descriptor_set->descriptors[descriptor_index]);
-        if ((NULL == descriptor->samplers) && (NULL == descriptor->textures) &&
-            (NULL == descriptor->uniform_buffers))
-        {
-            continue;
-        }
-
-        writes[write_index].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        writes[write_index].pNext = NULL;
-        writes[write_index].dstSet = p_descriptor_set->vk_descriptor_set;
-        writes[write_index].dstBinding = descriptor->binding;
-        writes[write_index].dstArrayElement = 0;
-        writes[write_index].descriptorCount = descriptor->count;
-        switch (descriptor->type)
+        tr_vk_descriptor_info* p_info = &(p_infos[i]);
+        switch (p_descriptor->type)
         {
         case tr_descriptor_type_sampler:
         {
-            assert(NULL != descriptor->samplers);
-
-            writes[write_index].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
-            writes[write_index].pImageInfo = &(sampler_views[sampler_view_index]);
-            for (uint32_t i = 0; i < descriptor->count; ++i)
-            {
-                memcpy(&(sampler_views[sampler_view_index]),
-                       &(descriptor->samplers[i]->vk_sampler_view),
-                       sizeof(descriptor->samplers[i]->vk_sampler_view));
-                ++sampler_view_index;
-            }
+            assert(NULL != p_descriptor->samplers[i]);
+            p_info->image = p_descriptor->samplers[i]->vk_sampler_view;
+            p_resource_ids[i] = p_descriptor->samplers[i]->vk_resource_id;
         }
         break;
 
         case tr_descriptor_type_uniform_buffer_cbv:
         {
-            assert(NULL != descriptor->uniform_buffers);
-
-            writes[write_index].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-            writes[write_index].pBufferInfo = &(buffer_views[buffer_view_index]);
-            for (uint32_t i = 0; i < descriptor->count; ++i)
+            assert(NULL != p_descriptor->uniform_buffers[i]);
+            p_info->buffer = p_descriptor->uniform_buffers[i]->vk_buffer_info;
+            p_resource_ids[i] = p_descriptor->uniform_buffers[i]->vk_resource_id;
+            if (0 != p_descriptor->uniform_buffer_sizes[i])
             {
-                memcpy(&(buffer_views[buffer_view_index]),
-                       &(descriptor->uniform_buffers[i]->vk_buffer_info),
-                       sizeof(descriptor->uniform_buffers[i]->vk_buffer_info));
-                ++buffer_view_index;
+                p_info->buffer.offset = p_descriptor->uniform_buffer_offsets[i];
+                p_info->buffer.range = p_descriptor->uniform_buffer_sizes[i];
             }
         }
         break;
 
-        case tr_descriptor_type_storage_buffer_srv:
+        case tr_descriptor_type_uniform_buffer_dynamic_cbv:
         {
-            assert(NULL != descriptor->buffers);
-
-            writes[write_index].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-            writes[write_index].pBufferInfo = &(buffer_views[buffer_view_index]);
-            for (uint32_t i = 0; i < descriptor->count; ++i)
+            tr_buffer* p_buffer = p_descriptor->uniform_buffers[i];
+            assert(NULL != p_buffer);
+            // The range is the window the dynamic offset slides over, so it can't be
+            // VK_WHOLE_SIZE for buffers larger than maxUniformBufferRange
+            uint64_t range = p_descriptor->uniform_buffer_sizes[i];
+            if (0 == range)
             {
-                memcpy(&(buffer_views[buffer_view_index]),
-                       &(descriptor->buffers[i]->vk_buffer_info),
-                       sizeof(descriptor->buffers[i]->vk_buffer_info));
-                ++buffer_view_index;
+                const VkPhysicalDeviceLimits& limits = p_renderer->vk_active_gpu_properties.limits;
+                range = tr_min_u64(p_buffer->size, limits.maxUniformBufferRange);
             }
+            p_info->buffer.buffer = p_buffer->vk_buffer;
+            p_info->buffer.offset = p_descriptor->uniform_buffer_offsets[i];
+            p_info->buffer.range = range;
+            p_resource_ids[i] = p_buffer->vk_resource_id;
         }
         break;
 
+        case tr_descriptor_type_storage_buffer_srv:
         case tr_descriptor_type_storage_buffer_uav:
         {
-            assert(NULL != descriptor->buffers);
-
-            writes[write_index].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-            writes[write_index].pBufferInfo = &(buffer_views[buffer_view_index]);
-            for (uint32_t i = 0; i < descriptor->count; ++i)
-            {
-                memcpy(&(buffer_views[buffer_view_index]),
-                       &(descriptor->buffers[i]->vk_buffer_info),
-                       sizeof(descriptor->buffers[i]->vk_buffer_info));
-                ++buffer_view_index;
-            }
+            assert(NULL != p_descriptor->buffers[i]);
+            p_info->buffer = p_descriptor->buffers[i]->vk_buffer_info;
+            p_resource_ids[i] = p_descriptor->buffers[i]->vk_resource_id;
         }
         break;
 
         case tr_descriptor_type_uniform_texel_buffer_srv:
+        case tr_descriptor_type_storage_texel_buffer_uav:
         {
-            assert(NULL != descriptor->buffers);
-
-            writes[write_index].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
-            writes[write_index].pBufferInfo = &(buffer_views[buffer_view_index]);
-            for (uint32_t i = 0; i < descriptor->count; ++i)
-            {
-                memcpy(&(buffer_views[buffer_view_index]),
-                       &(descriptor->buffers[i]->vk_buffer_info),
-                       sizeof(descriptor->buffers[i]->vk_buffer_info));
-                ++buffer_view_index;
-            }
+            assert(NULL != p_descriptor->buffers[i]);
+            p_info->texel_buffer_view = p_descriptor->buffers[i]->vk_buffer_view;
+            p_resource_ids[i] = p_descriptor->buffers[i]->vk_resource_id;
         }
         break;
 
-        case tr_descriptor_type_storage_texel_buffer_uav:
+        case tr_descriptor_type_texture_srv:
+        case tr_descriptor_type_texture_uav:
         {
-            assert(NULL != descriptor->buffers);
-
-            writes[write_index].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER;
-            writes[write_index].pBufferInfo = &(buffer_views[buffer_view_index]);
-            for (uint32_t i = 0; i < descriptor->count; ++i)
-            {
-                memcpy(&(buffer_views[buffer_view_index]),
-                       &(descriptor->buffers[i]->vk_buffer_info),
-                       sizeof(descriptor->buffers[i]->vk_buffer_info));
-                ++buffer_view_index;
-            }
+            assert(NULL != p_descriptor->textures[i]);
+            p_info->image = p_descriptor->textures[i]->vk_texture_view;
+            p_resource_ids[i] = p_descriptor->textures[i]->vk_resource_id;
         }
         break;
+        }
+    }
+}
 
-        case tr_descriptor_type_texture_srv:
-        {
-            assert(NULL != descriptor->textures);
+void tr_internal_vk_update_descriptor_set(tr_renderer* p_renderer,
+                                          tr_descriptor_set* p_descriptor_set)
+{
+    assert(VK_NULL_HANDLE != p_renderer->vk_device);
+    assert(VK_NULL_HANDLE != p_descriptor_set->vk_descriptor_set);
 
-            writes[write_index].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
-            writes[write_index].pImageInfo = &(image_views[texture_view_index]);
-            for (uint32_t i = 0; i < descriptor->count; ++i)
-            {
-                memcpy(&(image_views[texture_view_index]),
-                       &(descriptor->textures[i]->vk_texture_view),
-                       sizeof(descriptor->textures[i]->vk_texture_view));
-                ++texture_view_index;
-            }
+    // Resolve everything and compare it against what the last update wrote
+    std::vector<tr_vk_descriptor_info>& infos = p_descriptor_set->vk_descriptor_infos;
+    std::vector<tr_vk_descriptor_info> new_infos(infos.size());
+    std::vector<uint64_t>& resource_ids = p_descriptor_set->vk_descriptor_resource_ids;
+    std::vector<uint64_t> new_resource_ids(resource_ids.size());
+    std::vector<uint32_t> dirty_descriptors;
+    for (uint32_t descriptor_index = 0; descriptor_index < p_descriptor_set->descriptor_count;
+         ++descriptor_index)
+    {
+        const tr_descriptor* descriptor = &(p_descriptor_set->descriptors[descriptor_index]);
+        if (VK_DESCRIPTOR_TYPE_MAX_ENUM == tr_internal_vk_to_descriptor_type(descriptor->type))
+        {
+            continue;
         }
-        break;
 
-        case tr_descriptor_type_texture_uav:
+        uint32_t first = p_descriptor_set->vk_descriptor_info_offsets[descriptor_index];
+        tr_internal_vk_resolve_descriptor(p_renderer, descriptor, &(new_infos[first]),
+                                          &(new_resource_ids[first]));
+        if (!p_descriptor_set->vk_descriptors_written ||
+            (0 != memcmp(&(new_infos[first]), &(infos[first]),
+                         descriptor->count * sizeof(tr_vk_descriptor_info))) ||
+            (0 != memcmp(&(new_resource_ids[first]), &(resource_ids[first]),
+                         descriptor->count * sizeof(uint64_t))))
         {
-            assert(NULL != descriptor->textures);
+            dirty_descriptors.push_back(descriptor_index);
+        }
+    }
+    // Bail if nothing changed
+    if (dirty_descriptors.empty())
+    {
+        return;
+    }
+    infos.swap(new_infos);
+    resource_ids.swap(new_resource_ids);
+    p_descriptor_set->vk_descriptors_written = true;
+
+#if defined(VK_KHR_descriptor_update_template)
+    // The template rewrites the whole set in one call, which beats individual writes once most
+    // of the set changed
+    if ((VK_NULL_HANDLE != p_descriptor_set->vk_update_template) &&
+        (2 * dirty_descriptors.size() >= p_descriptor_set->descriptor_count))
+    {
+        p_renderer->vkUpdateDescriptorSetWithTemplateKHR(p_renderer->vk_device,
+                                                         p_descriptor_set->vk_descriptor_set,
+                                                         p_descriptor_set->vk_update_template,
+                                                         infos.data());
+        return;
+    }
+#endif
+
+    // The infos are strided by the union while writes read tightly packed arrays of the member
+    // type, so every array element gets its own write
+    std::vector<VkWriteDescriptorSet> writes;
+    for (size_t dirty_index = 0; dirty_index < dirty_descriptors.size(); ++dirty_index)
+    {
+        uint32_t descriptor_index = dirty_descriptors[dirty_index];
+        const tr_descriptor* descriptor = &(p_descriptor_set->descriptors[descriptor_index]);
+        tr_vk_descriptor_info* p_infos =
+            &(infos[p_descriptor_set->vk_descriptor_info_offsets[descriptor_index]]);
 
-            writes[write_index].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
-            writes[write_index].pImageInfo = &(image_views[texture_view_index]);
-            for (uint32_t i = 0; i < descriptor->count; ++i)
+        for (uint32_t i = 0; i < descriptor->count; ++i)
+        {
+            VkWriteDescriptorSet write = {};
+            write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            write.pNext = NULL;
+            write.dstSet = p_descriptor_set->vk_descriptor_set;
+            write.dstBinding = descriptor->binding;
+            write.dstArrayElement = i;
+            write.descriptorCount = 1;
+            write.descriptorType = tr_internal_vk_to_descriptor_type(descriptor->type);
+            switch (write.descriptorType)
             {
-                memcpy(&(image_views[texture_view_index]),
-                       &(descriptor->textures[i]->vk_texture_view),
-                       sizeof(descriptor->textures[i]->vk_texture_view));
-                ++texture_view_index;
+            case VK_DESCRIPTOR_TYPE_SAMPLER:
+            case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+            case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+                write.pImageInfo = &(p_infos[i].image);
+                break;
+            case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
+            case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
+                write.pTexelBufferView = &(p_infos[i].texel_buffer_view);
+                break;
+            default:
+                write.pBufferInfo = &(p_infos[i].buffer);
+                break;
             }
+            writes.push_back(write);
         }
-        break;
-        }
-
-        ++write_index;
     }
 
-    uint32_t copy_count = 0;
-    VkCopyDescriptorSet* copies = NULL;
-
-    vkUpdateDescriptorSets(p_renderer->vk_device, write_count, writes.data(), copy_count, copies);
+    vkUpdateDescriptorSets(p_renderer->vk_device, (uint32_t)writes.size(), writes.data(), 0, NULL);
 }
 
 // -------------------------------------------------------------------------------------------------
@@ -2689,22 +3844,54 @@ void tr_internal_vk_cmd_bind_pipeline(tr_cmd* p_cmd, tr_pipeline* p_pipeline)
 }
 
 void tr_internal_vk_cmd_bind_descriptor_sets(tr_cmd* p_cmd, tr_pipeline* p_pipeline,
-                                             tr_descriptor_set* p_descriptor_set)
+                                             uint32_t first_set, uint32_t descriptor_set_count,
+                                             tr_descriptor_set* const* pp_descriptor_sets,
+                                             uint32_t dynamic_offset_count,
+                                             const uint32_t* p_dynamic_offsets)
 {
     assert(p_cmd != NULL);
     assert(p_cmd->vk_cmd_buf != VK_NULL_HANDLE);
     assert(p_pipeline != NULL);
     assert(p_pipeline->vk_pipeline_layout != VK_NULL_HANDLE);
-    assert(p_descriptor_set != NULL);
-    assert(p_descriptor_set->vk_descriptor_set != VK_NULL_HANDLE);
+    assert(descriptor_set_count <= tr_max_descriptor_sets);
 
     VkPipelineBindPoint pipeline_bind_point = (p_pipeline->type == tr_pipeline_type_compute)
                                                   ? VK_PIPELINE_BIND_POINT_COMPUTE
                                                   : VK_PIPELINE_BIND_POINT_GRAPHICS;
 
-    // @TODO: Add dynamic offsets support
+    VkDescriptorSet descriptor_sets[tr_max_descriptor_sets];
+    uint32_t set_dynamic_offset_count = 0;
+    for (uint32_t i = 0; i < descriptor_set_count; ++i)
+    {
+        assert(pp_descriptor_sets[i] != NULL);
+        assert(pp_descriptor_sets[i]->vk_descriptor_set != VK_NULL_HANDLE);
+        descriptor_sets[i] = pp_descriptor_sets[i]->vk_descriptor_set;
+        set_dynamic_offset_count += pp_descriptor_sets[i]->dynamic_offset_count;
+    }
+
+    // Vulkan always wants an offset for every dynamic descriptor, bind them at 0 if none are given
+    uint32_t zero_offsets[tr_max_descriptor_sets * tr_max_dynamic_offsets];
+    if ((0 == dynamic_offset_count) && (set_dynamic_offset_count > 0))
+    {
+        assert(set_dynamic_offset_count <= tr_max_descriptor_sets * tr_max_dynamic_offsets);
+        memset(zero_offsets, 0, set_dynamic_offset_count * sizeof(uint32_t));
+        dynamic_offset_count = set_dynamic_offset_count;
+        p_dynamic_offsets = zero_offsets;
+    }
+
     vkCmdBindDescriptorSets(p_cmd->vk_cmd_buf, pipeline_bind_point, p_pipeline->vk_pipeline_layout,
-                            0, 1, &(p_descriptor_set->vk_descriptor_set), 0, NULL);
+                            first_set, descriptor_set_count, descriptor_sets, dynamic_offset_count,
+                            p_dynamic_offsets);
+}
+
+void tr_internal_vk_cmd_push_constants(tr_cmd* p_cmd, tr_pipeline* p_pipeline, uint32_t offset,
+                                      uint32_t size, const void* p_data)
+{
+    assert(VK_NULL_HANDLE != p_cmd->vk_cmd_buf);
+    assert(VK_NULL_HANDLE != p_pipeline->vk_pipeline_layout);
+
+    vkCmdPushConstants(p_cmd->vk_cmd_buf, p_pipeline->vk_pipeline_layout,
+                       p_pipeline->vk_push_constant_stages, offset, size, p_data);
 }
 
 void tr_internal_vk_cmd_bind_index_buffer(tr_cmd* p_cmd, tr_buffer* p_buffer)
@@ -2754,8 +3941,107 @@ void tr_internal_vk_cmd_draw_indexed(tr_cmd* p_cmd, uint32_t index_count, uint32
     vkCmdDrawIndexed(p_cmd->vk_cmd_buf, index_count, 1, first_index, 0, 0);
 }
 
+// Transfer and compute queues don't support the graphics stages, so drop them and fall back to
+// fallback_stage when nothing is left. Accesses the remaining stages can't perform are dropped
+// from access_mask too, a barrier may only name accesses its stages support.
+static VkPipelineStageFlags tr_internal_vk_queue_stage_mask(tr_cmd* p_cmd,
+                                                            VkPipelineStageFlags stage_mask,
+                                                            VkPipelineStageFlags fallback_stage,
+                                                            VkAccessFlags* p_access_mask)
+{
+    tr_queue* p_queue = p_cmd->cmd_pool->queue;
+    if ((NULL == p_queue) || (0 != (p_queue->vk_queue_flags & VK_QUEUE_GRAPHICS_BIT)))
+    {
+        return (0 != stage_mask) ? stage_mask : fallback_stage;
+    }
+
+    VkPipelineStageFlags supported_stages =
+        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT | VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT |
+        VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_HOST_BIT |
+        VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+    if (0 != (p_queue->vk_queue_flags & VK_QUEUE_COMPUTE_BIT))
+    {
+        supported_stages |=
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
+    }
+    stage_mask &= supported_stages;
+    stage_mask = (0 != stage_mask) ? stage_mask : fallback_stage;
+
+    // TOP_OF_PIPE and BOTTOM_OF_PIPE perform no accesses at all
+    VkAccessFlags supported_access = 0;
+    if (0 != (stage_mask & VK_PIPELINE_STAGE_ALL_COMMANDS_BIT))
+    {
+        supported_access = ~(VkAccessFlags)0;
+    }
+    if (0 != (stage_mask & VK_PIPELINE_STAGE_TRANSFER_BIT))
+    {
+        supported_access |= VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT |
+                            VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+    }
+    if (0 != (stage_mask & VK_PIPELINE_STAGE_HOST_BIT))
+    {
+        supported_access |= VK_ACCESS_HOST_READ_BIT | VK_ACCESS_HOST_WRITE_BIT |
+                            VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+    }
+    if (0 != (stage_mask & VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT))
+    {
+        supported_access |= VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT |
+                            VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_MEMORY_READ_BIT |
+                            VK_ACCESS_MEMORY_WRITE_BIT;
+    }
+    if (0 != (stage_mask & VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT))
+    {
+        supported_access |= VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_MEMORY_READ_BIT |
+                            VK_ACCESS_MEMORY_WRITE_BIT;
+    }
+    *p_access_mask &= supported_access;
+
+    return stage_mask;
+}
+
+// Fills in the queue family indices for an ownership transfer. Both the release on the source
+// queue and the acquire on the destination queue record the same barrier, each only keeps the
+// half of the dependency that applies to its own queue.
+static void tr_internal_vk_queue_ownership_transfer(tr_cmd* p_cmd, tr_queue* p_src_queue,
+                                                    tr_queue* p_dst_queue,
+                                                    uint32_t* p_src_queue_family_index,
+                                                    uint32_t* p_dst_queue_family_index,
+                                                    VkPipelineStageFlags* p_src_stage_mask,
+                                                    VkAccessFlags* p_src_access_mask,
+                                                    VkPipelineStageFlags* p_dst_stage_mask,
+                                                    VkAccessFlags* p_dst_access_mask)
+{
+    if ((NULL == p_src_queue) || (NULL == p_dst_queue) ||
+        (p_src_queue->vk_queue_family_index == p_dst_queue->vk_queue_family_index))
+    {
+        return;
+    }
+
+    *p_src_queue_family_index = p_src_queue->vk_queue_family_index;
+    *p_dst_queue_family_index = p_dst_queue->vk_queue_family_index;
+    if (p_cmd->cmd_pool->queue == p_src_queue)
+    {
+        *p_dst_stage_mask = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+        *p_dst_access_mask = 0;
+    }
+    else
+    {
+        assert(p_cmd->cmd_pool->queue == p_dst_queue);
+        *p_src_stage_mask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+        *p_src_access_mask = 0;
+    }
+}
+
 void tr_internal_vk_cmd_buffer_transition(tr_cmd* p_cmd, tr_buffer* p_buffer,
                                           tr_buffer_usage old_usage, tr_buffer_usage new_usage)
+{
+    tr_internal_vk_cmd_buffer_transition_queue(p_cmd, p_buffer, old_usage, new_usage, NULL, NULL);
+}
+
+void tr_internal_vk_cmd_buffer_transition_queue(tr_cmd* p_cmd, tr_buffer* p_buffer,
+                                                tr_buffer_usage old_usage,
+                                                tr_buffer_usage new_usage, tr_queue* p_src_queue,
+                                                tr_queue* p_dst_queue)
 {
     assert(p_cmd != NULL);
     assert(p_cmd->vk_cmd_buf != VK_NULL_HANDLE);
@@ -2766,8 +4052,8 @@ void tr_internal_vk_cmd_buffer_transition(tr_cmd* p_cmd, tr_buffer* p_buffer,
     VkBufferMemoryBarrier barrier = {};
     barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
     barrier.pNext = NULL;
-    barrier.srcQueueFamilyIndex = 0;
-    barrier.dstQueueFamilyIndex = 0;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
     barrier.buffer = p_buffer->vk_buffer;
     barrier.offset = 0;
     barrier.size = VK_WHOLE_SIZE;
@@ -2922,12 +4208,26 @@ void tr_internal_vk_cmd_buffer_transition(tr_cmd* p_cmd, tr_buffer* p_buffer,
     break;
     }
 
+    tr_internal_vk_queue_ownership_transfer(
+        p_cmd, p_src_queue, p_dst_queue, &barrier.srcQueueFamilyIndex,
+        &barrier.dstQueueFamilyIndex, &src_stage_mask, &barrier.srcAccessMask, &dst_stage_mask,
+        &barrier.dstAccessMask);
+    src_stage_mask = tr_internal_vk_queue_stage_mask(
+        p_cmd, src_stage_mask, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, &barrier.srcAccessMask);
+    dst_stage_mask = tr_internal_vk_queue_stage_mask(
+        p_cmd, dst_stage_mask, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, &barrier.dstAccessMask);
+
     vkCmdPipelineBarrier(p_cmd->vk_cmd_buf, src_stage_mask, dst_stage_mask, dependency_flags, 0,
                          NULL, 1, &barrier, 0, NULL);
 }
 
-void tr_internal_vk_cmd_image_transition(tr_cmd* p_cmd, tr_texture* p_texture,
-                                         tr_texture_usage old_usage, tr_texture_usage new_usage)
+// Transitions mip levels [base_mip_level, base_mip_level + mip_level_count) of p_texture
+static void tr_internal_vk_cmd_image_transition_mips(tr_cmd* p_cmd, tr_texture* p_texture,
+                                                     tr_texture_usage old_usage,
+                                                     tr_texture_usage new_usage,
+                                                     tr_queue* p_src_queue, tr_queue* p_dst_queue,
+                                                     uint32_t base_mip_level,
+                                                     uint32_t mip_level_count)
 {
     assert(VK_NULL_HANDLE != p_cmd->vk_cmd_buf);
     assert(VK_NULL_HANDLE != p_texture->vk_image);
@@ -2945,8 +4245,8 @@ void tr_internal_vk_cmd_image_transition(tr_cmd* p_cmd, tr_texture* p_texture,
     barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
     barrier.image = p_texture->vk_image;
     barrier.subresourceRange.aspectMask = p_texture->vk_aspect_mask;
-    barrier.subresourceRange.baseMipLevel = 0;
-    barrier.subresourceRange.levelCount = p_texture->mip_levels;
+    barrier.subresourceRange.baseMipLevel = base_mip_level;
+    barrier.subresourceRange.levelCount = mip_level_count;
     barrier.subresourceRange.baseArrayLayer = 0;
     barrier.subresourceRange.layerCount = 1;
 
@@ -3130,10 +4430,164 @@ void tr_internal_vk_cmd_image_transition(tr_cmd* p_cmd, tr_texture* p_texture,
     break;
     }
 
+    tr_internal_vk_queue_ownership_transfer(
+        p_cmd, p_src_queue, p_dst_queue, &barrier.srcQueueFamilyIndex,
+        &barrier.dstQueueFamilyIndex, &src_stage_mask, &barrier.srcAccessMask, &dst_stage_mask,
+        &barrier.dstAccessMask);
+    src_stage_mask = tr_internal_vk_queue_stage_mask(
+        p_cmd, src_stage_mask, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, &barrier.srcAccessMask);
+    dst_stage_mask = tr_internal_vk_queue_stage_mask(
+        p_cmd, dst_stage_mask, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, &barrier.dstAccessMask);
+
     vkCmdPipelineBarrier(p_cmd->vk_cmd_buf, src_stage_mask, dst_stage_mask, dependency_flags, 0,
                          NULL, 0, NULL, 1, &barrier);
 }
 
+void tr_internal_vk_cmd_image_transition(tr_cmd* p_cmd, tr_texture* p_texture,
+                                         tr_texture_usage old_usage, tr_texture_usage new_usage)
+{
+    tr_internal_vk_cmd_image_transition_queue(p_cmd, p_texture, old_usage, new_usage, NULL, NULL);
+}
+
+void tr_internal_vk_cmd_image_transition_queue(tr_cmd* p_cmd, tr_texture* p_texture,
+                                               tr_texture_usage old_usage,
+                                               tr_texture_usage new_usage, tr_queue* p_src_queue,
+                                               tr_queue* p_dst_queue)
+{
+    tr_internal_vk_cmd_image_transition_mips(p_cmd, p_texture, old_usage, new_usage, p_src_queue,
+                                             p_dst_queue, 0, p_texture->mip_levels);
+}
+
+bool tr_internal_vk_supports_format(tr_renderer* p_renderer, tr_format format,
+                                    tr_texture_usage_flags usage)
+{
+    VkFormat vk_format = tr_util_to_vk_format(format);
+    if (VK_FORMAT_UNDEFINED == vk_format)
+    {
+        return false;
+    }
+    // Device creation enables every texture compression feature the GPU has, so the format
+    // properties alone tell whether BC, ETC2 or ASTC textures can be used
+    VkFormatProperties format_props = {};
+    vkGetPhysicalDeviceFormatProperties(p_renderer->vk_active_gpu, vk_format, &format_props);
+    const VkFormatFeatureFlags required =
+        tr_util_vk_image_usage_to_format_features(tr_util_to_vk_image_usage(usage));
+    return (0 != format_props.optimalTilingFeatures) &&
+           (required == (format_props.optimalTilingFeatures & required));
+}
+
+bool tr_internal_vk_can_generate_mipmaps(tr_queue* p_queue, tr_texture* p_texture)
+{
+    // Blits need a graphics queue and an image that is both a transfer source and destination
+    const tr_texture_usage_flags transfer_usage =
+        tr_texture_usage_transfer_src | tr_texture_usage_transfer_dst;
+    if ((0 == (p_queue->vk_queue_flags & VK_QUEUE_GRAPHICS_BIT)) || p_texture->host_visible ||
+        (tr_sample_count_1 != p_texture->sample_count) ||
+        ((0 == (p_texture->usage & tr_texture_usage_sampled_image)) &&
+         (transfer_usage != (p_texture->usage & transfer_usage))))
+    {
+        return false;
+    }
+
+    VkFormatProperties format_props = {};
+    vkGetPhysicalDeviceFormatProperties(p_queue->renderer->vk_active_gpu,
+                                        tr_util_to_vk_format(p_texture->format), &format_props);
+    const VkFormatFeatureFlags blit_features =
+        VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT;
+    return blit_features == (format_props.optimalTilingFeatures & blit_features);
+}
+
+void tr_internal_vk_cmd_generate_mipmaps(tr_cmd* p_cmd, tr_texture* p_texture,
+                                         tr_texture_usage old_usage, tr_texture_usage new_usage)
+{
+    assert(VK_NULL_HANDLE != p_cmd->vk_cmd_buf);
+    assert(VK_NULL_HANDLE != p_texture->vk_image);
+    // Mip 0 is the source, so it has to hold something
+    assert(tr_texture_usage_undefined != old_usage);
+
+    const uint32_t mip_levels = p_texture->mip_levels;
+    if (mip_levels < 2)
+    {
+        if (old_usage != new_usage)
+        {
+            tr_internal_vk_cmd_image_transition(p_cmd, p_texture, old_usage, new_usage);
+        }
+        return;
+    }
+
+    // Formats without linear filtering still blit, just with nearest sampling. Depth and stencil
+    // blits must be nearest even when the format reports linear filtering.
+    const VkFormat format = tr_util_to_vk_format(p_texture->format);
+    VkFormatProperties format_props = {};
+    vkGetPhysicalDeviceFormatProperties(p_cmd->cmd_pool->renderer->vk_active_gpu, format,
+                                        &format_props);
+    const VkImageAspectFlags depth_stencil_aspects =
+        VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+    VkFilter filter = ((0 == (tr_util_vk_determine_aspect_mask(format) & depth_stencil_aspects)) &&
+                       (0 != (format_props.optimalTilingFeatures &
+                              VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)))
+                          ? VK_FILTER_LINEAR
+                          : VK_FILTER_NEAREST;
+
+    // Mip 0 is read by the first blit, the rest are overwritten so their contents don't matter
+    tr_internal_vk_cmd_image_transition_mips(p_cmd, p_texture, old_usage,
+                                             tr_texture_usage_transfer_src, NULL, NULL, 0, 1);
+    if (tr_texture_usage_transfer_dst != old_usage)
+    {
+        tr_internal_vk_cmd_image_transition_mips(p_cmd, p_texture, tr_texture_usage_undefined,
+                                                 tr_texture_usage_transfer_dst, NULL, NULL, 1,
+                                                 mip_levels - 1);
+    }
+
+    int32_t src_width = (int32_t)p_texture->width;
+    int32_t src_height = (int32_t)p_texture->height;
+    int32_t src_depth = (int32_t)p_texture->depth;
+    for (uint32_t mip_level = 1; mip_level < mip_levels; ++mip_level)
+    {
+        int32_t dst_width = std::max(src_width >> 1, 1);
+        int32_t dst_height = std::max(src_height >> 1, 1);
+        int32_t dst_depth = std::max(src_depth >> 1, 1);
+
+        VkImageBlit region = {};
+        region.srcSubresource.aspectMask = p_texture->vk_aspect_mask;
+        region.srcSubresource.mipLevel = mip_level - 1;
+        region.srcSubresource.baseArrayLayer = 0;
+        region.srcSubresource.layerCount = 1;
+        region.srcOffsets[1].x = src_width;
+        region.srcOffsets[1].y = src_height;
+        region.srcOffsets[1].z = src_depth;
+        region.dstSubresource.aspectMask = p_texture->vk_aspect_mask;
+        region.dstSubresource.mipLevel = mip_level;
+        region.dstSubresource.baseArrayLayer = 0;
+        region.dstSubresource.layerCount = 1;
+        region.dstOffsets[1].x = dst_width;
+        region.dstOffsets[1].y = dst_height;
+        region.dstOffsets[1].z = dst_depth;
+        vkCmdBlitImage(p_cmd->vk_cmd_buf, p_texture->vk_image,
+                       VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, p_texture->vk_image,
+                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region, filter);
+
+        // This level is the source of the next blit
+        if (mip_level + 1 < mip_levels)
+        {
+            tr_internal_vk_cmd_image_transition_mips(p_cmd, p_texture,
+                                                     tr_texture_usage_transfer_dst,
+                                                     tr_texture_usage_transfer_src, NULL, NULL,
+                                                     mip_level, 1);
+        }
+
+        src_width = dst_width;
+        src_height = dst_height;
+        src_depth = dst_depth;
+    }
+
+    // Every level but the last was a blit source
+    tr_internal_vk_cmd_image_transition_mips(p_cmd, p_texture, tr_texture_usage_transfer_src,
+                                             new_usage, NULL, NULL, 0, mip_levels - 1);
+    tr_internal_vk_cmd_image_transition_mips(p_cmd, p_texture, tr_texture_usage_transfer_dst,
+                                             new_usage, NULL, NULL, mip_levels - 1, 1);
+}
+
 void tr_internal_vk_cmd_render_target_transition(tr_cmd* p_cmd, tr_render_target* p_render_target,
                                                  tr_texture_usage old_usage,
                                                  tr_texture_usage new_usage)
@@ -3242,24 +4696,32 @@ void tr_internal_vk_acquire_next_image(tr_renderer* p_renderer, tr_semaphore* p_
 
     VkSemaphore semaphore =
         (NULL != p_signal_semaphore) ? p_signal_semaphore->vk_semaphore : VK_NULL_HANDLE;
-    VkFence fence = (NULL != p_fence) ? p_fence->vk_fence : VK_NULL_HANDLE;
+    VkFence fence = VK_NULL_HANDLE;
+    if (NULL != p_fence)
+    {
+        // Only wait when the fence is reused, by then the acquire that last signaled it has
+        // almost always completed
+        tr_internal_vk_wait_for_fence(p_renderer, p_fence);
+        tr_internal_vk_reset_fence(p_renderer, p_fence);
+        fence = p_fence->vk_fence;
+    }
 
     VkResult vk_res =
         vkAcquireNextImageKHR(p_renderer->vk_device, p_renderer->vk_swapchain, UINT64_MAX,
                               semaphore, fence, &(p_renderer->swapchain_image_index));
     assert(VK_SUCCESS == vk_res);
 
-    vk_res = vkWaitForFences(p_renderer->vk_device, 1, &fence, VK_TRUE, UINT64_MAX);
-    assert(VK_SUCCESS == vk_res);
-
-    vk_res = vkResetFences(p_renderer->vk_device, 1, &fence);
-    assert(VK_SUCCESS == vk_res);
+    if (NULL != p_fence)
+    {
+        p_fence->vk_submitted = true;
+    }
 }
 
 void tr_internal_vk_queue_submit(tr_queue* p_queue, uint32_t cmd_count, tr_cmd** pp_cmds,
                                  uint32_t wait_semaphore_count, tr_semaphore** pp_wait_semaphores,
-                                 uint32_t signal_semaphore_count,
-                                 tr_semaphore** pp_signal_semaphores)
+                                 const uint64_t* p_wait_values, uint32_t signal_semaphore_count,
+                                 tr_semaphore** pp_signal_semaphores,
+                                 const uint64_t* p_signal_values, tr_fence* p_fence)
 {
     assert(VK_NULL_HANDLE != p_queue->vk_queue);
 
@@ -3270,8 +4732,11 @@ void tr_internal_vk_queue_submit(tr_queue* p_queue, uint32_t cmd_count, tr_cmd**
         cmds[i] = pp_cmds[i]->vk_cmd_buf;
     }
 
+    // Binary semaphores ignore their entry in the value arrays
+    bool timeline = false;
     VkSemaphore wait_semaphores[tr_max_submit_wait_semaphores] = {};
     VkPipelineStageFlags wait_masks[tr_max_submit_wait_semaphores] = {};
+    uint64_t wait_values[tr_max_submit_wait_semaphores] = {};
     wait_semaphore_count = wait_semaphore_count > tr_max_submit_wait_semaphores
                                ? tr_max_submit_wait_semaphores
                                : wait_semaphore_count;
@@ -3279,20 +4744,46 @@ void tr_internal_vk_queue_submit(tr_queue* p_queue, uint32_t cmd_count, tr_cmd**
     {
         wait_semaphores[i] = pp_wait_semaphores[i]->vk_semaphore;
         wait_masks[i] = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+        if ((NULL != p_wait_values) && pp_wait_semaphores[i]->timeline)
+        {
+            wait_values[i] = p_wait_values[i];
+            timeline = true;
+        }
     }
 
     VkSemaphore signal_semaphores[tr_max_submit_signal_semaphores] = {};
+    uint64_t signal_values[tr_max_submit_signal_semaphores] = {};
     signal_semaphore_count = signal_semaphore_count > tr_max_submit_signal_semaphores
                                  ? tr_max_submit_signal_semaphores
                                  : signal_semaphore_count;
-    for (uint32_t i = 0; i < wait_semaphore_count; ++i)
+    for (uint32_t i = 0; i < signal_semaphore_count; ++i)
     {
         signal_semaphores[i] = pp_signal_semaphores[i]->vk_semaphore;
+        if ((NULL != p_signal_values) && pp_signal_semaphores[i]->timeline)
+        {
+            signal_values[i] = p_signal_values[i];
+            timeline = true;
+        }
     }
 
     VkSubmitInfo submit_info = {};
     submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
     submit_info.pNext = NULL;
+#if defined(VK_KHR_timeline_semaphore)
+    VkTimelineSemaphoreSubmitInfoKHR timeline_info = {};
+    timeline_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR;
+    timeline_info.pNext = NULL;
+    timeline_info.waitSemaphoreValueCount = wait_semaphore_count;
+    timeline_info.pWaitSemaphoreValues = wait_values;
+    timeline_info.signalSemaphoreValueCount = signal_semaphore_count;
+    timeline_info.pSignalSemaphoreValues = signal_values;
+    if (timeline)
+    {
+        submit_info.pNext = &timeline_info;
+    }
+#else
+    assert(!timeline);
+#endif
     submit_info.waitSemaphoreCount = wait_semaphore_count;
     submit_info.pWaitSemaphores = wait_semaphores;
     submit_info.pWaitDstStageMask = wait_masks;
@@ -3300,7 +4791,16 @@ void tr_internal_vk_queue_submit(tr_queue* p_queue, uint32_t cmd_count, tr_cmd**
     submit_info.pCommandBuffers = cmds;
     submit_info.signalSemaphoreCount = signal_semaphore_count;
     submit_info.pSignalSemaphores = signal_semaphores;
-    VkResult vk_res = vkQueueSubmit(p_queue->vk_queue, 1, &submit_info, VK_NULL_HANDLE);
+    VkFence fence = VK_NULL_HANDLE;
+    if (NULL != p_fence)
+    {
+        // Fences must be unsignaled when submitted, the caller has waited on the previous use
+        tr_internal_vk_reset_fence(p_queue->renderer, p_fence);
+        p_fence->vk_submitted = true;
+        fence = p_fence->vk_fence;
+    }
+
+    VkResult vk_res = vkQueueSubmit(p_queue->vk_queue, 1, &submit_info, fence);
     assert(VK_SUCCESS == vk_res);
 }
 
@@ -3342,6 +4842,105 @@ void tr_internal_vk_queue_wait_idle(tr_queue* p_queue)
     assert(VK_SUCCESS == vk_res);
 }
 
+bool tr_internal_vk_get_fence_status(tr_renderer* p_renderer, tr_fence* p_fence)
+{
+    assert(VK_NULL_HANDLE != p_renderer->vk_device);
+    assert(VK_NULL_HANDLE != p_fence->vk_fence);
+
+    if (!p_fence->vk_submitted)
+    {
+        return true;
+    }
+
+    VkResult vk_res = vkGetFenceStatus(p_renderer->vk_device, p_fence->vk_fence);
+    assert((VK_SUCCESS == vk_res) || (VK_NOT_READY == vk_res));
+    return VK_SUCCESS == vk_res;
+}
+
+void tr_internal_vk_wait_for_fence(tr_renderer* p_renderer, tr_fence* p_fence)
+{
+    assert(VK_NULL_HANDLE != p_renderer->vk_device);
+    assert(VK_NULL_HANDLE != p_fence->vk_fence);
+
+    if (!p_fence->vk_submitted)
+    {
+        return;
+    }
+
+    VkResult vk_res =
+        vkWaitForFences(p_renderer->vk_device, 1, &(p_fence->vk_fence), VK_TRUE, UINT64_MAX);
+    assert(VK_SUCCESS == vk_res);
+}
+
+void tr_internal_vk_reset_fence(tr_renderer* p_renderer, tr_fence* p_fence)
+{
+    assert(VK_NULL_HANDLE != p_renderer->vk_device);
+    assert(VK_NULL_HANDLE != p_fence->vk_fence);
+
+    if (!p_fence->vk_submitted)
+    {
+        return;
+    }
+
+    VkResult vk_res = vkResetFences(p_renderer->vk_device, 1, &(p_fence->vk_fence));
+    assert(VK_SUCCESS == vk_res);
+    p_fence->vk_submitted = false;
+}
+
+uint64_t tr_internal_vk_get_semaphore_value(tr_renderer* p_renderer, tr_semaphore* p_semaphore)
+{
+    assert(VK_NULL_HANDLE != p_renderer->vk_device);
+    assert(VK_NULL_HANDLE != p_semaphore->vk_semaphore);
+
+    uint64_t value = 0;
+#if defined(VK_KHR_timeline_semaphore)
+    assert(NULL != p_renderer->vkGetSemaphoreCounterValueKHR);
+    VkResult vk_res = p_renderer->vkGetSemaphoreCounterValueKHR(
+        p_renderer->vk_device, p_semaphore->vk_semaphore, &value);
+    assert(VK_SUCCESS == vk_res);
+#endif
+    return value;
+}
+
+void tr_internal_vk_signal_semaphore(tr_renderer* p_renderer, tr_semaphore* p_semaphore,
+                                    uint64_t value)
+{
+    assert(VK_NULL_HANDLE != p_renderer->vk_device);
+    assert(VK_NULL_HANDLE != p_semaphore->vk_semaphore);
+
+#if defined(VK_KHR_timeline_semaphore)
+    assert(NULL != p_renderer->vkSignalSemaphoreKHR);
+    VkSemaphoreSignalInfoKHR signal_info = {};
+    signal_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SIGNAL_INFO_KHR;
+    signal_info.pNext = NULL;
+    signal_info.semaphore = p_semaphore->vk_semaphore;
+    signal_info.value = value;
+    VkResult vk_res = p_renderer->vkSignalSemaphoreKHR(p_renderer->vk_device, &signal_info);
+    assert(VK_SUCCESS == vk_res);
+#endif
+}
+
+void tr_internal_vk_wait_for_semaphore(tr_renderer* p_renderer, tr_semaphore* p_semaphore,
+                                      uint64_t value)
+{
+    assert(VK_NULL_HANDLE != p_renderer->vk_device);
+    assert(VK_NULL_HANDLE != p_semaphore->vk_semaphore);
+
+#if defined(VK_KHR_timeline_semaphore)
+    assert(NULL != p_renderer->vkWaitSemaphoresKHR);
+    VkSemaphoreWaitInfoKHR wait_info = {};
+    wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR;
+    wait_info.pNext = NULL;
+    wait_info.flags = 0;
+    wait_info.semaphoreCount = 1;
+    wait_info.pSemaphores = &(p_semaphore->vk_semaphore);
+    wait_info.pValues = &value;
+    VkResult vk_res =
+        p_renderer->vkWaitSemaphoresKHR(p_renderer->vk_device, &wait_info, UINT64_MAX);
+    assert(VK_SUCCESS == vk_res);
+#endif
+}
+
 VkFormat tr_util_to_vk_format(tr_format format)
 {
     VkFormat result = VK_FORMAT_UNDEFINED;
@@ -3402,6 +5001,12 @@ VkFormat tr_util_to_vk_format(tr_format format)
     case tr_format_r8g8b8a8_unorm:
         result = VK_FORMAT_R8G8B8A8_UNORM;
         break;
+    case tr_format_b8g8r8a8_srgb:
+        result = VK_FORMAT_B8G8R8A8_SRGB;
+        break;
+    case tr_format_r8g8b8a8_srgb:
+        result = VK_FORMAT_R8G8B8A8_SRGB;
+        break;
     case tr_format_r16g16b16a16_unorm:
         result = VK_FORMAT_R16G16B16A16_UNORM;
         break;
@@ -3436,6 +5041,49 @@ VkFormat tr_util_to_vk_format(tr_format format)
     case tr_format_d32_float_s8_uint:
         result = VK_FORMAT_D32_SFLOAT_S8_UINT;
         break;
+        // Block compressed
+    case tr_format_bc1_rgba_unorm:
+        result = VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+        break;
+    case tr_format_bc1_rgba_srgb:
+        result = VK_FORMAT_BC1_RGBA_SRGB_BLOCK;
+        break;
+    case tr_format_bc3_unorm:
+        result = VK_FORMAT_BC3_UNORM_BLOCK;
+        break;
+    case tr_format_bc3_srgb:
+        result = VK_FORMAT_BC3_SRGB_BLOCK;
+        break;
+    case tr_format_bc4_unorm:
+        result = VK_FORMAT_BC4_UNORM_BLOCK;
+        break;
+    case tr_format_bc5_unorm:
+        result = VK_FORMAT_BC5_UNORM_BLOCK;
+        break;
+    case tr_format_bc6h_ufloat:
+        result = VK_FORMAT_BC6H_UFLOAT_BLOCK;
+        break;
+    case tr_format_bc7_unorm:
+        result = VK_FORMAT_BC7_UNORM_BLOCK;
+        break;
+    case tr_format_bc7_srgb:
+        result = VK_FORMAT_BC7_SRGB_BLOCK;
+        break;
+    case tr_format_etc2_r8g8b8_unorm:
+        result = VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK;
+        break;
+    case tr_format_etc2_r8g8b8a8_unorm:
+        result = VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK;
+        break;
+    case tr_format_etc2_r8g8b8a8_srgb:
+        result = VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK;
+        break;
+    case tr_format_astc_4x4_unorm:
+        result = VK_FORMAT_ASTC_4x4_UNORM_BLOCK;
+        break;
+    case tr_format_astc_4x4_srgb:
+        result = VK_FORMAT_ASTC_4x4_SRGB_BLOCK;
+        break;
     }
     return result;
 }
@@ -3500,6 +5148,12 @@ tr_format tr_util_from_vk_format(VkFormat format)
     case VK_FORMAT_R8G8B8A8_UNORM:
         result = tr_format_r8g8b8a8_unorm;
         break;
+    case VK_FORMAT_B8G8R8A8_SRGB:
+        result = tr_format_b8g8r8a8_srgb;
+        break;
+    case VK_FORMAT_R8G8B8A8_SRGB:
+        result = tr_format_r8g8b8a8_srgb;
+        break;
     case VK_FORMAT_R16G16B16A16_UNORM:
         result = tr_format_r16g16b16a16_unorm;
         break;
@@ -3534,6 +5188,49 @@ tr_format tr_util_from_vk_format(VkFormat format)
     case VK_FORMAT_D32_SFLOAT_S8_UINT:
         result = tr_format_d32_float_s8_uint;
         break;
+        // Block compressed
+    case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+        result = tr_format_bc1_rgba_unorm;
+        break;
+    case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+        result = tr_format_bc1_rgba_srgb;
+        break;
+    case VK_FORMAT_BC3_UNORM_BLOCK:
+        result = tr_format_bc3_unorm;
+        break;
+    case VK_FORMAT_BC3_SRGB_BLOCK:
+        result = tr_format_bc3_srgb;
+        break;
+    case VK_FORMAT_BC4_UNORM_BLOCK:
+        result = tr_format_bc4_unorm;
+        break;
+    case VK_FORMAT_BC5_UNORM_BLOCK:
+        result = tr_format_bc5_unorm;
+        break;
+    case VK_FORMAT_BC6H_UFLOAT_BLOCK:
+        result = tr_format_bc6h_ufloat;
+        break;
+    case VK_FORMAT_BC7_UNORM_BLOCK:
+        result = tr_format_bc7_unorm;
+        break;
+    case VK_FORMAT_BC7_SRGB_BLOCK:
+        result = tr_format_bc7_srgb;
+        break;
+    case VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK:
+        result = tr_format_etc2_r8g8b8_unorm;
+        break;
+    case VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK:
+        result = tr_format_etc2_r8g8b8a8_unorm;
+        break;
+    case VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK:
+        result = tr_format_etc2_r8g8b8a8_srgb;
+        break;
+    case VK_FORMAT_ASTC_4x4_UNORM_BLOCK:
+        result = tr_format_astc_4x4_unorm;
+        break;
+    case VK_FORMAT_ASTC_4x4_SRGB_BLOCK:
+        result = tr_format_astc_4x4_srgb;
+        break;
     }
     return result;
 }
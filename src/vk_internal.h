@@ -11,20 +11,41 @@ void tr_internal_vk_create_device(tr_renderer* p_renderer);
 void tr_internal_vk_create_swapchain(tr_renderer* p_renderer);
 void tr_internal_create_swapchain_renderpass(tr_renderer* p_renderer);
 void tr_internal_vk_create_swapchain_renderpass(tr_renderer* p_renderer);
+void tr_internal_vk_create_pipeline_cache(tr_renderer* p_renderer);
 void tr_internal_vk_destroy_instance(tr_renderer* p_renderer);
 void tr_internal_vk_destroy_surface(tr_renderer* p_renderer);
 void tr_internal_vk_destroy_device(tr_renderer* p_renderer);
 void tr_internal_vk_destroy_swapchain(tr_renderer* p_renderer);
+void tr_internal_vk_destroy_pipeline_cache(tr_renderer* p_renderer);
+
+// Internal memory functions
+void tr_internal_vk_allocate_memory(tr_renderer* p_renderer, const VkMemoryRequirements& mem_reqs,
+                                    VkMemoryPropertyFlags mem_flags, bool linear,
+                                    tr_memory_allocation* p_allocation);
+void tr_internal_vk_free_memory(tr_renderer* p_renderer, tr_memory_allocation* p_allocation);
+void tr_internal_vk_destroy_memory_blocks(tr_renderer* p_renderer);
 
 // Internal create functions
 void tr_internal_vk_create_fence(tr_renderer* p_renderer, tr_fence* p_fence);
 void tr_internal_vk_destroy_fence(tr_renderer* p_renderer, tr_fence* p_fence);
 void tr_internal_vk_create_semaphore(tr_renderer* p_renderer, tr_semaphore* p_semaphore);
 void tr_internal_vk_destroy_semaphore(tr_renderer* p_renderer, tr_semaphore* p_semaphore);
+void tr_internal_vk_create_timeline_semaphore(tr_renderer* p_renderer, uint64_t initial_value,
+                                             tr_semaphore* p_semaphore);
 void tr_internal_vk_create_descriptor_set(tr_renderer* p_renderer,
                                           tr_descriptor_set* p_descriptor_set);
+void tr_internal_vk_destroy_descriptor_pool(tr_renderer* p_renderer,
+                                            tr_descriptor_pool* p_descriptor_pool);
+void tr_internal_vk_reset_descriptor_pool(tr_renderer* p_renderer,
+                                          tr_descriptor_pool* p_descriptor_pool);
 void tr_internal_vk_destroy_descriptor_set(tr_renderer* p_renderer,
                                            tr_descriptor_set* p_descriptor_set);
+void tr_internal_vk_create_bindless_descriptor_set(tr_renderer* p_renderer,
+                                                   tr_descriptor_set* p_descriptor_set);
+void tr_internal_vk_destroy_bindless_descriptor_set(tr_renderer* p_renderer,
+                                                    tr_descriptor_set* p_descriptor_set);
+void tr_internal_vk_update_bindless_texture(tr_renderer* p_renderer, tr_texture* p_texture);
+void tr_internal_vk_update_bindless_buffer(tr_renderer* p_renderer, tr_buffer* p_buffer);
 void tr_internal_vk_create_cmd_pool(tr_renderer* p_renderer, tr_queue* p_queue, bool transient,
                                     tr_cmd_pool* p_cmd_pool);
 void tr_internal_vk_destroy_cmd_pool(tr_renderer* p_renderer, tr_cmd_pool* p_cmd_pool);
@@ -34,17 +55,24 @@ void tr_internal_vk_create_buffer(tr_renderer* p_renderer, tr_buffer* p_buffer);
 void tr_internal_vk_destroy_buffer(tr_renderer* p_renderer, tr_buffer* p_buffer);
 void tr_internal_vk_create_texture(tr_renderer* p_renderer, tr_texture* p_texture);
 void tr_internal_vk_destroy_texture(tr_renderer* p_renderer, tr_texture* p_texture);
+bool tr_internal_vk_supports_format(tr_renderer* p_renderer, tr_format format,
+                                    tr_texture_usage_flags usage);
 void tr_internal_vk_create_sampler(tr_renderer* p_renderer, tr_sampler* p_sampler);
 void tr_internal_vk_destroy_sampler(tr_renderer* p_renderer, tr_sampler* p_sampler);
 void tr_internal_vk_create_pipeline(tr_renderer* p_renderer, tr_shader_program* p_shader_program,
                                     const tr_vertex_layout* p_vertex_layout,
-                                    tr_descriptor_set* pp_descriptor_set,
+                                    uint32_t descriptor_set_count,
+                                    tr_descriptor_set* const* pp_descriptor_sets,
                                     tr_render_target* p_render_target,
                                     const tr_pipeline_settings* p_pipeline_settings,
                                     tr_pipeline* p_pipeline);
+void tr_internal_vk_create_pipelines(tr_renderer* p_renderer, uint32_t pipeline_count,
+                                     const tr_pipeline_create_info* p_create_infos,
+                                     tr_pipeline** pp_pipelines);
 void tr_internal_vk_create_compute_pipeline(tr_renderer* p_renderer,
                                             tr_shader_program* p_shader_program,
-                                            tr_descriptor_set* p_descriptor_set,
+                                            uint32_t descriptor_set_count,
+                                            tr_descriptor_set* const* pp_descriptor_sets,
                                             const tr_pipeline_settings* p_pipeline_settings,
                                             tr_pipeline* p_pipeline);
 void tr_internal_vk_destroy_pipeline(tr_renderer* p_renderer, tr_pipeline* p_pipeline);
@@ -82,7 +110,12 @@ void tr_cmd_internal_vk_cmd_clear_depth_stencil_attachment(tr_cmd* p_cmd,
                                                            const tr_clear_value* clear_value);
 void tr_internal_vk_cmd_bind_pipeline(tr_cmd* p_cmd, tr_pipeline* p_pipeline);
 void tr_internal_vk_cmd_bind_descriptor_sets(tr_cmd* p_cmd, tr_pipeline* p_pipeline,
-                                             tr_descriptor_set* p_descriptor_set);
+                                             uint32_t first_set, uint32_t descriptor_set_count,
+                                             tr_descriptor_set* const* pp_descriptor_sets,
+                                             uint32_t dynamic_offset_count,
+                                             const uint32_t* p_dynamic_offsets);
+void tr_internal_vk_cmd_push_constants(tr_cmd* p_cmd, tr_pipeline* p_pipeline, uint32_t offset,
+                                      uint32_t size, const void* p_data);
 void tr_internal_vk_cmd_bind_index_buffer(tr_cmd* p_cmd, tr_buffer* p_buffer);
 void tr_internal_vk_cmd_bind_vertex_buffers(tr_cmd* p_cmd, uint32_t buffer_count,
                                             tr_buffer** pp_buffers);
@@ -93,6 +126,17 @@ void tr_internal_vk_cmd_buffer_transition(tr_cmd* p_cmd, tr_buffer* p_buffer,
                                           tr_buffer_usage old_usage, tr_buffer_usage new_usage);
 void tr_internal_vk_cmd_image_transition(tr_cmd* p_cmd, tr_texture* p_texture,
                                          tr_texture_usage old_usage, tr_texture_usage new_usage);
+void tr_internal_vk_cmd_buffer_transition_queue(tr_cmd* p_cmd, tr_buffer* p_buffer,
+                                                tr_buffer_usage old_usage,
+                                                tr_buffer_usage new_usage, tr_queue* p_src_queue,
+                                                tr_queue* p_dst_queue);
+void tr_internal_vk_cmd_image_transition_queue(tr_cmd* p_cmd, tr_texture* p_texture,
+                                               tr_texture_usage old_usage,
+                                               tr_texture_usage new_usage, tr_queue* p_src_queue,
+                                               tr_queue* p_dst_queue);
+bool tr_internal_vk_can_generate_mipmaps(tr_queue* p_queue, tr_texture* p_texture);
+void tr_internal_vk_cmd_generate_mipmaps(tr_cmd* p_cmd, tr_texture* p_texture,
+                                         tr_texture_usage old_usage, tr_texture_usage new_usage);
 void tr_internal_vk_cmd_render_target_transition(tr_cmd* p_cmd, tr_render_target* p_render_target,
                                                  tr_texture_usage old_usage,
                                                  tr_texture_usage new_usage);
@@ -108,11 +152,20 @@ void tr_internal_vk_acquire_next_image(tr_renderer* p_renderer, tr_semaphore* p_
                                        tr_fence* p_fence);
 void tr_internal_vk_queue_submit(tr_queue* p_queue, uint32_t cmd_count, tr_cmd** pp_cmds,
                                  uint32_t wait_semaphore_count, tr_semaphore** pp_wait_semaphores,
-                                 uint32_t signal_semaphore_count,
-                                 tr_semaphore** pp_signal_semaphores);
+                                 const uint64_t* p_wait_values, uint32_t signal_semaphore_count,
+                                 tr_semaphore** pp_signal_semaphores,
+                                 const uint64_t* p_signal_values, tr_fence* p_fence);
 void tr_internal_vk_queue_present(tr_queue* p_queue, uint32_t wait_semaphore_count,
                                   tr_semaphore** pp_wait_semaphores);
 void tr_internal_vk_queue_wait_idle(tr_queue* p_queue);
+bool tr_internal_vk_get_fence_status(tr_renderer* p_renderer, tr_fence* p_fence);
+void tr_internal_vk_wait_for_fence(tr_renderer* p_renderer, tr_fence* p_fence);
+void tr_internal_vk_reset_fence(tr_renderer* p_renderer, tr_fence* p_fence);
+uint64_t tr_internal_vk_get_semaphore_value(tr_renderer* p_renderer, tr_semaphore* p_semaphore);
+void tr_internal_vk_signal_semaphore(tr_renderer* p_renderer, tr_semaphore* p_semaphore,
+                                    uint64_t value);
+void tr_internal_vk_wait_for_semaphore(tr_renderer* p_renderer, tr_semaphore* p_semaphore,
+                                      uint64_t value);
 
 VkFormat tr_util_to_vk_format(tr_format format);
 